@@ -57,7 +57,7 @@ public:
     void tx (germ::tx const & tx) override
     {
 
-        if ( tx.previous() != tx.account_ )
+        if ( tx.previous() != tx.account () )
             fill_value(tx);
     }
 
@@ -200,17 +200,17 @@ germ::store_iterator germ::block_store::block_info_end ()
     return result;
 }
 
-//germ::store_iterator germ::block_store::representation_begin (MDB_txn * transaction_a)
-//{
-//    germ::store_iterator result (transaction_a, representation);
-//    return result;
-//}
-//
-//germ::store_iterator germ::block_store::representation_end ()
-//{
-//    germ::store_iterator result (nullptr);
-//    return result;
-//}
+germ::store_iterator germ::block_store::representation_begin (MDB_txn * transaction_a)
+{
+    germ::store_iterator result (transaction_a, representation);
+    return result;
+}
+
+germ::store_iterator germ::block_store::representation_end ()
+{
+    germ::store_iterator result (nullptr);
+    return result;
+}
 
 germ::store_iterator germ::block_store::unchecked_begin (MDB_txn * transaction_a)
 {
@@ -240,8 +240,8 @@ germ::store_iterator germ::block_store::vote_end ()
     return germ::store_iterator (nullptr);
 }
 
-germ::block_store::block_store (bool & error_a, boost::filesystem::path const & path_a, int lmdb_max_dbs) :
-environment (error_a, path_a, lmdb_max_dbs),
+germ::block_store::block_store (bool & error_a, boost::filesystem::path const & path_a, int lmdb_max_dbs, germ::lmdb_config const & lmdb_config_a) :
+environment (error_a, path_a, lmdb_max_dbs, lmdb_config_a),
 frontiers (0),
 accounts (0),
 send_blocks (0),
@@ -249,10 +249,15 @@ receive_blocks (0),
 open_blocks (0),
 change_blocks (0),
 pending (0),
+receivable (0),
 blocks_info (0),
+heights (0),
+block_heights (0),
 representation (0),
+witness_tallies (0),
 unchecked (0),
-checksum (0)
+checksum (0),
+blocks_cached (0)
 {
     if (!error_a)
     {
@@ -265,8 +270,12 @@ checksum (0)
         error_a |= mdb_dbi_open (transaction, "change", MDB_CREATE, &change_blocks) != 0;
         error_a |= mdb_dbi_open (transaction, "state", MDB_CREATE, &state_blocks) != 0;
         error_a |= mdb_dbi_open (transaction, "pending", MDB_CREATE, &pending) != 0;
+        error_a |= mdb_dbi_open (transaction, "receivable", MDB_CREATE, &receivable) != 0;
         error_a |= mdb_dbi_open (transaction, "blocks_info", MDB_CREATE, &blocks_info) != 0;
-//        error_a |= mdb_dbi_open (transaction, "representation", MDB_CREATE, &representation) != 0;
+        error_a |= mdb_dbi_open (transaction, "heights", MDB_CREATE, &heights) != 0;
+        error_a |= mdb_dbi_open (transaction, "block_heights", MDB_CREATE, &block_heights) != 0;
+        error_a |= mdb_dbi_open (transaction, "representation", MDB_CREATE, &representation) != 0;
+        error_a |= mdb_dbi_open (transaction, "witness_tallies", MDB_CREATE, &witness_tallies) != 0;
         error_a |= mdb_dbi_open (transaction, "unchecked", MDB_CREATE | MDB_DUPSORT, &unchecked) != 0;
         error_a |= mdb_dbi_open (transaction, "checksum", MDB_CREATE, &checksum) != 0;
         error_a |= mdb_dbi_open (transaction, "vote", MDB_CREATE, &vote) != 0;
@@ -277,6 +286,22 @@ checksum (0)
             checksum_put (transaction, 0, 0, 0);
         }
     }
+    if (!error_a)
+    {
+        // Loaded from the committed tables, replacing anything the upgrades queued on commit
+        germ::transaction transaction (environment, nullptr, false);
+        blocks_cached = block_count (transaction).sum ();
+        std::lock_guard<std::mutex> lock (weights_mutex);
+        weights_cache.clear ();
+        for (auto i (representation_begin (transaction)), n (representation_end ()); i != n; ++i)
+        {
+            germ::uint128_union weight;
+            germ::bufferstream stream (reinterpret_cast<uint8_t const *> (i->second.data ()), i->second.size ());
+            auto error (germ::read (stream, weight));
+            assert (!error);
+            weights_cache[germ::account (i->first.uint256 ())] = weight.number ();
+        }
+    }
 }
 
 void germ::block_store::version_put (MDB_txn * transaction_a, int version_a)
@@ -284,6 +309,7 @@ void germ::block_store::version_put (MDB_txn * transaction_a, int version_a)
     germ::uint256_union version_key (1);
     germ::uint256_union version_value (version_a);
     auto status (mdb_put (transaction_a, meta, germ::mdb_val (version_key), germ::mdb_val (version_value), 0));
+    environment.write_status (status);
     assert (status == 0);
 }
 
@@ -322,6 +348,7 @@ germ::raw_key germ::block_store::get_node_id (MDB_txn * transaction_a)
     {
         germ::random_pool.GenerateBlock (node_id.data.bytes.data (), node_id.data.bytes.size ());
         error = mdb_put (transaction_a, meta, germ::mdb_val (node_id_mdb_key), germ::mdb_val (node_id.data), 0);
+        environment.write_status (error);
     }
     assert (!error);
     return node_id;
@@ -331,6 +358,7 @@ void germ::block_store::delete_node_id (MDB_txn * transaction_a)
 {
     germ::uint256_union node_id_mdb_key (3);
     auto error (mdb_del (transaction_a, meta, germ::mdb_val (node_id_mdb_key), nullptr));
+    environment.write_status (error);
     assert (!error || error == MDB_NOTFOUND);
 }
 
@@ -359,6 +387,12 @@ void germ::block_store::do_upgrades (MDB_txn * transaction_a)
         case 10:
             upgrade_v10_to_v11 (transaction_a);
         case 11:
+            upgrade_v11_to_v12 (transaction_a);
+        case 12:
+            upgrade_v12_to_v13 (transaction_a);
+        case 13:
+            upgrade_v13_to_v14 (transaction_a);
+        case 14:
             break;
         default:
             assert (false);
@@ -393,6 +427,7 @@ void germ::block_store::upgrade_v1_to_v2 (MDB_txn * transaction_a)
         }
         v2.open_block = block->hash ();
         auto status (mdb_put (transaction_a, accounts, germ::mdb_val (account), v2.val (), 0));
+        environment.write_status (status);
         assert (status == 0);
         account = account.number () + 1;
     }
@@ -515,6 +550,7 @@ void germ::block_store::upgrade_v8_to_v9 (MDB_txn * transaction_a)
             dummy->serialize (stream);
         }
         auto status1 (mdb_put (transaction_a, vote, i->first, germ::mdb_val (vector.size (), vector.data ()), 0));
+        environment.write_status (status1);
         assert (status1 == 0);
         assert (!error);
     }
@@ -560,6 +596,48 @@ void germ::block_store::upgrade_v10_to_v11 (MDB_txn * transaction_a)
     mdb_drop (transaction_a, unsynced, 1);
 }
 
+void germ::block_store::upgrade_v11_to_v12 (MDB_txn * transaction_a)
+{
+    version_put (transaction_a, 12);
+    for (auto i (latest_begin (transaction_a)), n (latest_end ()); i != n; ++i)
+    {
+        germ::account account (i->first.uint256 ());
+        germ::account_info info (i->second);
+        uint64_t height (1);
+        auto hash (info.open_block);
+        while (!hash.is_zero ())
+        {
+            block_height_put (transaction_a, account, height, hash);
+            hash = block_successor (transaction_a, hash);
+            ++height;
+        }
+    }
+}
+
+void germ::block_store::upgrade_v12_to_v13 (MDB_txn * transaction_a)
+{
+    version_put (transaction_a, 13);
+    mdb_drop (transaction_a, receivable, 0);
+    for (auto i (pending_begin (transaction_a)), n (pending_end ()); i != n; ++i)
+    {
+        germ::pending_key key (i->first);
+        germ::pending_info info (i->second);
+        receivable_add (transaction_a, key.account, 1, info.amount.number (), true);
+    }
+}
+
+void germ::block_store::upgrade_v13_to_v14 (MDB_txn * transaction_a)
+{
+    version_put (transaction_a, 14);
+    // Accounts represent themselves so weights are rebuilt from balances
+    mdb_drop (transaction_a, representation, 0);
+    for (auto i (latest_begin (transaction_a)), n (latest_end ()); i != n; ++i)
+    {
+        germ::account_info info (i->second);
+        representation_add (transaction_a, i->first.uint256 (), info.balance.number ());
+    }
+}
+
 void germ::block_store::clear (MDB_dbi db_a)
 {
     germ::transaction transaction (environment, nullptr, true);
@@ -574,14 +652,68 @@ germ::uint128_t germ::block_store::block_balance (MDB_txn * transaction_a, germ:
     return visitor.balance;
 }
 
-//void germ::block_store::representation_add (MDB_txn * transaction_a, germ::block_hash const & source_a, germ::uint128_t const & amount_a)
-//{
-//    auto source_block (block_get (transaction_a, source_a));
-//    assert (source_block != nullptr);
-//    auto source_rep (source_block->representative ());
-//    auto source_previous (representation_get (transaction_a, source_rep));
-//    representation_put (transaction_a, source_rep, source_previous + amount_a);
-//}
+void germ::block_store::representation_add (MDB_txn * transaction_a, germ::account const & account_a, germ::uint128_t const & amount_a)
+{
+    auto previous (representation_get (transaction_a, account_a));
+    representation_put (transaction_a, account_a, previous + amount_a);
+}
+
+void germ::block_store::representation_sub (MDB_txn * transaction_a, germ::account const & account_a, germ::uint128_t const & amount_a)
+{
+    auto previous (representation_get (transaction_a, account_a));
+    assert (previous >= amount_a);
+    representation_put (transaction_a, account_a, previous - amount_a);
+}
+
+germ::block_store::cache_delta::cache_delta () :
+transaction (nullptr),
+blocks_added (0),
+blocks_removed (0)
+{
+}
+
+germ::block_store::cache_delta & germ::block_store::delta (MDB_txn * transaction_a)
+{
+    if (pending_delta.transaction != transaction_a)
+    {
+        assert (pending_delta.transaction == nullptr);
+        pending_delta.transaction = transaction_a;
+        environment.on_end (transaction_a, [this](bool committed_a) {
+            delta_end (committed_a);
+        });
+    }
+    return pending_delta;
+}
+
+void germ::block_store::delta_end (bool committed_a)
+{
+    if (committed_a)
+    {
+        assert (blocks_cached + pending_delta.blocks_added >= pending_delta.blocks_removed);
+        blocks_cached += pending_delta.blocks_added;
+        blocks_cached -= pending_delta.blocks_removed;
+        if (!pending_delta.weights.empty ())
+        {
+            // Commits from different transactions can finish out of order, so the cache is moved by the differences rather than set
+            std::lock_guard<std::mutex> lock (weights_mutex);
+            for (auto & i : pending_delta.weights)
+            {
+                auto & weight (weights_cache[i.first]);
+                weight += i.second.first;
+                assert (weight >= i.second.second);
+                weight -= i.second.second;
+                if (weight.is_zero ())
+                {
+                    weights_cache.erase (i.first);
+                }
+            }
+        }
+    }
+    pending_delta.transaction = nullptr;
+    pending_delta.blocks_added = 0;
+    pending_delta.blocks_removed = 0;
+    pending_delta.weights.clear ();
+}
 
 MDB_dbi germ::block_store::block_database (germ::block_type type_a)
 {
@@ -614,6 +746,7 @@ MDB_dbi germ::block_store::block_database (germ::block_type type_a)
 void germ::block_store::block_put_raw (MDB_txn * transaction_a, MDB_dbi database_a, germ::block_hash const & hash_a, MDB_val value_a)
 {
     auto status2 (mdb_put (transaction_a, database_a, germ::mdb_val (hash_a), &value_a, 0));
+    environment.write_status (status2);
     assert (status2 == 0);
 }
 
@@ -626,7 +759,15 @@ void germ::block_store::block_put (MDB_txn * transaction_a, germ::block_hash con
         block_a.serialize (stream);
         germ::write (stream, successor_a.bytes);
     }
-    block_put_raw (transaction_a, block_database (block_a.type ()), hash_a, { vector.size (), vector.data () });
+    auto database (block_database (block_a.type ()));
+    germ::mdb_val junk;
+    auto existing (mdb_get (transaction_a, database, germ::mdb_val (hash_a), junk));
+    assert (existing == 0 || existing == MDB_NOTFOUND);
+    block_put_raw (transaction_a, database, hash_a, { vector.size (), vector.data () });
+    if (existing == MDB_NOTFOUND)
+    {
+        ++delta (transaction_a).blocks_added;
+    }
     set_predecessor predecessor (transaction_a, *this);
     block_a.visit (predecessor);
 //    assert (block_a.previous ().is_zero () || block_successor (transaction_a, block_a.previous ()) == hash_a);
@@ -772,30 +913,41 @@ std::unique_ptr<germ::tx> germ::block_store::block_get (MDB_txn * transaction_a,
     }
     return result;
 }
-void germ::block_store::block_del (MDB_txn * transaction_a, germ::block_hash const & hash_a)
-{
-    auto status_state (mdb_del (transaction_a, state_blocks, germ::mdb_val (hash_a), nullptr));
-    assert (status_state == 0 || status_state == MDB_NOTFOUND);
-    if (status_state == 0)
-        return;
 
-    auto status_send (mdb_del (transaction_a, send_blocks, germ::mdb_val (hash_a), nullptr));
-    assert (status_send == 0 || status_send == MDB_NOTFOUND);
-    if (status_send == 0)
-        return;
-
-    auto status_recv (mdb_del (transaction_a, receive_blocks, germ::mdb_val (hash_a), nullptr));
-    assert (status_recv == 0 || status_recv == MDB_NOTFOUND);
-    if (status_recv == 0)
-        return;
-
-    auto status_open (mdb_del (transaction_a, open_blocks, germ::mdb_val (hash_a), nullptr));
-    assert (status_open == 0 || status_open == MDB_NOTFOUND);
-    if (status_open == 0)
-        return;
+bool germ::block_store::block_view (MDB_txn * transaction_a, germ::block_hash const & hash_a, germ::tx_view & view_a)
+{
+    germ::block_type type;
+    auto value (block_get_raw (transaction_a, hash_a, type));
+    auto result (value.mv_size != 0);
+    if (result)
+    {
+        auto error (false);
+        view_a = germ::tx_view (error, reinterpret_cast<uint8_t const *> (value.mv_data), value.mv_size);
+        assert (!error);
+    }
+    return result;
+}
 
-    auto status_change (mdb_del (transaction_a, change_blocks, germ::mdb_val (hash_a), nullptr));
-    assert (status_change == 0);
+void germ::block_store::block_del (MDB_txn * transaction_a, germ::block_hash const & hash_a)
+{
+    auto deleted (false);
+    for (auto database : { state_blocks, send_blocks, receive_blocks, open_blocks, change_blocks })
+    {
+        auto status (mdb_del (transaction_a, database, germ::mdb_val (hash_a), nullptr));
+        environment.write_status (status);
+        assert (status == 0 || status == MDB_NOTFOUND);
+        if (status == 0)
+        {
+            deleted = true;
+            break;
+        }
+    }
+    // The block is asserted to be in one of the tables above
+    assert (deleted);
+    if (deleted)
+    {
+        ++delta (transaction_a).blocks_removed;
+    }
 }
 
 bool germ::block_store::block_exists (MDB_txn * transaction_a, germ::block_hash const & hash_a)
@@ -866,6 +1018,7 @@ bool germ::block_store::root_exists (MDB_txn * transaction_a, germ::uint256_unio
 void germ::block_store::account_del (MDB_txn * transaction_a, germ::account const & account_a)
 {
     auto status (mdb_del (transaction_a, accounts, germ::mdb_val (account_a), nullptr));
+    environment.write_status (status);
     assert (status == 0);
 }
 
@@ -898,6 +1051,7 @@ bool germ::block_store::account_get (MDB_txn * transaction_a, germ::account cons
 void germ::block_store::frontier_put (MDB_txn * transaction_a, germ::block_hash const & block_a, germ::account const & account_a)
 {
     auto status (mdb_put (transaction_a, frontiers, germ::mdb_val (block_a), germ::mdb_val (account_a), 0));
+    environment.write_status (status);
     assert (status == 0);
 }
 
@@ -917,6 +1071,7 @@ germ::account germ::block_store::frontier_get (MDB_txn * transaction_a, germ::bl
 void germ::block_store::frontier_del (MDB_txn * transaction_a, germ::block_hash const & block_a)
 {
     auto status (mdb_del (transaction_a, frontiers, germ::mdb_val (block_a), nullptr));
+    environment.write_status (status);
     assert (status == 0);
 }
 
@@ -932,19 +1087,69 @@ size_t germ::block_store::account_count (MDB_txn * transaction_a)
 void germ::block_store::account_put (MDB_txn * transaction_a, germ::account const & account_a, germ::account_info const & info_a)
 {
     auto status (mdb_put (transaction_a, accounts, germ::mdb_val (account_a), info_a.val (), 0));
+    environment.write_status (status);
     assert (status == 0);
 }
 
 void germ::block_store::pending_put (MDB_txn * transaction_a, germ::pending_key const & key_a, germ::pending_info const & pending_a)
 {
+    germ::pending_info existing;
+    if (pending_get (transaction_a, key_a, existing))
+    {
+        receivable_add (transaction_a, key_a.account, -1, existing.amount.number (), false);
+    }
     auto status (mdb_put (transaction_a, pending, key_a.val (), pending_a.val (), 0));
+    environment.write_status (status);
     assert (status == 0);
+    receivable_add (transaction_a, key_a.account, 1, pending_a.amount.number (), true);
 }
 
 void germ::block_store::pending_del (MDB_txn * transaction_a, germ::pending_key const & key_a)
 {
+    germ::pending_info existing;
+    auto found (pending_get (transaction_a, key_a, existing));
+    assert (found);
     auto status (mdb_del (transaction_a, pending, key_a.val (), nullptr));
+    environment.write_status (status);
     assert (status == 0);
+    if (found)
+    {
+        receivable_add (transaction_a, key_a.account, -1, existing.amount.number (), false);
+    }
+}
+
+germ::receivable_info germ::block_store::receivable_get (MDB_txn * transaction_a, germ::account const & account_a)
+{
+    germ::receivable_info result;
+    germ::mdb_val value;
+    auto status (mdb_get (transaction_a, receivable, germ::mdb_val (account_a), value));
+    assert (status == 0 || status == MDB_NOTFOUND);
+    if (status == 0)
+    {
+        result = germ::receivable_info (value);
+    }
+    return result;
+}
+
+void germ::block_store::receivable_add (MDB_txn * transaction_a, germ::account const & account_a, int64_t count_a, germ::uint128_t const & amount_a, bool increase_a)
+{
+    auto info (receivable_get (transaction_a, account_a));
+    assert (count_a >= 0 || info.count >= static_cast<uint64_t> (-count_a));
+    assert (increase_a || info.total.number () >= amount_a);
+    info.count += count_a;
+    info.total = increase_a ? info.total.number () + amount_a : info.total.number () - amount_a;
+    if (info.count != 0)
+    {
+        auto status (mdb_put (transaction_a, receivable, germ::mdb_val (account_a), info.val (), 0));
+        environment.write_status (status);
+        assert (status == 0);
+    }
+    else
+    {
+        auto status (mdb_del (transaction_a, receivable, germ::mdb_val (account_a), nullptr));
+        environment.write_status (status);
+        assert (status == 0 || status == MDB_NOTFOUND);
+    }
 }
 
 bool germ::block_store::pending_exists (MDB_txn * transaction_a, germ::pending_key const & key_a)
@@ -997,12 +1202,14 @@ germ::store_iterator germ::block_store::pending_end ()
 void germ::block_store::block_info_put (MDB_txn * transaction_a, germ::block_hash const & hash_a, germ::block_info const & block_info_a)
 {
     auto status (mdb_put (transaction_a, blocks_info, germ::mdb_val (hash_a), block_info_a.val (), 0));
+    environment.write_status (status);
     assert (status == 0);
 }
 
 void germ::block_store::block_info_del (MDB_txn * transaction_a, germ::block_hash const & hash_a)
 {
     auto status (mdb_del (transaction_a, blocks_info, germ::mdb_val (hash_a), nullptr));
+    environment.write_status (status);
     assert (status == 0);
 }
 
@@ -1035,33 +1242,177 @@ bool germ::block_store::block_info_get (MDB_txn * transaction_a, germ::block_has
     return result;
 }
 
-//germ::uint128_t germ::block_store::representation_get (MDB_txn * transaction_a, germ::account const & account_a)
-//{
-//    germ::mdb_val value;
-//    auto status (mdb_get (transaction_a, representation, germ::mdb_val (account_a), value));
-//    assert (status == 0 || status == MDB_NOTFOUND);
-//    germ::uint128_t result;
-//    if (status == 0)
-//    {
-//        germ::uint128_union rep;
-//        germ::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
-//        auto error (germ::read (stream, rep));
-//        assert (!error);
-//        result = rep.number ();
-//    }
-//    else
-//    {
-//        result = 0;
-//    }
-//    return result;
-//}
-//
-//void germ::block_store::representation_put (MDB_txn * transaction_a, germ::account const & account_a, germ::uint128_t const & representation_a)
-//{
-//    germ::uint128_union rep (representation_a);
-//    auto status (mdb_put (transaction_a, representation, germ::mdb_val (account_a), germ::mdb_val (rep), 0));
-//    assert (status == 0);
-//}
+void germ::block_store::block_height_put (MDB_txn * transaction_a, germ::account const & account_a, uint64_t height_a, germ::block_hash const & hash_a)
+{
+    germ::height_key key (account_a, height_a);
+    auto status1 (mdb_put (transaction_a, heights, key.val (), germ::mdb_val (hash_a), 0));
+    environment.write_status (status1);
+    assert (status1 == 0);
+    germ::height_info info (account_a, height_a);
+    auto status2 (mdb_put (transaction_a, block_heights, germ::mdb_val (hash_a), info.val (), 0));
+    environment.write_status (status2);
+    assert (status2 == 0);
+}
+
+void germ::block_store::block_height_del (MDB_txn * transaction_a, germ::account const & account_a, uint64_t height_a, germ::block_hash const & hash_a)
+{
+    germ::height_key key (account_a, height_a);
+    auto status1 (mdb_del (transaction_a, heights, key.val (), nullptr));
+    environment.write_status (status1);
+    assert (status1 == 0 || status1 == MDB_NOTFOUND);
+    auto status2 (mdb_del (transaction_a, block_heights, germ::mdb_val (hash_a), nullptr));
+    environment.write_status (status2);
+    assert (status2 == 0 || status2 == MDB_NOTFOUND);
+}
+
+bool germ::block_store::block_height_get (MDB_txn * transaction_a, germ::block_hash const & hash_a, germ::height_info & info_a)
+{
+    germ::mdb_val value;
+    auto status (mdb_get (transaction_a, block_heights, germ::mdb_val (hash_a), value));
+    assert (status == 0 || status == MDB_NOTFOUND);
+    bool result (status == 0);
+    if (result)
+    {
+        info_a = germ::height_info (value);
+    }
+    return result;
+}
+
+germ::block_hash germ::block_store::block_at_height (MDB_txn * transaction_a, germ::account const & account_a, uint64_t height_a)
+{
+    germ::height_key key (account_a, height_a);
+    germ::mdb_val value;
+    auto status (mdb_get (transaction_a, heights, key.val (), value));
+    assert (status == 0 || status == MDB_NOTFOUND);
+    germ::block_hash result (0);
+    if (status == 0)
+    {
+        result = value.uint256 ();
+    }
+    return result;
+}
+
+germ::store_iterator germ::block_store::height_begin (MDB_txn * transaction_a, germ::account const & account_a, uint64_t height_a)
+{
+    germ::height_key key (account_a, height_a);
+    germ::store_iterator result (transaction_a, heights, key.val ());
+    return result;
+}
+
+germ::store_iterator germ::block_store::height_end ()
+{
+    germ::store_iterator result (nullptr);
+    return result;
+}
+
+germ::uint128_t germ::block_store::representation_get (MDB_txn * transaction_a, germ::account const & account_a)
+{
+    germ::mdb_val value;
+    auto status (mdb_get (transaction_a, representation, germ::mdb_val (account_a), value));
+    assert (status == 0 || status == MDB_NOTFOUND);
+    germ::uint128_t result;
+    if (status == 0)
+    {
+        germ::uint128_union rep;
+        germ::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
+        auto error (germ::read (stream, rep));
+        assert (!error);
+        result = rep.number ();
+    }
+    else
+    {
+        result = 0;
+    }
+    return result;
+}
+
+void germ::block_store::representation_put (MDB_txn * transaction_a, germ::account const & account_a, germ::uint128_t const & representation_a)
+{
+    auto previous (representation_get (transaction_a, account_a));
+    if (!representation_a.is_zero ())
+    {
+        germ::uint128_union rep (representation_a);
+        auto status (mdb_put (transaction_a, representation, germ::mdb_val (account_a), germ::mdb_val (rep), 0));
+        environment.write_status (status);
+        assert (status == 0);
+    }
+    else
+    {
+        auto status (mdb_del (transaction_a, representation, germ::mdb_val (account_a), nullptr));
+        environment.write_status (status);
+        assert (status == 0 || status == MDB_NOTFOUND);
+    }
+    if (representation_a != previous)
+    {
+        auto & change (delta (transaction_a).weights[account_a]);
+        if (representation_a > previous)
+        {
+            change.first += representation_a - previous;
+        }
+        else
+        {
+            change.second += previous - representation_a;
+        }
+    }
+}
+
+germ::uint128_t germ::block_store::witness_tally_get (MDB_txn * transaction_a, germ::account const & account_a)
+{
+    germ::mdb_val value;
+    auto status (mdb_get (transaction_a, witness_tallies, germ::mdb_val (account_a), value));
+    assert (status == 0 || status == MDB_NOTFOUND);
+    germ::uint128_t result (0);
+    if (status == 0)
+    {
+        germ::uint128_union tally;
+        germ::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
+        auto error (germ::read (stream, tally));
+        assert (!error);
+        result = tally.number ();
+    }
+    return result;
+}
+
+void germ::block_store::witness_tally_put (MDB_txn * transaction_a, germ::account const & account_a, germ::uint128_t const & tally_a)
+{
+    if (!tally_a.is_zero ())
+    {
+        germ::uint128_union tally (tally_a);
+        auto status (mdb_put (transaction_a, witness_tallies, germ::mdb_val (account_a), germ::mdb_val (tally), 0));
+        environment.write_status (status);
+        assert (status == 0);
+    }
+    else
+    {
+        auto status (mdb_del (transaction_a, witness_tallies, germ::mdb_val (account_a), nullptr));
+        environment.write_status (status);
+        assert (status == 0 || status == MDB_NOTFOUND);
+    }
+}
+
+germ::store_iterator germ::block_store::witness_tally_begin (MDB_txn * transaction_a)
+{
+    germ::store_iterator result (transaction_a, witness_tallies);
+    return result;
+}
+
+germ::store_iterator germ::block_store::witness_tally_end ()
+{
+    germ::store_iterator result (nullptr);
+    return result;
+}
+
+germ::uint128_t germ::block_store::representation_cached (germ::account const & account_a)
+{
+    std::lock_guard<std::mutex> lock (weights_mutex);
+    auto existing (weights_cache.find (account_a));
+    return existing != weights_cache.end () ? existing->second : germ::uint128_t (0);
+}
+
+uint64_t germ::block_store::block_count_cached ()
+{
+    return blocks_cached.load ();
+}
 
 void germ::block_store::unchecked_clear (MDB_txn * transaction_a)
 {
@@ -1144,6 +1495,7 @@ void germ::block_store::unchecked_del (MDB_txn * transaction_a, germ::block_hash
         germ::serialize_block (stream, block_a);
     }
     auto status (mdb_del (transaction_a, unchecked, germ::mdb_val (hash_a), germ::mdb_val (vector.size (), vector.data ())));
+    environment.write_status (status);
     assert (status == 0 || status == MDB_NOTFOUND);
 }
 
@@ -1161,6 +1513,7 @@ void germ::block_store::checksum_put (MDB_txn * transaction_a, uint64_t prefix,
     assert ((prefix & 0xff) == 0);
     uint64_t key (prefix | mask);
     auto status (mdb_put (transaction_a, checksum, germ::mdb_val (sizeof (key), &key), germ::mdb_val (hash_a), 0));
+    environment.write_status (status);
     assert (status == 0);
 }
 
@@ -1191,6 +1544,7 @@ void germ::block_store::checksum_del (MDB_txn * transaction_a, uint64_t prefix,
     assert ((prefix & 0xff) == 0);
     uint64_t key (prefix | mask);
     auto status (mdb_del (transaction_a, checksum, germ::mdb_val (sizeof (key), &key), nullptr));
+    environment.write_status (status);
     assert (status == 0);
 }
 
@@ -1211,6 +1565,7 @@ void germ::block_store::flush (MDB_txn * transaction_a)
             germ::serialize_block (stream, *i.second);
         }
         auto status (mdb_put (transaction_a, unchecked, germ::mdb_val (i.first), germ::mdb_val (vector.size (), vector.data ()), 0));
+        environment.write_status (status);
         assert (status == 0);
     }
     for (auto i (sequence_cache_l.begin ()), n (sequence_cache_l.end ()); i != n; ++i)
@@ -1221,6 +1576,7 @@ void germ::block_store::flush (MDB_txn * transaction_a)
             i->second->serialize (stream);
         }
         auto status1 (mdb_put (transaction_a, vote, germ::mdb_val (i->first), germ::mdb_val (vector.size (), vector.data ()), 0));
+        environment.write_status (status1);
         assert (status1 == 0);
     }
 }
@@ -1242,14 +1598,22 @@ std::shared_ptr<germ::vote> germ::block_store::vote_current (MDB_txn * transacti
 
 std::shared_ptr<germ::vote> germ::block_store::vote_generate (MDB_txn * transaction_a, germ::account const & account_a, germ::raw_key const & key_a, std::shared_ptr<germ::tx> block_a)
 {
-    std::lock_guard<std::mutex> lock (cache_mutex);
-    auto result (vote_current (transaction_a, account_a));
-    uint64_t sequence ((result ? result->sequence : 0) + 1);
-    result = std::make_shared<germ::vote> (account_a, key_a, sequence, block_a);
-    vote_cache[account_a] = result;
+    auto sequence (vote_sequence (transaction_a, account_a));
+    // Signed without holding the cache lock, the highest sequence wins if votes finish out of order
+    auto result (std::make_shared<germ::vote> (account_a, key_a, sequence, block_a));
+    vote_max (transaction_a, result);
     return result;
 }
 
+uint64_t germ::block_store::vote_sequence (MDB_txn * transaction_a, germ::account const & account_a)
+{
+    std::lock_guard<std::mutex> lock (cache_mutex);
+    auto current (vote_current (transaction_a, account_a));
+    auto & reserved (vote_sequences[account_a]);
+    reserved = std::max<uint64_t> ((current ? current->sequence : 0), reserved) + 1;
+    return reserved;
+}
+
 std::shared_ptr<germ::vote> germ::block_store::vote_max (MDB_txn * transaction_a, std::shared_ptr<germ::vote> vote_a)
 {
     std::lock_guard<std::mutex> lock (cache_mutex);
@@ -34,7 +34,7 @@ public:
 class block_store
 {
 public:
-    block_store (bool &, boost::filesystem::path const &, int lmdb_max_dbs = 128);
+    block_store (bool &, boost::filesystem::path const &, int lmdb_max_dbs = 128, germ::lmdb_config const & = germ::lmdb_config ());
 
     MDB_dbi block_database (germ::block_type);
     void block_put_raw (MDB_txn *, MDB_dbi, germ::block_hash const &, MDB_val);
@@ -43,6 +43,8 @@ public:
     germ::block_hash block_successor (MDB_txn *, germ::block_hash const &);
     void block_successor_clear (MDB_txn *, germ::block_hash const &);
     std::unique_ptr<germ::tx> block_get (MDB_txn *, germ::block_hash const &);
+    // Reads the block in place, the view is valid until the transaction ends. Returns true if found
+    bool block_view (MDB_txn *, germ::block_hash const &, germ::tx_view &);
     std::unique_ptr<germ::tx> block_random (MDB_txn *);
     std::unique_ptr<germ::tx> block_random (MDB_txn *, MDB_dbi);
     void block_del (MDB_txn *, germ::block_hash const &);
@@ -70,6 +72,9 @@ public:
     germ::store_iterator pending_begin (MDB_txn *, germ::pending_key const &);
     germ::store_iterator pending_begin (MDB_txn *);
     germ::store_iterator pending_end ();
+    // Count and sum of pending entries for an account, kept in step with pending_put/pending_del
+    germ::receivable_info receivable_get (MDB_txn *, germ::account const &);
+    void receivable_add (MDB_txn *, germ::account const &, int64_t, germ::uint128_t const &, bool);
 
     void block_info_put (MDB_txn *, germ::block_hash const &, germ::block_info const &);
     void block_info_del (MDB_txn *, germ::block_hash const &);
@@ -81,11 +86,32 @@ public:
     germ::uint128_t block_balance (MDB_txn *, germ::block_hash const &);
     static size_t const block_info_max = 32;
 
-//    germ::uint128_t representation_get (MDB_txn *, germ::account const &);
-//    void representation_put (MDB_txn *, germ::account const &, germ::uint128_t const &);
-//    void representation_add (MDB_txn *, germ::account const &, germ::uint128_t const &);
-//    germ::store_iterator representation_begin (MDB_txn *);
-//    germ::store_iterator representation_end ();
+    void block_height_put (MDB_txn *, germ::account const &, uint64_t, germ::block_hash const &);
+    void block_height_del (MDB_txn *, germ::account const &, uint64_t, germ::block_hash const &);
+    // Returns true if the block is indexed
+    bool block_height_get (MDB_txn *, germ::block_hash const &, germ::height_info &);
+    // Returns zero if the account has no block at that height
+    germ::block_hash block_at_height (MDB_txn *, germ::account const &, uint64_t);
+    // Iterates an account chain from `height' down to its open block
+    germ::store_iterator height_begin (MDB_txn *, germ::account const &, uint64_t);
+    germ::store_iterator height_end ();
+
+    germ::uint128_t representation_get (MDB_txn *, germ::account const &);
+    void representation_put (MDB_txn *, germ::account const &, germ::uint128_t const &);
+    void representation_add (MDB_txn *, germ::account const &, germ::uint128_t const &);
+    void representation_sub (MDB_txn *, germ::account const &, germ::uint128_t const &);
+    germ::store_iterator representation_begin (MDB_txn *);
+    germ::store_iterator representation_end ();
+    // Weight as of the last committed write without touching the database
+    germ::uint128_t representation_cached (germ::account const &);
+    // Sum of block_count () as of the last committed write without touching the database
+    uint64_t block_count_cached ();
+
+    germ::uint128_t witness_tally_get (MDB_txn *, germ::account const &);
+    // A zero tally removes the account
+    void witness_tally_put (MDB_txn *, germ::account const &, germ::uint128_t const &);
+    germ::store_iterator witness_tally_begin (MDB_txn *);
+    germ::store_iterator witness_tally_end ();
 
     void unchecked_clear (MDB_txn *);
     void unchecked_put (MDB_txn *, germ::block_hash const &, std::shared_ptr<germ::tx> const &);
@@ -107,6 +133,8 @@ public:
     std::shared_ptr<germ::vote> vote_generate (MDB_txn *, germ::account const &, germ::raw_key const &, std::shared_ptr<germ::tx>);
     // Return either vote or the stored vote with a higher sequence number
     std::shared_ptr<germ::vote> vote_max (MDB_txn *, std::shared_ptr<germ::vote>);
+    // Reserves the next sequence number for a vote by an account so votes signed outside the cache lock never share one
+    uint64_t vote_sequence (MDB_txn *, germ::account const &);
     // Return latest vote for an account considering the vote cache
     std::shared_ptr<germ::vote> vote_current (MDB_txn *, germ::account const &);
     void flush (MDB_txn *);
@@ -114,6 +142,9 @@ public:
     germ::store_iterator vote_end ();
     std::mutex cache_mutex;
     std::unordered_map<germ::account, std::shared_ptr<germ::vote>> vote_cache;
+    std::unordered_map<germ::account, uint64_t> vote_sequences;
+    std::mutex weights_mutex;
+    std::unordered_map<germ::account, germ::uint128_t> weights_cache;
 
     void version_put (MDB_txn *, int);
     int version_get (MDB_txn *);
@@ -128,6 +159,9 @@ public:
     void upgrade_v8_to_v9 (MDB_txn *);
     void upgrade_v9_to_v10 (MDB_txn *);
     void upgrade_v10_to_v11 (MDB_txn *);
+    void upgrade_v11_to_v12 (MDB_txn *);
+    void upgrade_v12_to_v13 (MDB_txn *);
+    void upgrade_v13_to_v14 (MDB_txn *);
 
     // Requires a write transaction
     germ::raw_key get_node_id (MDB_txn *);
@@ -187,18 +221,42 @@ public:
      */
     MDB_dbi pending;
 
+    /**
+     * Maps destination account to the number and total amount of its pending entries.
+     * germ::account -> uint64_t, germ::amount
+     */
+    MDB_dbi receivable;
+
     /**
      * Maps block hash to account and balance.
      * block_hash -> germ::account, germ::amount
      */
     MDB_dbi blocks_info;
 
+    /**
+     * Maps (account, height) to the block at that position of the account chain.
+     * germ::height_key -> germ::block_hash
+     */
+    MDB_dbi heights;
+
+    /**
+     * Maps block hash to owning account and position in the account chain.
+     * germ::block_hash -> germ::account, uint64_t
+     */
+    MDB_dbi block_heights;
+
     /**
      * Representative weights.
      * germ::account -> germ::uint128_t
      */
     MDB_dbi representation;
 
+    /**
+     * Election weight voted for each witness candidate.
+     * germ::account -> germ::uint128_t
+     */
+    MDB_dbi witness_tallies;
+
     /**
      * Unchecked bootstrap blocks.
      * germ::block_hash -> germ::tx
@@ -222,6 +280,26 @@ public:
      * germ::uint256_union (arbitrary key) -> blob
      */
     MDB_dbi meta;
+    std::atomic<uint64_t> blocks_cached;
+
+private:
+    /**
+     * Changes to the cached block count and weights made by the open write transaction, applied together once it commits.
+     * Only the thread holding the write transaction touches it and LMDB allows one at a time, so it needs no lock.
+     */
+    class cache_delta
+    {
+    public:
+        cache_delta ();
+        MDB_txn * transaction;
+        uint64_t blocks_added;
+        uint64_t blocks_removed;
+        // Increase and decrease of each account's weight
+        std::unordered_map<germ::account, std::pair<germ::uint128_t, germ::uint128_t>> weights;
+    };
+    germ::block_store::cache_delta & delta (MDB_txn *);
+    void delta_end (bool);
+    germ::block_store::cache_delta pending_delta;
 };
 
 }
@@ -5,6 +5,7 @@
 #include <src/node/common.hpp>
 #include <src/versioning.hpp>
 
+#include <boost/endian/conversion.hpp>
 #include <boost/property_tree/json_parser.hpp>
 
 #include <queue>
@@ -168,6 +169,85 @@ bool germ::votes::uncontested ()
     return result;
 }
 
+germ::vote_tally::vote_tally (std::shared_ptr<germ::tx> block_a) :
+total (0)
+{
+    auto hash (block_a->hash ());
+    totals.insert (std::make_pair (hash, std::make_pair (germ::uint128_t (0), block_a)));
+    ranking.insert (std::make_pair (germ::uint128_t (0), hash));
+}
+
+void germ::vote_tally::vote (germ::account const & account_a, germ::uint128_t const & weight_a, std::shared_ptr<germ::tx> block_a)
+{
+    auto hash (block_a->hash ());
+    auto existing (weights.find (account_a));
+    if (existing == weights.end ())
+    {
+        existing = weights.insert (std::make_pair (account_a, std::make_pair (weight_a, hash))).first;
+        total += weight_a;
+    }
+    else
+    {
+        if (existing->second.second == hash)
+            return;
+
+        move (existing->second.second, existing->second.first, false);
+        existing->second.second = hash;
+    }
+    if (totals.find (hash) == totals.end ())
+    {
+        totals.insert (std::make_pair (hash, std::make_pair (germ::uint128_t (0), block_a)));
+        ranking.insert (std::make_pair (germ::uint128_t (0), hash));
+    }
+    move (hash, existing->second.first, true);
+}
+
+void germ::vote_tally::move (germ::block_hash const & hash_a, germ::uint128_t const & weight_a, bool increase_a)
+{
+    auto existing (totals.find (hash_a));
+    assert (existing != totals.end ());
+    auto & amount (existing->second.first);
+    auto erased (ranking.erase (std::make_pair (amount, hash_a)));
+    assert (erased == 1);
+    assert (increase_a || amount >= weight_a);
+    amount = increase_a ? amount + weight_a : amount - weight_a;
+    ranking.insert (std::make_pair (amount, hash_a));
+}
+
+std::pair<germ::uint128_t, std::shared_ptr<germ::tx>> germ::vote_tally::winner () const
+{
+    assert (!ranking.empty ());
+    auto & best (*ranking.begin ());
+    return std::make_pair (best.first, totals.find (best.second)->second.second);
+}
+
+germ::uint128_t germ::vote_tally::runner_up () const
+{
+    auto i (ranking.begin ());
+    ++i;
+    return i != ranking.end () ? i->first : germ::uint128_t (0);
+}
+
+germ::uint128_t germ::vote_tally::sum () const
+{
+    return total;
+}
+
+size_t germ::vote_tally::size () const
+{
+    return totals.size ();
+}
+
+std::vector<std::pair<germ::uint128_t, std::shared_ptr<germ::tx>>> germ::vote_tally::candidates () const
+{
+    std::vector<std::pair<germ::uint128_t, std::shared_ptr<germ::tx>>> result;
+    for (auto & i : ranking)
+    {
+        result.push_back (std::make_pair (i.first, totals.find (i.second)->second.second));
+    }
+    return result;
+}
+
 // Create a new random keypair
 germ::keypair::keypair ()
 {
@@ -282,6 +362,15 @@ germ::mdb_val germ::account_info::val () const
     return germ::mdb_val (sizeof (*this), const_cast<germ::account_info *> (this));
 }
 
+void germ::account_info::serialize_json (germ::json_writer & writer_a) const
+{
+    writer_a.value ("frontier", head.to_string ());
+    writer_a.value ("open_block", open_block.to_string ());
+    writer_a.value ("balance", balance.to_string_dec ());
+    writer_a.value ("modified_timestamp", std::to_string (modified));
+    writer_a.value ("block_count", std::to_string (block_count));
+}
+
 germ::block_counts::block_counts () :
 send (0),
 receive (0),
@@ -425,6 +514,92 @@ germ::mdb_val germ::block_info::val () const
     return germ::mdb_val (sizeof (*this), const_cast<germ::block_info *> (this));
 }
 
+germ::receivable_info::receivable_info () :
+count (0),
+total (0)
+{
+}
+
+germ::receivable_info::receivable_info (MDB_val const & val_a)
+{
+    assert (val_a.mv_size == sizeof (*this));
+    static_assert (sizeof (count) + sizeof (total) == sizeof (*this), "Packed class");
+    std::copy (reinterpret_cast<uint8_t const *> (val_a.mv_data), reinterpret_cast<uint8_t const *> (val_a.mv_data) + sizeof (*this), reinterpret_cast<uint8_t *> (this));
+}
+
+germ::receivable_info::receivable_info (uint64_t count_a, germ::amount const & total_a) :
+count (count_a),
+total (total_a)
+{
+}
+
+bool germ::receivable_info::operator== (germ::receivable_info const & other_a) const
+{
+    return count == other_a.count && total == other_a.total;
+}
+
+germ::mdb_val germ::receivable_info::val () const
+{
+    return germ::mdb_val (sizeof (*this), const_cast<germ::receivable_info *> (this));
+}
+
+germ::height_key::height_key (germ::account const & account_a, uint64_t height_a) :
+account (account_a),
+height_inverted (boost::endian::native_to_big (~height_a))
+{
+}
+
+germ::height_key::height_key (MDB_val const & val_a)
+{
+    assert (val_a.mv_size == sizeof (*this));
+    static_assert (sizeof (account) + sizeof (height_inverted) == sizeof (*this), "Packed class");
+    std::copy (reinterpret_cast<uint8_t const *> (val_a.mv_data), reinterpret_cast<uint8_t const *> (val_a.mv_data) + sizeof (*this), reinterpret_cast<uint8_t *> (this));
+}
+
+bool germ::height_key::operator== (germ::height_key const & other_a) const
+{
+    return account == other_a.account && height_inverted == other_a.height_inverted;
+}
+
+uint64_t germ::height_key::height () const
+{
+    return ~boost::endian::big_to_native (height_inverted);
+}
+
+germ::mdb_val germ::height_key::val () const
+{
+    return germ::mdb_val (sizeof (*this), const_cast<germ::height_key *> (this));
+}
+
+germ::height_info::height_info () :
+account (0),
+height (0)
+{
+}
+
+germ::height_info::height_info (MDB_val const & val_a)
+{
+    assert (val_a.mv_size == sizeof (*this));
+    static_assert (sizeof (account) + sizeof (height) == sizeof (*this), "Packed class");
+    std::copy (reinterpret_cast<uint8_t const *> (val_a.mv_data), reinterpret_cast<uint8_t const *> (val_a.mv_data) + sizeof (*this), reinterpret_cast<uint8_t *> (this));
+}
+
+germ::height_info::height_info (germ::account const & account_a, uint64_t height_a) :
+account (account_a),
+height (height_a)
+{
+}
+
+bool germ::height_info::operator== (germ::height_info const & other_a) const
+{
+    return account == other_a.account && height == other_a.height;
+}
+
+germ::mdb_val germ::height_info::val () const
+{
+    return germ::mdb_val (sizeof (*this), const_cast<germ::height_info *> (this));
+}
+
 germ::epoch_info::epoch_info () :
 head (0),
 modified (0),
@@ -675,33 +850,39 @@ void germ::balance_visitor::compute (germ::block_hash const & block_hash)
         }
         else
         {
-            auto block (store.block_get (transaction, current_balance));
-            assert (block != nullptr);
-            block->visit (*this);
+            // Walked in place rather than deserializing each block
+            germ::tx_view block;
+            auto found (store.block_view (transaction, current_balance, block));
+            assert (found);
+            step (block.type (), current_balance, block.balance (), block.source (), block.previous ());
         }
     }
 }
 
 void germ::balance_visitor::tx(germ::tx const& tx)
 {
-    germ::block_type tx_type = tx.type();
-    if (tx_type == germ::block_type::send || tx_type == germ::block_type::vote)
+    step (tx.type (), tx.hash (), tx.balance (), tx.source (), tx.previous ());
+}
+
+void germ::balance_visitor::step (germ::block_type type_a, germ::block_hash const & hash_a, germ::amount const & balance_a, germ::block_hash const & source_a, germ::block_hash const & previous_a)
+{
+    if (type_a == germ::block_type::send || type_a == germ::block_type::vote)
     {
-        balance += tx.balance_.number ();
+        balance += balance_a.number ();
         current_balance = 0;
     }
-    else if(tx_type == germ::block_type::receive)
+    else if (type_a == germ::block_type::receive)
     {
         germ::block_info block_info;
-        if (store.block_info_get (transaction, tx.hash (), block_info))
+        if (store.block_info_get (transaction, hash_a, block_info))
         {
             balance += block_info.balance.number ();
             current_balance = 0;
         }
         else
         {
-            current_amount = tx.source_;
-            current_balance = tx.previous_;
+            current_amount = source_a;
+            current_balance = previous_a;
         }
     }
 }
@@ -908,7 +1089,8 @@ void germ::genesis::initialize (MDB_txn * transaction_a, germ::block_store & sto
     assert (store_a.latest_begin (transaction_a) == store_a.latest_end ());
     store_a.block_put (transaction_a, hash_l, *open);
     store_a.account_put (transaction_a, genesis_account, { hash_l, /*open->hash (),*/ open->hash (), std::numeric_limits<germ::uint128_t>::max (), germ::seconds_since_epoch (), 1 });
-//    store_a.representation_put (transaction_a, genesis_account, std::numeric_limits<germ::uint128_t>::max ());
+    store_a.block_height_put (transaction_a, genesis_account, 1, hash_l);
+    store_a.representation_put (transaction_a, genesis_account, std::numeric_limits<germ::uint128_t>::max ());
     store_a.checksum_put (transaction_a, 0, 0, hash_l);
     store_a.frontier_put (transaction_a, hash_l, genesis_account);
 }
@@ -5,6 +5,7 @@
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <set>
 #include <unordered_map>
 
 #include <blake2/blake2.h>
@@ -46,6 +47,8 @@ public:
     void change_block (germ::change_block const &) override;
     void state_block (germ::state_block const &) override;
     void tx (germ::tx const & tx) override;
+    // Applies one block of the chain walk, shared by tx () and compute () which reads blocks through a tx_view
+    void step (germ::block_type, germ::block_hash const &, germ::amount const &, germ::block_hash const &, germ::block_hash const &);
     MDB_txn * transaction;
     germ::block_store & store;
     germ::block_hash current_balance;
@@ -125,6 +128,8 @@ public:
     account_info (germ::block_hash const &, /*germ::block_hash const &,*/ germ::block_hash const &, germ::amount const &, uint64_t, uint64_t);
     void serialize (germ::stream &) const;
     bool deserialize (germ::stream &);
+    // Writes the members into the enclosing object, as returned by the account_info RPC
+    void serialize_json (germ::json_writer &) const;
     bool operator== (germ::account_info const &) const;
     bool operator!= (germ::account_info const &) const;
     germ::mdb_val val () const;
@@ -178,6 +183,46 @@ public:
     germ::account account;
     germ::amount balance;
 };
+/**
+ * Aggregate of the uncollected sends to an account
+ */
+class receivable_info
+{
+public:
+    receivable_info ();
+    receivable_info (MDB_val const &);
+    receivable_info (uint64_t, germ::amount const &);
+    bool operator== (germ::receivable_info const &) const;
+    germ::mdb_val val () const;
+    uint64_t count;
+    germ::amount total;
+};
+/**
+ * Position of a block within its account chain.
+ * The height is stored big endian and inverted so keys for an account sort from the head down to the open block.
+ */
+class height_key
+{
+public:
+    height_key (germ::account const &, uint64_t);
+    height_key (MDB_val const &);
+    bool operator== (germ::height_key const &) const;
+    uint64_t height () const;
+    germ::mdb_val val () const;
+    germ::account account;
+    uint64_t height_inverted;
+};
+class height_info
+{
+public:
+    height_info ();
+    height_info (MDB_val const &);
+    height_info (germ::account const &, uint64_t);
+    bool operator== (germ::height_info const &) const;
+    germ::mdb_val val () const;
+    germ::account account;
+    uint64_t height;
+};
 class block_counts
 {
 public:
@@ -283,6 +328,32 @@ public:
     // All votes received by account
     std::unordered_map<germ::account, std::shared_ptr<germ::tx>> rep_votes;
 };
+/**
+ * Running vote weight per candidate block of an election.
+ * A representative's weight is snapshotted on its first vote so later balance changes don't skew totals,
+ * changing a vote moves that weight between candidates instead of recounting every representative.
+ */
+class vote_tally
+{
+public:
+    vote_tally (std::shared_ptr<germ::tx>);
+    void vote (germ::account const &, germ::uint128_t const &, std::shared_ptr<germ::tx>);
+    // Candidate with the most weight and its total
+    std::pair<germ::uint128_t, std::shared_ptr<germ::tx>> winner () const;
+    // Total of the best candidate other than the winner
+    germ::uint128_t runner_up () const;
+    // Sum of all weights counted
+    germ::uint128_t sum () const;
+    size_t size () const;
+    std::vector<std::pair<germ::uint128_t, std::shared_ptr<germ::tx>>> candidates () const;
+
+private:
+    void move (germ::block_hash const &, germ::uint128_t const &, bool);
+    std::unordered_map<germ::account, std::pair<germ::uint128_t, germ::block_hash>> weights;
+    std::unordered_map<germ::block_hash, std::pair<germ::uint128_t, std::shared_ptr<germ::tx>>> totals;
+    std::set<std::pair<germ::uint128_t, germ::block_hash>, std::greater<std::pair<germ::uint128_t, germ::block_hash>>> ranking;
+    germ::uint128_t total;
+};
 extern germ::keypair const & zero_key;
 extern germ::keypair const & test_genesis_key;
 extern germ::account const & rai_test_account;
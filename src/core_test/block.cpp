@@ -6,6 +6,7 @@
 
 #include <src/lib/interface.h>
 #include <src/node/common.hpp>
+#include <src/lib/epoch.h>
 #include <src/node/node.hpp>
 
 #include <ed25519-donna/ed25519.h>
@@ -410,3 +411,186 @@ TEST (state_block, hashing)
 	block.hashables.link.bytes[0] ^= 0x1;
 	ASSERT_EQ (hash, block.hash ());
 }
+
+TEST (merkle_tree, proof)
+{
+	ASSERT_TRUE (germ::merkle_tree (std::vector<germ::block_hash> ()).root ().is_zero ());
+	for (size_t count : { 1, 2, 5, 8, 13 })
+	{
+		std::vector<germ::block_hash> txs;
+		for (size_t i (0); i < count; ++i)
+		{
+			txs.push_back (germ::block_hash (i + 1));
+		}
+		germ::merkle_tree tree (txs);
+		for (size_t i (0); i < count; ++i)
+		{
+			auto proof (tree.proof (i));
+			ASSERT_TRUE (germ::merkle_tree::verify (txs[i], i, count, proof, tree.root ()));
+			ASSERT_FALSE (germ::merkle_tree::verify (germ::block_hash (count + 1), i, count, proof, tree.root ()));
+			if (!proof.empty ())
+			{
+				proof[0].bytes[0] ^= 0x1;
+				ASSERT_FALSE (germ::merkle_tree::verify (txs[i], i, count, proof, tree.root ()));
+			}
+		}
+	}
+	germ::merkle_tree single (std::vector<germ::block_hash> (1, germ::block_hash (1)));
+	ASSERT_EQ (germ::merkle_tree::leaf (germ::block_hash (1)), single.root ());
+}
+
+TEST (epoch_validator, signatures)
+{
+	std::vector<germ::keypair> keys (4);
+	std::vector<germ::account> witnesses;
+	for (auto & i : keys)
+	{
+		witnesses.push_back (i.pub);
+	}
+	germ::signature zero;
+	zero.clear ();
+	auto sign ([&keys, &zero](germ::epoch & epoch_a, size_t skip_a) {
+		std::vector<germ::signature> pre_votes;
+		for (size_t i (0); i < keys.size (); ++i)
+		{
+			pre_votes.push_back (i == skip_a ? zero : germ::sign_message (keys[i].prv, keys[i].pub, epoch_a.pre_vote_hash ()));
+		}
+		epoch_a.set_pre_votes (pre_votes);
+		std::vector<germ::signature> votes;
+		for (size_t i (0); i < keys.size (); ++i)
+		{
+			votes.push_back (i == skip_a ? zero : germ::sign_message (keys[i].prv, keys[i].pub, epoch_a.vote_hash ()));
+		}
+		epoch_a.set_votes (votes);
+	});
+	germ::epoch epoch1 (1, germ::epoch_hash (0), zero, std::vector<germ::block_hash> (1, germ::block_hash (1)), {}, {});
+	sign (epoch1, keys.size ());
+	ASSERT_TRUE (germ::epoch_validator::validate (epoch1, witnesses));
+	germ::epoch epoch2 (2, epoch1.hash (), zero, std::vector<germ::block_hash> (1, germ::block_hash (2)), {}, {});
+	sign (epoch2, 0);
+	ASSERT_TRUE (germ::epoch_validator::validate (epoch2, witnesses));
+	auto votes (epoch2.votes ());
+	votes[1].bytes[0] ^= 0x1;
+	epoch2.set_votes (votes);
+	ASSERT_FALSE (germ::epoch_validator::validate (epoch2, witnesses));
+	// Below two thirds of the witnesses
+	votes[1] = zero;
+	epoch2.set_votes (votes);
+	ASSERT_FALSE (germ::epoch_validator::validate (epoch2, witnesses));
+	auto valid (germ::epoch_validator::validate ({ &epoch1, &epoch2, &epoch1 }, { witnesses, witnesses, witnesses }));
+	ASSERT_EQ (std::vector<bool> ({ true, false, true }), valid);
+	// Votes survive serialization
+	std::vector<uint8_t> bytes;
+	{
+		germ::vectorstream stream (bytes);
+		epoch1.serialize (stream);
+	}
+	germ::bufferstream stream (bytes.data (), bytes.size ());
+	germ::epoch epoch3;
+	ASSERT_FALSE (epoch3.deserialize (stream));
+	ASSERT_EQ (epoch1, epoch3);
+}
+
+TEST (tx_view, fields)
+{
+	germ::keypair key;
+	germ::tx_message message (1, "data", 2, 3);
+	germ::tx tx (4, key.pub, 5, key.pub, 6, message, 7, key.prv, key.pub);
+	std::vector<uint8_t> bytes;
+	{
+		germ::vectorstream stream (bytes);
+		tx.serialize (stream);
+	}
+	auto error (false);
+	germ::tx_view view (error, bytes.data (), bytes.size ());
+	ASSERT_FALSE (error);
+	ASSERT_EQ (tx.previous (), view.previous ());
+	ASSERT_EQ (tx.destination (), view.destination ());
+	ASSERT_EQ (tx.source (), view.source ());
+	ASSERT_EQ (tx.balance (), view.balance ());
+	ASSERT_EQ (tx.account (), view.account ());
+	ASSERT_EQ (1, view.value ());
+	ASSERT_EQ ("data", std::string (reinterpret_cast<char const *> (view.data ()), view.data_size ()));
+	ASSERT_EQ (2, view.gas ());
+	ASSERT_EQ (3, view.gas_price ());
+	ASSERT_EQ (tx.epoch (), view.epoch ());
+	ASSERT_EQ (tx.signature, view.signature ());
+	ASSERT_EQ (tx.type (), view.type ());
+	ASSERT_EQ (tx, *view.materialize ());
+	germ::tx_view truncated (error, bytes.data (), bytes.size () - 1);
+	ASSERT_TRUE (error);
+	germ::tx copy (0, 0, 0, 0, 0, germ::tx_message (), 0, key.prv, key.pub);
+	germ::bufferstream stream (bytes.data (), bytes.size ());
+	ASSERT_FALSE (copy.deserialize (stream));
+	ASSERT_EQ (tx, copy);
+}
+
+TEST (tx, hash_cached)
+{
+	germ::keypair key;
+	germ::tx tx (1, key.pub, 0, key.pub, 100, germ::tx_message (1, std::string (1024, 'a'), 2, 3), 0, key.prv, key.pub);
+	auto computed (germ::tx::hashes_computed.load ());
+	auto hash (tx.hash ());
+	ASSERT_EQ (hash, tx.hash ());
+	ASSERT_EQ (computed, germ::tx::hashes_computed.load ());
+	ASSERT_EQ (hash, tx.compute_hash ());
+	// Mutators recompute the hash
+	tx.set_tx_info (germ::tx_message (1, "b", 2, 3));
+	ASSERT_NE (hash, tx.hash ());
+	ASSERT_EQ (tx.compute_hash (), tx.hash ());
+	auto hash2 (tx.hash ());
+	tx.set_balance (99);
+	ASSERT_NE (hash2, tx.hash ());
+	ASSERT_EQ (tx.compute_hash (), tx.hash ());
+	// The signature isn't hashed
+	auto hash3 (tx.hash ());
+	tx.signature_set (germ::signature ());
+	ASSERT_EQ (hash3, tx.hash ());
+	std::vector<uint8_t> bytes;
+	{
+		germ::vectorstream stream (bytes);
+		tx.serialize (stream);
+	}
+	germ::bufferstream stream (bytes.data (), bytes.size ());
+	auto error (false);
+	germ::tx tx2 (error, stream);
+	ASSERT_FALSE (error);
+	ASSERT_EQ (tx.hash (), tx2.hash ());
+	germ::epoch epoch;
+	auto epoch_hash (epoch.hash ());
+	epoch.set_txs (std::vector<germ::block_hash> (1, hash));
+	ASSERT_NE (epoch_hash, epoch.hash ());
+	ASSERT_EQ (epoch.compute_hash (), epoch.hash ());
+}
+
+TEST (tx, json_document_matches_ptree)
+{
+	germ::keypair key;
+	germ::tx tx (1, key.pub, 2, key.pub, 3, germ::tx_message (4, "da\"ta", 5, 6), 7, key.prv, key.pub);
+	germ::json_writer writer;
+	tx.serialize_json (writer);
+	std::string text;
+	tx.serialize_json (text);
+	ASSERT_EQ (writer.output, text);
+	boost::property_tree::ptree tree;
+	std::stringstream stream (text);
+	boost::property_tree::read_json (stream, tree);
+	ASSERT_EQ (tx.account ().to_account (), tree.get<std::string> ("account"));
+	ASSERT_EQ ("da\"ta", tree.get<std::string> ("tx_info.data"));
+	// The parsers are fed a document carrying every field they require
+	tree.put ("epoch", tx.epoch ().to_string ());
+	tree.put ("balance", tx.balance ().to_string ());
+	std::stringstream ostream;
+	boost::property_tree::write_json (ostream, tree);
+	auto complete (ostream.str ());
+	auto error (false);
+	germ::json_document document (error, complete);
+	ASSERT_FALSE (error);
+	auto block1 (germ::deserialize_block_json (tree));
+	auto block2 (germ::deserialize_block_json (document.root ()));
+	ASSERT_NE (nullptr, block1);
+	ASSERT_NE (nullptr, block2);
+	ASSERT_EQ (*block1, *block2);
+	ASSERT_EQ (tx.balance (), block2->balance ());
+	ASSERT_EQ (tx.tx_info ().data, block2->tx_info ().data);
+}
@@ -952,3 +952,279 @@ TEST (block_store, state_block)
 	auto count2 (store.block_count (transaction));
 	ASSERT_EQ (0, count2.state);
 }
+
+TEST (block_store, block_height)
+{
+	bool init (false);
+	germ::block_store store (init, germ::unique_path ());
+	ASSERT_TRUE (!init);
+	germ::transaction transaction (store.environment, nullptr, true);
+	germ::account account1 (1);
+	germ::account account2 (2);
+	store.block_height_put (transaction, account1, 1, 10);
+	store.block_height_put (transaction, account1, 2, 11);
+	store.block_height_put (transaction, account1, 3, 12);
+	store.block_height_put (transaction, account2, 1, 20);
+	germ::height_info info;
+	ASSERT_TRUE (store.block_height_get (transaction, 11, info));
+	ASSERT_EQ (account1, info.account);
+	ASSERT_EQ (2, info.height);
+	ASSERT_EQ (germ::block_hash (12), store.block_at_height (transaction, account1, 3));
+	ASSERT_TRUE (store.block_at_height (transaction, account1, 4).is_zero ());
+	std::vector<germ::block_hash> chain;
+	for (auto i (store.height_begin (transaction, account1, 3)), n (store.height_end ()); i != n && germ::height_key (i->first).account == account1; ++i)
+	{
+		chain.push_back (i->second.uint256 ());
+	}
+	ASSERT_EQ (std::vector<germ::block_hash> ({ 12, 11, 10 }), chain);
+	store.block_height_del (transaction, account1, 3, 12);
+	ASSERT_FALSE (store.block_height_get (transaction, 12, info));
+	ASSERT_TRUE (store.block_at_height (transaction, account1, 3).is_zero ());
+}
+
+TEST (block_store, receivable_totals)
+{
+	bool init (false);
+	germ::block_store store (init, germ::unique_path ());
+	ASSERT_TRUE (!init);
+	germ::transaction transaction (store.environment, nullptr, true);
+	germ::account account1 (1);
+	germ::account account2 (2);
+	ASSERT_EQ (germ::receivable_info (), store.receivable_get (transaction, account1));
+	store.pending_put (transaction, germ::pending_key (account1, 10), germ::pending_info (account2, 100));
+	store.pending_put (transaction, germ::pending_key (account1, 11), germ::pending_info (account2, 50));
+	store.pending_put (transaction, germ::pending_key (account2, 12), germ::pending_info (account1, 5));
+	ASSERT_EQ (germ::receivable_info (2, 150), store.receivable_get (transaction, account1));
+	ASSERT_EQ (germ::receivable_info (1, 5), store.receivable_get (transaction, account2));
+	// Overwriting an entry replaces its contribution
+	store.pending_put (transaction, germ::pending_key (account1, 11), germ::pending_info (account2, 70));
+	ASSERT_EQ (germ::receivable_info (2, 170), store.receivable_get (transaction, account1));
+	store.pending_del (transaction, germ::pending_key (account1, 10));
+	ASSERT_EQ (germ::receivable_info (1, 70), store.receivable_get (transaction, account1));
+	store.pending_del (transaction, germ::pending_key (account1, 11));
+	ASSERT_EQ (germ::receivable_info (), store.receivable_get (transaction, account1));
+}
+
+TEST (block_store, representation_cache)
+{
+	auto path (germ::unique_path ());
+	germ::account account1 (1);
+	{
+		bool init (false);
+		germ::block_store store (init, path);
+		ASSERT_TRUE (!init);
+		{
+			germ::transaction transaction (store.environment, nullptr, true);
+			ASSERT_EQ (0, store.block_count_cached ());
+			store.representation_add (transaction, account1, 100);
+			store.representation_sub (transaction, account1, 40);
+			ASSERT_EQ (60, store.representation_get (transaction, account1));
+			germ::genesis genesis;
+			genesis.initialize (transaction, store);
+			// Nothing is visible in the cache until the transaction commits
+			ASSERT_EQ (0, store.representation_cached (account1));
+			ASSERT_EQ (0, store.block_count_cached ());
+		}
+		ASSERT_EQ (60, store.representation_cached (account1));
+		ASSERT_EQ (1, store.block_count_cached ());
+		ASSERT_EQ (std::numeric_limits<germ::uint128_t>::max (), store.representation_cached (germ::genesis_account));
+	}
+	bool init (false);
+	germ::block_store store (init, path);
+	ASSERT_TRUE (!init);
+	ASSERT_EQ (60, store.representation_cached (account1));
+	ASSERT_EQ (1, store.block_count_cached ());
+}
+
+TEST (block_store, read_transaction_pool)
+{
+	bool init (false);
+	germ::block_store store (init, germ::unique_path ());
+	ASSERT_TRUE (!init);
+	germ::account account1 (1);
+	{
+		germ::read_transaction transaction (store.environment);
+		ASSERT_FALSE (store.account_exists (transaction, account1));
+		ASSERT_EQ (1, store.environment.readers_active);
+	}
+	ASSERT_EQ (0, store.environment.readers_active);
+	ASSERT_EQ (1, store.environment.read_pool.size ());
+	// Pooled handles don't count as open, so they never hold back growth
+	ASSERT_EQ (0, store.environment.transactions_open);
+	{
+		germ::transaction transaction (store.environment, nullptr, true);
+		store.account_put (transaction, account1, germ::account_info ());
+	}
+	{
+		// A renewed handle sees writes committed after it was reset
+		germ::read_transaction transaction (store.environment);
+		ASSERT_TRUE (store.account_exists (transaction, account1));
+	}
+	ASSERT_EQ (1, store.environment.readers_created);
+}
+
+TEST (block_store, map_growth_under_readers)
+{
+	germ::lmdb_config config;
+	config.map_size = 1024 * 1024;
+	config.map_growth = 1024 * 1024;
+	bool init (false);
+	germ::block_store store (init, germ::unique_path (), 128, config);
+	ASSERT_TRUE (!init);
+	std::atomic<bool> done (false);
+	// Keeps read transactions open most of the time, growth has to use the gaps between them
+	std::thread reader ([&store, &done]() {
+		while (!done)
+		{
+			{
+				germ::read_transaction transaction (store.environment);
+				std::this_thread::sleep_for (std::chrono::milliseconds (1));
+			}
+			std::this_thread::sleep_for (std::chrono::microseconds (100));
+		}
+	});
+	for (auto i (0); i != 100;)
+	{
+		// Grows between write transactions the way the block processor does
+		while (store.environment.grow () && store.environment.map_full)
+		{
+			std::this_thread::yield ();
+		}
+		auto full (false);
+		{
+			germ::transaction transaction (store.environment, nullptr, true);
+			try
+			{
+				for (auto j (0); j != 100; ++j)
+				{
+					germ::block_hash hash;
+					germ::random_pool.GenerateBlock (hash.bytes.data (), hash.bytes.size ());
+					store.account_put (transaction, hash, germ::account_info ());
+				}
+			}
+			catch (germ::map_full_error const &)
+			{
+				full = true;
+			}
+			auto status (transaction.commit ());
+			ASSERT_TRUE (status == 0 || full || status == MDB_MAP_FULL);
+			full = status != 0;
+		}
+		if (!full)
+		{
+			++i;
+		}
+	}
+	done = true;
+	reader.join ();
+	MDB_envinfo info;
+	ASSERT_EQ (0, mdb_env_info (store.environment, &info));
+	ASSERT_LT (config.map_size, info.me_mapsize);
+	germ::read_transaction transaction (store.environment);
+	ASSERT_EQ (100 * 100, store.account_count (transaction));
+}
+
+TEST (block_store, grow_skipped_while_open)
+{
+	germ::lmdb_config config;
+	config.map_size = 1024 * 1024;
+	config.map_growth = 1024 * 1024;
+	bool init (false);
+	germ::block_store store (init, germ::unique_path (), 128, config);
+	ASSERT_TRUE (!init);
+	store.environment.map_full = true;
+	{
+		// A long-lived reader holds back growth without anything waiting on it
+		germ::read_transaction transaction (store.environment);
+		ASSERT_TRUE (store.environment.grow ());
+		germ::read_transaction transaction2 (store.environment);
+		ASSERT_EQ (2, store.environment.transactions_open);
+	}
+	MDB_envinfo info1;
+	ASSERT_EQ (0, mdb_env_info (store.environment, &info1));
+	ASSERT_EQ (config.map_size, info1.me_mapsize);
+	ASSERT_FALSE (store.environment.grow ());
+	ASSERT_FALSE (store.environment.map_full);
+	MDB_envinfo info2;
+	ASSERT_EQ (0, mdb_env_info (store.environment, &info2));
+	ASSERT_EQ (config.map_size + config.map_growth, info2.me_mapsize);
+}
+
+TEST (block_store, sync_interval)
+{
+	germ::lmdb_config config;
+	config.sync = germ::lmdb_sync::no_sync;
+	config.sync_commits = 0;
+	config.sync_interval = std::chrono::milliseconds (10);
+	bool init (false);
+	germ::block_store store (init, germ::unique_path (), 128, config);
+	ASSERT_TRUE (!init);
+	{
+		germ::transaction transaction (store.environment, nullptr, true);
+		store.account_put (transaction, germ::account (1), germ::account_info ());
+	}
+	auto unsynced ([&store]() {
+		std::lock_guard<std::mutex> lock (store.environment.sync_mutex);
+		return store.environment.commits_since_sync;
+	});
+	// Flushed by the timer without any further commit
+	auto iterations (0);
+	while (unsynced () != 0)
+	{
+		std::this_thread::sleep_for (std::chrono::milliseconds (10));
+		++iterations;
+		ASSERT_LT (iterations, 200);
+	}
+}
+
+TEST (epoch_store, indexes)
+{
+	bool init (false);
+	germ::epoch_store store (init, germ::unique_path ());
+	ASSERT_TRUE (!init);
+	germ::signature signature;
+	signature.clear ();
+	germ::epoch epoch1 (100, 0, signature, { germ::block_hash (1), germ::block_hash (2) }, {}, {});
+	auto hash1 (epoch1.hash ());
+	germ::epoch epoch2 (200, hash1, signature, { germ::block_hash (3) }, {}, {});
+	auto hash2 (epoch2.hash ());
+	germ::transaction transaction (store.environment, nullptr, true);
+	store.block_put (transaction, hash1, epoch1);
+	store.block_put (transaction, hash2, epoch2);
+	germ::epoch_tx_info tx_info;
+	ASSERT_TRUE (store.tx_epoch_get (transaction, germ::block_hash (2), tx_info));
+	ASSERT_EQ (hash1, tx_info.epoch);
+	ASSERT_EQ (1, tx_info.index);
+	germ::epoch_height_info height_info;
+	ASSERT_TRUE (store.height_get (transaction, hash2, height_info));
+	ASSERT_EQ (2, height_info.height);
+	ASSERT_EQ (200, height_info.timestamp);
+	auto i (store.time_begin (transaction, 150));
+	ASSERT_NE (store.time_end (), i);
+	ASSERT_EQ (hash2, i->second.uint256 ());
+	ASSERT_EQ (200, germ::epoch_time_key (i->first).timestamp ());
+	store.block_del (transaction, hash2);
+	ASSERT_FALSE (store.tx_epoch_get (transaction, germ::block_hash (3), tx_info));
+	ASSERT_FALSE (store.height_get (transaction, hash2, height_info));
+	ASSERT_EQ (store.time_end (), store.time_begin (transaction, 150));
+	ASSERT_TRUE (store.tx_epoch_get (transaction, germ::block_hash (1), tx_info));
+}
+
+TEST (block_store, block_view)
+{
+	bool init (false);
+	germ::block_store store (init, germ::unique_path ());
+	ASSERT_TRUE (!init);
+	germ::keypair key;
+	// An open has the account as previous so there's no predecessor to link
+	germ::tx tx (key.pub, key.pub, 0, key.pub, 100, germ::tx_message (), 0, key.prv, key.pub);
+	auto hash (tx.hash ());
+	germ::transaction transaction (store.environment, nullptr, true);
+	germ::tx_view view;
+	ASSERT_FALSE (store.block_view (transaction, hash, view));
+	store.block_put (transaction, hash, tx);
+	ASSERT_TRUE (store.block_view (transaction, hash, view));
+	ASSERT_EQ (tx.previous (), view.previous ());
+	ASSERT_EQ (germ::amount (100), view.balance ());
+	ASSERT_EQ (tx, *view.materialize ());
+}
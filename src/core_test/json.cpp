@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include <src/lib/json.hpp>
+
+#include <boost/property_tree/json_parser.hpp>
+
+TEST (json_writer, escapes)
+{
+	germ::json_writer writer;
+	writer.begin_object ();
+	writer.value ("text", "a\"b\\c\nd\x01");
+	writer.begin_array ("list");
+	writer.value ("1");
+	writer.value ("2");
+	writer.end_array ();
+	writer.begin_object ("empty");
+	writer.end_object ();
+	writer.end_object ();
+	ASSERT_EQ ("{\"text\":\"a\\\"b\\\\c\\nd\\u0001\",\"list\":[\"1\",\"2\"],\"empty\":{}}", writer.output);
+	boost::property_tree::ptree tree;
+	std::stringstream stream (writer.output);
+	boost::property_tree::read_json (stream, tree);
+	ASSERT_EQ ("a\"b\\c\nd\x01", tree.get<std::string> ("text"));
+	ASSERT_EQ (2, tree.get_child ("list").size ());
+}
+
+TEST (json_writer, take)
+{
+	germ::json_writer writer;
+	writer.begin_object ();
+	writer.begin_object ("a");
+	std::string text (writer.take ());
+	writer.value ("1", "x");
+	text += writer.take ();
+	writer.value ("2", "y");
+	writer.end_object ();
+	writer.end_object ();
+	text += writer.take ();
+	ASSERT_EQ ("{\"a\":{\"1\":\"x\",\"2\":\"y\"}}", text);
+	ASSERT_TRUE (writer.output.empty ());
+}
+
+TEST (json_document, parse)
+{
+	std::string text ("{ \"action\": \"pending\", \"count\": 10, \"source\": true, \"nested\": {\"k\\u00e9y\": \"\\ud83d\\ude00\"}, \"hashes\": [\"a\", \"b\", \"c\"] }");
+	auto error (false);
+	germ::json_document document (error, text);
+	ASSERT_FALSE (error);
+	std::string value;
+	ASSERT_TRUE (document.root ().get ("action", value));
+	ASSERT_EQ ("pending", value);
+	ASSERT_TRUE (document.root ().get ("count", value));
+	ASSERT_EQ ("10", value);
+	ASSERT_TRUE (document.root ().get ("source", value));
+	ASSERT_EQ ("true", value);
+	ASSERT_TRUE (document.root ().get ("nested.k\xc3\xa9y", value));
+	ASSERT_EQ ("\xf0\x9f\x98\x80", value);
+	ASSERT_FALSE (document.root ().get ("missing", value));
+	ASSERT_FALSE (document.root ().get ("nested", value));
+	auto hashes (document.root ().find ("hashes"));
+	ASSERT_NE (nullptr, hashes);
+	ASSERT_EQ (germ::json_type::array, hashes->type);
+	std::string joined;
+	for (auto i (hashes->child); i != nullptr; i = i->next)
+	{
+		joined += i->string ();
+	}
+	ASSERT_EQ ("abc", joined);
+}
+
+TEST (json_document, malformed)
+{
+	for (std::string text : { "", "{", "{\"a\":}", "[1,]", "01", "\"\\x\"", "{} {}", "\"\\u12\"", "[\"a\" \"b\"]", "\"a\nb\"" })
+	{
+		auto error (false);
+		germ::json_document document (error, text);
+		ASSERT_TRUE (error) << text;
+	}
+	std::string deep (germ::json_document::max_depth + 1, '[');
+	deep.append (germ::json_document::max_depth + 1, ']');
+	auto error (false);
+	germ::json_document document (error, deep);
+	ASSERT_TRUE (error);
+}
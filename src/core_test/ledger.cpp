@@ -771,10 +771,10 @@ TEST (votes, check_signature)
 	ASSERT_EQ (1, votes1->votes.rep_votes.size ());
 	auto vote1 (std::make_shared<germ::vote> (germ::test_genesis_key.pub, germ::test_genesis_key.prv, 1, send1));
 	vote1->signature.bytes[0] ^= 1;
-	ASSERT_EQ (germ::vote_code::invalid, node1.vote_processor.vote (vote1, germ::endpoint ()));
+	ASSERT_EQ (germ::vote_code::invalid, node1.vote_processor.vote_blocking (germ::read_transaction (node1.store.environment), vote1, germ::endpoint ()));
 	vote1->signature.bytes[0] ^= 1;
-	ASSERT_EQ (germ::vote_code::vote, node1.vote_processor.vote (vote1, germ::endpoint ()));
-	ASSERT_EQ (germ::vote_code::replay, node1.vote_processor.vote (vote1, germ::endpoint ()));
+	ASSERT_EQ (germ::vote_code::vote, node1.vote_processor.vote_blocking (germ::read_transaction (node1.store.environment), vote1, germ::endpoint ()));
+	ASSERT_EQ (germ::vote_code::replay, node1.vote_processor.vote_blocking (germ::read_transaction (node1.store.environment), vote1, germ::endpoint ()));
 }
 
 TEST (votes, add_one)
@@ -889,12 +889,12 @@ TEST (votes, add_old)
 	node1.active.start (send1);
 	auto votes1 (node1.active.roots.find (send1->root ())->election);
 	auto vote1 (std::make_shared<germ::vote> (germ::test_genesis_key.pub, germ::test_genesis_key.prv, 2, send1));
-	node1.vote_processor.vote (vote1, germ::endpoint ());
+	node1.vote_processor.vote_blocking (germ::read_transaction (node1.store.environment), vote1, germ::endpoint ());
 	germ::keypair key2;
 	auto send2 (std::make_shared<germ::send_block> (genesis.hash (), key2.pub, 0, germ::test_genesis_key.prv, germ::test_genesis_key.pub, 0));
 	auto vote2 (std::make_shared<germ::vote> (germ::test_genesis_key.pub, germ::test_genesis_key.prv, 1, send2));
 	votes1->last_votes[germ::test_genesis_key.pub].time = std::chrono::steady_clock::now () - std::chrono::seconds (20);
-	node1.vote_processor.vote (vote2, germ::endpoint ());
+	node1.vote_processor.vote_blocking (germ::read_transaction (node1.store.environment), vote2, germ::endpoint ());
 	ASSERT_EQ (2, votes1->votes.rep_votes.size ());
 	ASSERT_NE (votes1->votes.rep_votes.end (), votes1->votes.rep_votes.find (germ::test_genesis_key.pub));
 	ASSERT_EQ (*send1, *votes1->votes.rep_votes[germ::test_genesis_key.pub]);
@@ -925,12 +925,12 @@ TEST (votes, add_old_different_account)
 	ASSERT_EQ (1, votes1->votes.rep_votes.size ());
 	ASSERT_EQ (1, votes2->votes.rep_votes.size ());
 	auto vote1 (std::make_shared<germ::vote> (germ::test_genesis_key.pub, germ::test_genesis_key.prv, 2, send1));
-	auto vote_result1 (node1.vote_processor.vote (vote1, germ::endpoint ()));
+	auto vote_result1 (node1.vote_processor.vote_blocking (germ::read_transaction (node1.store.environment), vote1, germ::endpoint ()));
 	ASSERT_EQ (germ::vote_code::vote, vote_result1);
 	ASSERT_EQ (2, votes1->votes.rep_votes.size ());
 	ASSERT_EQ (1, votes2->votes.rep_votes.size ());
 	auto vote2 (std::make_shared<germ::vote> (germ::test_genesis_key.pub, germ::test_genesis_key.prv, 1, send2));
-	auto vote_result2 (node1.vote_processor.vote (vote2, germ::endpoint ()));
+	auto vote_result2 (node1.vote_processor.vote_blocking (germ::read_transaction (node1.store.environment), vote2, germ::endpoint ()));
 	ASSERT_EQ (germ::vote_code::vote, vote_result2);
 	ASSERT_EQ (2, votes1->votes.rep_votes.size ());
 	ASSERT_EQ (2, votes2->votes.rep_votes.size ());
@@ -961,11 +961,11 @@ TEST (votes, add_cooldown)
 	node1.active.start (send1);
 	auto votes1 (node1.active.roots.find (send1->root ())->election);
 	auto vote1 (std::make_shared<germ::vote> (germ::test_genesis_key.pub, germ::test_genesis_key.prv, 1, send1));
-	node1.vote_processor.vote (vote1, germ::endpoint ());
+	node1.vote_processor.vote_blocking (germ::read_transaction (node1.store.environment), vote1, germ::endpoint ());
 	germ::keypair key2;
 	auto send2 (std::make_shared<germ::send_block> (genesis.hash (), key2.pub, 0, germ::test_genesis_key.prv, germ::test_genesis_key.pub, 0));
 	auto vote2 (std::make_shared<germ::vote> (germ::test_genesis_key.pub, germ::test_genesis_key.prv, 2, send2));
-	node1.vote_processor.vote (vote2, germ::endpoint ());
+	node1.vote_processor.vote_blocking (germ::read_transaction (node1.store.environment), vote2, germ::endpoint ());
 	ASSERT_EQ (2, votes1->votes.rep_votes.size ());
 	ASSERT_NE (votes1->votes.rep_votes.end (), votes1->votes.rep_votes.find (germ::test_genesis_key.pub));
 	ASSERT_EQ (*send1, *votes1->votes.rep_votes[germ::test_genesis_key.pub]);
@@ -974,6 +974,32 @@ TEST (votes, add_cooldown)
 	ASSERT_EQ (*send1, *winner.second);
 }
 
+TEST (vote_tally, change)
+{
+	germ::keypair key1;
+	germ::keypair key2;
+	auto block1 (std::make_shared<germ::tx> (0, key1.pub, 0, germ::test_genesis_key.pub, 100, germ::tx_message (), 0, germ::test_genesis_key.prv, germ::test_genesis_key.pub));
+	auto block2 (std::make_shared<germ::tx> (0, key2.pub, 0, germ::test_genesis_key.pub, 100, germ::tx_message (), 0, germ::test_genesis_key.prv, germ::test_genesis_key.pub));
+	germ::vote_tally tally (block1);
+	ASSERT_EQ (1, tally.size ());
+	ASSERT_EQ (0, tally.winner ().first);
+	tally.vote (key1.pub, 10, block1);
+	tally.vote (key2.pub, 30, block2);
+	ASSERT_EQ (2, tally.size ());
+	ASSERT_EQ (40, tally.sum ());
+	ASSERT_EQ (30, tally.winner ().first);
+	ASSERT_EQ (*block2, *tally.winner ().second);
+	ASSERT_EQ (10, tally.runner_up ());
+	// The weight from the first vote is kept even if the representative's weight changed since
+	tally.vote (key2.pub, 5, block1);
+	ASSERT_EQ (40, tally.sum ());
+	ASSERT_EQ (40, tally.winner ().first);
+	ASSERT_EQ (*block1, *tally.winner ().second);
+	ASSERT_EQ (0, tally.runner_up ());
+	tally.vote (key2.pub, 30, block1);
+	ASSERT_EQ (40, tally.winner ().first);
+}
+
 // Query for block successor
 TEST (ledger, successor)
 {
@@ -518,7 +518,18 @@ TEST (node_config, serialization)
 	config1.callback_address = "test";
 	config1.callback_port = 10;
 	config1.callback_target = "test";
+	config1.active_elections_size = 10;
 	config1.lmdb_max_dbs = 256;
+	config1.lmdb_config.sync = germ::lmdb_sync::no_sync;
+	config1.lmdb_config.sync_commits = 10;
+	config1.lmdb_config.map_size = 1024 * 1024;
+	config1.metrics_config.enable = true;
+	config1.metrics_config.port = 10;
+	config1.subscription_config.enable = true;
+	config1.subscription_config.port = 10;
+	config1.subscription_config.queue_max = 10;
+	config1.subscription_config.history = 10;
+	config1.subscription_config.batch_max = 10;
 	config1.state_block_parse_canary = 10;
 	config1.state_block_generate_canary = 10;
 	boost::property_tree::ptree tree;
@@ -537,7 +548,18 @@ TEST (node_config, serialization)
 	ASSERT_NE (config2.callback_address, config1.callback_address);
 	ASSERT_NE (config2.callback_port, config1.callback_port);
 	ASSERT_NE (config2.callback_target, config1.callback_target);
+	ASSERT_NE (config2.active_elections_size, config1.active_elections_size);
 	ASSERT_NE (config2.lmdb_max_dbs, config1.lmdb_max_dbs);
+	ASSERT_NE (config2.lmdb_config.sync, config1.lmdb_config.sync);
+	ASSERT_NE (config2.lmdb_config.sync_commits, config1.lmdb_config.sync_commits);
+	ASSERT_NE (config2.lmdb_config.map_size, config1.lmdb_config.map_size);
+	ASSERT_NE (config2.metrics_config.enable, config1.metrics_config.enable);
+	ASSERT_NE (config2.metrics_config.port, config1.metrics_config.port);
+	ASSERT_NE (config2.subscription_config.enable, config1.subscription_config.enable);
+	ASSERT_NE (config2.subscription_config.port, config1.subscription_config.port);
+	ASSERT_NE (config2.subscription_config.queue_max, config1.subscription_config.queue_max);
+	ASSERT_NE (config2.subscription_config.history, config1.subscription_config.history);
+	ASSERT_NE (config2.subscription_config.batch_max, config1.subscription_config.batch_max);
 	ASSERT_NE (config2.state_block_parse_canary, config1.state_block_parse_canary);
 	ASSERT_NE (config2.state_block_generate_canary, config1.state_block_generate_canary);
 
@@ -554,7 +576,18 @@ TEST (node_config, serialization)
 	ASSERT_EQ (config2.callback_address, config1.callback_address);
 	ASSERT_EQ (config2.callback_port, config1.callback_port);
 	ASSERT_EQ (config2.callback_target, config1.callback_target);
+	ASSERT_EQ (config2.active_elections_size, config1.active_elections_size);
 	ASSERT_EQ (config2.lmdb_max_dbs, config1.lmdb_max_dbs);
+	ASSERT_EQ (config2.lmdb_config.sync, config1.lmdb_config.sync);
+	ASSERT_EQ (config2.lmdb_config.sync_commits, config1.lmdb_config.sync_commits);
+	ASSERT_EQ (config2.lmdb_config.map_size, config1.lmdb_config.map_size);
+	ASSERT_EQ (config2.metrics_config.enable, config1.metrics_config.enable);
+	ASSERT_EQ (config2.metrics_config.port, config1.metrics_config.port);
+	ASSERT_EQ (config2.subscription_config.enable, config1.subscription_config.enable);
+	ASSERT_EQ (config2.subscription_config.port, config1.subscription_config.port);
+	ASSERT_EQ (config2.subscription_config.queue_max, config1.subscription_config.queue_max);
+	ASSERT_EQ (config2.subscription_config.history, config1.subscription_config.history);
+	ASSERT_EQ (config2.subscription_config.batch_max, config1.subscription_config.batch_max);
 	ASSERT_EQ (config2.state_block_parse_canary, config1.state_block_parse_canary);
 	ASSERT_EQ (config2.state_block_generate_canary, config1.state_block_generate_canary);
 }
@@ -1692,3 +1725,476 @@ TEST (node, confirm_quorum)
 	}
 	ASSERT_EQ (0, system.nodes[0]->balance (germ::test_genesis_key.pub));
 }
+
+TEST (vote_processor, batch)
+{
+	germ::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	germ::genesis genesis;
+	std::shared_ptr<germ::tx> block (std::move (genesis.open));
+	auto vote1 (std::make_shared<germ::vote> (germ::test_genesis_key.pub, germ::test_genesis_key.prv, 1, block));
+	auto vote2 (std::make_shared<germ::vote> (*vote1));
+	vote2->signature.bytes[0] ^= 1;
+	node1.vote_processor.vote (vote1, germ::endpoint ());
+	node1.vote_processor.vote (vote2, germ::endpoint ());
+	node1.vote_processor.flush ();
+	ASSERT_EQ (0, node1.vote_processor.size ());
+	ASSERT_LE (1, node1.vote_processor.queued_peak);
+	// Only votes with a valid signature count as verified
+	ASSERT_EQ (1, node1.stats.count (germ::stat::type::vote, germ::stat::detail::vote_verified, germ::stat::dir::in));
+	germ::read_transaction transaction (node1.store.environment);
+	ASSERT_EQ (1, node1.store.vote_max (transaction, vote1)->sequence);
+}
+
+TEST (signer_pool, sign)
+{
+	germ::stat stats;
+	germ::signer_pool pool (stats, 2);
+	germ::genesis genesis;
+	std::shared_ptr<germ::tx> block (std::move (genesis.open));
+	std::vector<germ::keypair> signers (3);
+	std::vector<std::shared_ptr<germ::vote>> votes;
+	std::vector<germ::uint256_union const *> keys;
+	for (auto i (0); i < 100; ++i)
+	{
+		auto & signer (signers[i % signers.size ()]);
+		auto vote (std::make_shared<germ::vote> ());
+		vote->account = signer.pub;
+		vote->block = block;
+		vote->sequence = i;
+		votes.push_back (vote);
+		keys.push_back (&signer.prv.data);
+	}
+	pool.sign (votes, keys);
+	for (auto & vote : votes)
+	{
+		ASSERT_FALSE (vote->validate ());
+	}
+	ASSERT_EQ (100, stats.count (germ::stat::type::vote, germ::stat::detail::vote_signed, germ::stat::dir::out));
+	ASSERT_EQ (1, stats.count (germ::stat::type::vote, germ::stat::detail::vote_sign_batch, germ::stat::dir::out));
+	// Signed on the caller once stopped
+	pool.stop ();
+	votes[0]->signature.clear ();
+	pool.sign (votes, keys);
+	ASSERT_FALSE (votes[0]->validate ());
+}
+
+TEST (node, votes_generate)
+{
+	germ::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	auto wallet (system.wallet (0));
+	wallet->insert_adhoc (germ::test_genesis_key.prv);
+	germ::genesis genesis;
+	std::shared_ptr<germ::tx> block (std::move (genesis.open));
+	{
+		germ::read_transaction transaction (node1.store.environment);
+		auto votes1 (node1.votes_generate (transaction, block));
+		ASSERT_EQ (1, votes1.size ());
+		ASSERT_FALSE (votes1[0]->validate ());
+		auto votes2 (node1.votes_generate (transaction, block));
+		ASSERT_EQ (1, votes2.size ());
+		ASSERT_EQ (votes1[0]->sequence + 1, votes2[0]->sequence);
+		ASSERT_EQ (votes2[0], node1.store.vote_max (transaction, votes1[0]));
+	}
+	// The key was decrypted once and then served from the cache
+	ASSERT_EQ (1, wallet->signers.size ());
+	ASSERT_EQ (1, node1.stats.count (germ::stat::type::vote, germ::stat::detail::vote_key_decrypt, germ::stat::dir::out));
+	wallet->lock ();
+	ASSERT_EQ (0, wallet->signers.size ());
+	germ::read_transaction transaction (node1.store.environment);
+	ASSERT_TRUE (node1.votes_generate (transaction, block).empty ());
+}
+
+TEST (active_transactions, bounded)
+{
+	germ::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	node1.config.active_elections_size = 2;
+	germ::keypair key1;
+	// Each block gets its own root
+	auto block ([&key1](germ::uint128_t const & balance_a) {
+		return std::make_shared<germ::tx> (balance_a, key1.pub, 0, key1.pub, balance_a, germ::tx_message (), 0, key1.prv, key1.pub);
+	});
+	auto block1 (block (10));
+	auto block2 (block (20));
+	auto block3 (block (5));
+	auto block4 (block (30));
+	ASSERT_FALSE (node1.active.start (block1));
+	ASSERT_FALSE (node1.active.start (block2));
+	ASSERT_TRUE (node1.active.start (block1));
+	// Lower priority than anything active
+	ASSERT_TRUE (node1.active.start (block3));
+	ASSERT_FALSE (node1.active.active (*block3));
+	// Evicts the lowest priority election
+	ASSERT_FALSE (node1.active.start (block4));
+	ASSERT_EQ (2, node1.active.size ());
+	ASSERT_FALSE (node1.active.active (*block1));
+	ASSERT_TRUE (node1.active.active (*block2));
+	ASSERT_TRUE (node1.active.active (*block4));
+	ASSERT_EQ (1, node1.stats.count (germ::stat::type::election, germ::stat::detail::election_drop));
+	ASSERT_EQ (1, node1.stats.count (germ::stat::type::election, germ::stat::detail::election_evict));
+}
+
+TEST (block_tracer, stages)
+{
+	germ::block_tracer tracer;
+	germ::block_hash hash1 (1);
+	germ::block_hash hash2 (2);
+	// Stages past election don't start a trace
+	tracer.add (hash2, germ::block_stage::vote);
+	tracer.add (hash2, germ::block_stage::confirmed);
+	ASSERT_EQ (0, tracer.traced.load ());
+	tracer.add (hash1, germ::block_stage::queued);
+	tracer.add (hash1, germ::block_stage::ledger);
+	tracer.add (hash1, germ::block_stage::ledger);
+	tracer.add (hash1, germ::block_stage::confirmed);
+	ASSERT_EQ (1, tracer.traced.load ());
+	ASSERT_EQ (0, tracer.histograms[static_cast<size_t> (germ::block_stage::arrival)].total ());
+	ASSERT_EQ (1, tracer.histograms[static_cast<size_t> (germ::block_stage::queued)].total ());
+	ASSERT_EQ (0, tracer.histograms[static_cast<size_t> (germ::block_stage::queued)].percentile (0.5));
+	ASSERT_EQ (1, tracer.histograms[static_cast<size_t> (germ::block_stage::ledger)].total ());
+	ASSERT_EQ (1, tracer.histograms[static_cast<size_t> (germ::block_stage::confirmed)].total ());
+	// A confirmed trace frees its slot
+	tracer.add (hash1, germ::block_stage::confirmed);
+	ASSERT_EQ (1, tracer.traced.load ());
+}
+
+TEST (block_tracer, concurrent_claims)
+{
+	germ::block_tracer tracer;
+	std::vector<std::thread> threads;
+	for (auto i (0); i < 4; ++i)
+	{
+		threads.push_back (std::thread ([&tracer, i]() {
+			for (uint64_t j (0); j < 10000; ++j)
+			{
+				// Every thread's blocks map onto the same few slots so claims keep colliding
+				germ::block_hash hash;
+				hash.qwords[0] = (j << 2) | i;
+				hash.qwords[1] = j % 4;
+				tracer.add (hash, germ::block_stage::arrival);
+				tracer.add (hash, germ::block_stage::confirmed);
+			}
+		}));
+	}
+	for (auto & i : threads)
+	{
+		i.join ();
+	}
+	ASSERT_LE (tracer.traced.load (), 40000);
+	ASSERT_EQ (tracer.traced.load (), tracer.histograms[static_cast<size_t> (germ::block_stage::confirmed)].total ());
+}
+
+TEST (stats, threaded_counts)
+{
+	germ::stat stats;
+	std::vector<std::thread> threads;
+	for (auto i (0); i < 8; ++i)
+	{
+		threads.push_back (std::thread ([&stats]() {
+			for (auto j (0); j < 10000; ++j)
+			{
+				stats.inc (germ::stat::type::ledger, germ::stat::detail::send);
+				stats.inc_detail_only (germ::stat::type::error, germ::stat::detail::bad_sender);
+				stats.add (germ::stat::type::traffic, germ::stat::dir::out, 2);
+			}
+		}));
+	}
+	for (auto & i : threads)
+	{
+		i.join ();
+	}
+	ASSERT_EQ (80000, stats.count (germ::stat::type::ledger, germ::stat::detail::send));
+	ASSERT_EQ (80000, stats.count (germ::stat::type::ledger));
+	ASSERT_EQ (0, stats.count (germ::stat::type::ledger, germ::stat::detail::send, germ::stat::dir::out));
+	ASSERT_EQ (80000, stats.count (germ::stat::type::error, germ::stat::detail::bad_sender));
+	ASSERT_EQ (0, stats.count (germ::stat::type::error));
+	ASSERT_EQ (160000, stats.count (germ::stat::type::traffic, germ::stat::dir::out));
+}
+
+TEST (stats, log_counters)
+{
+	germ::stat stats;
+	std::vector<std::pair<uint64_t, uint64_t>> observed;
+	stats.observe_count (germ::stat::type::vote, germ::stat::detail::vote_valid, germ::stat::dir::in, [&observed](uint64_t old_a, uint64_t new_a) {
+		observed.push_back (std::make_pair (old_a, new_a));
+	});
+	stats.inc (germ::stat::type::vote, germ::stat::detail::vote_valid);
+	stats.inc (germ::stat::type::vote, germ::stat::detail::vote_valid);
+	stats.inc (germ::stat::type::message, germ::stat::detail::keepalive, germ::stat::dir::out);
+	auto sink (stats.log_sink_json ());
+	stats.log_counters (*sink);
+	auto & tree (*static_cast<boost::property_tree::ptree *> (sink->to_object ()));
+	ASSERT_EQ ("counters", tree.get<std::string> ("type"));
+	std::vector<std::string> entries;
+	for (auto & i : tree.get_child ("entries"))
+	{
+		entries.push_back (i.second.get<std::string> ("type") + "." + i.second.get<std::string> ("detail") + "." + i.second.get<std::string> ("dir") + "=" + i.second.get<std::string> ("value"));
+	}
+	// Entries come out sorted by type, detail and direction
+	std::vector<std::string> expected{ "message.all.out=1", "message.keepalive.out=1", "vote.all.in=2", "vote.vote_valid.in=2" };
+	ASSERT_EQ (expected, entries);
+	// Observers see aggregated changes, which may cover several updates
+	ASSERT_FALSE (observed.empty ());
+	ASSERT_GE (2, observed.size ());
+	ASSERT_EQ (0, observed.front ().first);
+	ASSERT_EQ (2, observed.back ().second);
+}
+
+TEST (metrics, render)
+{
+	germ::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	node1.stats.inc (germ::stat::type::message, germ::stat::detail::keepalive, germ::stat::dir::out);
+	node1.active.confirmation_latency.add (std::chrono::milliseconds (3));
+	auto text (node1.metrics.render ());
+	ASSERT_NE (std::string::npos, text.find ("# TYPE germ_stat counter\n"));
+	ASSERT_NE (std::string::npos, text.find ("germ_stat_total{type=\"message\",detail=\"keepalive\",dir=\"out\"} 1\n"));
+	ASSERT_NE (std::string::npos, text.find ("germ_block_processor_queue 0\n"));
+	ASSERT_NE (std::string::npos, text.find ("germ_active_elections 0\n"));
+	ASSERT_NE (std::string::npos, text.find ("germ_bootstrap_in_progress "));
+	ASSERT_NE (std::string::npos, text.find ("germ_lmdb_map_used_bytes "));
+	// 3ms falls in the [2, 4) bucket, buckets are cumulative
+	ASSERT_NE (std::string::npos, text.find ("germ_election_confirmation_seconds_bucket{le=\"0.002\"} 0\n"));
+	ASSERT_NE (std::string::npos, text.find ("germ_election_confirmation_seconds_bucket{le=\"0.004\"} 1\n"));
+	ASSERT_NE (std::string::npos, text.find ("germ_election_confirmation_seconds_bucket{le=\"+Inf\"} 1\n"));
+	ASSERT_NE (std::string::npos, text.find ("germ_block_stage_seconds_count{stage=\"arrival\"} "));
+	ASSERT_EQ (text.size () - 6, text.rfind ("# EOF\n"));
+}
+
+TEST (subscription, replay)
+{
+	germ::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	node1.config.subscription_config.history = 2;
+	germ::keypair key;
+	auto block (std::make_shared<germ::tx> (0, key.pub, 0, germ::test_genesis_key.pub, 1, germ::tx_message (), 0, germ::test_genesis_key.prv, germ::test_genesis_key.pub));
+	for (auto i (0); i < 3; ++i)
+	{
+		node1.subscriptions.publish (block, key.pub, 1, false);
+	}
+	std::vector<std::shared_ptr<germ::confirmation_event const>> events;
+	uint64_t newest (0);
+	// The first event fell out of the history
+	ASSERT_EQ (2, node1.subscriptions.replay (0, events, newest));
+	ASSERT_EQ (3, newest);
+	ASSERT_EQ (2, events.size ());
+	ASSERT_EQ (2, events[0]->sequence);
+	ASSERT_EQ (3, events[1]->sequence);
+	events.clear ();
+	node1.subscriptions.replay (3, events, newest);
+	ASSERT_TRUE (events.empty ());
+	ASSERT_NE (std::string::npos, node1.subscriptions.history.back ()->json.find ("\"sequence\":\"3\""));
+}
+
+TEST (subscription, websocket)
+{
+	germ::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	node1.config.subscription_config.enable = true;
+	node1.subscriptions.start ();
+	germ::keypair key1;
+	germ::keypair key2;
+	auto block (std::make_shared<germ::tx> (0, key1.pub, 0, germ::test_genesis_key.pub, 1, germ::tx_message (), 0, germ::test_genesis_key.prv, germ::test_genesis_key.pub));
+	node1.subscriptions.publish (block, key1.pub, 1, false);
+	node1.subscriptions.publish (block, key1.pub, 1, false);
+	node1.subscriptions.publish (block, key2.pub, 1, false);
+	std::vector<std::string> messages;
+	std::atomic<int> received (0);
+	std::thread client ([&messages, &received, &key1]() {
+		boost::asio::io_service service;
+		boost::asio::ip::tcp::socket socket (service);
+		socket.connect (germ::tcp_endpoint (boost::asio::ip::address_v6::loopback (), germ::subscription_server::subscription_port));
+		boost::beast::websocket::stream<boost::asio::ip::tcp::socket &> stream (socket);
+		stream.handshake ("localhost", "/");
+		stream.write (boost::asio::buffer ("{\"action\":\"subscribe\",\"accounts\":[\"" + key1.pub.to_account () + "\"],\"sequence\":\"1\"}"));
+		for (auto i (0); i < 3; ++i)
+		{
+			boost::beast::flat_buffer buffer;
+			stream.read (buffer);
+			messages.push_back (std::string (boost::asio::buffers_begin (buffer.data ()), boost::asio::buffers_end (buffer.data ())));
+			++received;
+		}
+	});
+	auto published (false);
+	auto iterations (0);
+	while (received < 3)
+	{
+		if (received == 2 && !published)
+		{
+			// Live events follow the replayed ones
+			node1.subscriptions.publish (block, key2.pub, 1, false);
+			node1.subscriptions.publish (block, key1.pub, 1, false);
+			published = true;
+		}
+		system.poll ();
+		++iterations;
+		ASSERT_LT (iterations, 1000);
+	}
+	client.join ();
+	ASSERT_NE (std::string::npos, messages[0].find ("\"type\":\"subscribed\""));
+	ASSERT_NE (std::string::npos, messages[0].find ("\"sequence\":\"3\""));
+	ASSERT_NE (std::string::npos, messages[0].find ("\"resumed\":\"true\""));
+	ASSERT_NE (std::string::npos, messages[0].find ("\"epoch\":\"" + std::to_string (node1.subscriptions.epoch) + "\""));
+	// Sequence 3 is for another account and filtered out
+	ASSERT_NE (std::string::npos, messages[1].find ("\"type\":\"confirmations\""));
+	ASSERT_NE (std::string::npos, messages[1].find ("\"sequence\":\"2\""));
+	ASSERT_EQ (std::string::npos, messages[1].find ("\"sequence\":\"3\""));
+	ASSERT_NE (std::string::npos, messages[2].find ("\"sequence\":\"5\""));
+	ASSERT_EQ (std::string::npos, messages[2].find ("\"sequence\":\"4\""));
+	ASSERT_EQ (1, node1.subscriptions.size ());
+}
+
+TEST (subscription, stale_sequence)
+{
+	germ::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	node1.config.subscription_config.enable = true;
+	node1.subscriptions.start ();
+	germ::keypair key1;
+	auto block (std::make_shared<germ::tx> (0, key1.pub, 0, germ::test_genesis_key.pub, 1, germ::tx_message (), 0, germ::test_genesis_key.prv, germ::test_genesis_key.pub));
+	node1.subscriptions.publish (block, key1.pub, 1, false);
+	node1.subscriptions.publish (block, key1.pub, 1, false);
+	std::vector<std::string> messages;
+	std::atomic<int> received (0);
+	std::thread client ([&messages, &received]() {
+		boost::asio::io_service service;
+		boost::asio::ip::tcp::socket socket (service);
+		socket.connect (germ::tcp_endpoint (boost::asio::ip::address_v6::loopback (), germ::subscription_server::subscription_port));
+		boost::beast::websocket::stream<boost::asio::ip::tcp::socket &> stream (socket);
+		stream.handshake ("localhost", "/");
+		// Left over from a run that published more events than this one
+		stream.write (boost::asio::buffer (std::string ("{\"action\":\"subscribe\",\"sequence\":\"9\"}")));
+		for (auto i (0); i < 2; ++i)
+		{
+			boost::beast::flat_buffer buffer;
+			stream.read (buffer);
+			messages.push_back (std::string (boost::asio::buffers_begin (buffer.data ()), boost::asio::buffers_end (buffer.data ())));
+			++received;
+		}
+	});
+	auto iterations (0);
+	while (received < 2)
+	{
+		system.poll ();
+		++iterations;
+		ASSERT_LT (iterations, 1000);
+	}
+	client.join ();
+	ASSERT_NE (std::string::npos, messages[0].find ("\"resumed\":\"false\""));
+	// The whole history is sent since nothing after the stale sequence can be picked out
+	ASSERT_NE (std::string::npos, messages[1].find ("\"sequence\":\"1\""));
+	ASSERT_NE (std::string::npos, messages[1].find ("\"sequence\":\"2\""));
+}
+
+TEST (active_elections, ranking)
+{
+	germ::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	std::vector<germ::account> accounts;
+	for (auto i (1); i <= 60; ++i)
+	{
+		germ::keypair key;
+		accounts.push_back (key.pub);
+	}
+	{
+		germ::transaction transaction (node1.store.environment, nullptr, true);
+		germ::tx block (0, accounts[0], 0, germ::test_genesis_key.pub, 1, germ::tx_message (), 0, germ::test_genesis_key.prv, germ::test_genesis_key.pub);
+		// Accounts without a tally aren't candidates
+		ASSERT_FALSE (node1.active_election.vote (transaction, block, germ::general_account (accounts[0], 0)));
+	}
+	ASSERT_FALSE (node1.active_election.is_candidate (accounts[0]));
+	{
+		std::lock_guard<std::mutex> lock (node1.active_election.mutex);
+		for (auto & i : accounts)
+		{
+			node1.active_election.lists.insert (germ::election_tally{ i, germ::amount (0) });
+		}
+	}
+	{
+		germ::transaction transaction (node1.store.environment, nullptr, true);
+		for (auto i (1); i <= 60; ++i)
+		{
+			germ::tx block (0, accounts[i - 1], 0, germ::test_genesis_key.pub, i, germ::tx_message (), 0, germ::test_genesis_key.prv, germ::test_genesis_key.pub);
+			ASSERT_TRUE (node1.active_election.vote (transaction, block, germ::general_account (accounts[i - 1], 0)));
+		}
+		// The ranking only changes once the transaction commits
+		ASSERT_FALSE (node1.active_election.is_witness (accounts[59]));
+	}
+	// Accounts were voted with increasing weight so the last ones rank highest
+	ASSERT_TRUE (node1.active_election.is_witness (accounts[59]));
+	ASSERT_TRUE (node1.active_election.is_witness (accounts[39]));
+	ASSERT_FALSE (node1.active_election.is_witness (accounts[38]));
+	ASSERT_TRUE (node1.active_election.is_candidate (accounts[10]));
+	ASSERT_FALSE (node1.active_election.is_candidate (accounts[9]));
+	{
+		germ::transaction transaction (node1.store.environment, nullptr, true);
+		germ::tx block (0, accounts[0], 0, germ::test_genesis_key.pub, 100, germ::tx_message (), 0, germ::test_genesis_key.prv, germ::test_genesis_key.pub);
+		ASSERT_TRUE (node1.active_election.vote (transaction, block, germ::general_account (accounts[0], 0)));
+	}
+	ASSERT_TRUE (node1.active_election.is_witness (accounts[0]));
+	ASSERT_FALSE (node1.active_election.is_witness (accounts[39]));
+	ASSERT_FALSE (node1.active_election.is_candidate (accounts[10]));
+	auto snapshot (node1.active_election.epoch_boundary (1));
+	ASSERT_EQ (germ::witness_candidate::witness_candidate_count, snapshot.candidates.size ());
+	ASSERT_EQ (accounts[0], snapshot.candidates[0].account);
+	ASSERT_EQ (101, snapshot.candidates[0].weight.number ());
+	// Tallies are reloaded from the store
+	germ::active_elections elections (node1);
+	ASSERT_TRUE (elections.is_witness (accounts[0]));
+	ASSERT_EQ (snapshot.candidates.size (), elections.ranking (germ::witness_candidate::witness_candidate_count).size ());
+}
+
+TEST (epoch_builder, seal)
+{
+	germ::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	ASSERT_TRUE (node1.epoch_builder.seal ().is_zero ());
+	node1.epoch_builder.add (germ::block_hash (1));
+	node1.epoch_builder.add (germ::block_hash (2));
+	node1.epoch_builder.add (germ::block_hash (1));
+	ASSERT_EQ (2, node1.epoch_builder.size ());
+	auto epoch1 (node1.epoch_builder.seal ());
+	ASSERT_FALSE (epoch1.is_zero ());
+	ASSERT_EQ (0, node1.epoch_builder.size ());
+	node1.epoch_builder.add (germ::block_hash (3));
+	auto epoch2 (node1.epoch_builder.seal ());
+	germ::read_transaction transaction (node1.epoch_store.environment);
+	ASSERT_EQ (epoch2, node1.epoch_store.head_get (transaction));
+	auto block1 (node1.epoch_store.block_get (transaction, epoch1));
+	ASSERT_NE (nullptr, block1);
+	ASSERT_EQ (2, block1->txs ().size ());
+	auto block2 (node1.epoch_store.block_get (transaction, epoch2));
+	ASSERT_NE (nullptr, block2);
+	ASSERT_EQ (epoch1, block2->previous_epoch ());
+	germ::epoch_tx_info info;
+	ASSERT_TRUE (node1.epoch_store.tx_epoch_get (transaction, germ::block_hash (2), info));
+	ASSERT_EQ (epoch1, info.epoch);
+	ASSERT_EQ (1, info.index);
+	ASSERT_TRUE (node1.epoch_store.tx_epoch_get (transaction, germ::block_hash (3), info));
+	ASSERT_EQ (epoch2, info.epoch);
+	// Each sealed epoch records the witness ranking in effect at it
+	std::vector<germ::account> witnesses;
+	ASSERT_TRUE (node1.active_election.epoch_witnesses (epoch1, witnesses));
+	ASSERT_TRUE (node1.active_election.epoch_witnesses (epoch2, witnesses));
+}
+
+TEST (epoch_builder, already_included)
+{
+	germ::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	node1.epoch_builder.add (germ::block_hash (1));
+	auto epoch1 (node1.epoch_builder.seal ());
+	node1.epoch_builder.add (germ::block_hash (1));
+	ASSERT_TRUE (node1.epoch_builder.seal ().is_zero ());
+	node1.epoch_builder.add (germ::block_hash (1));
+	node1.epoch_builder.add (germ::block_hash (2));
+	auto epoch2 (node1.epoch_builder.seal ());
+	germ::read_transaction transaction (node1.epoch_store.environment);
+	auto block2 (node1.epoch_store.block_get (transaction, epoch2));
+	ASSERT_EQ (std::vector<germ::block_hash> (1, germ::block_hash (2)), block2->txs ());
+	germ::epoch_tx_info info;
+	ASSERT_TRUE (node1.epoch_store.tx_epoch_get (transaction, germ::block_hash (1), info));
+	ASSERT_EQ (epoch1, info.epoch);
+}
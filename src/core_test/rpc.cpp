@@ -879,6 +879,63 @@ TEST (rpc, frontier_limited)
 	ASSERT_EQ (100, frontiers_node.size ());
 }
 
+TEST (rpc, frontier_cursor)
+{
+	germ::system system (24000, 1);
+	std::unordered_map<germ::account, germ::block_hash> source;
+	{
+		germ::transaction transaction (system.nodes[0]->store.environment, nullptr, true);
+		for (auto i (0); i < 1000; ++i)
+		{
+			germ::keypair key;
+			source[key.pub] = key.prv.data;
+			system.nodes[0]->store.account_put (transaction, key.pub, germ::account_info (key.prv.data, 0, 0, 0, 0));
+		}
+	}
+	germ::rpc rpc (system.service, *system.nodes[0], germ::rpc_config (true));
+	rpc.start ();
+	std::unordered_map<germ::account, germ::block_hash> frontiers;
+	boost::property_tree::ptree request;
+	request.put ("action", "frontiers");
+	request.put ("account", germ::account (0).to_account ());
+	request.put ("count", std::to_string (300));
+	auto pages (0);
+	for (auto more (true); more; ++pages)
+	{
+		test_response response (request, rpc, system.service);
+		while (response.status == 0)
+		{
+			system.poll ();
+		}
+		ASSERT_EQ (200, response.status);
+		for (auto & i : response.json.get_child ("frontiers"))
+		{
+			germ::account account;
+			ASSERT_FALSE (account.decode_account (i.first));
+			germ::block_hash frontier;
+			ASSERT_FALSE (frontier.decode_hex (i.second.get<std::string> ("")));
+			ASSERT_TRUE (frontiers.insert (std::make_pair (account, frontier)).second);
+		}
+		auto cursor (response.json.get_optional<std::string> ("cursor"));
+		more = cursor.is_initialized ();
+		if (more)
+		{
+			request.put ("cursor", cursor.get ());
+		}
+	}
+	// 1001 accounts including genesis
+	ASSERT_EQ (4, pages);
+	ASSERT_EQ (1, frontiers.erase (germ::test_genesis_key.pub));
+	ASSERT_EQ (source, frontiers);
+	request.put ("cursor", "00");
+	test_response response (request, rpc, system.service);
+	while (response.status == 0)
+	{
+		system.poll ();
+	}
+	ASSERT_EQ ("Invalid cursor", response.json.get<std::string> ("error"));
+}
+
 TEST (rpc, frontier_startpoint)
 {
 	germ::system system (24000, 1);
@@ -889,7 +946,7 @@ TEST (rpc, frontier_startpoint)
 		{
 			germ::keypair key;
 			source[key.pub] = key.prv.data;
-			system.nodes[0]->store.account_put (transaction, key.pub, germ::account_info (key.prv.data, 0, 0, 0, 0, 0));
+			system.nodes[0]->store.account_put (transaction, key.pub, germ::account_info (key.prv.data, 0, 0, 0, 0));
 		}
 	}
 	germ::keypair key;
@@ -1457,6 +1514,9 @@ TEST (rpc_config, serialization)
 	config1.enable_control = true;
 	config1.frontier_request_limit = 8192;
 	config1.chain_request_limit = 4096;
+	config1.worker_threads = 100;
+	config1.max_pipelined = 2;
+	config1.idle_timeout = std::chrono::seconds (5);
 	boost::property_tree::ptree tree;
 	config1.serialize_json (tree);
 	germ::rpc_config config2;
@@ -1465,12 +1525,18 @@ TEST (rpc_config, serialization)
 	ASSERT_NE (config2.enable_control, config1.enable_control);
 	ASSERT_NE (config2.frontier_request_limit, config1.frontier_request_limit);
 	ASSERT_NE (config2.chain_request_limit, config1.chain_request_limit);
+	ASSERT_NE (config2.worker_threads, config1.worker_threads);
+	ASSERT_NE (config2.max_pipelined, config1.max_pipelined);
+	ASSERT_NE (config2.idle_timeout, config1.idle_timeout);
 	config2.deserialize_json (tree);
 	ASSERT_EQ (config2.address, config1.address);
 	ASSERT_EQ (config2.port, config1.port);
 	ASSERT_EQ (config2.enable_control, config1.enable_control);
 	ASSERT_EQ (config2.frontier_request_limit, config1.frontier_request_limit);
 	ASSERT_EQ (config2.chain_request_limit, config1.chain_request_limit);
+	ASSERT_EQ (config2.worker_threads, config1.worker_threads);
+	ASSERT_EQ (config2.max_pipelined, config1.max_pipelined);
+	ASSERT_EQ (config2.idle_timeout, config1.idle_timeout);
 }
 
 TEST (rpc, search_pending)
@@ -3628,6 +3694,125 @@ TEST (rpc, confirmation_history)
 	system.stop ();
 }
 
+TEST (rpc, confirmation_latency)
+{
+	germ::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	germ::block_hash hash (1);
+	node1.tracer.add (hash, germ::block_stage::arrival);
+	node1.tracer.add (hash, germ::block_stage::confirmed);
+	germ::rpc rpc (system.service, node1, germ::rpc_config (true));
+	rpc.start ();
+	boost::property_tree::ptree request;
+	request.put ("action", "confirmation_latency");
+	test_response response (request, rpc, system.service);
+	while (response.status == 0)
+	{
+		system.poll ();
+	}
+	ASSERT_EQ (200, response.status);
+	ASSERT_EQ ("1", response.json.get<std::string> ("traced"));
+	auto & stages (response.json.get_child ("stages"));
+	ASSERT_EQ (germ::block_tracer::stage_count, stages.size ());
+	ASSERT_EQ ("1", stages.get<std::string> ("arrival.count"));
+	ASSERT_EQ ("0", stages.get<std::string> ("arrival.p99"));
+	ASSERT_EQ ("0", stages.get<std::string> ("vote.count"));
+	system.stop ();
+}
+
+TEST (rpc, epoch_proof)
+{
+	germ::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	for (auto i (1); i <= 3; ++i)
+	{
+		node1.epoch_builder.add (germ::block_hash (i));
+	}
+	auto epoch (node1.epoch_builder.seal ());
+	germ::rpc rpc (system.service, node1, germ::rpc_config (true));
+	rpc.start ();
+	boost::property_tree::ptree request;
+	request.put ("action", "epoch_proof");
+	request.put ("hash", germ::block_hash (3).to_string ());
+	test_response response (request, rpc, system.service);
+	while (response.status == 0)
+	{
+		system.poll ();
+	}
+	ASSERT_EQ (200, response.status);
+	ASSERT_EQ (epoch.to_string (), response.json.get<std::string> ("epoch"));
+	ASSERT_EQ ("2", response.json.get<std::string> ("index"));
+	ASSERT_EQ ("3", response.json.get<std::string> ("count"));
+	germ::uint256_union root;
+	ASSERT_FALSE (root.decode_hex (response.json.get<std::string> ("root")));
+	std::vector<germ::uint256_union> proof;
+	for (auto & i : response.json.get_child ("proof"))
+	{
+		germ::uint256_union sibling;
+		ASSERT_FALSE (sibling.decode_hex (i.second.get<std::string> ("")));
+		proof.push_back (sibling);
+	}
+	ASSERT_TRUE (germ::merkle_tree::verify (germ::block_hash (3), 2, 3, proof, root));
+	system.stop ();
+}
+
+TEST (rpc, tx_epoch)
+{
+	germ::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	node1.epoch_builder.add (germ::block_hash (1));
+	auto epoch1 (node1.epoch_builder.seal ());
+	node1.epoch_builder.add (germ::block_hash (2));
+	node1.epoch_builder.add (germ::block_hash (3));
+	auto epoch2 (node1.epoch_builder.seal ());
+	germ::rpc rpc (system.service, node1, germ::rpc_config (true));
+	rpc.start ();
+	boost::property_tree::ptree request;
+	request.put ("action", "tx_epoch");
+	request.put ("hash", germ::block_hash (3).to_string ());
+	test_response response (request, rpc, system.service);
+	while (response.status == 0)
+	{
+		system.poll ();
+	}
+	ASSERT_EQ (200, response.status);
+	ASSERT_EQ (epoch2.to_string (), response.json.get<std::string> ("epoch"));
+	ASSERT_EQ ("1", response.json.get<std::string> ("index"));
+	ASSERT_EQ ("2", response.json.get<std::string> ("height"));
+	request.put ("hash", germ::block_hash (4).to_string ());
+	test_response response1 (request, rpc, system.service);
+	while (response1.status == 0)
+	{
+		system.poll ();
+	}
+	ASSERT_EQ ("Transaction not in any epoch", response1.json.get<std::string> ("error"));
+	boost::property_tree::ptree request2;
+	request2.put ("action", "epochs_range");
+	request2.put ("from_time", "0");
+	request2.put ("to_time", std::to_string (germ::seconds_since_epoch ()));
+	test_response response2 (request2, rpc, system.service);
+	while (response2.status == 0)
+	{
+		system.poll ();
+	}
+	ASSERT_EQ (200, response2.status);
+	std::vector<std::string> hashes;
+	for (auto & i : response2.json.get_child ("epochs"))
+	{
+		hashes.push_back (i.second.get<std::string> ("hash"));
+	}
+	ASSERT_EQ (std::vector<std::string> ({ epoch1.to_string (), epoch2.to_string () }), hashes);
+	request2.put ("to_time", "1");
+	test_response response3 (request2, rpc, system.service);
+	while (response3.status == 0)
+	{
+		system.poll ();
+	}
+	ASSERT_EQ (200, response3.status);
+	ASSERT_EQ (0, response3.json.get_child ("epochs").size ());
+	system.stop ();
+}
+
 TEST (rpc, block_confirm)
 {
 	germ::system system (24000, 1);
@@ -3670,3 +3855,137 @@ TEST (rpc, block_confirm_absent)
 	ASSERT_EQ (200, response.status);
 	ASSERT_EQ ("Block not found", response.json.get<std::string> ("error"));
 }
+
+TEST (rpc, keepalive_pipelining)
+{
+	germ::system system (24000, 1);
+	germ::rpc rpc (system.service, *system.nodes[0], germ::rpc_config (true));
+	rpc.start ();
+	std::atomic<bool> done (false);
+	boost::system::error_code client_error;
+	std::vector<boost::beast::http::response<boost::beast::http::string_body>> responses;
+	std::thread client ([&rpc, &done, &client_error, &responses]() {
+		boost::asio::io_service service;
+		boost::asio::ip::tcp::socket sock (service);
+		sock.connect (germ::tcp_endpoint (boost::asio::ip::address_v6::loopback (), rpc.config.port), client_error);
+		// Both requests are sent on one connection before either response is read
+		for (auto action : { "block_count", "version" })
+		{
+			boost::beast::http::request<boost::beast::http::string_body> req;
+			req.method (boost::beast::http::verb::post);
+			req.target ("/");
+			req.version (11);
+			req.body () = std::string ("{\"action\": \"") + action + "\"}";
+			req.prepare_payload ();
+			if (!client_error)
+			{
+				boost::beast::http::write (sock, req, client_error);
+			}
+		}
+		boost::beast::flat_buffer buffer;
+		for (auto i (0); i < 2 && !client_error; ++i)
+		{
+			boost::beast::http::response<boost::beast::http::string_body> resp;
+			boost::beast::http::read (sock, buffer, resp, client_error);
+			responses.push_back (resp);
+		}
+		done = true;
+	});
+	while (!done)
+	{
+		system.poll ();
+	}
+	client.join ();
+	ASSERT_FALSE (client_error);
+	ASSERT_EQ (2, responses.size ());
+	// Responses come back in request order and the connection stays open
+	ASSERT_TRUE (responses[0].keep_alive ());
+	ASSERT_NE (std::string::npos, responses[0].body ().find ("\"count\""));
+	ASSERT_TRUE (responses[1].keep_alive ());
+	ASSERT_NE (std::string::npos, responses[1].body ().find ("\"node_vendor\""));
+	boost::property_tree::ptree request;
+	request.put ("action", "stats");
+	request.put ("type", "rpc");
+	test_response response (request, rpc, system.service);
+	while (response.status == 0)
+	{
+		system.poll ();
+	}
+	ASSERT_EQ (200, response.status);
+	ASSERT_EQ ("1", response.json.get<std::string> ("actions.block_count.count"));
+	ASSERT_EQ ("1", response.json.get<std::string> ("actions.version.count"));
+	system.stop ();
+}
+
+TEST (rpc, batch)
+{
+	germ::system system (24000, 1);
+	germ::rpc rpc (system.service, *system.nodes[0], germ::rpc_config (true));
+	rpc.start ();
+	boost::property_tree::ptree request;
+	request.put ("action", "batch");
+	boost::property_tree::ptree requests;
+	// Enough items to be split across several workers
+	size_t count (3 * germ::rpc_handler::batch_chunk);
+	for (size_t i (0); i < count; ++i)
+	{
+		boost::property_tree::ptree item;
+		switch (i % 3)
+		{
+			case 0:
+				item.put ("action", "account_balance");
+				item.put ("account", germ::test_genesis_key.pub.to_account ());
+				break;
+			case 1:
+				item.put ("action", "account_info");
+				item.put ("account", "bad");
+				break;
+			default:
+				item.put ("action", "stop");
+				break;
+		}
+		requests.push_back (std::make_pair ("", item));
+	}
+	request.add_child ("requests", requests);
+	test_response response (request, rpc, system.service);
+	while (response.status == 0)
+	{
+		system.poll ();
+	}
+	ASSERT_EQ (200, response.status);
+	auto & responses (response.json.get_child ("responses"));
+	ASSERT_EQ (count, responses.size ());
+	size_t index (0);
+	for (auto & i : responses)
+	{
+		switch (index++ % 3)
+		{
+			case 0:
+				ASSERT_EQ ("340282366920938463463374607431768211455", i.second.get<std::string> ("balance"));
+				break;
+			case 1:
+				ASSERT_EQ ("Bad account number", i.second.get<std::string> ("error"));
+				break;
+			default:
+				ASSERT_EQ ("Action not available in batch", i.second.get<std::string> ("error"));
+				break;
+		}
+	}
+}
+
+TEST (rpc_stream, writable)
+{
+	std::atomic<unsigned> notified (0);
+	germ::rpc_stream stream (std::chrono::milliseconds (10), [&notified]() { ++notified; });
+	// Output stays with the action until its response is first in line
+	ASSERT_FALSE (stream.writable ());
+	stream.activate ();
+	ASSERT_TRUE (stream.writable ());
+	ASSERT_FALSE (stream.write (std::string (germ::rpc_stream::queued_max, 'a')));
+	// Nothing takes the output, so the next write gives up after the send timeout
+	ASSERT_TRUE (stream.write ("b"));
+	std::string data;
+	auto complete (false);
+	ASSERT_TRUE (stream.take (data, complete));
+	ASSERT_EQ (2, notified);
+}
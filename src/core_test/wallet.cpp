@@ -856,6 +856,171 @@ TEST (wallet, send_race)
 	}
 }
 
+TEST (wallet, send_batch)
+{
+	germ::system system (24000, 1);
+	system.wallet (0)->insert_adhoc (germ::test_genesis_key.prv);
+	germ::keypair key2;
+	germ::keypair key3;
+	std::vector<germ::send_item> items;
+	for (auto i (0); i < 600; ++i)
+	{
+		items.push_back (germ::send_item{ germ::test_genesis_key.pub, key2.pub, germ::Gxrb_ratio, std::string ("payout-") + std::to_string (i) });
+	}
+	items.push_back (germ::send_item{ germ::test_genesis_key.pub, key2.pub, germ::Gxrb_ratio, std::string ("payout-0") });
+	items.push_back (germ::send_item{ key3.pub, key2.pub, germ::Gxrb_ratio, boost::none });
+	items.push_back (germ::send_item{ germ::test_genesis_key.pub, key2.pub, germ::genesis_amount, boost::none });
+	items.push_back (germ::send_item{ germ::test_genesis_key.pub, key2.pub, germ::genesis_amount, std::string ("retry") });
+	items.push_back (germ::send_item{ germ::test_genesis_key.pub, key2.pub, germ::Gxrb_ratio, std::string ("retry") });
+	auto results (system.wallet (0)->send_batch_action (items));
+	ASSERT_EQ (items.size (), results.size ());
+	for (auto i (0); i < 600; ++i)
+	{
+		ASSERT_EQ (germ::send_status::sent, results[i].status);
+		ASSERT_FALSE (germ::validate_message (germ::test_genesis_key.pub, results[i].block->hash (), results[i].block->block_signature ()));
+	}
+	// Each send builds on the one before it
+	ASSERT_EQ (results[598].block->hash (), results[599].block->previous ());
+	ASSERT_EQ (germ::send_status::duplicate, results[600].status);
+	ASSERT_EQ (results[0].block->hash (), results[600].block->hash ());
+	ASSERT_EQ (germ::send_status::not_found, results[601].status);
+	ASSERT_EQ (germ::send_status::insufficient_balance, results[602].status);
+	// A failed send doesn't claim its id
+	ASSERT_EQ (germ::send_status::insufficient_balance, results[603].status);
+	ASSERT_EQ (germ::send_status::sent, results[604].status);
+	ASSERT_EQ (germ::genesis_amount - germ::Gxrb_ratio * 601, system.nodes[0]->balance (germ::test_genesis_key.pub));
+	// Running the batch again only finds the earlier sends
+	items.resize (600);
+	auto again (system.wallet (0)->send_batch_action (items));
+	for (auto i (0); i < 600; ++i)
+	{
+		ASSERT_EQ (germ::send_status::duplicate, again[i].status);
+		ASSERT_EQ (results[i].block->hash (), again[i].block->hash ());
+	}
+	ASSERT_EQ (germ::genesis_amount - germ::Gxrb_ratio * 601, system.nodes[0]->balance (germ::test_genesis_key.pub));
+}
+
+TEST (wallet, metadata)
+{
+	germ::system system (24000, 1);
+	auto wallet1 (system.wallet (0));
+	wallet1->insert_adhoc (germ::test_genesis_key.prv);
+	germ::keypair key2;
+	germ::keypair key3;
+	auto wallet2 (system.nodes[0]->wallets.create (100));
+	wallet2->insert_adhoc (key2.prv);
+	{
+		germ::transaction transaction (system.nodes[0]->store.environment, nullptr, true);
+		wallet2->insert_watch (transaction, key3.pub);
+	}
+	// Locked so the sends below stay receivable
+	wallet2->store.password.value_set (germ::keypair ().prv);
+	auto representatives (wallet1->representatives_list ());
+	ASSERT_EQ (1, representatives.size ());
+	ASSERT_EQ (germ::test_genesis_key.pub, representatives[0]);
+	ASSERT_TRUE (wallet2->representatives_list ().empty ());
+	ASSERT_TRUE (wallet2->receivable_list ().empty ());
+	ASSERT_NE (nullptr, wallet1->send_action (germ::test_genesis_key.pub, key2.pub, germ::Gxrb_ratio));
+	ASSERT_NE (nullptr, wallet1->send_action (germ::test_genesis_key.pub, key3.pub, germ::Gxrb_ratio));
+	// Sends flag the destination, watch-only accounts are left out
+	auto receivable (wallet2->receivable_list ());
+	ASSERT_EQ (1, receivable.size ());
+	ASSERT_EQ (key2.pub, receivable[0]);
+	{
+		germ::transaction transaction (system.nodes[0]->store.environment, nullptr, false);
+		ASSERT_TRUE (wallet2->store.exists (transaction, key3.pub));
+		// Flags are stored for every held account, loading reads them instead of the ledger
+		ASSERT_EQ (germ::wallets::metadata_receivable, system.nodes[0]->wallets.metadata_get (transaction, key2.pub));
+		ASSERT_EQ (germ::wallets::metadata_weighted, system.nodes[0]->wallets.metadata_get (transaction, germ::test_genesis_key.pub));
+		wallet2->metadata_load (transaction);
+	}
+	ASSERT_EQ (receivable, wallet2->receivable_list ());
+	{
+		germ::transaction transaction (system.nodes[0]->store.environment, nullptr, true);
+		wallet2->store.erase (transaction, key2.pub);
+		ASSERT_FALSE (wallet2->store.exists (transaction, key2.pub));
+		ASSERT_FALSE (system.nodes[0]->wallets.exists (transaction, key2.pub));
+		wallet2->metadata_update (transaction, key2.pub);
+	}
+	ASSERT_TRUE (wallet2->receivable_list ().empty ());
+}
+
+TEST (wallets, holders)
+{
+	germ::system system (24000, 1);
+	auto & wallets (system.nodes[0]->wallets);
+	auto wallet1 (system.wallet (0));
+	auto wallet2 (wallets.create (100));
+	germ::keypair key1;
+	wallet1->insert_adhoc (key1.prv);
+	ASSERT_EQ (1, wallets.holding (key1.pub).size ());
+	ASSERT_EQ (wallet1, wallets.holding (key1.pub)[0]);
+	{
+		germ::transaction transaction (system.nodes[0]->store.environment, nullptr, true);
+		wallet2->insert_watch (transaction, key1.pub);
+	}
+	ASSERT_EQ (2, wallets.holding (key1.pub).size ());
+	{
+		germ::transaction transaction (system.nodes[0]->store.environment, nullptr, true);
+		wallet1->store.erase (transaction, key1.pub);
+		ASSERT_FALSE (wallet1->store.exists (transaction, key1.pub));
+		ASSERT_TRUE (wallets.exists (transaction, key1.pub));
+	}
+	ASSERT_EQ (1, wallets.holding (key1.pub).size ());
+	wallets.destroy (100);
+	ASSERT_TRUE (wallets.holding (key1.pub).empty ());
+	ASSERT_TRUE (wallets.holders.find (key1.pub) == wallets.holders.end ());
+}
+
+TEST (signer_cache, insert)
+{
+	germ::signer_cache cache;
+	std::vector<germ::keypair> keys (germ::signer_cache::page_keys + 1);
+	for (auto & key : keys)
+	{
+		cache.insert (key.pub, key.prv);
+	}
+	// Keys survive the buffer growing past its first page
+	ASSERT_EQ (keys.size (), cache.size ());
+	for (auto & key : keys)
+	{
+		germ::raw_key prv;
+		ASSERT_TRUE (cache.find (key.pub, prv));
+		ASSERT_EQ (key.prv, prv);
+	}
+	cache.clear ();
+	ASSERT_EQ (0, cache.size ());
+	germ::raw_key prv;
+	ASSERT_FALSE (cache.find (keys[0].pub, prv));
+}
+
+TEST (signer_cache, sign)
+{
+	germ::stat stats;
+	germ::signer_pool pool (stats, 2);
+	germ::signer_cache cache;
+	germ::keypair key1;
+	germ::keypair key2;
+	ASSERT_FALSE (cache.insert (key1.pub, key1.prv));
+	germ::genesis genesis;
+	std::shared_ptr<germ::tx> block (std::move (genesis.open));
+	std::vector<std::shared_ptr<germ::vote>> votes;
+	for (auto & key : { key1.pub, key2.pub })
+	{
+		auto vote (std::make_shared<germ::vote> ());
+		vote->account = key;
+		vote->block = block;
+		votes.push_back (vote);
+	}
+	std::vector<uint8_t> signed_l (votes.size (), 0);
+	cache.sign (pool, votes, signed_l);
+	// Only the vote whose key is held is signed
+	ASSERT_EQ (1, signed_l[0]);
+	ASSERT_FALSE (votes[0]->validate ());
+	ASSERT_EQ (0, signed_l[1]);
+	ASSERT_TRUE (votes[1]->validate ());
+}
+
 TEST (wallet, password_race)
 {
 	germ::system system (24000, 1);
@@ -4,6 +4,8 @@
 
 #include <src/epoch_common.h>
 
+#include <boost/endian/conversion.hpp>
+
 
 germ::epoch_counts::epoch_counts()
         :count(0)
@@ -15,6 +17,82 @@ size_t germ::epoch_counts::sum()
     return count;
 }
 
+germ::epoch_tx_info::epoch_tx_info () :
+epoch (0),
+index (0)
+{
+}
+
+germ::epoch_tx_info::epoch_tx_info (MDB_val const & val_a)
+{
+    assert (val_a.mv_size == sizeof (*this));
+    std::copy (reinterpret_cast<uint8_t const *> (val_a.mv_data), reinterpret_cast<uint8_t const *> (val_a.mv_data) + sizeof (*this), reinterpret_cast<uint8_t *> (this));
+}
+
+germ::epoch_tx_info::epoch_tx_info (germ::epoch_hash const & epoch_a, uint64_t index_a) :
+epoch (epoch_a),
+index (index_a)
+{
+}
+
+germ::mdb_val germ::epoch_tx_info::val () const
+{
+    static_assert (sizeof (epoch) + sizeof (index) == sizeof (*this), "Packed class");
+    return germ::mdb_val (sizeof (*this), const_cast<germ::epoch_tx_info *> (this));
+}
+
+germ::epoch_height_info::epoch_height_info () :
+height (0),
+timestamp (0)
+{
+}
+
+germ::epoch_height_info::epoch_height_info (MDB_val const & val_a)
+{
+    assert (val_a.mv_size == sizeof (*this));
+    std::copy (reinterpret_cast<uint8_t const *> (val_a.mv_data), reinterpret_cast<uint8_t const *> (val_a.mv_data) + sizeof (*this), reinterpret_cast<uint8_t *> (this));
+}
+
+germ::epoch_height_info::epoch_height_info (uint64_t height_a, uint64_t timestamp_a) :
+height (height_a),
+timestamp (timestamp_a)
+{
+}
+
+germ::mdb_val germ::epoch_height_info::val () const
+{
+    static_assert (sizeof (height) + sizeof (timestamp) == sizeof (*this), "Packed class");
+    return germ::mdb_val (sizeof (*this), const_cast<germ::epoch_height_info *> (this));
+}
+
+germ::epoch_time_key::epoch_time_key (uint64_t timestamp_a, uint64_t height_a) :
+timestamp_big (boost::endian::native_to_big (timestamp_a)),
+height_big (boost::endian::native_to_big (height_a))
+{
+}
+
+germ::epoch_time_key::epoch_time_key (MDB_val const & val_a)
+{
+    assert (val_a.mv_size == sizeof (*this));
+    std::copy (reinterpret_cast<uint8_t const *> (val_a.mv_data), reinterpret_cast<uint8_t const *> (val_a.mv_data) + sizeof (*this), reinterpret_cast<uint8_t *> (this));
+}
+
+uint64_t germ::epoch_time_key::timestamp () const
+{
+    return boost::endian::big_to_native (timestamp_big);
+}
+
+uint64_t germ::epoch_time_key::height () const
+{
+    return boost::endian::big_to_native (height_big);
+}
+
+germ::mdb_val germ::epoch_time_key::val () const
+{
+    static_assert (sizeof (timestamp_big) + sizeof (height_big) == sizeof (*this), "Packed class");
+    return germ::mdb_val (sizeof (*this), const_cast<germ::epoch_time_key *> (this));
+}
+
 //germ::epoch_infos::epoch_infos ()
 //        :timestamp(0),
 //         prev(0),
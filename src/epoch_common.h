@@ -21,6 +21,49 @@ namespace germ
         size_t count;
     };
 
+    /**
+     * Epoch that included a transaction and the transaction's index in it
+     */
+    class epoch_tx_info
+    {
+    public:
+        epoch_tx_info ();
+        epoch_tx_info (MDB_val const &);
+        epoch_tx_info (germ::epoch_hash const &, uint64_t);
+        germ::mdb_val val () const;
+        germ::epoch_hash epoch;
+        uint64_t index;
+    };
+
+    /**
+     * Position of an epoch in the chain, the first epoch has height 1
+     */
+    class epoch_height_info
+    {
+    public:
+        epoch_height_info ();
+        epoch_height_info (MDB_val const &);
+        epoch_height_info (uint64_t, uint64_t);
+        germ::mdb_val val () const;
+        uint64_t height;
+        uint64_t timestamp;
+    };
+
+    /**
+     * Orders epochs by timestamp, then height. Both are stored big endian so keys sort numerically
+     */
+    class epoch_time_key
+    {
+    public:
+        epoch_time_key (uint64_t, uint64_t);
+        epoch_time_key (MDB_val const &);
+        uint64_t timestamp () const;
+        uint64_t height () const;
+        germ::mdb_val val () const;
+        uint64_t timestamp_big;
+        uint64_t height_big;
+    };
+
 //    class epoch_infos
 //    {
 //    public:
@@ -34,7 +34,11 @@ namespace
         }
         void epoch_block (germ::epoch const & epoch_r) override
         {
-            fill_value (epoch_r);
+            // The first epoch has no predecessor to link
+            if (!epoch_r.previous_epoch ().is_zero ())
+            {
+                fill_value (epoch_r);
+            }
         }
 
         MDB_txn * transaction;
@@ -178,12 +182,15 @@ germ::epoch_iterator germ::epoch_store::block_info_end ()
 
 /* ------------------------------------------- epoch_store class --------------------------------------------------------------------------------------*/
 //constructor
-germ::epoch_store::epoch_store (bool & error_a, boost::filesystem::path const & path_a, int lmdb_max_dbs) :
-        environment (error_a, path_a, lmdb_max_dbs),
+germ::epoch_store::epoch_store (bool & error_a, boost::filesystem::path const & path_a, int lmdb_max_dbs, germ::lmdb_config const & lmdb_config_a) :
+        environment (error_a, path_a, lmdb_max_dbs, lmdb_config_a),
         //frontiers (0),
         //accounts (0),
         //blocks_info (0),
         epoch_blocks (0),
+        tx_epochs (0),
+        epoch_heights (0),
+        epoch_times (0),
         checksum (0)
 {
     if (!error_a)
@@ -192,6 +199,10 @@ germ::epoch_store::epoch_store (bool & error_a, boost::filesystem::path const &
         //error_a |= mdb_dbi_open (transaction, "frontiers", MDB_CREATE, &frontiers) != 0;
         //error_a |= mdb_dbi_open (transaction, "accounts", MDB_CREATE, &accounts) != 0;
         //error_a |= mdb_dbi_open (transaction, "blocks_info", MDB_CREATE, &blocks_info) != 0;
+        error_a |= mdb_dbi_open (transaction, "epoch_blocks", MDB_CREATE, &epoch_blocks) != 0;
+        error_a |= mdb_dbi_open (transaction, "tx_epochs", MDB_CREATE, &tx_epochs) != 0;
+        error_a |= mdb_dbi_open (transaction, "epoch_heights", MDB_CREATE, &epoch_heights) != 0;
+        error_a |= mdb_dbi_open (transaction, "epoch_times", MDB_CREATE, &epoch_times) != 0;
         error_a |= mdb_dbi_open (transaction, "checksum", MDB_CREATE, &checksum) != 0;
         error_a |= mdb_dbi_open (transaction, "meta", MDB_CREATE, &meta) != 0;
         if (!error_a)
@@ -232,6 +243,22 @@ void germ::epoch_store::block_put (MDB_txn * transaction_a, germ::epoch_hash con
     set_predecessor predecessor (transaction_a, *this);
     block_a.visit (predecessor);
     assert (block_a.previous_epoch ().is_zero () || block_successor (transaction_a, block_a.previous_epoch ()) == hash_a);
+
+    // Lookup indexes, so finding the epoch of a tx or the epochs in a time span doesn't scan epoch_blocks
+    germ::epoch_height_info previous;
+    auto error (!block_a.previous_epoch ().is_zero () && !height_get (transaction_a, block_a.previous_epoch (), previous));
+    assert (!error);
+    germ::epoch_height_info info (previous.height + 1, block_a.timestamp ());
+    auto status (mdb_put (transaction_a, epoch_heights, germ::mdb_val (hash_a), info.val (), 0));
+    assert (status == 0);
+    status = mdb_put (transaction_a, epoch_times, germ::epoch_time_key (info.timestamp, info.height).val (), germ::mdb_val (hash_a), 0);
+    assert (status == 0);
+    auto & txs (block_a.txs ());
+    for (uint64_t i (0), n (txs.size ()); i < n; ++i)
+    {
+        status = mdb_put (transaction_a, tx_epochs, germ::mdb_val (txs[i]), germ::epoch_tx_info (hash_a, i).val (), 0);
+        assert (status == 0);
+    }
 }
 
 //put an epoch block into DB
@@ -273,6 +300,28 @@ MDB_val germ::epoch_store::block_get_raw (MDB_txn * transaction_a, germ::epoch_h
 //given a hash, delete a epoch block
 void germ::epoch_store::block_del (MDB_txn * transaction_a, germ::epoch_hash const & hash_a)
 {
+    auto block (block_get (transaction_a, hash_a));
+    if (block != nullptr)
+    {
+        for (auto & i : block->txs ())
+        {
+            // Only drop entries still pointing at this epoch
+            germ::epoch_tx_info info;
+            if (tx_epoch_get (transaction_a, i, info) && info.epoch == hash_a)
+            {
+                auto status (mdb_del (transaction_a, tx_epochs, germ::mdb_val (i), nullptr));
+                assert (status == 0);
+            }
+        }
+        germ::epoch_height_info info;
+        if (height_get (transaction_a, hash_a, info))
+        {
+            auto status (mdb_del (transaction_a, epoch_times, germ::epoch_time_key (info.timestamp, info.height).val (), nullptr));
+            assert (status == 0 || status == MDB_NOTFOUND);
+            status = mdb_del (transaction_a, epoch_heights, germ::mdb_val (hash_a), nullptr);
+            assert (status == 0);
+        }
+    }
     auto status_epoch (mdb_del (transaction_a, epoch_blocks, germ::mdb_val (hash_a), nullptr));
     assert (status_epoch == 0 || status_epoch == MDB_NOTFOUND);
     if (status_epoch == 0)
@@ -301,6 +350,65 @@ void germ::epoch_store::version_put (MDB_txn * transaction_a, int version_a)
     assert (status == 0);
 }
 
+bool germ::epoch_store::tx_epoch_get (MDB_txn * transaction_a, germ::block_hash const & tx_a, germ::epoch_tx_info & info_a)
+{
+    germ::mdb_val value;
+    auto status (mdb_get (transaction_a, tx_epochs, germ::mdb_val (tx_a), value));
+    assert (status == 0 || status == MDB_NOTFOUND);
+    auto result (status == 0);
+    if (result)
+    {
+        info_a = germ::epoch_tx_info (value);
+    }
+    return result;
+}
+
+bool germ::epoch_store::height_get (MDB_txn * transaction_a, germ::epoch_hash const & hash_a, germ::epoch_height_info & info_a)
+{
+    germ::mdb_val value;
+    auto status (mdb_get (transaction_a, epoch_heights, germ::mdb_val (hash_a), value));
+    assert (status == 0 || status == MDB_NOTFOUND);
+    auto result (status == 0);
+    if (result)
+    {
+        info_a = germ::epoch_height_info (value);
+    }
+    return result;
+}
+
+germ::epoch_iterator germ::epoch_store::time_begin (MDB_txn * transaction_a, uint64_t timestamp_a)
+{
+    germ::epoch_iterator result (transaction_a, epoch_times, germ::epoch_time_key (timestamp_a, 0).val ());
+    return result;
+}
+
+germ::epoch_iterator germ::epoch_store::time_end ()
+{
+    germ::epoch_iterator result (nullptr);
+    return result;
+}
+
+germ::epoch_hash germ::epoch_store::head_get (MDB_txn * transaction_a)
+{
+    germ::uint256_union head_key (4);
+    germ::mdb_val value;
+    auto status (mdb_get (transaction_a, meta, germ::mdb_val (head_key), value));
+    assert (status == 0 || status == MDB_NOTFOUND);
+    germ::epoch_hash result (0);
+    if (status == 0)
+    {
+        result = value.uint256 ();
+    }
+    return result;
+}
+
+void germ::epoch_store::head_put (MDB_txn * transaction_a, germ::epoch_hash const & head_a)
+{
+    germ::uint256_union head_key (4);
+    auto status (mdb_put (transaction_a, meta, germ::mdb_val (head_key), germ::mdb_val (head_a), 0));
+    assert (status == 0);
+}
+
 germ::raw_key germ::epoch_store::get_node_id (MDB_txn * transaction_a)
 {
     germ::uint256_union node_id_mdb_key (3);
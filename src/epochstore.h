@@ -44,7 +44,7 @@ namespace germ
     {
     public:
         //constructor
-        epoch_store (bool &, boost::filesystem::path const &, int lmdb_max_dbs = 128);
+        epoch_store (bool &, boost::filesystem::path const &, int lmdb_max_dbs = 128, germ::lmdb_config const & = germ::lmdb_config ());
 
         //create a db with epoch bloch type
         MDB_dbi block_database (germ::block_type);
@@ -103,6 +103,18 @@ namespace germ
 
         void version_put (MDB_txn *, int);
 
+        // Epoch including a tx and the tx's index in it, maintained by block_put and block_del. Returns true if found
+        bool tx_epoch_get (MDB_txn *, germ::block_hash const &, germ::epoch_tx_info &);
+        // Returns true if found
+        bool height_get (MDB_txn *, germ::epoch_hash const &, germ::epoch_height_info &);
+        // Epochs ordered by timestamp then height, the key is a germ::epoch_time_key and the value the epoch hash
+        germ::epoch_iterator time_begin (MDB_txn *, uint64_t);
+        germ::epoch_iterator time_end ();
+
+        // Latest epoch produced by this node, zero if none
+        germ::epoch_hash head_get (MDB_txn *);
+        void head_put (MDB_txn *, germ::epoch_hash const &);
+
         // Requires a write transaction
         germ::raw_key get_node_id (MDB_txn *);
 
@@ -130,6 +142,24 @@ namespace germ
          */
         MDB_dbi  epoch_blocks;
 
+        /**
+         * Maps tx hash to the epoch that included it
+         * germ::block_hash -> germ::epoch_tx_info
+         */
+        MDB_dbi tx_epochs;
+
+        /**
+         * Maps epoch hash to its height and timestamp
+         * germ::epoch_hash -> germ::epoch_height_info
+         */
+        MDB_dbi epoch_heights;
+
+        /**
+         * Maps (timestamp, height) to epoch hash
+         * germ::epoch_time_key -> germ::epoch_hash
+         */
+        MDB_dbi epoch_times;
+
 //        /**
 //         * Maps epoch hash to timestamp, previous, merkle, signature.
 //         * epoch_hash -> germ::uint64_t, germ::epoch_hash, (1, 2 ,3) germ::signature
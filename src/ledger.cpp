@@ -163,21 +163,22 @@ public:
         {
             auto hash (tx.hash ());
             germ::pending_info pending;
-            germ::pending_key key (tx.destination_, hash);
+            germ::pending_key key (tx.destination (), hash);
             while ( ledger.store.pending_get (transaction, key, pending) )
             {
-                ledger.rollback (transaction, ledger.latest (transaction, tx.destination_));
+                ledger.rollback (transaction, ledger.latest (transaction, tx.destination ()));
             }
             germ::account_info info;
             auto found (ledger.store.account_get (transaction, pending.source, info));
             assert (found);
             ledger.store.pending_del (transaction, key);
 //            ledger.store.representation_add (transaction, ledger.representative (transaction, hash), pending.amount.number ());
-            ledger.change_latest (transaction, pending.source, tx.previous_, /*info.rep_block,*/ ledger.balance (transaction, tx.previous_), info.block_count - 1);
+            ledger.change_latest (transaction, pending.source, tx.previous (), /*info.rep_block,*/ ledger.balance (transaction, tx.previous ()), info.block_count - 1);
+            ledger.store.block_height_del (transaction, pending.source, info.block_count, hash);
             ledger.store.block_del (transaction, hash);
             ledger.store.frontier_del (transaction, hash);
-            ledger.store.frontier_put (transaction, tx.previous_, pending.source);
-            ledger.store.block_successor_clear (transaction, tx.previous_);
+            ledger.store.frontier_put (transaction, tx.previous (), pending.source);
+            ledger.store.block_successor_clear (transaction, tx.previous ());
             if (!(info.block_count % ledger.store.block_info_max))
             {
                 ledger.store.block_info_del (transaction, hash);
@@ -192,19 +193,20 @@ public:
         {
             auto hash (tx.hash ());
 //        auto representative (ledger.representative (transaction, tx.hashables.previous));
-            auto amount (ledger.amount (transaction, tx.source_));
+            auto amount (ledger.amount (transaction, tx.source ()));
             auto destination_account (ledger.account (transaction, hash));
-            auto source_account (ledger.account (transaction, tx.source_));
+            auto source_account (ledger.account (transaction, tx.source ()));
             germ::account_info info;
             auto found (ledger.store.account_get (transaction, destination_account, info));
             assert (found);
 //        ledger.store.representation_add (transaction, ledger.representative (transaction, hash), 0 - amount);
-            ledger.change_latest (transaction, destination_account, tx.previous_, /*representative,*/ ledger.balance (transaction, tx.previous_), info.block_count - 1);
+            ledger.change_latest (transaction, destination_account, tx.previous (), /*representative,*/ ledger.balance (transaction, tx.previous ()), info.block_count - 1);
+            ledger.store.block_height_del (transaction, destination_account, info.block_count, hash);
             ledger.store.block_del (transaction, hash);
-            ledger.store.pending_put (transaction, germ::pending_key (destination_account, tx.source_), { source_account, amount });
+            ledger.store.pending_put (transaction, germ::pending_key (destination_account, tx.source ()), { source_account, amount });
             ledger.store.frontier_del (transaction, hash);
-            ledger.store.frontier_put (transaction, tx.previous_, destination_account);
-            ledger.store.block_successor_clear (transaction, tx.previous_);
+            ledger.store.frontier_put (transaction, tx.previous (), destination_account);
+            ledger.store.block_successor_clear (transaction, tx.previous ());
             if (!(info.block_count % ledger.store.block_info_max))
             {
                 ledger.store.block_info_del (transaction, hash);
@@ -549,42 +551,43 @@ void ledger_processor::tx(germ::tx const& tx)
         if (result.code != germ::process_result::progress)
             return;
 
-        auto previous (ledger.store.block_get (transaction, tx.previous_));
-        result.code = previous != nullptr ? germ::process_result::progress : germ::process_result::gap_previous; // Have we seen the previous block already? (Harmless)
+        germ::tx_view previous;
+        result.code = ledger.store.block_view (transaction, tx.previous (), previous) ? germ::process_result::progress : germ::process_result::gap_previous; // Have we seen the previous block already? (Harmless)
         if (result.code != germ::process_result::progress)
             return;
 
-        result.code = tx.valid_predecessor (*previous) ? germ::process_result::progress : germ::process_result::block_position;
+        result.code = tx.valid_predecessor (previous) ? germ::process_result::progress : germ::process_result::block_position;
         if (result.code != germ::process_result::progress)
             return;
 
-        auto account (ledger.store.frontier_get (transaction, tx.previous_));
+        auto account (ledger.store.frontier_get (transaction, tx.previous ()));
         result.code = account.is_zero () ? germ::process_result::fork : germ::process_result::progress;
         if (result.code != germ::process_result::progress)
             return;
 
-        result.code = validate_message (tx.account_, hash, tx.signature) ? germ::process_result::bad_signature : germ::process_result::progress; // Is this block signed correctly (Malformed)
+        result.code = validate_message (tx.account (), hash, tx.signature) ? germ::process_result::bad_signature : germ::process_result::progress; // Is this block signed correctly (Malformed)
         if (result.code != germ::process_result::progress)
             return;
 
         germ::account_info info;
         auto latest_found (ledger.store.account_get (transaction, account, info));
         assert (latest_found);
-        assert (info.head == tx.previous_);
-        result.code = info.balance.number () >= tx.balance_.number () ? germ::process_result::progress : germ::process_result::negative_spend; // Is this trying to spend a negative amount (Malicious)
+        assert (info.head == tx.previous ());
+        result.code = info.balance.number () >= tx.balance ().number () ? germ::process_result::progress : germ::process_result::negative_spend; // Is this trying to spend a negative amount (Malicious)
         if (result.code != germ::process_result::progress)
             return;
 
-        auto amount (info.balance.number () - tx.balance_.number ());
+        auto amount (info.balance.number () - tx.balance ().number ());
 //    ledger.store.representation_add (transaction, info.rep_block, 0 - amount);
         ledger.store.block_put (transaction, hash, tx);
-        ledger.change_latest (transaction, account, hash, /*info.rep_block,*/ tx.balance_, info.block_count + 1);
-        ledger.store.pending_put (transaction, germ::pending_key (tx.destination_, hash), { account, amount });
-        ledger.store.frontier_del (transaction, tx.previous_);
+        ledger.store.block_height_put (transaction, account, info.block_count + 1, hash);
+        ledger.change_latest (transaction, account, hash, /*info.rep_block,*/ tx.balance (), info.block_count + 1);
+        ledger.store.pending_put (transaction, germ::pending_key (tx.destination (), hash), { account, amount });
+        ledger.store.frontier_del (transaction, tx.previous ());
         ledger.store.frontier_put (transaction, hash, account);
         result.account = account;
         result.amount = amount;
-        result.pending_account = tx.destination_;
+        result.pending_account = tx.destination ();
         ledger.stats.inc (germ::stat::type::ledger, germ::stat::detail::send);
     }
     else if(tx_type == germ::block_type::vote)
@@ -599,37 +602,37 @@ void ledger_processor::tx(germ::tx const& tx)
         if (result.code != germ::process_result::progress)
             return;
 
-        auto previous (ledger.store.block_get (transaction, tx.previous_));
-        if (previous != nullptr)
+        germ::tx_view previous;
+        if (ledger.store.block_view (transaction, tx.previous (), previous))
         {
             result.code = germ::process_result::progress;
         }
         else
         {
-            if (tx.previous_ == tx.account_)
+            if (tx.previous () == tx.account ())
             {
-                auto source_missing (!ledger.store.block_exists (transaction, tx.source_));
+                auto source_missing (!ledger.store.block_exists (transaction, tx.source ()));
                 result.code = source_missing ? germ::process_result::gap_source : germ::process_result::progress; // Have we seen the source block? (Harmless)
                 if (result.code != germ::process_result::progress)
                     return;
 
-                result.code = germ::validate_message (tx.account_, hash, tx.signature) ? germ::process_result::bad_signature : germ::process_result::progress; // Is the signature valid (Malformed)
+                result.code = germ::validate_message (tx.account (), hash, tx.signature) ? germ::process_result::bad_signature : germ::process_result::progress; // Is the signature valid (Malformed)
                 if (result.code != germ::process_result::progress)
                     return;
 
                 germ::account_info info;
-                result.code = (!ledger.store.account_get (transaction, tx.account_, info)) ? germ::process_result::progress : germ::process_result::fork; // Has this account already been opened? (Malicious)
+                result.code = (!ledger.store.account_get (transaction, tx.account (), info)) ? germ::process_result::progress : germ::process_result::fork; // Has this account already been opened? (Malicious)
                 if (result.code != germ::process_result::progress)
                     return;
 
 //                auto latest(ledger.latest(transaction, tx.source_));
-                germ::pending_key key (tx.account_, tx.source_);
+                germ::pending_key key (tx.account (), tx.source ());
                 germ::pending_info pending;
                 result.code = (!ledger.store.pending_get (transaction, key, pending)) ? germ::process_result::unreceivable : germ::process_result::progress; // Has this source already been received (Malformed)
                 if (result.code != germ::process_result::progress)
                     return;
 
-                result.code = tx.account_ == germ::burn_account ? germ::process_result::opened_burn_account : germ::process_result::progress; // Is it burning 0 account? (Malicious)
+                result.code = tx.account () == germ::burn_account ? germ::process_result::opened_burn_account : germ::process_result::progress; // Is it burning 0 account? (Malicious)
                 if (result.code != germ::process_result::progress)
                     return;
 
@@ -638,9 +641,10 @@ void ledger_processor::tx(germ::tx const& tx)
                 assert (found);
                 ledger.store.pending_del (transaction, key);
                 ledger.store.block_put (transaction, hash, tx);
-                ledger.change_latest (transaction, tx.account_, hash, pending.amount.number (), info.block_count + 1);
-                ledger.store.frontier_put (transaction, hash, tx.account_);
-                result.account = tx.account_;
+                ledger.store.block_height_put (transaction, tx.account (), info.block_count + 1, hash);
+                ledger.change_latest (transaction, tx.account (), hash, pending.amount.number (), info.block_count + 1);
+                ledger.store.frontier_put (transaction, hash, tx.account ());
+                result.account = tx.account ();
                 result.amount = pending.amount;
                 ledger.stats.inc (germ::stat::type::ledger, germ::stat::detail::receive);
                 return;
@@ -653,34 +657,34 @@ void ledger_processor::tx(germ::tx const& tx)
             return;
 
 
-        result.code = tx.valid_predecessor (*previous) ? germ::process_result::progress : germ::process_result::block_position;
+        result.code = tx.valid_predecessor (previous) ? germ::process_result::progress : germ::process_result::block_position;
         if (result.code != germ::process_result::progress)
             return;
 
 //        auto latest (ledger.latest (transaction, tx.source_));
-        result.code = ledger.store.block_exists (transaction, tx.source_) ? germ::process_result::progress : germ::process_result::gap_source; // Have we seen the source block already? (Harmless)
+        result.code = ledger.store.block_exists (transaction, tx.source ()) ? germ::process_result::progress : germ::process_result::gap_source; // Have we seen the source block already? (Harmless)
         if (result.code != germ::process_result::progress)
             return;
 
-        auto account (ledger.store.frontier_get (transaction, tx.previous_));
+        auto account (ledger.store.frontier_get (transaction, tx.previous ()));
         result.code = account.is_zero () ? germ::process_result::gap_previous : germ::process_result::progress; //Have we seen the previous block? No entries for account at all (Harmless)
         if (result.code != germ::process_result::progress)
         {
-            result.code = ledger.store.block_exists (transaction, tx.previous_) ? germ::process_result::fork : germ::process_result::gap_previous; // If we have the block but it's not the latest we have a signed fork (Malicious)
+            result.code = ledger.store.block_exists (transaction, tx.previous ()) ? germ::process_result::fork : germ::process_result::gap_previous; // If we have the block but it's not the latest we have a signed fork (Malicious)
             return;
         }
 
-        result.code = germ::validate_message (tx.account_, hash, tx.signature) ? germ::process_result::bad_signature : germ::process_result::progress; // Is the signature valid (Malformed)
+        result.code = germ::validate_message (tx.account (), hash, tx.signature) ? germ::process_result::bad_signature : germ::process_result::progress; // Is the signature valid (Malformed)
         if (result.code != germ::process_result::progress)
             return;
 
         germ::account_info info;
         ledger.store.account_get (transaction, account, info);
-        result.code = info.head == tx.previous_ ? germ::process_result::progress : germ::process_result::gap_previous; // Block doesn't immediately follow latest block (Harmless)
+        result.code = info.head == tx.previous () ? germ::process_result::progress : germ::process_result::gap_previous; // Block doesn't immediately follow latest block (Harmless)
         if (result.code != germ::process_result::progress)
             return;
 
-        germ::pending_key key (account, tx.source_);
+        germ::pending_key key (account, tx.source ());
         germ::pending_info pending;
         result.code = (!ledger.store.pending_get (transaction, key, pending)) ? germ::process_result::unreceivable : germ::process_result::progress; // Has this source already been received (Malformed)
         if (result.code != germ::process_result::progress)
@@ -692,8 +696,9 @@ void ledger_processor::tx(germ::tx const& tx)
         assert (found);
         ledger.store.pending_del (transaction, key);
         ledger.store.block_put (transaction, hash, tx);
+        ledger.store.block_height_put (transaction, account, info.block_count + 1, hash);
         ledger.change_latest (transaction, account, hash, new_balance, info.block_count + 1);
-        ledger.store.frontier_del (transaction, tx.previous_);
+        ledger.store.frontier_del (transaction, tx.previous ());
         ledger.store.frontier_put (transaction, hash, account);
         result.account = account;
         result.amount = pending.amount;
@@ -784,14 +789,7 @@ germ::uint128_t germ::ledger::account_balance (MDB_txn * transaction_a, germ::ac
 
 germ::uint128_t germ::ledger::account_pending (MDB_txn * transaction_a, germ::account const & account_a)
 {
-    germ::uint128_t result (0);
-    germ::account end (account_a.number () + 1);
-    for (auto i (store.pending_begin (transaction_a, germ::pending_key (account_a, 0))), n (store.pending_begin (transaction_a, germ::pending_key (end, 0))); i != n; ++i)
-    {
-        germ::pending_info info (i->second);
-        result += info.amount.number ();
-    }
-    return result;
+    return store.receivable_get (transaction_a, account_a).total.number ();
 }
 
 germ::process_return germ::ledger::process (MDB_txn * transaction_a, germ::tx const & tx)
@@ -842,10 +840,10 @@ std::string germ::ledger::block_text (germ::block_hash const & hash_a)
 bool germ::ledger::is_send (MDB_txn * transaction_a, germ::tx const & tx)
 {
     bool result (false);
-    germ::block_hash previous (tx.previous_);
+    germ::block_hash previous (tx.previous ());
     if (!previous.is_zero ())
     {
-        if (tx.balance_ < balance (transaction_a, previous))
+        if (tx.balance () < balance (transaction_a, previous))
         {
             result = true;
         }
@@ -867,7 +865,7 @@ germ::block_hash germ::ledger::block_destination (MDB_txn * transaction_a, germ:
 //        result = state_block->hashables.link;
 //    }
 
-    result = tx.destination_;
+    result = tx.destination ();
 
     return result;
 }
@@ -888,10 +886,12 @@ germ::block_hash germ::ledger::block_source (MDB_txn * transaction_a, germ::tx c
 // Vote weight of an account
 germ::uint128_t germ::ledger::weight (MDB_txn * transaction_a, germ::account const & account_a)
 {
+    // The cache only holds committed weights, a transaction with its own pending changes reads them from the store
+    auto uncommitted (store.environment.uncommitted (transaction_a));
     if (check_bootstrap_weights.load ())
     {
-        auto blocks = store.block_count (transaction_a);
-        if (blocks.sum () < bootstrap_weight_max_blocks)
+        auto blocks (uncommitted ? store.block_count (transaction_a).sum () : store.block_count_cached ());
+        if (blocks < bootstrap_weight_max_blocks)
         {
             auto weight = bootstrap_weights.find (account_a);
             if (weight != bootstrap_weights.end ())
@@ -904,8 +904,7 @@ germ::uint128_t germ::ledger::weight (MDB_txn * transaction_a, germ::account con
             check_bootstrap_weights = false;
         }
     }
-//    return store.representation_get (transaction_a, account_a);
-    return 0;
+    return uncommitted ? store.representation_get (transaction_a, account_a) : store.representation_cached (account_a);
 }
 
 // Rollback blocks until `tx' doesn't exist
@@ -927,25 +926,33 @@ void germ::ledger::rollback (MDB_txn * transaction_a, germ::block_hash const & t
 // Return account containing hash
 germ::account germ::ledger::account (MDB_txn * transaction_a, germ::block_hash const & hash_a)
 {
+    germ::height_info height_info;
+    if (store.block_height_get (transaction_a, hash_a, height_info))
+    {
+        return height_info.account;
+    }
     germ::account result;
     auto hash (hash_a);
     germ::block_hash successor (1);
     germ::block_info block_info;
-    std::unique_ptr<germ::tx> block (store.block_get (transaction_a, hash));
-    while (!successor.is_zero () && block->type () != germ::block_type::state && !store.block_info_get (transaction_a, successor, block_info))
+    germ::tx_view block;
+    auto found (store.block_view (transaction_a, hash, block));
+    assert (found);
+    while (!successor.is_zero () && block.type () != germ::block_type::state && !store.block_info_get (transaction_a, successor, block_info))
     {
         successor = store.block_successor (transaction_a, hash);
         if (!successor.is_zero ())
         {
             hash = successor;
-            block = store.block_get (transaction_a, hash);
+            found = store.block_view (transaction_a, hash, block);
+            assert (found);
         }
     }
-    if (block->type () == germ::block_type::state)
+    if (block.type () == germ::block_type::state)
     {
 //        auto state_block (dynamic_cast<germ::state_block *> (block.get ()));
 //        result = state_block->hashables.account;
-        result = block.get()->destination_;
+        result = block.destination ();
     }
     else if (successor.is_zero ())
     {
@@ -1026,6 +1033,17 @@ void germ::ledger::change_latest (MDB_txn * transaction_a, germ::account const &
 {
     germ::account_info info;
     auto exists (store.account_get (transaction_a, account_a, info));
+    // Accounts represent themselves, so weight follows the balance
+    germ::uint128_t previous_balance (exists ? info.balance.number () : 0);
+    germ::uint128_t balance (hash_a.is_zero () ? 0 : balance_a.number ());
+    if (balance > previous_balance)
+    {
+        store.representation_add (transaction_a, account_a, balance - previous_balance);
+    }
+    else if (balance < previous_balance)
+    {
+        store.representation_sub (transaction_a, account_a, previous_balance - balance);
+    }
     if (exists)
     {
         checksum_update (transaction_a, info.head);
@@ -1173,7 +1173,7 @@ std::unique_ptr<germ::tx> germ::deserialize_block_json (boost::property_tree::pt
         auto type (tree_a.get<std::string> ("type"));
         if (type == "receive")
         {
-            bool error;
+            bool error (false);
             std::unique_ptr<germ::tx> obj (new germ::tx (error, tree_a));
             if (error)
                 return result;
@@ -1182,7 +1182,7 @@ std::unique_ptr<germ::tx> germ::deserialize_block_json (boost::property_tree::pt
         }
         else if (type == "send")
         {
-            bool error;
+            bool error (false);
             std::unique_ptr<germ::tx> obj (new germ::tx (error, tree_a));
             if (error)
                 return result;
@@ -1191,7 +1191,7 @@ std::unique_ptr<germ::tx> germ::deserialize_block_json (boost::property_tree::pt
         }
         else if (type == "open")
         {
-            bool error;
+            bool error (false);
             std::unique_ptr<germ::tx> obj (new germ::tx (error, tree_a));
             if (error)
                 return result;
@@ -1200,7 +1200,7 @@ std::unique_ptr<germ::tx> germ::deserialize_block_json (boost::property_tree::pt
         }
         else if (type == "change")
         {
-            bool error;
+            bool error (false);
             std::unique_ptr<germ::tx> obj (new germ::tx (error, tree_a));
             if (error)
                 return result;
@@ -1209,7 +1209,7 @@ std::unique_ptr<germ::tx> germ::deserialize_block_json (boost::property_tree::pt
         }
         else if (type == "vote")
         {
-            bool error;
+            bool error (false);
             std::unique_ptr<germ::tx> obj (new germ::tx (error, tree_a));
             if (error)
                 return result;
@@ -1218,7 +1218,7 @@ std::unique_ptr<germ::tx> germ::deserialize_block_json (boost::property_tree::pt
         }
         else if (type == "state")
         {
-            bool error;
+            bool error (false);
             std::unique_ptr<germ::tx> obj (new germ::tx (error, tree_a));
             if (error)
                 return result;
@@ -1232,6 +1232,22 @@ std::unique_ptr<germ::tx> germ::deserialize_block_json (boost::property_tree::pt
     return result;
 }
 
+std::unique_ptr<germ::tx> germ::deserialize_block_json (germ::json_value const & value_a)
+{
+    std::unique_ptr<germ::tx> result;
+    std::string type;
+    if (value_a.get ("type", type) && (type == "send" || type == "receive" || type == "open" || type == "change" || type == "vote" || type == "state"))
+    {
+        bool error (false);
+        std::unique_ptr<germ::tx> obj (new germ::tx (error, value_a));
+        if (!error)
+        {
+            result = std::move (obj);
+        }
+    }
+    return result;
+}
+
 std::unique_ptr<germ::tx> germ::deserialize_block (germ::stream & stream_a)
 {
     germ::block_type type;
@@ -1256,7 +1272,7 @@ std::unique_ptr<germ::tx> germ::deserialize_block (germ::stream & stream_a, germ
     {
         case germ::block_type::receive:
         {
-            bool error;
+            bool error (false);
             std::unique_ptr<germ::tx> obj (new germ::tx (error, stream_a));
             if (error)
                 return result;
@@ -1266,7 +1282,7 @@ std::unique_ptr<germ::tx> germ::deserialize_block (germ::stream & stream_a, germ
         }
         case germ::block_type::send:
         {
-            bool error;
+            bool error (false);
             std::unique_ptr<germ::tx> obj (new germ::tx (error, stream_a));
             if (error)
                 return result;
@@ -1276,7 +1292,7 @@ std::unique_ptr<germ::tx> germ::deserialize_block (germ::stream & stream_a, germ
         }
         case germ::block_type::open:
         {
-            bool error;
+            bool error (false);
             std::unique_ptr<germ::tx> obj (new germ::tx (error, stream_a));
             if (error)
                 return result;
@@ -1286,7 +1302,7 @@ std::unique_ptr<germ::tx> germ::deserialize_block (germ::stream & stream_a, germ
         }
         case germ::block_type::change:
         {
-            bool error;
+            bool error (false);
             std::unique_ptr<germ::tx> obj (new germ::tx (error, stream_a));
             if (error)
                 return result;
@@ -1296,7 +1312,7 @@ std::unique_ptr<germ::tx> germ::deserialize_block (germ::stream & stream_a, germ
         }
         case germ::block_type::vote:
         {
-            bool error;
+            bool error (false);
             std::unique_ptr<germ::tx> obj (new germ::tx (error, stream_a));
             if (error)
                 return result;
@@ -1306,7 +1322,7 @@ std::unique_ptr<germ::tx> germ::deserialize_block (germ::stream & stream_a, germ
         }
         case germ::block_type::state:
         {
-            bool error;
+            bool error (false);
             std::unique_ptr<germ::tx> obj (new germ::tx (error, stream_a));
             if (error)
                 return result;
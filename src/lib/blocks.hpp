@@ -9,6 +9,7 @@
 
 namespace germ
 {
+class json_value;
 class tx;
 std::string to_string(std::vector<uint8_t> const & vector);
 void to_vector(std::vector<uint8_t> & vec, std::string const & str);
@@ -309,5 +310,6 @@ public:
 std::unique_ptr<germ::tx> deserialize_block (germ::stream &);
 std::unique_ptr<germ::tx> deserialize_block (germ::stream &, germ::block_type);
 std::unique_ptr<germ::tx> deserialize_block_json (boost::property_tree::ptree const &);
+std::unique_ptr<germ::tx> deserialize_block_json (germ::json_value const &);
 void serialize_block (germ::stream &, germ::tx const &);
 }
@@ -6,6 +6,128 @@
 #include <src/epochstore.h>
 #include <src/ledger.hpp>
 
+#include <algorithm>
+#include <thread>
+
+size_t constexpr germ::merkle_tree::parallel_leaves;
+
+germ::merkle_tree::merkle_tree (std::vector<germ::block_hash> const & txs_a)
+{
+    std::vector<germ::uint256_union> leaves (txs_a.size ());
+    auto hash_range ([&txs_a, &leaves](size_t begin_a, size_t end_a) {
+        for (auto i (begin_a); i < end_a; ++i)
+        {
+            leaves[i] = leaf (txs_a[i]);
+        }
+    });
+    auto threads (std::max<size_t> (1, std::min<size_t> (std::thread::hardware_concurrency (), txs_a.size () / parallel_leaves)));
+    if (threads > 1)
+    {
+        auto chunk ((txs_a.size () + threads - 1) / threads);
+        std::vector<std::thread> helpers;
+        for (size_t i (1); i < threads; ++i)
+        {
+            helpers.push_back (std::thread (hash_range, i * chunk, std::min (txs_a.size (), (i + 1) * chunk)));
+        }
+        hash_range (0, chunk);
+        for (auto & i : helpers)
+        {
+            i.join ();
+        }
+    }
+    else
+    {
+        hash_range (0, txs_a.size ());
+    }
+    levels.push_back (std::move (leaves));
+    while (levels.back ().size () > 1)
+    {
+        auto & below (levels.back ());
+        std::vector<germ::uint256_union> level;
+        level.reserve ((below.size () + 1) / 2);
+        for (size_t i (0); i < below.size (); i += 2)
+        {
+            level.push_back (i + 1 < below.size () ? node (below[i], below[i + 1]) : below[i]);
+        }
+        levels.push_back (std::move (level));
+    }
+}
+
+germ::uint256_union germ::merkle_tree::root () const
+{
+    return levels.back ().empty () ? germ::uint256_union (0) : levels.back ().front ();
+}
+
+std::vector<germ::uint256_union> germ::merkle_tree::proof (size_t index_a) const
+{
+    assert (index_a < levels.front ().size ());
+    std::vector<germ::uint256_union> result;
+    for (size_t i (0); i + 1 < levels.size (); ++i)
+    {
+        auto sibling (index_a ^ 1);
+        if (sibling < levels[i].size ())
+        {
+            result.push_back (levels[i][sibling]);
+        }
+        index_a /= 2;
+    }
+    return result;
+}
+
+bool germ::merkle_tree::verify (germ::block_hash const & tx_a, size_t index_a, size_t count_a, std::vector<germ::uint256_union> const & proof_a, germ::uint256_union const & root_a)
+{
+    auto result (index_a < count_a);
+    auto current (leaf (tx_a));
+    auto sibling (proof_a.begin ());
+    for (auto count (count_a); result && count > 1; count = (count + 1) / 2, index_a /= 2)
+    {
+        if (index_a % 2 == 1 || index_a + 1 < count)
+        {
+            result = sibling != proof_a.end ();
+            if (result)
+            {
+                current = index_a % 2 == 1 ? node (*sibling, current) : node (current, *sibling);
+                ++sibling;
+            }
+        }
+    }
+    return result && sibling == proof_a.end () && current == root_a;
+}
+
+germ::uint256_union germ::merkle_tree::leaf (germ::block_hash const & tx_a)
+{
+    germ::uint256_union result;
+    uint8_t prefix (0);
+    blake2b_state hash;
+    auto status (blake2b_init (&hash, sizeof (result.bytes)));
+    assert (status == 0);
+    status = blake2b_update (&hash, &prefix, sizeof (prefix));
+    assert (status == 0);
+    status = blake2b_update (&hash, tx_a.bytes.data (), sizeof (tx_a.bytes));
+    assert (status == 0);
+    status = blake2b_final (&hash, result.bytes.data (), sizeof (result.bytes));
+    assert (status == 0);
+    return result;
+}
+
+germ::uint256_union germ::merkle_tree::node (germ::uint256_union const & left_a, germ::uint256_union const & right_a)
+{
+    germ::uint256_union result;
+    uint8_t prefix (1);
+    blake2b_state hash;
+    auto status (blake2b_init (&hash, sizeof (result.bytes)));
+    assert (status == 0);
+    status = blake2b_update (&hash, &prefix, sizeof (prefix));
+    assert (status == 0);
+    status = blake2b_update (&hash, left_a.bytes.data (), sizeof (left_a.bytes));
+    assert (status == 0);
+    status = blake2b_update (&hash, right_a.bytes.data (), sizeof (right_a.bytes));
+    assert (status == 0);
+    status = blake2b_final (&hash, result.bytes.data (), sizeof (result.bytes));
+    assert (status == 0);
+    return result;
+}
+
 /* ------------------------------------------------------ Constructors ------------------------------------------------------------------*/
 // default constructor
 germ::epoch::epoch()
@@ -13,6 +135,7 @@ germ::epoch::epoch()
 {
     prev_.clear();
     signature_.clear();
+    rehash();
 }
 
 // constructor to set all member variables with input parameters
@@ -29,6 +152,7 @@ germ::epoch::epoch(uint64_t timestamp_r,
  pre_votes_(pre_votes_r),
  votes_(votes_r)
 {
+    rehash();
 }
 
 // constructor using stream as input
@@ -52,6 +176,24 @@ germ::epoch::epoch(bool & error, boost::property_tree::ptree const & tree_r)
 
 /* operations */
 germ::epoch_hash germ::epoch::hash() const
+{
+#ifdef GERMBLOCKS_HASH_CHECK
+    if (hash_ != compute_hash () || root_ != germ::merkle_tree (txs_).root ())
+    {
+        std::cerr << "Stale cached hash for epoch " << hash_.to_string () << std::endl;
+        std::abort ();
+    }
+#endif
+    return hash_;
+}
+
+void germ::epoch::rehash()
+{
+    root_ = germ::merkle_tree (txs_).root ();
+    hash_ = compute_hash ();
+}
+
+germ::epoch_hash germ::epoch::compute_hash() const
 {
     germ::uint256_union result;
     blake2b_state hash_;
@@ -81,11 +223,9 @@ void germ::epoch::hash(blake2b_state &hash_r) const
     status = blake2b_update (&hash_r, signature_.bytes.data (), sizeof (signature_.bytes));
     assert (status == 0);
 
-    for(auto tx:txs_)
-    {
-        status = blake2b_update (&hash_r, tx.bytes.data (), sizeof (tx.bytes));
-        assert(status ==0);
-    }
+    // Transactions are committed through their Merkle root so inclusion can be proven without the whole list
+    status = blake2b_update (&hash_r, root_.bytes.data (), sizeof (root_.bytes));
+    assert (status == 0);
 
     for(auto pre_vote:pre_votes_)
     {
@@ -121,7 +261,7 @@ void germ::epoch::serialize(germ::stream & stream_r) const
     for(germ::signature i : pre_votes_)
         write (stream_r, i.bytes);
 
-    uint32_t votes_len = (uint32_t) pre_votes_.size();
+    uint32_t votes_len = (uint32_t) votes_.size();
     write(stream_r, votes_len);
     for(germ::signature i : votes_)
         write (stream_r, i.bytes);
@@ -187,51 +327,48 @@ bool germ::epoch::deserialize(germ::stream &stream_r)
         if (error)
             return error;
         else
-            pre_votes_.push_back(vote_holder);
+            votes_.push_back(vote_holder);
     }
 
     error = germ::read(stream_r, signature_.bytes);
+    if (!error)
+        rehash();
 
     return error;
 }
 
 void germ::epoch::serialize_json(std::string &string) const
 {
-    boost::property_tree::ptree tree;
-    tree.put("type", "epoch");
-
-    std::string time(germ::to_string_hex(timestamp_));
-    tree.put("timestamp", time);
+    germ::json_writer writer;
+    serialize_json(writer);
+    string = std::move(writer.output);
+}
 
-    std::string previous_r;
-    prev_.encode_hex(previous_r);
-    tree.put("previous", previous_r);
+void germ::epoch::serialize_json(germ::json_writer &writer) const
+{
+    writer.begin_object();
+    writer.value("type", "epoch");
+    writer.value("timestamp", germ::to_string_hex(timestamp_));
+    writer.value("previous", prev_.to_string());
 
-    // fill the "txs" sub-tree, and put it in tree
-    boost::property_tree::ptree txs_r;
-    for(germ::epoch_hash i : txs_)
-        txs_r.put(i.to_string(),"");
-    tree.put_child("txs",txs_r);
+    // txs, pre_votes and votes are objects keyed by hash with empty values
+    writer.begin_object("txs");
+    for(germ::epoch_hash const & i : txs_)
+        writer.value(i.to_string(), "");
+    writer.end_object();
 
-    // fill the "pre_votes" sub-tree, and put it in tree
-    boost::property_tree::ptree pre_votes_r;
-    for(germ::signature i : pre_votes_)
-        pre_votes_r.put(i.to_string(),"");
-    tree.put_child("pre_votes",pre_votes_r);
+    writer.begin_object("pre_votes");
+    for(germ::signature const & i : pre_votes_)
+        writer.value(i.to_string(), "");
+    writer.end_object();
 
-    // fill the "votes" sub-tree, and put it in tree
-    boost::property_tree::ptree votes_r;
-    for(germ::signature i : votes_)
-        votes_r.put(i.to_string(),"");
-    tree.put_child("votes",votes_r);
-
-    std::string signature_r;
-    signature_.encode_hex(signature_r);
-    tree.put("signature", signature_r);
+    writer.begin_object("votes");
+    for(germ::signature const & i : votes_)
+        writer.value(i.to_string(), "");
+    writer.end_object();
 
-    std::stringstream ostream;
-    boost::property_tree::write_json(ostream, tree);
-    string = ostream.str();
+    writer.value("signature", signature_.to_string());
+    writer.end_object();
 }
 
 bool germ::epoch::deserialize_json(boost::property_tree::ptree const &tree_r)
@@ -269,6 +406,8 @@ bool germ::epoch::deserialize_json(boost::property_tree::ptree const &tree_r)
             votes_.push_back(germ::signature(i->first));
 
         error = signature_.decode_hex(signature_r);
+        if (!error)
+            rehash();
     }
     catch (std::runtime_error const &)
     {
@@ -280,7 +419,49 @@ bool germ::epoch::deserialize_json(boost::property_tree::ptree const &tree_r)
 
 germ::block_hash germ::epoch::previous_epoch() const
 {
-    return germ::block_hash(0);
+    return prev_;
+}
+
+germ::uint256_union germ::epoch::merkle_root() const
+{
+    return root_;
+}
+
+germ::uint256_union germ::epoch::pre_vote_hash() const
+{
+    germ::uint256_union result;
+    blake2b_state hash_;
+    auto status (blake2b_init (&hash_, sizeof (result.bytes)));
+    assert (status == 0);
+    status = blake2b_update (&hash_, prev_.bytes.data (), sizeof (prev_.bytes));
+    assert (status == 0);
+    status = blake2b_update (&hash_, &timestamp_, sizeof (timestamp_));
+    assert (status == 0);
+    auto root (merkle_root ());
+    status = blake2b_update (&hash_, root.bytes.data (), sizeof (root.bytes));
+    assert (status == 0);
+    status = blake2b_final (&hash_, result.bytes.data (), sizeof (result.bytes));
+    assert (status == 0);
+    return result;
+}
+
+germ::uint256_union germ::epoch::vote_hash() const
+{
+    germ::uint256_union result;
+    blake2b_state hash_;
+    auto status (blake2b_init (&hash_, sizeof (result.bytes)));
+    assert (status == 0);
+    auto pre_vote (pre_vote_hash ());
+    status = blake2b_update (&hash_, pre_vote.bytes.data (), sizeof (pre_vote.bytes));
+    assert (status == 0);
+    for (auto & i : pre_votes_)
+    {
+        status = blake2b_update (&hash_, i.bytes.data (), sizeof (i.bytes));
+        assert (status == 0);
+    }
+    status = blake2b_final (&hash_, result.bytes.data (), sizeof (result.bytes));
+    assert (status == 0);
+    return result;
 }
 
 bool germ::epoch::operator==(germ::epoch const &other_r) const
@@ -324,17 +505,17 @@ germ::epoch_hash germ::epoch::prev() const
 }
 
 
-std::vector<germ::block_hash> germ::epoch::txs() const
+std::vector<germ::block_hash> const & germ::epoch::txs() const
 {
     return txs_;
 }
 
-std::vector<germ::signature> germ::epoch::pre_votes() const
+std::vector<germ::signature> const & germ::epoch::pre_votes() const
 {
     return pre_votes_;
 }
 
-std::vector<germ::signature> germ::epoch::votes() const
+std::vector<germ::signature> const & germ::epoch::votes() const
 {
     return votes_;
 }
@@ -353,26 +534,31 @@ void germ::epoch::set_timestamp(uint64_t const & timestamp_r)
 void germ::epoch::set_prev(germ::epoch_hash const & prev_r)
 {
     prev_ = prev_r;
+    hash_ = compute_hash();
 }
 
 void germ::epoch::set_txs(std::vector<germ::block_hash> const & txs_r)
 {
     txs_ = txs_r;
+    rehash();
 }
 
 void germ::epoch::set_pre_votes(std::vector<germ::signature> const & pre_votes_r)
 {
     pre_votes_ = pre_votes_r;
+    hash_ = compute_hash();
 }
 
 void germ::epoch::set_votes(std::vector<germ::signature> const & votes_r)
 {
     votes_ = votes_r;
+    hash_ = compute_hash();
 }
 
 void germ::epoch::set_signature(germ::uint512_union const &signature_r)
 {
     signature_ = signature_r;
+    hash_ = compute_hash();
 }
 
 bool germ::epoch::valid_predecessor(germ::epoch const & epoch_r) const
@@ -413,6 +599,93 @@ size_t germ::epoch::size() const
 //    return germ::mdb_val (sizeof (*this), const_cast<germ::epoch*> (this));
 //}
 
+size_t constexpr germ::epoch_validator::parallel_epochs;
+
+std::vector<bool> germ::epoch_validator::validate (std::vector<germ::epoch const *> const & epochs_a, std::vector<std::vector<germ::account>> const & witnesses_a)
+{
+    assert (epochs_a.size () == witnesses_a.size ());
+    germ::signature zero;
+    zero.clear ();
+    // Written from several threads so not a vector<bool>
+    std::vector<uint8_t> valid (epochs_a.size (), 0);
+    auto validate_range ([&](size_t begin_a, size_t end_a) {
+        // Two messages per epoch, reserved so the pointers into it stay put
+        std::vector<germ::uint256_union> hashes;
+        hashes.reserve (2 * (end_a - begin_a));
+        std::vector<unsigned char const *> messages;
+        std::vector<unsigned char const *> pub_keys;
+        std::vector<unsigned char const *> signatures;
+        std::vector<size_t> owners;
+        auto add ([&](std::vector<germ::signature> const & signatures_a, std::vector<germ::account> const & witnesses_a, size_t owner_a) {
+            for (size_t i (0); i < signatures_a.size (); ++i)
+            {
+                if (signatures_a[i] != zero)
+                {
+                    messages.push_back (hashes.back ().bytes.data ());
+                    pub_keys.push_back (witnesses_a[i].bytes.data ());
+                    signatures.push_back (signatures_a[i].bytes.data ());
+                    owners.push_back (owner_a);
+                }
+            }
+        });
+        for (auto i (begin_a); i < end_a; ++i)
+        {
+            auto & epoch (*epochs_a[i]);
+            auto & witnesses (witnesses_a[i]);
+            auto & pre_votes (epoch.pre_votes ());
+            auto & votes (epoch.votes ());
+            auto needed (quorum (witnesses.size ()));
+            auto pre_vote_count (pre_votes.size () - std::count (pre_votes.begin (), pre_votes.end (), zero));
+            auto vote_count (votes.size () - std::count (votes.begin (), votes.end (), zero));
+            // Epochs without enough signatures are rejected before verifying any of them
+            if (pre_votes.size () <= witnesses.size () && votes.size () <= witnesses.size () && pre_vote_count >= needed && vote_count >= needed)
+            {
+                valid[i] = 1;
+                hashes.push_back (epoch.pre_vote_hash ());
+                add (pre_votes, witnesses, i);
+                hashes.push_back (epoch.vote_hash ());
+                add (votes, witnesses, i);
+            }
+        }
+        if (!messages.empty ())
+        {
+            std::vector<size_t> lengths (messages.size (), sizeof (germ::uint256_union));
+            std::vector<int> verifications (messages.size (), 0);
+            germ::validate_message_batch (messages.data (), lengths.data (), pub_keys.data (), signatures.data (), messages.size (), verifications.data ());
+            for (size_t i (0); i < verifications.size (); ++i)
+            {
+                if (verifications[i] != 1)
+                {
+                    valid[owners[i]] = 0;
+                }
+            }
+        }
+    });
+    auto threads (std::max<size_t> (1, std::min<size_t> (std::thread::hardware_concurrency (), epochs_a.size () / parallel_epochs)));
+    auto chunk ((epochs_a.size () + threads - 1) / threads);
+    std::vector<std::thread> helpers;
+    for (size_t i (1); i < threads; ++i)
+    {
+        helpers.push_back (std::thread (validate_range, i * chunk, std::min (epochs_a.size (), (i + 1) * chunk)));
+    }
+    validate_range (0, std::min (epochs_a.size (), chunk));
+    for (auto & i : helpers)
+    {
+        i.join ();
+    }
+    return std::vector<bool> (valid.begin (), valid.end ());
+}
+
+bool germ::epoch_validator::validate (germ::epoch const & epoch_a, std::vector<germ::account> const & witnesses_a)
+{
+    return validate (std::vector<germ::epoch const *> (1, &epoch_a), std::vector<std::vector<germ::account>> (1, witnesses_a)).front ();
+}
+
+size_t germ::epoch_validator::quorum (size_t witnesses_a)
+{
+    return witnesses_a * 2 / 3 + 1;
+}
+
 germ::epoch_message::epoch_message()
 :epoch_hash_(0)
 {
@@ -20,6 +20,27 @@ enum class epoch_type : uint8_t
     epoch = 2
 };
 
+/**
+ * Binary Merkle tree over the transactions of an epoch.
+ * Leaves are blake2b (0x00 || tx hash) and inner nodes blake2b (0x01 || left || right) so a leaf can't pass for an inner node,
+ * a node without a sibling moves up a level unchanged. The root of an empty tree is zero.
+ */
+class merkle_tree
+{
+public:
+    merkle_tree (std::vector<germ::block_hash> const &);
+    germ::uint256_union root () const;
+    // Sibling hashes from the leaf at index up to the root
+    std::vector<germ::uint256_union> proof (size_t) const;
+    static bool verify (germ::block_hash const &, size_t, size_t, std::vector<germ::uint256_union> const &, germ::uint256_union const &);
+    static germ::uint256_union leaf (germ::block_hash const &);
+    static germ::uint256_union node (germ::uint256_union const &, germ::uint256_union const &);
+    // levels.front () holds the leaves, levels.back () the root
+    std::vector<std::vector<germ::uint256_union>> levels;
+    // Leaves are hashed across threads above this many transactions
+    static size_t constexpr parallel_leaves = 4096;
+};
+
 class epoch_visitor;
 class epoch : public std::enable_shared_from_this<germ::epoch>
 {
@@ -39,14 +60,23 @@ public:
 
     /* operations */
     // epoch block hash functions
+    // Cached, kept current by the constructors, deserialization and the mutators
     germ::epoch_hash hash() const;
+    germ::epoch_hash compute_hash() const;
     void hash (blake2b_state &) const;
     germ::epoch_hash previous_epoch () const;
+    // Commitment to txs, part of the epoch hash
+    germ::uint256_union merkle_root () const;
+    // Signed by each witness in the pre-vote round, commits to the predecessor, timestamp and txs
+    germ::uint256_union pre_vote_hash () const;
+    // Signed in the vote round, additionally commits to the pre-votes gathered
+    germ::uint256_union vote_hash () const;
 
     //serialize and deserialize operations
     std::string to_json ();
     void serialize (germ::stream & stream_r) const;
     void serialize_json (std::string & string) const;
+    void serialize_json (germ::json_writer & writer) const;
     bool deserialize (germ::stream & stream_r) ;
     bool deserialize_json (boost::property_tree::ptree const & tree_r);
 
@@ -66,9 +96,9 @@ public:
     /* Accessor methods */
     uint64_t                        timestamp() const;
     germ::epoch_hash                prev() const;
-    std::vector<germ::block_hash>   txs() const;
-    std::vector<germ::signature>    pre_votes() const;
-    std::vector<germ::signature>    votes() const;
+    std::vector<germ::block_hash> const &   txs() const;
+    std::vector<germ::signature> const &    pre_votes() const;
+    std::vector<germ::signature> const &    votes() const;
     germ::signature                 signature () const;
 
     /* Mutator methods*/
@@ -96,9 +126,31 @@ private:
     std::vector<germ::signature> pre_votes_;   // size: 15 ~ 20
     std::vector<germ::signature> votes_;       // size: 15 ~ 20
     germ::signature signature_;
+
+    // Recomputes the Merkle root and the hash
+    void rehash();
+    germ::uint256_union root_;
+    germ::epoch_hash hash_;
 };
 
 
+/**
+ * Checks the witness signatures of epochs.
+ * pre_votes[i] and votes[i] are by witnesses[i], a zero signature marks a witness that didn't sign.
+ * Every signature present has to verify and each round needs more than two thirds of the witnesses.
+ * The signatures of a run of epochs are checked in a single ed25519 batch, runs are spread over threads.
+ */
+class epoch_validator
+{
+public:
+    // witnesses[i] is the witness set epochs[i] was produced under, returns whether each epoch is valid
+    static std::vector<bool> validate (std::vector<germ::epoch const *> const &, std::vector<std::vector<germ::account>> const &);
+    static bool validate (germ::epoch const &, std::vector<germ::account> const &);
+    static size_t quorum (size_t);
+    // Epochs are verified on more than one thread above this many
+    static size_t constexpr parallel_epochs = 8;
+};
+
 class epoch_message : public epoch
 {
 public:
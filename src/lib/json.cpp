@@ -0,0 +1,591 @@
+#include <src/lib/json.hpp>
+
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+size_t constexpr none = std::numeric_limits<size_t>::max ();
+
+int hex_digit (char value_a)
+{
+    int result (-1);
+    if (value_a >= '0' && value_a <= '9')
+    {
+        result = value_a - '0';
+    }
+    else if (value_a >= 'a' && value_a <= 'f')
+    {
+        result = value_a - 'a' + 10;
+    }
+    else if (value_a >= 'A' && value_a <= 'F')
+    {
+        result = value_a - 'A' + 10;
+    }
+    return result;
+}
+
+uint32_t read_hex4 (char const * data_a)
+{
+    uint32_t result (0);
+    for (auto i (0); i < 4; ++i)
+    {
+        result = (result << 4) | hex_digit (data_a[i]);
+    }
+    return result;
+}
+
+void append_utf8 (std::string & output_a, uint32_t code_a)
+{
+    if (code_a < 0x80)
+    {
+        output_a.push_back (static_cast<char> (code_a));
+    }
+    else if (code_a < 0x800)
+    {
+        output_a.push_back (static_cast<char> (0xc0 | (code_a >> 6)));
+        output_a.push_back (static_cast<char> (0x80 | (code_a & 0x3f)));
+    }
+    else if (code_a < 0x10000)
+    {
+        output_a.push_back (static_cast<char> (0xe0 | (code_a >> 12)));
+        output_a.push_back (static_cast<char> (0x80 | ((code_a >> 6) & 0x3f)));
+        output_a.push_back (static_cast<char> (0x80 | (code_a & 0x3f)));
+    }
+    else
+    {
+        output_a.push_back (static_cast<char> (0xf0 | (code_a >> 18)));
+        output_a.push_back (static_cast<char> (0x80 | ((code_a >> 12) & 0x3f)));
+        output_a.push_back (static_cast<char> (0x80 | ((code_a >> 6) & 0x3f)));
+        output_a.push_back (static_cast<char> (0x80 | (code_a & 0x3f)));
+    }
+}
+
+// Escapes were validated while parsing so decoding can't fail
+std::string unescape (char const * data_a, size_t size_a)
+{
+    std::string result;
+    result.reserve (size_a);
+    auto end (data_a + size_a);
+    for (auto i (data_a); i != end; ++i)
+    {
+        if (*i != '\\')
+        {
+            result.push_back (*i);
+            continue;
+        }
+        ++i;
+        switch (*i)
+        {
+            case 'b':
+                result.push_back ('\b');
+                break;
+            case 'f':
+                result.push_back ('\f');
+                break;
+            case 'n':
+                result.push_back ('\n');
+                break;
+            case 'r':
+                result.push_back ('\r');
+                break;
+            case 't':
+                result.push_back ('\t');
+                break;
+            case 'u':
+            {
+                auto code (read_hex4 (i + 1));
+                i += 4;
+                // Combine a surrogate pair, a lone surrogate is passed through as is
+                if (code >= 0xd800 && code < 0xdc00 && end - i > 6 && i[1] == '\\' && i[2] == 'u')
+                {
+                    auto low (read_hex4 (i + 3));
+                    if (low >= 0xdc00 && low < 0xe000)
+                    {
+                        code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                        i += 6;
+                    }
+                }
+                append_utf8 (result, code);
+                break;
+            }
+            default:
+                result.push_back (*i);
+                break;
+        }
+    }
+    return result;
+}
+}
+
+germ::json_writer::json_writer () :
+depth (0),
+continued (false)
+{
+}
+
+void germ::json_writer::begin_object ()
+{
+    separator ();
+    output.push_back ('{');
+    ++depth;
+}
+
+void germ::json_writer::begin_object (std::string const & key_a)
+{
+    separator ();
+    key (key_a);
+    output.push_back ('{');
+    ++depth;
+}
+
+void germ::json_writer::end_object ()
+{
+    assert (depth > 0);
+    output.push_back ('}');
+    --depth;
+}
+
+void germ::json_writer::begin_array ()
+{
+    separator ();
+    output.push_back ('[');
+    ++depth;
+}
+
+void germ::json_writer::begin_array (std::string const & key_a)
+{
+    separator ();
+    key (key_a);
+    output.push_back ('[');
+    ++depth;
+}
+
+void germ::json_writer::end_array ()
+{
+    assert (depth > 0);
+    output.push_back (']');
+    --depth;
+}
+
+void germ::json_writer::value (std::string const & key_a, std::string const & value_a)
+{
+    separator ();
+    key (key_a);
+    string (value_a.data (), value_a.size ());
+}
+
+void germ::json_writer::value (std::string const & value_a)
+{
+    separator ();
+    string (value_a.data (), value_a.size ());
+}
+
+void germ::json_writer::raw (std::string const & json_a)
+{
+    separator ();
+    output.append (json_a);
+}
+
+std::string germ::json_writer::take ()
+{
+    if (!output.empty ())
+    {
+        continued = output.back () != '{' && output.back () != '[';
+    }
+    std::string result;
+    result.swap (output);
+    return result;
+}
+
+void germ::json_writer::separator ()
+{
+    if (output.empty () ? continued : output.back () != '{' && output.back () != '[')
+    {
+        output.push_back (',');
+    }
+}
+
+void germ::json_writer::key (std::string const & key_a)
+{
+    string (key_a.data (), key_a.size ());
+    output.push_back (':');
+}
+
+void germ::json_writer::string (char const * data_a, size_t size_a)
+{
+    static char const hex[] = "0123456789abcdef";
+    output.push_back ('"');
+    auto run (data_a);
+    auto end (data_a + size_a);
+    for (auto i (data_a); i != end; ++i)
+    {
+        auto value (static_cast<unsigned char> (*i));
+        if (value >= 0x20 && value != '"' && value != '\\')
+        {
+            continue;
+        }
+        // Copy the plain run before this character in one go
+        output.append (run, i - run);
+        run = i + 1;
+        output.push_back ('\\');
+        switch (value)
+        {
+            case '"':
+            case '\\':
+                output.push_back (*i);
+                break;
+            case '\b':
+                output.push_back ('b');
+                break;
+            case '\f':
+                output.push_back ('f');
+                break;
+            case '\n':
+                output.push_back ('n');
+                break;
+            case '\r':
+                output.push_back ('r');
+                break;
+            case '\t':
+                output.push_back ('t');
+                break;
+            default:
+                output.append ("u00");
+                output.push_back (hex[value >> 4]);
+                output.push_back (hex[value & 0xf]);
+                break;
+        }
+    }
+    output.append (run, end - run);
+    output.push_back ('"');
+}
+
+germ::json_value::json_value () :
+type (germ::json_type::null),
+data (nullptr),
+size (0),
+key_data (nullptr),
+key_size (0),
+escaped (false),
+key_escaped (false),
+child (nullptr),
+next (nullptr)
+{
+}
+
+std::string germ::json_value::string () const
+{
+    return escaped ? unescape (data, size) : std::string (data, size);
+}
+
+std::string germ::json_value::key () const
+{
+    return key_escaped ? unescape (key_data, key_size) : std::string (key_data, key_size);
+}
+
+bool germ::json_value::key_equals (char const * data_a, size_t size_a) const
+{
+    bool result;
+    if (!key_escaped)
+    {
+        result = key_size == size_a && std::memcmp (key_data, data_a, size_a) == 0;
+    }
+    else
+    {
+        result = key () == std::string (data_a, size_a);
+    }
+    return result;
+}
+
+germ::json_value const * germ::json_value::find (std::string const & path_a) const
+{
+    auto result (this);
+    size_t begin (0);
+    while (result != nullptr && begin <= path_a.size ())
+    {
+        auto dot (path_a.find ('.', begin));
+        auto end (dot == std::string::npos ? path_a.size () : dot);
+        auto current (result);
+        result = nullptr;
+        if (current->type == germ::json_type::object)
+        {
+            for (auto i (current->child); i != nullptr && result == nullptr; i = i->next)
+            {
+                if (i->key_equals (path_a.data () + begin, end - begin))
+                {
+                    result = i;
+                }
+            }
+        }
+        begin = end + 1;
+    }
+    return result;
+}
+
+bool germ::json_value::get (std::string const & path_a, std::string & value_a) const
+{
+    auto existing (find (path_a));
+    auto result (existing != nullptr && !existing->is_container ());
+    if (result)
+    {
+        value_a = existing->string ();
+    }
+    return result;
+}
+
+bool germ::json_value::is_container () const
+{
+    return type == germ::json_type::object || type == germ::json_type::array;
+}
+
+size_t constexpr germ::json_document::max_depth;
+
+germ::json_document::json_document (bool & error_a, std::string const & text_a) :
+position (text_a.data ()),
+end (text_a.data () + text_a.size ())
+{
+    if (!error_a)
+    {
+        size_t root_l;
+        error_a = parse_value (0, root_l);
+        if (!error_a)
+        {
+            skip_whitespace ();
+            error_a = position != end;
+        }
+    }
+    if (!error_a)
+    {
+        // The vector is complete so links can become pointers that stay valid
+        for (size_t i (0), n (values.size ()); i < n; ++i)
+        {
+            values[i].child = links[i].first != none ? &values[links[i].first] : nullptr;
+            values[i].next = links[i].second != none ? &values[links[i].second] : nullptr;
+        }
+    }
+    else
+    {
+        values.clear ();
+        values.emplace_back ();
+    }
+    links.clear ();
+    links.shrink_to_fit ();
+}
+
+germ::json_value const & germ::json_document::root () const
+{
+    return values.front ();
+}
+
+bool germ::json_document::parse_value (size_t depth_a, size_t & index_a)
+{
+    auto error (depth_a >= max_depth);
+    skip_whitespace ();
+    error = error || position == end;
+    if (!error)
+    {
+        index_a = values.size ();
+        values.emplace_back ();
+        links.emplace_back (none, none);
+        switch (*position)
+        {
+            case '{':
+            case '[':
+            {
+                auto object (*position == '{');
+                values[index_a].type = object ? germ::json_type::object : germ::json_type::array;
+                values[index_a].data = position;
+                ++position;
+                skip_whitespace ();
+                auto close (object ? '}' : ']');
+                auto previous (none);
+                auto done (position != end && *position == close);
+                while (!error && !done)
+                {
+                    char const * key_data (nullptr);
+                    size_t key_size (0);
+                    auto key_escaped (false);
+                    if (object)
+                    {
+                        skip_whitespace ();
+                        error = position == end || *position != '"' || parse_string (key_data, key_size, key_escaped);
+                        skip_whitespace ();
+                        error = error || position == end || *position++ != ':';
+                    }
+                    size_t child (0);
+                    error = error || parse_value (depth_a + 1, child);
+                    if (!error)
+                    {
+                        values[child].key_data = key_data;
+                        values[child].key_size = key_size;
+                        values[child].key_escaped = key_escaped;
+                        if (previous == none)
+                        {
+                            links[index_a].first = child;
+                        }
+                        else
+                        {
+                            links[previous].second = child;
+                        }
+                        previous = child;
+                        skip_whitespace ();
+                        error = position == end || (*position != ',' && *position != close);
+                        done = !error && *position == close;
+                        if (!error && !done)
+                        {
+                            ++position;
+                        }
+                    }
+                }
+                if (!error)
+                {
+                    ++position;
+                    values[index_a].size = position - values[index_a].data;
+                }
+                break;
+            }
+            case '"':
+            {
+                char const * data (nullptr);
+                size_t size (0);
+                auto escaped (false);
+                error = parse_string (data, size, escaped);
+                values[index_a].type = germ::json_type::string;
+                values[index_a].data = data;
+                values[index_a].size = size;
+                values[index_a].escaped = escaped;
+                break;
+            }
+            case 't':
+                error = parse_literal ("true", germ::json_type::boolean);
+                break;
+            case 'f':
+                error = parse_literal ("false", germ::json_type::boolean);
+                break;
+            case 'n':
+                error = parse_literal ("null", germ::json_type::null);
+                break;
+            default:
+                error = parse_number ();
+                break;
+        }
+    }
+    return error;
+}
+
+bool germ::json_document::parse_string (char const *& data_a, size_t & size_a, bool & escaped_a)
+{
+    assert (*position == '"');
+    ++position;
+    data_a = position;
+    escaped_a = false;
+    auto error (false);
+    auto done (false);
+    while (!error && !done)
+    {
+        if (position == end || static_cast<unsigned char> (*position) < 0x20)
+        {
+            error = true;
+        }
+        else if (*position == '"')
+        {
+            done = true;
+        }
+        else if (*position == '\\')
+        {
+            escaped_a = true;
+            ++position;
+            if (position == end)
+            {
+                error = true;
+            }
+            else if (*position == 'u')
+            {
+                error = end - position < 5;
+                for (auto i (1); !error && i < 5; ++i)
+                {
+                    error = hex_digit (position[i]) < 0;
+                }
+                position += error ? 0 : 5;
+            }
+            else
+            {
+                error = std::strchr ("\"\\/bfnrt", *position) == nullptr || *position == '\0';
+                ++position;
+            }
+        }
+        else
+        {
+            ++position;
+        }
+    }
+    if (!error)
+    {
+        size_a = position - data_a;
+        ++position;
+    }
+    return error;
+}
+
+bool germ::json_document::parse_number ()
+{
+    auto & value (values.back ());
+    value.type = germ::json_type::number;
+    value.data = position;
+    auto digits ([this]() {
+        auto begin (position);
+        while (position != end && *position >= '0' && *position <= '9')
+        {
+            ++position;
+        }
+        return position - begin;
+    });
+    if (position != end && *position == '-')
+    {
+        ++position;
+    }
+    auto leading_zero (position != end && *position == '0');
+    auto integral (digits ());
+    auto error (integral == 0 || (leading_zero && integral > 1));
+    if (!error && position != end && *position == '.')
+    {
+        ++position;
+        error = digits () == 0;
+    }
+    if (!error && position != end && (*position == 'e' || *position == 'E'))
+    {
+        ++position;
+        if (position != end && (*position == '+' || *position == '-'))
+        {
+            ++position;
+        }
+        error = digits () == 0;
+    }
+    value.size = position - value.data;
+    return error;
+}
+
+bool germ::json_document::parse_literal (char const * text_a, germ::json_type type_a)
+{
+    auto & value (values.back ());
+    auto size (std::strlen (text_a));
+    auto error (static_cast<size_t> (end - position) < size || std::memcmp (position, text_a, size) != 0);
+    if (!error)
+    {
+        value.type = type_a;
+        value.data = position;
+        value.size = size;
+        position += size;
+    }
+    return error;
+}
+
+void germ::json_document::skip_whitespace ()
+{
+    while (position != end && (*position == ' ' || *position == '\t' || *position == '\n' || *position == '\r'))
+    {
+        ++position;
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace germ
+{
+/**
+ * Appends compact JSON to a string without building an intermediate tree.
+ * Every value is written as a string, the same as property_tree output, so clients see the same documents.
+ */
+class json_writer
+{
+public:
+    json_writer ();
+    void begin_object ();
+    void begin_object (std::string const &);
+    void end_object ();
+    void begin_array ();
+    void begin_array (std::string const &);
+    void end_array ();
+    // Member of the enclosing object
+    void value (std::string const &, std::string const &);
+    // Element of the enclosing array
+    void value (std::string const &);
+    // Element of the enclosing array which is already serialized JSON
+    void raw (std::string const &);
+    // Hands over what has been written so far, later output carries on the same document
+    std::string take ();
+    std::string output;
+
+private:
+    void separator ();
+    void key (std::string const &);
+    void string (char const *, size_t);
+    size_t depth;
+    // Whether the last output handed over ended in a value, so the next one needs a separator
+    bool continued;
+};
+enum class json_type : uint8_t
+{
+    null,
+    boolean,
+    number,
+    string,
+    array,
+    object
+};
+/**
+ * Value inside a json_document, text is referenced in place and escapes are only decoded when asked for.
+ */
+class json_value
+{
+public:
+    json_value ();
+    // Decoded string contents, otherwise the value's text as it appears in the document
+    std::string string () const;
+    std::string key () const;
+    bool key_equals (char const *, size_t) const;
+    // Member of an object by dotted path, nullptr if any step is missing
+    json_value const * find (std::string const &) const;
+    // Scalar at a dotted path, returns true if it was found
+    bool get (std::string const &, std::string &) const;
+    bool is_container () const;
+    json_type type;
+    char const * data;
+    size_t size;
+    char const * key_data;
+    size_t key_size;
+    bool escaped;
+    bool key_escaped;
+    // Children of objects and arrays are a linked list in document order
+    json_value const * child;
+    json_value const * next;
+};
+/**
+ * Parses JSON in place over a caller owned string which must outlive the document.
+ * All values live in one flat vector so parsing makes a single growing allocation.
+ */
+class json_document
+{
+public:
+    json_document (bool &, std::string const &);
+    json_document (germ::json_document const &) = delete;
+    germ::json_document & operator= (germ::json_document const &) = delete;
+    json_value const & root () const;
+    std::vector<germ::json_value> values;
+    // Nesting deeper than this is rejected rather than risking the stack
+    static size_t constexpr max_depth = 128;
+
+private:
+    bool parse_value (size_t, size_t &);
+    bool parse_string (char const *&, size_t &, bool &);
+    bool parse_number ();
+    bool parse_literal (char const *, json_type);
+    void skip_whitespace ();
+    char const * position;
+    char const * end;
+    std::vector<std::pair<size_t, size_t>> links;
+};
+}
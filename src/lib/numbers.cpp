@@ -430,6 +430,11 @@ bool germ::validate_message (germ::public_key const & public_key, germ::uint256_
     return result;
 }
 
+void germ::validate_message_batch (unsigned char const ** m, size_t * mlen, unsigned char const ** pk, unsigned char const ** RS, size_t num, int * valid)
+{
+    ed25519_sign_open_batch (m, mlen, pk, RS, num, valid);
+}
+
 germ::uint128_union::uint128_union (std::string const & string_a)
 {
     decode_hex (string_a);
@@ -124,6 +124,8 @@ using signature = uint512_union;
 
 germ::uint512_union sign_message (germ::raw_key const &, germ::public_key const &, germ::uint256_union const &);
 bool validate_message (germ::public_key const &, germ::uint256_union const &, germ::uint512_union const &);
+// Verifies num signatures together, valid[i] is set to 1 if signature i is good
+void validate_message_batch (unsigned char const **, size_t *, unsigned char const **, unsigned char const **, size_t, int *);
 void deterministic_key (germ::uint256_union const &, uint32_t, germ::uint256_union &);
 }
 
@@ -3,6 +3,7 @@
 //
 
 #include <src/lib/tx.h>
+#include <src/node/utility.hpp>
 
 germ::tx_message::tx_message():
 value(0),
@@ -39,8 +40,70 @@ std::string germ::tx::to_json()
     return result;
 }
 
+std::atomic<uint64_t> germ::tx::hashes_computed (0);
+
+// Reads the json fields through get (path, value) which returns true if the field exists, shared by the property_tree and json_value parsers
+template <typename T>
+bool germ::tx::deserialize_fields (T const & get)
+{
+    std::string previous, destination, source, balance, account;
+    std::string tx_value, tx_data, tx_gas, tx_gasprice;
+    std::string epoch_r, signature_r;
+    auto error (!get ("previous", previous) || !get ("destination", destination) || !get ("source", source) || !get ("balance", balance) || !get ("account", account) ||
+                !get ("tx_info.value", tx_value) || !get ("tx_info.data", tx_data) || !get ("tx_info.gas", tx_gas) || !get ("tx_info.gasprice", tx_gasprice) ||
+                !get ("epoch", epoch_r) || !get ("signature", signature_r));
+    if (error)
+        return error;
+
+    if (!previous.empty() && (error = previous_.decode_hex(previous)))
+        return error;
+
+    if (!destination.empty() && (error = destination_.decode_account(destination)))
+        return error;
+
+    if (!source.empty() && (error = source_.decode_hex(source)))
+        return error;
+
+    if (!balance.empty() && (error = balance_.decode_hex(balance)))
+        return error;
+
+    if (!account.empty() && (error = account_.decode_account(account)))
+        return error;
+
+    if (!tx_value.empty() && (error = germ::from_string_hex(tx_value, tx_info_.value)))
+        return error;
+
+    tx_info_.data = tx_data;
+
+    if (!tx_gas.empty() && (error = germ::from_string_hex(tx_gas, tx_info_.gas)))
+        return error;
+
+    if (!tx_gasprice.empty() && (error = germ::from_string_hex(tx_gasprice, tx_info_.gas_price)))
+        return error;
+
+    if (!epoch_r.empty() && (error = epoch_.decode_hex(epoch_r)))
+        return error;
+
+    if (signature_r.empty() && (error = signature.decode_hex(signature_r)))
+        return error;
+
+    rehash ();
+    return error;
+}
+
 germ::block_hash germ::tx::hash() const
 {
+    return hash_cached;
+}
+
+void germ::tx::rehash()
+{
+    hash_cached = compute_hash ();
+}
+
+germ::block_hash germ::tx::compute_hash() const
+{
+    hashes_computed.fetch_add (1, std::memory_order_relaxed);
     germ::uint256_union result;
     blake2b_state hash_;
     auto status (blake2b_init(&hash_, sizeof(result.bytes)));
@@ -55,16 +118,22 @@ germ::block_hash germ::tx::hash() const
 germ::tx::tx(germ::block_hash const &previous_r, germ::account const &destination_r, germ::block_hash source_r, germ::account const & account, germ::amount const & balance_r,
              germ::tx_message const &tx_info_r, germ::epoch_hash const &epoch_r, germ::raw_key const &prv_r,
              germ::public_key const &pub_r):
+tx (previous_r, destination_r, source_r, account, balance_r, tx_info_r, epoch_r)
+{
+    signature = germ::sign_message (prv_r, pub_r, hash_cached);
+}
+
+germ::tx::tx(germ::block_hash const &previous_r, germ::account const &destination_r, germ::block_hash source_r, germ::account const & account, germ::amount const & balance_r,
+             germ::tx_message const &tx_info_r, germ::epoch_hash const &epoch_r):
 previous_(previous_r),
 destination_(destination_r),
 source_(source_r),
 balance_(balance_r),
 account_(account),
-tx_info(tx_info_r),
-epoch(epoch_r),
-signature(germ::sign_message(prv_r, pub_r, hash()))
+tx_info_(tx_info_r),
+epoch_(epoch_r)
 {
-
+    rehash ();
 }
 
 germ::tx::tx(bool &error, germ::stream &stream)
@@ -87,7 +156,7 @@ germ::tx::tx(bool &error, germ::stream &stream)
     if ((error = germ::read(stream, account_.bytes)))
         return ;
 
-    if ((error = germ::read(stream, tx_info.value)))
+    if ((error = germ::read(stream, tx_info_.value)))
         return ;
 
     size_t data_len;
@@ -100,83 +169,49 @@ germ::tx::tx(bool &error, germ::stream &stream)
         if ((error = germ::read_data(stream, datas)))
             return;
 
-        tx_info.data = germ::to_string(datas);
+        tx_info_.data = germ::to_string(datas);
     }
     else
     {
-        tx_info.data = "";
+        tx_info_.data = "";
     }
 
-    if ((error = germ::read(stream, tx_info.gas)))
+    if ((error = germ::read(stream, tx_info_.gas)))
         return ;
 
-    if ((error = germ::read(stream, tx_info.gas_price)))
+    if ((error = germ::read(stream, tx_info_.gas_price)))
         return ;
 
-    if ((error = germ::read(stream, epoch.bytes)))
+    if ((error = germ::read(stream, epoch_.bytes)))
         return ;
 
     error = germ::read(stream, signature.bytes);
+    if (!error)
+        rehash ();
 }
 
 germ::tx::tx(bool &error, boost::property_tree::ptree const &tree)
 {
-    try
-    {
-        if (error)
-            return ;
-
-        auto previous(tree.get<std::string>("previous"));
-        auto destination(tree.get<std::string>("destination"));
-        auto source(tree.get<std::string>("source"));
-        auto balance(tree.get<std::string>("balance"));
-        auto account(tree.get<std::string>("account"));
-
-        auto tx(tree.get_child("tx_info"));
-        auto tx_value(tx.get<std::string>("value"));
-        auto tx_data(tx.get<std::string>("data"));
-        auto tx_gas(tx.get<std::string>("gas"));
-        auto tx_gasprice(tx.get<std::string>("gasprice"));
-
-        auto epoch_r(tree.get<std::string>("epoch"));
-        auto signature_r(tree.get<std::string>("signature"));
-
-        if (!previous.empty() && (error = previous_.decode_hex(previous)))
-            return ;
-
-        if (!destination.empty() && (error = destination_.decode_account(destination)))
-            return ;
-
-        if (!source.empty() && (error = source_.decode_hex(source)))
-            return ;
-
-        if (!balance.empty() && (error = balance_.decode_hex(balance)))
-            return ;
-
-        if (!account.empty() && (error = account_.decode_account(account)))
-            return ;
-
-        if (!tx_value.empty() && (error = germ::from_string_hex(tx_value, tx_info.value)))
-            return ;
-
-        tx_info.data = tx_data;
+    if (error)
+        return ;
 
-        if (!tx_gas.empty() && (error = germ::from_string_hex(tx_gas, tx_info.gas)))
-            return ;
+    error = deserialize_fields ([&tree](char const * path, std::string & value) {
+        auto existing (tree.get_optional<std::string> (path));
+        if (existing)
+            value = *existing;
 
-        if (!tx_gasprice.empty() && (error = germ::from_string_hex(tx_gasprice, tx_info.gas_price)))
-            return ;
+        return !!existing;
+    });
+}
 
-        if (!epoch_r.empty() && (error = epoch.decode_hex(epoch_r)))
-            return ;
+germ::tx::tx(bool &error, germ::json_value const &value)
+{
+    if (error)
+        return ;
 
-        if (signature_r.empty() && (error = signature.decode_hex(signature_r)))
-            return ;
-    }
-    catch (std::runtime_error const &)
-    {
-        error = true;
-    }
+    error = deserialize_fields ([&value](char const * path, std::string & field) {
+        return value.get (path, field);
+    });
 }
 
 germ::tx::~tx()
@@ -215,9 +250,9 @@ void germ::tx::hash(blake2b_state &hash_r) const
     status = blake2b_update(&hash_r, account_.bytes.data(), sizeof (account_.bytes));
     assert(status == 0);
 
-    hash_tx(hash_r, tx_info);
+    hash_tx(hash_r, tx_info_);
 
-    status = blake2b_update (&hash_r, epoch.bytes.data (), sizeof (epoch.bytes));
+    status = blake2b_update (&hash_r, epoch_.bytes.data (), sizeof (epoch_.bytes));
     assert (status == 0);
 }
 
@@ -237,6 +272,68 @@ germ::block_hash germ::tx::source() const
     return source_;
 }
 
+germ::amount germ::tx::balance() const
+{
+    return balance_;
+}
+
+germ::account germ::tx::account() const
+{
+    return account_;
+}
+
+germ::tx_message const & germ::tx::tx_info() const
+{
+    return tx_info_;
+}
+
+germ::epoch_hash germ::tx::epoch() const
+{
+    return epoch_;
+}
+
+void germ::tx::set_previous(germ::block_hash const & previous_r)
+{
+    previous_ = previous_r;
+    rehash ();
+}
+
+void germ::tx::set_destination(germ::account const & destination_r)
+{
+    destination_ = destination_r;
+    rehash ();
+}
+
+void germ::tx::set_source(germ::block_hash const & source_r)
+{
+    source_ = source_r;
+    rehash ();
+}
+
+void germ::tx::set_balance(germ::amount const & balance_r)
+{
+    balance_ = balance_r;
+    rehash ();
+}
+
+void germ::tx::set_account(germ::account const & account_r)
+{
+    account_ = account_r;
+    rehash ();
+}
+
+void germ::tx::set_tx_info(germ::tx_message const & tx_info_r)
+{
+    tx_info_ = tx_info_r;
+    rehash ();
+}
+
+void germ::tx::set_epoch(germ::epoch_hash const & epoch_r)
+{
+    epoch_ = epoch_r;
+    rehash ();
+}
+
 germ::block_hash germ::tx::root() const
 {
     return previous_;
@@ -249,79 +346,68 @@ void germ::tx::serialize(germ::stream & stream_r) const
     write(stream_r, source_.bytes);
     write(stream_r, balance_.bytes);
     write(stream_r, account_.bytes);
-    write(stream_r, tx_info.value);
+    write(stream_r, tx_info_.value);
 
-    size_t len = (size_t)tx_info.data.length();
+    size_t len = (size_t)tx_info_.data.length();
     write(stream_r, len);
 
     if (len != 0)
     {
         std::vector<uint8_t> datas;
-        germ::to_vector(datas, tx_info.data);
+        germ::to_vector(datas, tx_info_.data);
         germ::write_data(stream_r, datas);
     }
 
-    write(stream_r, tx_info.gas);
-    write(stream_r, tx_info.gas_price);
-    write(stream_r, epoch.bytes);
+    write(stream_r, tx_info_.gas);
+    write(stream_r, tx_info_.gas_price);
+    write(stream_r, epoch_.bytes);
     write(stream_r, signature.bytes);
 }
 
 void germ::tx::serialize_json(std::string &string_r) const
 {
-    boost::property_tree::ptree tree;
+    germ::json_writer writer;
+    serialize_json(writer);
+    string_r = std::move(writer.output);
+}
+
+void germ::tx::serialize_json(germ::json_writer &writer) const
+{
+    writer.begin_object();
     germ::block_type tx_type = type();
     if (tx_type == germ::block_type::send)
     {
-        tree.put("type", "send");
+        writer.value("type", "send");
     }
     else if (tx_type == germ::block_type::receive)
     {
-        tree.put("type", "receive");
+        writer.value("type", "receive");
     }
 
-    std::string previous;
-    previous_.encode_hex(previous);
-    tree.put("previous", previous);
-
-    std::string destination;
-    destination_.encode_account(destination);
-    tree.put("destination", destination);
-
-    std::string source;
-    source_.encode_hex(source);
-    tree.put("source", source);
-
-    std::string balance;
-    balance_.encode_hex(balance);
-    tree.put("balance", balance_.to_string_dec());
-
-    std::string account;
-    account_.encode_account(account);
-    tree.put("account", account);
-
-    boost::property_tree::ptree tx;
-    tx.put("value", germ::to_string_hex(tx_info.value));
-    tx.put("data", tx_info.data);
-
-    tx.put("gas", germ::to_string_hex(tx_info.gas));
-    tx.put("gasprice", germ::to_string_hex(tx_info.gas_price));
-
-    tree.put_child("tx_info", tx);
-
-    std::string signature_r;
-    signature.encode_hex(signature_r);
-    tree.put("signature", signature_r);
-
-    std::stringstream ostream;
-    boost::property_tree::write_json(ostream, tree);
-    string_r = ostream.str();
+    writer.value("previous", previous_.to_string());
+    writer.value("destination", destination_.to_account());
+    writer.value("source", source_.to_string());
+    writer.value("balance", balance_.to_string_dec());
+    writer.value("account", account_.to_account());
+
+    writer.begin_object("tx_info");
+    writer.value("value", germ::to_string_hex(tx_info_.value));
+    writer.value("data", tx_info_.data);
+    writer.value("gas", germ::to_string_hex(tx_info_.gas));
+    writer.value("gasprice", germ::to_string_hex(tx_info_.gas_price));
+    writer.end_object();
+
+    writer.value("signature", signature.to_string());
+    writer.end_object();
 }
 
 bool germ::tx::deserialize(germ::stream &stream_r)
 {
     auto error(false);
 
+    if ((error = germ::read(stream_r, previous_.bytes)))
+        return error;
+
     if ((error = germ::read(stream_r, destination_.bytes)))
         return error;
 
@@ -334,40 +420,38 @@ bool germ::tx::deserialize(germ::stream &stream_r)
     if ((error = germ::read(stream_r, account_.bytes)))
         return error;
 
-    if ((error = germ::read(stream_r, tx_info.value)))
+    if ((error = germ::read(stream_r, tx_info_.value)))
         return error;
 
     size_t data_len;
     if ((error = germ::read(stream_r, data_len)))
         return error;
 
-    std::vector<uint8_t> datas(data_len);
-    if ((error = germ::read_data(stream_r, datas)))
-        return error;
-
     if (data_len != 0)
     {
         std::vector<uint8_t> datas(data_len);
         if ((error = germ::read_data(stream_r, datas)))
             return error;
 
-        tx_info.data = germ::to_string(datas);
+        tx_info_.data = germ::to_string(datas);
     }
     else
     {
-        tx_info.data = "";
+        tx_info_.data = "";
     }
 
-    if((error = germ::read(stream_r, tx_info.gas)))
+    if((error = germ::read(stream_r, tx_info_.gas)))
         return error;
 
-    if ((error = germ::read(stream_r, tx_info.gas_price)))
+    if ((error = germ::read(stream_r, tx_info_.gas_price)))
         return error;
 
-    if ((error = germ::read(stream_r, epoch.bytes)))
+    if ((error = germ::read(stream_r, epoch_.bytes)))
         return error;
 
     error = germ::read(stream_r, signature.bytes);
+    if (!error)
+        rehash ();
 
     return error;
 }
@@ -379,52 +463,13 @@ bool germ::tx::deserialize_json(boost::property_tree::ptree const &tree_r)
     {
         auto tx_type(tree_r.get<std::string>("type"));
         assert(tx_type == "send" || tx_type == "receive");
-        auto previous(tree_r.get<std::string>("previous"));
-        auto destination(tree_r.get<std::string>("destination"));
-        auto source(tree_r.get<std::string>("source"));
-        auto balance(tree_r.get<std::string>("balance"));
-        auto account(tree_r.get<std::string>("account"));
-
-        auto tx(tree_r.get_child("tx_info"));
-        auto tx_value(tx.get<std::string>("value"));
-        auto tx_data(tx.get<std::string>("data"));
-        auto tx_gas(tx.get<std::string>("gas"));
-        auto tx_gasprice(tx.get<std::string>("gasprice"));
-
-        auto epoch_r(tree_r.get<std::string>("epoch"));
-        auto signature_r(tree_r.get<std::string>("signature"));
-
-        if (!previous.empty() && (error = previous_.decode_hex(previous)))
-            return error;
-
-        if (!destination.empty() && (error = destination_.decode_account(destination)))
-            return error;
-
-        if (!source.empty() && (error = source_.decode_hex(source)))
-            return error;
-
-        if (!balance.empty() && (error = balance_.decode_hex(balance)))
-            return error;
-
-        if (!account.empty() && (error = account_.decode_account(account)))
-            return error;
-
-        if (!tx_value.empty() && (error = germ::from_string_hex(tx_value, tx_info.value)))
-            return error;
+        error = deserialize_fields ([&tree_r](char const * path, std::string & value) {
+            auto existing (tree_r.get_optional<std::string> (path));
+            if (existing)
+                value = *existing;
 
-        tx_info.data = tx_data;
-
-        if (!tx_gas.empty() && (error = germ::from_string_hex(tx_gas, tx_info.gas)))
-            return error;
-
-        if (!tx_gasprice.empty() && (error = germ::from_string_hex(tx_gasprice, tx_info.gas_price)))
-            return error;
-
-        if (!epoch_r.empty() && (error = epoch.decode_hex(epoch_r)))
-            return error;
-
-        if (signature_r.empty() && (error = signature.decode_hex(signature_r)))
-            return error;
+            return !!existing;
+        });
     }
     catch (std::runtime_error const &)
     {
@@ -434,11 +479,24 @@ bool germ::tx::deserialize_json(boost::property_tree::ptree const &tree_r)
     return error;
 }
 
+bool germ::tx::deserialize_json(germ::json_value const &value_r)
+{
+    std::string tx_type;
+    auto error(!value_r.get("type", tx_type));
+    if (error)
+        return error;
+
+    assert(tx_type == "send" || tx_type == "receive");
+    return deserialize_fields ([&value_r](char const * path, std::string & value) {
+        return value_r.get (path, value);
+    });
+}
+
 bool germ::tx::operator==(germ::tx const &other) const
 {
     auto result(previous_ == other.previous_ && destination_ == other.destination_ && source_ == other.source_ && balance_ == other.balance_ && account_ == other.account_ &&
-                tx_info.value == other.tx_info.value && tx_info.data == other.tx_info.data && tx_info.gas == other.tx_info.gas && tx_info.gas_price == other.tx_info.gas_price &&
-                epoch == other.epoch && signature == other.signature
+                tx_info_.value == other.tx_info_.value && tx_info_.data == other.tx_info_.data && tx_info_.gas == other.tx_info_.gas && tx_info_.gas_price == other.tx_info_.gas_price &&
+                epoch_ == other.epoch_ && signature == other.signature
             );
 
     return result;
@@ -482,9 +540,30 @@ germ::signature germ::tx::block_signature() const
 
 void germ::tx::signature_set(germ::uint512_union const &signature_r)
 {
+    // The signature isn't part of the hash so the cached hash stays valid
     signature = signature_r;
 }
 
+bool germ::tx::valid_predecessor(germ::tx_view const &tx) const
+{
+    // Only this tx's type matters, so a view of the predecessor is enough
+    auto result(false);
+    germ::block_type tx_type = type();
+    switch (tx_type)
+    {
+        case germ::block_type::send:
+        case germ::block_type::receive:
+        case germ::block_type::vote:
+            result = true;
+            break;
+        default:
+            result = false;
+            break;
+    }
+
+    return result;
+}
+
 bool germ::tx::valid_predecessor(germ::tx const &tx) const
 {
     auto result(false);
@@ -504,12 +583,136 @@ bool germ::tx::valid_predecessor(germ::tx const &tx) const
     return result;
 }
 
+size_t constexpr germ::tx_view::previous_offset;
+size_t constexpr germ::tx_view::destination_offset;
+size_t constexpr germ::tx_view::source_offset;
+size_t constexpr germ::tx_view::balance_offset;
+size_t constexpr germ::tx_view::account_offset;
+size_t constexpr germ::tx_view::value_offset;
+size_t constexpr germ::tx_view::data_size_offset;
+size_t constexpr germ::tx_view::data_offset;
+size_t constexpr germ::tx_view::fixed_size;
+
+germ::tx_view::tx_view () :
+bytes (nullptr),
+size (0),
+data_length (0)
+{
+}
+
+germ::tx_view::tx_view (bool & error_a, uint8_t const * bytes_a, size_t size_a) :
+bytes (bytes_a),
+size (size_a),
+data_length (0)
+{
+    error_a = size < fixed_size;
+    if (!error_a)
+    {
+        data_length = get<size_t> (data_size_offset);
+        error_a = size - fixed_size < data_length;
+    }
+}
+
+germ::block_hash germ::tx_view::previous () const
+{
+    return get<germ::block_hash> (previous_offset);
+}
+
+germ::account germ::tx_view::destination () const
+{
+    return get<germ::account> (destination_offset);
+}
+
+germ::block_hash germ::tx_view::source () const
+{
+    return get<germ::block_hash> (source_offset);
+}
+
+germ::amount germ::tx_view::balance () const
+{
+    return get<germ::amount> (balance_offset);
+}
+
+germ::account germ::tx_view::account () const
+{
+    return get<germ::account> (account_offset);
+}
+
+uint64_t germ::tx_view::value () const
+{
+    return get<uint64_t> (value_offset);
+}
+
+uint8_t const * germ::tx_view::data () const
+{
+    return bytes + data_offset;
+}
+
+size_t germ::tx_view::data_size () const
+{
+    return data_length;
+}
+
+size_t germ::tx_view::gas_offset () const
+{
+    return data_offset + data_length;
+}
+
+uint64_t germ::tx_view::gas () const
+{
+    return get<uint64_t> (gas_offset ());
+}
+
+uint64_t germ::tx_view::gas_price () const
+{
+    return get<uint64_t> (gas_offset () + sizeof (uint64_t));
+}
+
+germ::epoch_hash germ::tx_view::epoch () const
+{
+    return get<germ::epoch_hash> (gas_offset () + 2 * sizeof (uint64_t));
+}
+
+germ::signature germ::tx_view::signature () const
+{
+    return get<germ::signature> (gas_offset () + 2 * sizeof (uint64_t) + sizeof (germ::epoch_hash));
+}
+
+germ::block_hash germ::tx_view::root () const
+{
+    return previous ();
+}
+
+germ::block_type germ::tx_view::type () const
+{
+    // Same rules as tx::type
+    germ::block_type result (germ::block_type::not_a_block);
+    if (!destination ().is_zero ())
+    {
+        result = germ::block_type::send;
+    }
+    else if (!source ().is_zero ())
+    {
+        result = germ::block_type::receive;
+    }
+    return result;
+}
+
+std::unique_ptr<germ::tx> germ::tx_view::materialize () const
+{
+    germ::bufferstream stream (bytes, size);
+    auto error (false);
+    std::unique_ptr<germ::tx> result (new germ::tx (error, stream));
+    assert (!error);
+    return result;
+}
+
 size_t germ::tx::size() const
 {
     size_t size;
     size = sizeof (previous_) + sizeof (destination_) + sizeof (source_) + sizeof (balance_) + sizeof(account_) +
-           sizeof (tx_info.value) + tx_info.data.length() + sizeof (tx_info.gas) + sizeof (tx_info.gas_price) +
-           sizeof (epoch) +  sizeof(size_t) + 
+           sizeof (tx_info_.value) + tx_info_.data.length() + sizeof (tx_info_.gas) + sizeof (tx_info_.gas_price) +
+           sizeof (epoch_) +  sizeof(size_t) + 
            sizeof (signature);
 
     return size;
@@ -10,6 +10,9 @@
 #include <blake2/blake2.h>
 #include <boost/property_tree/json_parser.hpp>
 #include <src/lib/blocks.hpp>
+#include <src/lib/json.hpp>
+
+#include <atomic>
 
 
 namespace germ
@@ -27,16 +30,22 @@ public:
     uint64_t    gas_price;
 };
 
+class tx_view;
 // Transaction: 
 class tx
 {
 public:
     tx (germ::block_hash const & previous_r, germ::account const & destination_r, germ::block_hash source_r, germ::account const & account, germ::amount const & balance_r, germ::tx_message const &tx_info, germ::epoch_hash const & epoch_r, germ::raw_key const & prv_r, germ::public_key const & pub_r);
+    // Unsigned, the hash doesn't cover the signature so it can be set later with signature_set
+    tx (germ::block_hash const & previous_r, germ::account const & destination_r, germ::block_hash source_r, germ::account const & account, germ::amount const & balance_r, germ::tx_message const &tx_info, germ::epoch_hash const & epoch_r);
     tx (bool & error, germ::stream & stream);
     tx (bool & error, boost::property_tree::ptree const & tree);
+    tx (bool & error, germ::json_value const & value);
     ~tx ();
 
+    // Computed on construction or deserialization and again by each mutator of a hashed field
     germ::block_hash hash () const;
+    germ::block_hash compute_hash () const;
     std::string to_json ();
 
 
@@ -44,17 +53,34 @@ public:
     germ::account destination() const ;
     germ::block_hash previous () const ;
     germ::block_hash source () const ;
+    germ::amount balance () const;
+    germ::account account () const;
+    germ::tx_message const & tx_info () const;
+    germ::epoch_hash epoch () const;
     germ::block_hash root () const ;
+
+    /* Mutator methods, the hash is recomputed */
+    void set_previous (germ::block_hash const &);
+    void set_destination (germ::account const &);
+    void set_source (germ::block_hash const &);
+    void set_balance (germ::amount const &);
+    void set_account (germ::account const &);
+    void set_tx_info (germ::tx_message const &);
+    void set_epoch (germ::epoch_hash const &);
+
     void serialize (germ::stream &) const ;
     void serialize_json (std::string &) const ;
+    void serialize_json (germ::json_writer &) const;
     bool deserialize (germ::stream & stream_r) ;
     bool deserialize_json (boost::property_tree::ptree const & tree_r);
+    bool deserialize_json (germ::json_value const & value_r);
     bool operator== (germ::tx const & other) const;
     void visit (germ::block_visitor & visit_r) const  ;
     germ::block_type type () const ;
     germ::signature block_signature () const ;
     void signature_set (germ::uint512_union const & signature_r) ;
     bool valid_predecessor (germ::tx const & tx) const ;
+    bool valid_predecessor (germ::tx_view const & tx) const ;
 
     static size_t constexpr size_ = sizeof (germ::account) + sizeof (germ::block_hash) + sizeof (germ::block_hash) + sizeof (germ::amount) + sizeof(germ::account) +
                                    sizeof (uint64_t) + sizeof (germ::signature) + sizeof (uint64_t) + sizeof (uint64_t) +  sizeof (std::string) +
@@ -64,6 +90,18 @@ public:
     size_t size() const;
 
 
+    // Not hashed, so it can be set directly
+    germ::signature signature;
+
+    // Number of times a tx hash was computed rather than served from the cache
+    static std::atomic<uint64_t> hashes_computed;
+
+private:
+    template <typename T>
+    bool deserialize_fields (T const &);
+    void rehash ();
+
+    // Hashed fields are only written through the constructors, deserialize and the mutators so hash_cached can't go stale
     germ::block_hash previous_;
     germ::account destination_;
     germ::block_hash source_;
@@ -72,11 +110,67 @@ public:
 
 //    std::vector<germ::amount> accounts_voted;  //  被选举的账户（必须已缴纳保证金）
 
-    germ::tx_message   tx_info;
+    germ::tx_message   tx_info_;
 
-    germ::epoch_hash    epoch;
+    germ::epoch_hash    epoch_;
 
-    germ::signature signature;
+    germ::block_hash hash_cached = germ::block_hash (0);
+};
+
+/**
+ * Read-only view over a serialized tx, fields are copied out of the buffer on access instead of deserializing the whole tx.
+ * The buffer isn't owned, a view of a block in the store is only valid for the lifetime of its read transaction.
+ */
+class tx_view
+{
+public:
+    tx_view ();
+    // Sets error if the buffer is too short for the tx it holds
+    tx_view (bool &, uint8_t const *, size_t);
+    germ::block_hash previous () const;
+    germ::account destination () const;
+    germ::block_hash source () const;
+    germ::amount balance () const;
+    germ::account account () const;
+    uint64_t value () const;
+    // tx_info.data in place, not null terminated
+    uint8_t const * data () const;
+    size_t data_size () const;
+    uint64_t gas () const;
+    uint64_t gas_price () const;
+    germ::epoch_hash epoch () const;
+    germ::signature signature () const;
+    germ::block_hash root () const;
+    germ::block_type type () const;
+    // Deserializes a copy that outlives the buffer
+    std::unique_ptr<germ::tx> materialize () const;
+
+    // Offsets in the layout written by tx::serialize, the fields after tx_info.data move with its length
+    static size_t constexpr previous_offset = 0;
+    static size_t constexpr destination_offset = previous_offset + sizeof (germ::block_hash);
+    static size_t constexpr source_offset = destination_offset + sizeof (germ::account);
+    static size_t constexpr balance_offset = source_offset + sizeof (germ::block_hash);
+    static size_t constexpr account_offset = balance_offset + sizeof (germ::amount);
+    static size_t constexpr value_offset = account_offset + sizeof (germ::account);
+    static size_t constexpr data_size_offset = value_offset + sizeof (uint64_t);
+    static size_t constexpr data_offset = data_size_offset + sizeof (size_t);
+    // Size of a tx with empty data
+    static size_t constexpr fixed_size = data_offset + sizeof (uint64_t) + sizeof (uint64_t) + sizeof (germ::epoch_hash) + sizeof (germ::signature);
+
+private:
+    template <typename T>
+    T get (size_t offset_a) const
+    {
+        static_assert (std::is_pod<T>::value, "Can't read non-standard layout types");
+        assert (offset_a + sizeof (T) <= size);
+        T result;
+        std::copy (bytes + offset_a, bytes + offset_a + sizeof (T), reinterpret_cast<uint8_t *> (&result));
+        return result;
+    }
+    size_t gas_offset () const;
+    uint8_t const * bytes;
+    size_t size;
+    size_t data_length;
 };
 
 template <typename T>
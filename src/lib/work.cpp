@@ -143,6 +143,12 @@ void germ::work_pool::cancel (germ::uint256_union const & root_a)
     });
 }
 
+size_t germ::work_pool::size ()
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    return pending.size ();
+}
+
 void germ::work_pool::stop ()
 {
     std::lock_guard<std::mutex> lock (mutex);
@@ -27,6 +27,7 @@ public:
     void cancel (germ::uint256_union const &);
     void generate (germ::uint256_union const &, std::function<void(boost::optional<uint64_t> const &)>);
     uint64_t generate (germ::uint256_union const &);
+    size_t size ();
     std::atomic<int> ticket;
     bool done;
     std::vector<std::thread> threads;
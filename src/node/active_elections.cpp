@@ -9,10 +9,22 @@
 constexpr int germ::active_elections::deposit_warmup_period_round;
 constexpr int germ::active_elections::deposit_cooldown_period_epoch;
 constexpr int germ::active_elections::witness_max_count_per_voting;
+constexpr size_t germ::active_elections::snapshot_history;
 
 germ::active_elections::active_elections(germ::node & node_r)
-:node(node_r)
+:node(node_r),
+candidate_floor({ germ::account(0), germ::amount(0) })
 {
+    germ::read_transaction transaction(node.store.environment);
+    for (auto i(node.store.witness_tally_begin(transaction)), n(node.store.witness_tally_end()); i != n; ++i)
+    {
+        germ::uint128_union weight;
+        germ::bufferstream stream(reinterpret_cast<uint8_t const *> (i->second.data()), i->second.size());
+        auto error(germ::read(stream, weight));
+        assert(!error);
+        lists.insert(germ::election_tally{ germ::account(i->first.uint256()), weight });
+    }
+    refresh_ranking();
 }
 
 germ::active_elections::~active_elections()
@@ -20,65 +32,160 @@ germ::active_elections::~active_elections()
 }
 
 
-bool germ::active_elections::vote(germ::tx & block, germ::general_account const & general)
+bool germ::active_elections::vote(MDB_txn * transaction_r, germ::tx const & block, germ::general_account const & general)
 {
-    std::lock_guard<std::mutex> lock (mutex);
+    if ( !deposited(general.account) )
+        return false;
 
-    auto deposited(false);
-    for (auto i (lists.begin ()), n (lists.end ()); i != n; ++i)
     {
-        if (general.account == i->account)
-        {
-            deposited = true;
-            break;
-        }
+        // Only accounts already holding a tally can be voted for
+        std::lock_guard<std::mutex> lock (mutex);
+        if (lists.find(general.account) == lists.end())
+            return false;
     }
 
-    if ( !deposited )
-        return false;
+    // deposit paid, the store holds this transaction's view of the tally and the lists follow once it commits
+    germ::amount balance(block.balance ());
+    auto tally(node.store.witness_tally_get(transaction_r, general.account));
+    node.store.witness_tally_put(transaction_r, general.account, tally + balance.number());
+    auto account_l(general.account);
+    node.store.environment.on_commit(transaction_r, [this, account_l, balance]() {
+        tally_add(account_l, balance);
+    });
 
-    // deposit paid
-    germ::block_hash hash = block.hash();
-    germ::transaction transaction_r(node.store.environment, nullptr, false);
-    germ::amount balance = node.store.block_balance(transaction_r, hash);
-    auto account(lists.find(general.account));
+    return true;
+}
+
+void germ::active_elections::tally_add(germ::account const & account_r, germ::amount const & amount_r)
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    germ::amount weight;
+    auto account(lists.find(account_r));
     if (account != lists.end())
     {
-        lists.modify(account, [&balance](germ::election_tally& election){
-            germ::uint128_t weight = election.weight.number() + balance.number();
-            election.weight = germ::amount(weight);
+        weight = germ::amount(account->weight.number() + amount_r.number());
+        lists.modify(account, [&weight](germ::election_tally& election){
+            election.weight = weight;
         });
     }
     else
     {
-        lists.insert(germ::election_tally{ general.account, balance });
+        weight = amount_r;
+        lists.insert(germ::election_tally{ account_r, weight });
+    }
+    if (ranking_affected(account_r, weight))
+    {
+        refresh_ranking();
     }
-
-
-    return true;
 }
 
-bool germ::active_elections::witness_account()
+bool germ::active_elections::ranking_affected(germ::account const & account_r, germ::amount const & weight_r)
 {
-    auto result(false);
+    return candidate_set.find(account_r) != candidate_set.end ()
+        || candidate_set.size() < germ::witness_candidate::witness_candidate_count
+        || candidate_floor.weight < weight_r
+        || (candidate_floor.weight == weight_r && candidate_floor.account < account_r);
+}
 
-    germ::transaction transaction_a (node.store.environment, nullptr, false);
-    for (auto beg(node.wallets.items.begin()), end(node.wallets.items.end()); beg != end; ++beg)
+void germ::active_elections::refresh_ranking()
+{
+    candidate_set.clear();
+    witness_set.clear();
+    auto & by_weight(lists.get<1>());
+    auto i(by_weight.rbegin());
+    for (size_t index(0); index < witness_candidates.size(); ++index)
     {
-        auto wallet(beg->second);
-        for (auto acc_beg (wallet->store.begin (transaction_a)), acc_end (wallet->store.end ()); acc_beg != acc_end; ++acc_beg)
+        germ::account account(0);
+        germ::amount weight(0);
+        if (i != by_weight.rend())
         {
-            germ::account account(germ::uint256_union (acc_beg->first.uint256 ()));
+            account = i->account;
+            weight = i->weight;
+            candidate_floor = *i;
+            candidate_set.insert(account);
+            if (index < witnesses.size())
             {
-                std::lock_guard<std::mutex> lock(mutex);
-                for (auto i(witnesses.begin()), n(witnesses.end()); i != n; ++i )
-                {
-                    if( i->account == account )
-                        return true;
-                }
+                witness_set.insert(account);
+                witnesses[index].account = account;
+                witnesses[index].amount = weight;
             }
+            ++i;
+        }
+        else if (index < witnesses.size())
+        {
+            witnesses[index].account = account;
+            witnesses[index].amount = weight;
+        }
+        witness_candidates[index].account = account;
+        witness_candidates[index].amount = weight;
+    }
+}
+
+bool germ::active_elections::is_witness(germ::account const & account_r)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return witness_set.find(account_r) != witness_set.end();
+}
+
+bool germ::active_elections::is_candidate(germ::account const & account_r)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return candidate_set.find(account_r) != candidate_set.end();
+}
+
+std::vector<germ::election_tally> germ::active_elections::ranking(size_t count_r)
+{
+    std::vector<germ::election_tally> result;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto & by_weight(lists.get<1>());
+    for (auto i(by_weight.rbegin()), n(by_weight.rend()); i != n && result.size() < count_r; ++i)
+    {
+        result.push_back(*i);
+    }
+    return result;
+}
+
+germ::witness_snapshot germ::active_elections::epoch_boundary(germ::epoch_hash const & epoch_r)
+{
+    germ::witness_snapshot result{ epoch_r, ranking(germ::witness_candidate::witness_candidate_count) };
+    std::lock_guard<std::mutex> lock(mutex);
+    snapshots.push_back(result);
+    if (snapshots.size() > snapshot_history)
+    {
+        snapshots.pop_front();
+    }
+    return result;
+}
+
+bool germ::active_elections::epoch_witnesses(germ::epoch_hash const & epoch_r, std::vector<germ::account> & witnesses_r)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto existing(std::find_if(snapshots.rbegin(), snapshots.rend(), [&epoch_r](germ::witness_snapshot const & snapshot_r) { return snapshot_r.epoch == epoch_r; }));
+    auto result(existing != snapshots.rend());
+    if (result)
+    {
+        witnesses_r.clear();
+        for (auto i(existing->candidates.begin()), n(existing->candidates.end()); i != n && witnesses_r.size() < germ::witness::witness_count; ++i)
+        {
+            witnesses_r.push_back(i->account);
         }
     }
+    return result;
+}
+
+bool germ::active_elections::witness_account()
+{
+    std::vector<germ::account> witnesses_l;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        witnesses_l.assign(witness_set.begin(), witness_set.end());
+    }
+    auto result(false);
+    germ::read_transaction transaction_a (node.store.environment);
+    for (auto i(witnesses_l.begin()), n(witnesses_l.end()); i != n && !result; ++i)
+    {
+        result = node.wallets.exists(transaction_a, *i);
+    }
 
     return result;
 }
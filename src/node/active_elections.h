@@ -6,12 +6,25 @@
 #define SRC_ACTIVE_ELECTIONS_H
 
 #include <thread>
+#include <deque>
+#include <unordered_set>
 #include <src/lib/election.h>
 #include <src/lib/tx.h>
+#include <src/node/utility.hpp>
+
+#include <boost/multi_index/composite_key.hpp>
 
 namespace germ
 {
 
+// Ranking as of an epoch block, ordered by weight. The first witness_count entries are the witnesses
+class witness_snapshot
+{
+public:
+    germ::epoch_hash epoch;
+    std::vector<germ::election_tally> candidates;
+};
+
 class node;
 class active_elections
 {
@@ -19,8 +32,19 @@ public:
     active_elections(germ::node & node_r);
     ~active_elections();
 
-    bool vote(germ::tx & block, germ::general_account const & general);
+    // Adds the balance of the tx to the tally of an account already in the lists. The tally is written in the given
+    // write transaction and the in-memory ranking follows once that transaction commits. Returns false for any other account
+    bool vote(MDB_txn * transaction_r, germ::tx const & block, germ::general_account const & general);
+    // Whether any wallet account is a witness
     bool witness_account();
+    bool is_witness(germ::account const & account_r);
+    bool is_candidate(germ::account const & account_r);
+    // Highest tallies first
+    std::vector<germ::election_tally> ranking(size_t count_r);
+    // Record the ranking in effect for an epoch
+    germ::witness_snapshot epoch_boundary(germ::epoch_hash const & epoch_r);
+    // Witnesses elected at the given epoch in rank order, the signers of the epoch that follows it. Returns true if the epoch is in the recorded history
+    bool epoch_witnesses(germ::epoch_hash const & epoch_r, std::vector<germ::account> & witnesses_r);
 
 
     // 申请缴纳一定量的保证金
@@ -38,17 +62,36 @@ public:
     std::array<germ::witness_candidate, germ::witness_candidate::witness_candidate_count> witness_candidates;  // 前50名候选见证人列表
     std::array<germ::witness, germ::witness::witness_count> witnesses;  // 前21名超级见证人列表
 
+    // Ordered by (weight, account) so ties rank the same on every node
     boost::multi_index_container<
     germ::election_tally,
     boost::multi_index::indexed_by<
             boost::multi_index::hashed_unique<boost::multi_index::member<germ::election_tally, germ::account, &germ::election_tally::account>>,
-            boost::multi_index::ordered_non_unique<boost::multi_index::member<germ::election_tally, germ::amount , &germ::election_tally::weight>>>>
+            boost::multi_index::ordered_unique<boost::multi_index::composite_key<germ::election_tally,
+                    boost::multi_index::member<germ::election_tally, germ::amount, &germ::election_tally::weight>,
+                    boost::multi_index::member<germ::election_tally, germ::account, &germ::election_tally::account>>>>>
     lists;  //
 
+    std::unordered_set<germ::account> candidate_set;
+    std::unordered_set<germ::account> witness_set;
+    std::deque<germ::witness_snapshot> snapshots;
+
+    static constexpr size_t snapshot_history = 64;
+
 
     static constexpr int deposit_warmup_period_round = 20; // 提出缴纳保证金后， 需要经过 warmup 轮投票(一轮投票包含21个epoch block)后才有资格成为见证候选人
     static constexpr int deposit_cooldown_period_epoch = 10; // 提出取消保证金后， 需要经过 cooldown个epoch block后才可以退出超级见证人列表
     static constexpr int witness_max_count_per_voting = 22; // 每个账户可以最多选举22个超级节点
+
+private:
+    // Applies a committed tally increase to the lists and the ranking
+    void tally_add(germ::account const & account_r, germ::amount const & amount_r);
+    // Whether a tally change for account can alter the top candidates
+    bool ranking_affected(germ::account const & account_r, germ::amount const & weight_r);
+    // Rebuild the top candidate and witness sets from the ordered index, this only reads witness_candidate_count entries
+    void refresh_ranking();
+    // Lowest ranked candidate, used to skip refreshing for tallies that stay below the top
+    germ::election_tally candidate_floor;
 };
 
 
@@ -133,7 +133,7 @@ std::unique_ptr<germ::tx> germ::tcp_bulk_pull_blocks_server::get_next ()
     auto current = stream->first.uint256 ();
     if (current < request->max_hash)
     {
-        germ::transaction transaction (connection->node->store.environment, nullptr, false);
+        germ::read_transaction transaction (connection->node->store.environment);
         result = connection->node->store.block_get (transaction, current);
 
         ++stream;
@@ -16,7 +16,7 @@
 void germ::tcp_bulk_pull_server::set_current_end ()
 {
     assert (request != nullptr);
-    germ::transaction transaction (connection->node->store.environment, nullptr, false);
+    germ::read_transaction transaction (connection->node->store.environment);
     if (!connection->node->store.block_exists (transaction, request->end))
     {
         if (connection->node->config.logging.bulk_pull_logging ())
@@ -86,7 +86,7 @@ std::unique_ptr<germ::tx> germ::tcp_bulk_pull_server::get_next ()
     std::unique_ptr<germ::tx> result;
     if (current != request->end)
     {
-        germ::transaction transaction (connection->node->store.environment, nullptr, false);
+        germ::read_transaction transaction (connection->node->store.environment);
         result = connection->node->store.block_get (transaction, current);
         if (result != nullptr)
         {
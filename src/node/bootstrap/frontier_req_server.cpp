@@ -109,7 +109,7 @@ void germ::tcp_frontier_req_server::sent_action (boost::system::error_code const
 
 void germ::tcp_frontier_req_server::next ()
 {
-    germ::transaction transaction (connection->node->store.environment, nullptr, false);
+    germ::read_transaction transaction (connection->node->store.environment);
     auto iterator (connection->node->store.latest_begin (transaction, current.number () + 1));
 
     if (iterator != connection->node->store.latest_end ())
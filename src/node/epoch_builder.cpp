@@ -0,0 +1,94 @@
+#include <src/node/epoch_builder.h>
+
+#include <src/node/node.hpp>
+
+size_t constexpr germ::epoch_builder::max_txs;
+std::chrono::seconds constexpr germ::epoch_builder::seal_interval;
+
+germ::epoch_builder::epoch_builder (germ::node & node_a) :
+node (node_a)
+{
+}
+
+void germ::epoch_builder::add (germ::block_hash const & hash_a)
+{
+    auto full (false);
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+        if (pending_set.insert (hash_a).second)
+        {
+            pending.push_back (hash_a);
+            full = pending.size () >= max_txs;
+        }
+    }
+    if (full)
+    {
+        seal ();
+    }
+}
+
+germ::epoch_hash germ::epoch_builder::seal ()
+{
+    germ::epoch_hash result (0);
+    // Seals run one at a time so witness snapshots are recorded in epoch order, add () only waits for the swap below
+    std::lock_guard<std::mutex> seal_lock (seal_mutex);
+    std::vector<germ::block_hash> pending_l;
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+        pending_l.swap (pending);
+        pending_set.clear ();
+    }
+    if (!pending_l.empty ())
+    {
+        // Seals are the only writes to the epoch store, so its map grows here between them
+        node.epoch_store.environment.grow ();
+        {
+            germ::transaction transaction (node.epoch_store.environment, nullptr, true);
+            // A block confirmed again after its epoch was sealed stays in the earlier epoch
+            std::vector<germ::block_hash> txs;
+            txs.reserve (pending_l.size ());
+            for (auto & i : pending_l)
+            {
+                germ::epoch_tx_info info;
+                if (!node.epoch_store.tx_epoch_get (transaction, i, info))
+                {
+                    txs.push_back (i);
+                }
+            }
+            if (!txs.empty ())
+            {
+                // Witness signatures aren't produced yet, the epoch only commits to its predecessor and transactions
+                germ::signature signature;
+                signature.clear ();
+                germ::epoch epoch (germ::seconds_since_epoch (), node.epoch_store.head_get (transaction), signature, txs, std::vector<germ::signature> (), std::vector<germ::signature> ());
+                result = epoch.hash ();
+                node.epoch_store.block_put (transaction, result, epoch);
+                node.epoch_store.head_put (transaction, result);
+            }
+        }
+        if (!result.is_zero ())
+        {
+            // The ranking in effect now elects the witnesses for the epoch after this one
+            node.active_election.epoch_boundary (result);
+        }
+    }
+    return result;
+}
+
+void germ::epoch_builder::ongoing_seal ()
+{
+    seal ();
+    std::weak_ptr<germ::node> node_w (node.shared ());
+    node.alarm.add (std::chrono::steady_clock::now () + seal_interval, [node_w]() {
+        if (auto node_l = node_w.lock ())
+        {
+            node_l->epoch_builder.ongoing_seal ();
+        }
+    });
+}
+
+size_t germ::epoch_builder::size ()
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    return pending.size ();
+}
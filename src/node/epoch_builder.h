@@ -0,0 +1,35 @@
+#pragma once
+
+#include <src/lib/epoch.h>
+
+#include <chrono>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace germ
+{
+class node;
+/**
+ * Collects confirmed transactions into the next epoch.
+ * The epoch is sealed once it's full or on a timer, it's written to the epoch store with each transaction's position so inclusion proofs can be served.
+ */
+class epoch_builder
+{
+public:
+    epoch_builder (germ::node &);
+    void add (germ::block_hash const &);
+    // Writes out the pending transactions as an epoch following the head and records the witness ranking at it
+    // Returns the epoch's hash or zero if there was nothing new to include
+    germ::epoch_hash seal ();
+    void ongoing_seal ();
+    size_t size ();
+    germ::node & node;
+    std::mutex mutex;
+    std::mutex seal_mutex;
+    std::vector<germ::block_hash> pending;
+    std::unordered_set<germ::block_hash> pending_set;
+    static size_t constexpr max_txs = 16384;
+    static std::chrono::seconds constexpr seal_interval = std::chrono::seconds (30);
+};
+}
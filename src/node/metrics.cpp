@@ -0,0 +1,258 @@
+#include <src/node/metrics.hpp>
+
+#include <src/node/bootstrap/bootstrap_attempt.h>
+#include <src/node/node.hpp>
+
+#include <sstream>
+
+std::string const germ::metrics_server::content_type ("application/openmetrics-text; version=1.0.0; charset=utf-8");
+
+germ::metrics_config::metrics_config () :
+enable (false),
+address (boost::asio::ip::address_v6::loopback ()),
+port (germ::metrics_server::metrics_port)
+{
+}
+
+void germ::metrics_config::serialize_json (boost::property_tree::ptree & tree_a) const
+{
+    tree_a.put ("enable", enable);
+    tree_a.put ("address", address.to_string ());
+    tree_a.put ("port", std::to_string (port));
+}
+
+bool germ::metrics_config::deserialize_json (boost::property_tree::ptree const & tree_a)
+{
+    auto result (false);
+    try
+    {
+        enable = tree_a.get<bool> ("enable");
+        auto address_l (tree_a.get<std::string> ("address"));
+        auto port_l (tree_a.get<std::string> ("port"));
+        try
+        {
+            port = std::stoul (port_l);
+            result = port > std::numeric_limits<uint16_t>::max ();
+        }
+        catch (std::logic_error const &)
+        {
+            result = true;
+        }
+        boost::system::error_code ec;
+        address = boost::asio::ip::address_v6::from_string (address_l, ec);
+        if (ec)
+        {
+            result = true;
+        }
+    }
+    catch (std::runtime_error const &)
+    {
+        result = true;
+    }
+    return result;
+}
+
+germ::metrics_server::metrics_server (boost::asio::io_service & service_a, germ::node & node_a, germ::metrics_config const & config_a) :
+acceptor (service_a),
+config (config_a),
+node (node_a)
+{
+}
+
+void germ::metrics_server::start ()
+{
+    auto endpoint (germ::tcp_endpoint (config.address, config.port));
+    acceptor.open (endpoint.protocol ());
+    acceptor.set_option (boost::asio::ip::tcp::acceptor::reuse_address (true));
+
+    boost::system::error_code ec;
+    acceptor.bind (endpoint, ec);
+    if (ec)
+    {
+        BOOST_LOG (node.log) << boost::str (boost::format ("Error while binding for metrics on port %1%: %2%") % endpoint.port () % ec.message ());
+        throw std::runtime_error (ec.message ());
+    }
+
+    acceptor.listen ();
+    accept ();
+}
+
+void germ::metrics_server::accept ()
+{
+    auto connection (std::make_shared<germ::metrics_connection> (node, *this));
+    acceptor.async_accept (connection->socket, [this, connection](boost::system::error_code const & ec) {
+        if (!ec)
+        {
+            accept ();
+            connection->read ();
+        }
+        else if (ec != boost::asio::error::operation_aborted)
+        {
+            BOOST_LOG (this->node.log) << boost::str (boost::format ("Error accepting metrics connections: %1%") % ec);
+        }
+    });
+}
+
+void germ::metrics_server::stop ()
+{
+    boost::system::error_code ec;
+    acceptor.close (ec);
+}
+
+namespace
+{
+/** Writes stat counters as samples of one counter family, labelled by type, detail and direction */
+class openmetrics_writer : public germ::stat_log_sink
+{
+public:
+    openmetrics_writer (std::ostream & stream_a) :
+    stream (stream_a)
+    {
+    }
+    std::ostream & out () override
+    {
+        return stream;
+    }
+    void write_entry (tm &, std::string type, std::string detail, std::string dir, uint64_t value) override
+    {
+        stream << "germ_stat_total{type=\"" << type << "\",detail=\"" << detail << "\",dir=\"" << dir << "\"} " << value << '\n';
+    }
+    std::ostream & stream;
+};
+
+void family (std::ostream & stream_a, std::string const & name_a, std::string const & type_a, std::string const & help_a)
+{
+    stream_a << "# TYPE " << name_a << ' ' << type_a << '\n';
+    stream_a << "# HELP " << name_a << ' ' << help_a << '\n';
+}
+
+void gauge (std::ostream & stream_a, std::string const & name_a, std::string const & help_a, uint64_t value_a)
+{
+    family (stream_a, name_a, "gauge", help_a);
+    stream_a << name_a << ' ' << value_a << '\n';
+}
+
+// Histogram buckets are cumulative and bounded inclusively, each power of two bucket is reported against its upper limit
+void histogram (std::ostream & stream_a, std::string const & name_a, std::string const & labels_a, germ::stat_histogram const & histogram_a, double scale_a)
+{
+    auto separator (labels_a.empty () ? "" : ",");
+    uint64_t total (0);
+    for (size_t i (0); i < germ::stat_histogram::bucket_count; ++i)
+    {
+        total += histogram_a.buckets[i].load ();
+        stream_a << name_a << "_bucket{" << labels_a << separator << "le=\"";
+        if (i + 1 < germ::stat_histogram::bucket_count)
+        {
+            stream_a << germ::stat_histogram::bucket_limit (i) * scale_a;
+        }
+        else
+        {
+            stream_a << "+Inf";
+        }
+        stream_a << "\"} " << total << '\n';
+    }
+    stream_a << name_a << "_count";
+    if (!labels_a.empty ())
+    {
+        stream_a << '{' << labels_a << '}';
+    }
+    stream_a << ' ' << total << '\n';
+}
+}
+
+std::string germ::metrics_server::render ()
+{
+    std::ostringstream stream;
+    stream.precision (12);
+
+    // Counters are aggregated under the stat lock only, updating them never waits on it
+    family (stream, "germ_stat", "counter", "Node statistics counters, detail all is the total for the type");
+    openmetrics_writer sink (stream);
+    node.stats.log_counters (sink);
+
+    gauge (stream, "germ_block_processor_queue", "Blocks waiting in the block processor", node.block_processor.size ());
+    gauge (stream, "germ_vote_processor_queue", "Votes waiting in the vote processor", node.vote_processor.size ());
+    gauge (stream, "germ_vote_processor_queue_peak", "Most votes waiting in the vote processor at once", node.vote_processor.queued_peak.load ());
+    gauge (stream, "germ_active_elections", "Elections in progress", node.active.size ());
+    gauge (stream, "germ_peers", "Peers in the peer container", node.peers.size ());
+    gauge (stream, "germ_work_pool_queue", "Work generation requests queued", node.work.size ());
+    {
+        germ::read_transaction transaction (node.store.environment);
+        gauge (stream, "germ_unchecked_blocks", "Blocks waiting on a dependency", node.store.unchecked_count (transaction));
+    }
+
+    auto & environment (node.store.environment);
+    MDB_envinfo info;
+    auto status (mdb_env_info (environment, &info));
+    assert (status == 0);
+    MDB_stat stat;
+    status = mdb_env_stat (environment, &stat);
+    assert (status == 0);
+    gauge (stream, "germ_lmdb_map_size_bytes", "Size of the ledger memory map", info.me_mapsize);
+    gauge (stream, "germ_lmdb_map_used_bytes", "Bytes of the ledger memory map in use", (info.me_last_pgno + 1) * stat.ms_psize);
+    gauge (stream, "germ_lmdb_reader_slots_used", "Ledger reader table slots in use", info.me_numreaders);
+    gauge (stream, "germ_lmdb_reader_slots_max", "Ledger reader table size", info.me_maxreaders);
+    gauge (stream, "germ_lmdb_readers_active", "Ledger read transactions handed out", environment.readers_active.load ());
+
+    auto attempt (node.bootstrap_initiator.current_attempt ());
+    gauge (stream, "germ_bootstrap_in_progress", "1 while a bootstrap attempt is running", attempt != nullptr ? 1 : 0);
+    gauge (stream, "germ_bootstrap_connections", "Connections of the current bootstrap attempt", attempt != nullptr ? attempt->connections.load () : 0);
+    gauge (stream, "germ_bootstrap_pulling", "Pulls in flight in the current bootstrap attempt", attempt != nullptr ? attempt->pulling.load () : 0);
+    gauge (stream, "germ_bootstrap_accounts", "Accounts found by the current bootstrap attempt", attempt != nullptr ? attempt->account_count.load () : 0);
+    gauge (stream, "germ_bootstrap_blocks", "Blocks pulled by the current bootstrap attempt", attempt != nullptr ? attempt->total_blocks.load () : 0);
+
+    family (stream, "germ_election_confirmation_seconds", "histogram", "Time from election start to confirmation");
+    stream << "# UNIT germ_election_confirmation_seconds seconds\n";
+    histogram (stream, "germ_election_confirmation_seconds", "", node.active.confirmation_latency, 1e-3);
+
+    family (stream, "germ_block_stage_seconds", "histogram", "Time from a traced block's first stage to each later stage");
+    stream << "# UNIT germ_block_stage_seconds seconds\n";
+    for (size_t i (0); i < germ::block_tracer::stage_count; ++i)
+    {
+        auto stage (germ::block_tracer::stage_to_string (static_cast<germ::block_stage> (i)));
+        histogram (stream, "germ_block_stage_seconds", "stage=\"" + stage + "\"", node.tracer.histograms[i], 1e-6);
+    }
+
+    stream << "# EOF\n";
+    return stream.str ();
+}
+
+germ::metrics_connection::metrics_connection (germ::node & node_a, germ::metrics_server & server_a) :
+node (node_a.shared ()),
+server (server_a),
+socket (node_a.service)
+{
+}
+
+void germ::metrics_connection::read ()
+{
+    auto this_l (shared_from_this ());
+    boost::beast::http::async_read (socket, buffer, request, [this_l](boost::system::error_code const & ec, size_t bytes_transferred) {
+        if (ec)
+        {
+            return;
+        }
+        this_l->node->background ([this_l]() {
+            auto & res (this_l->res);
+            res.version (this_l->request.version ());
+            res.set ("Connection", "close");
+            if (this_l->request.method () != boost::beast::http::verb::get)
+            {
+                res.result (boost::beast::http::status::method_not_allowed);
+            }
+            else if (this_l->request.target () != "/metrics")
+            {
+                res.result (boost::beast::http::status::not_found);
+            }
+            else
+            {
+                res.result (boost::beast::http::status::ok);
+                res.set ("Content-Type", germ::metrics_server::content_type);
+                res.body () = this_l->server.render ();
+            }
+            res.prepare_payload ();
+            boost::beast::http::async_write (this_l->socket, res, [this_l](boost::system::error_code const & ec, size_t bytes_transferred) {
+            });
+        });
+    });
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <src/config.hpp>
+#include <src/node/utility.hpp>
+
+#include <string>
+
+namespace germ
+{
+class node;
+/**
+ * Options for the metrics listener, a local HTTP endpoint serving node statistics as OpenMetrics text.
+ * It's separate from RPC so monitoring can be exposed without opening the RPC port.
+ */
+class metrics_config
+{
+public:
+    metrics_config ();
+    void serialize_json (boost::property_tree::ptree &) const;
+    bool deserialize_json (boost::property_tree::ptree const &);
+    bool enable;
+    boost::asio::ip::address_v6 address;
+    uint16_t port;
+};
+class metrics_server
+{
+public:
+    metrics_server (boost::asio::io_service &, germ::node &, germ::metrics_config const &);
+    void start ();
+    void accept ();
+    void stop ();
+    // Current state of the node in the OpenMetrics text format
+    std::string render ();
+    boost::asio::ip::tcp::acceptor acceptor;
+    germ::metrics_config const & config;
+    germ::node & node;
+    static uint16_t const metrics_port = germ::rai_network == germ::germ_networks::germ_live_network ? 7078 : 56000;
+    static std::string const content_type;
+};
+class metrics_connection : public std::enable_shared_from_this<germ::metrics_connection>
+{
+public:
+    metrics_connection (germ::node &, germ::metrics_server &);
+    void read ();
+    std::shared_ptr<germ::node> node;
+    germ::metrics_server & server;
+    boost::asio::ip::tcp::socket socket;
+    boost::beast::flat_buffer buffer;
+    boost::beast::http::request<boost::beast::http::string_body> request;
+    boost::beast::http::response<boost::beast::http::string_body> res;
+};
+}
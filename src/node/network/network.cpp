@@ -298,7 +298,7 @@ germ::endpoint germ::udp_network::endpoint ()
 template <typename T>
 void rep_query (germ::node & node_a, T const & peers_a)
 {
-    germ::transaction transaction (node_a.store.environment, nullptr, false);
+    germ::read_transaction transaction (node_a.store.environment);
     std::shared_ptr<germ::tx> block (node_a.store.block_random (transaction));
     auto hash (block->hash ());
     node_a.rep_crawler.add (hash);
@@ -361,6 +361,7 @@ namespace
             }
             node.stats.inc (germ::stat::type::message, germ::stat::detail::publish, germ::stat::dir::in);
             node.peers.contacted (sender, message_a.header.version);
+            node.tracer.add (message_a.block->hash (), germ::block_stage::arrival);
             node.process_active (message_a.block);
         }
         void confirm_req (germ::confirm_req const & message_a) override
@@ -372,7 +373,7 @@ namespace
             node.stats.inc (germ::stat::type::message, germ::stat::detail::confirm_req, germ::stat::dir::in);
             node.peers.contacted (sender, message_a.header.version);
             node.process_active (message_a.block);
-            germ::transaction transaction_a (node.store.environment, nullptr, false);
+            germ::read_transaction transaction_a (node.store.environment);
             auto successor (node.ledger.successor (transaction_a, message_a.block->root ()));
             if (successor != nullptr)
             {
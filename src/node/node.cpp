@@ -34,7 +34,10 @@ std::chrono::minutes constexpr germ::node::backup_interval;
 int constexpr germ::port_mapping::mapping_timeout;
 int constexpr germ::port_mapping::check_timeout;
 unsigned constexpr germ::active_transactions::announce_interval_ms;
+unsigned constexpr germ::active_transactions::announce_backoff;
 size_t constexpr germ::block_arrival::arrival_size_min;
+size_t constexpr germ::vote_processor::max_votes;
+size_t constexpr germ::vote_processor::verify_batch_size;
 std::chrono::seconds constexpr germ::block_arrival::arrival_time_min;
 
 germ::endpoint germ::map_endpoint_to_v6 (germ::endpoint const & endpoint_a)
@@ -182,9 +185,9 @@ bool confirm_block (MDB_txn * transaction_a, germ::node & node_a, T & list_a, st
     bool result (false);
     if (node_a.config.enable_voting)
     {
-        node_a.wallets.foreach_representative (transaction_a, [&result, &block_a, &list_a, &node_a, &transaction_a](germ::public_key const & pub_a, germ::raw_key const & prv_a) {
+        for (auto & vote : node_a.votes_generate (transaction_a, block_a))
+        {
             result = true;
-            auto vote (node_a.store.vote_generate (transaction_a, pub_a, prv_a, block_a));
             germ::confirm_ack confirm (vote);
             std::shared_ptr<std::vector<uint8_t>> bytes (new std::vector<uint8_t>);
             {
@@ -195,7 +198,7 @@ bool confirm_block (MDB_txn * transaction_a, germ::node & node_a, T & list_a, st
             {
                 node_a.network.confirm_send (confirm, bytes, *j);
             }
-        });
+        }
     }
     return result;
 }
@@ -328,7 +331,7 @@ void germ::network::send_confirm_req (germ::endpoint const & endpoint_a, std::sh
 template <typename T>
 void rep_query (germ::node & node_a, T const & peers_a)
 {
-    germ::transaction transaction (node_a.store.environment, nullptr, false);
+    germ::read_transaction transaction (node_a.store.environment);
 
 
     std::shared_ptr<germ::tx> block (node_a.store.block_random (transaction));
@@ -393,6 +396,7 @@ public:
         }
         node.stats.inc (germ::stat::type::message, germ::stat::detail::publish, germ::stat::dir::in);
         node.peers.contacted (sender, message_a.header.version);
+        node.tracer.add (message_a.block->hash (), germ::block_stage::arrival);
         node.process_active (message_a.block);
     }
     void confirm_req (germ::confirm_req const & message_a) override
@@ -404,7 +408,7 @@ public:
         node.stats.inc (germ::stat::type::message, germ::stat::detail::confirm_req, germ::stat::dir::in);
         node.peers.contacted (sender, message_a.header.version);
         node.process_active (message_a.block);
-        germ::transaction transaction_a (node.store.environment, nullptr, false);
+        germ::read_transaction transaction_a (node.store.environment);
         auto successor (node.ledger.successor (transaction_a, message_a.block->root ()));
         if (successor != nullptr)
         {
@@ -948,6 +952,7 @@ enable_voting (true),
 bootstrap_connections (4),
 bootstrap_connections_max (64),
 callback_port (0),
+active_elections_size (50000),
 lmdb_max_dbs (128)
 {
     switch (germ::rai_network)
@@ -986,7 +991,7 @@ lmdb_max_dbs (128)
 
 void germ::node_config::serialize_json (boost::property_tree::ptree & tree_a) const
 {
-    tree_a.put ("version", "12");
+    tree_a.put ("version", "16");
     tree_a.put ("peering_port", std::to_string (peering_port));
     tree_a.put ("bootstrap_fraction_numerator", std::to_string (bootstrap_fraction_numerator));
     tree_a.put ("receive_minimum", receive_minimum.to_string_dec ());
@@ -1028,7 +1033,17 @@ void germ::node_config::serialize_json (boost::property_tree::ptree & tree_a) co
     tree_a.put ("callback_address", callback_address);
     tree_a.put ("callback_port", std::to_string (callback_port));
     tree_a.put ("callback_target", callback_target);
+    tree_a.put ("active_elections_size", std::to_string (active_elections_size));
     tree_a.put ("lmdb_max_dbs", lmdb_max_dbs);
+    boost::property_tree::ptree lmdb_l;
+    lmdb_config.serialize_json (lmdb_l);
+    tree_a.add_child ("lmdb", lmdb_l);
+    boost::property_tree::ptree metrics_l;
+    metrics_config.serialize_json (metrics_l);
+    tree_a.add_child ("metrics", metrics_l);
+    boost::property_tree::ptree subscription_l;
+    subscription_config.serialize_json (subscription_l);
+    tree_a.add_child ("subscription", subscription_l);
     tree_a.put ("state_block_parse_canary", state_block_parse_canary.to_string ());
     tree_a.put ("state_block_generate_canary", state_block_generate_canary.to_string ());
 }
@@ -1127,6 +1142,40 @@ bool germ::node_config::upgrade_json (unsigned version, boost::property_tree::pt
             result = true;
         }
         case 12:
+        {
+            boost::property_tree::ptree lmdb_l;
+            lmdb_config.serialize_json (lmdb_l);
+            tree_a.add_child ("lmdb", lmdb_l);
+            tree_a.erase ("version");
+            tree_a.put ("version", "13");
+            result = true;
+        }
+        case 13:
+        {
+            tree_a.put ("active_elections_size", std::to_string (active_elections_size));
+            tree_a.erase ("version");
+            tree_a.put ("version", "14");
+            result = true;
+        }
+        case 14:
+        {
+            boost::property_tree::ptree metrics_l;
+            metrics_config.serialize_json (metrics_l);
+            tree_a.add_child ("metrics", metrics_l);
+            tree_a.erase ("version");
+            tree_a.put ("version", "15");
+            result = true;
+        }
+        case 15:
+        {
+            boost::property_tree::ptree subscription_l;
+            subscription_config.serialize_json (subscription_l);
+            tree_a.add_child ("subscription", subscription_l);
+            tree_a.erase ("version");
+            tree_a.put ("version", "16");
+            result = true;
+        }
+        case 16:
             break;
         default:
             throw std::runtime_error ("Unknown node_config version");
@@ -1210,7 +1259,11 @@ bool germ::node_config::deserialize_json (bool & upgraded_a, boost::property_tre
         callback_address = tree_a.get<std::string> ("callback_address");
         auto callback_port_l (tree_a.get<std::string> ("callback_port"));
         callback_target = tree_a.get<std::string> ("callback_target");
+        auto active_elections_size_l (tree_a.get<std::string> ("active_elections_size"));
         auto lmdb_max_dbs_l = tree_a.get<std::string> ("lmdb_max_dbs");
+        auto & lmdb_l (tree_a.get_child ("lmdb"));
+        auto & metrics_l (tree_a.get_child ("metrics"));
+        auto & subscription_l (tree_a.get_child ("subscription"));
         result |= parse_port (callback_port_l, callback_port);
         auto state_block_parse_canary_l = tree_a.get<std::string> ("state_block_parse_canary");
         auto state_block_generate_canary_l = tree_a.get<std::string> ("state_block_generate_canary");
@@ -1223,16 +1276,21 @@ bool germ::node_config::deserialize_json (bool & upgraded_a, boost::property_tre
             work_threads = std::stoul (work_threads_l);
             bootstrap_connections = std::stoul (bootstrap_connections_l);
             bootstrap_connections_max = std::stoul (bootstrap_connections_max_l);
+            active_elections_size = std::stoul (active_elections_size_l);
             lmdb_max_dbs = std::stoi (lmdb_max_dbs_l);
             online_weight_quorum = std::stoul (online_weight_quorum_l);
             result |= peering_port > std::numeric_limits<uint16_t>::max ();
             result |= logging.deserialize_json (upgraded_a, logging_l);
+            result |= lmdb_config.deserialize_json (lmdb_l);
+            result |= metrics_config.deserialize_json (metrics_l);
+            result |= subscription_config.deserialize_json (subscription_l);
             result |= receive_minimum.decode_dec (receive_minimum_l);
             result |= online_weight_minimum.decode_dec (online_weight_minimum_l);
             result |= online_weight_quorum > 100;
             result |= password_fanout < 16;
             result |= password_fanout > 1024 * 1024;
             result |= io_threads == 0;
+            result |= active_elections_size == 0;
             result |= state_block_parse_canary.decode_hex (state_block_parse_canary_l);
             result |= state_block_generate_canary.decode_hex (state_block_generate_canary_l);
         }
@@ -1257,46 +1315,187 @@ germ::account germ::node_config::random_representative ()
 }
 
 germ::vote_processor::vote_processor (germ::node & node_a) :
-node (node_a)
+node (node_a),
+queued (0),
+queued_peak (0),
+stopped (false),
+active (false)
 {
 }
 
-germ::vote_code germ::vote_processor::vote (std::shared_ptr<germ::vote> vote_a, germ::endpoint endpoint_a)
+void germ::vote_processor::vote (std::shared_ptr<germ::vote> vote_a, germ::endpoint endpoint_a)
 {
-    auto result (germ::vote_code::invalid);
-    if (!vote_a->validate ())
+    auto process (false);
     {
-        result = germ::vote_code::replay;
-        std::shared_ptr<germ::vote> max_vote;
+        std::unique_lock<std::mutex> lock (mutex);
+        if (!stopped)
         {
-            germ::transaction transaction (node.store.environment, nullptr, false);
-            max_vote = node.store.vote_max (transaction, vote_a);
+            auto size (votes.size ());
+            process = size < max_votes / 2;
+            if (!process && size < max_votes)
+            {
+                // Weights are served from memory so this doesn't reach the database
+                lock.unlock ();
+                process = node.weight (vote_a->account) >= node.online_reps.online_stake () / 1000;
+                lock.lock ();
+                process = process && !stopped && votes.size () < max_votes;
+            }
+            if (process)
+            {
+                votes.push_back (std::make_pair (vote_a, endpoint_a));
+                queued = votes.size ();
+                queued_peak = std::max (queued_peak.load (), votes.size ());
+                condition.notify_all ();
+            }
         }
-        if (!node.active.vote (vote_a) || max_vote->sequence > vote_a->sequence)
+    }
+    if (!process)
+    {
+        node.stats.inc (germ::stat::type::vote, germ::stat::detail::vote_overflow);
+    }
+}
+
+void germ::vote_processor::process_loop ()
+{
+    std::unique_lock<std::mutex> lock (mutex);
+    while (!stopped)
+    {
+        if (!votes.empty ())
         {
-            result = germ::vote_code::vote;
+            std::deque<std::pair<std::shared_ptr<germ::vote>, germ::endpoint>> votes_l;
+            votes_l.swap (votes);
+            queued = 0;
+            active = true;
+            lock.unlock ();
+            verify_votes (votes_l);
+            std::vector<std::shared_ptr<germ::vote>> valid;
+            valid.reserve (votes_l.size ());
+            std::vector<std::shared_ptr<germ::vote>> max_votes_l;
+            max_votes_l.reserve (votes_l.size ());
+            {
+                germ::read_transaction transaction (node.store.environment);
+                for (auto & i : votes_l)
+                {
+                    valid.push_back (i.first);
+                    max_votes_l.push_back (node.store.vote_max (transaction, i.first));
+                }
+                auto replays (node.active.vote (transaction, valid));
+                for (size_t i (0), n (valid.size ()); i < n; ++i)
+                {
+                    auto result (!replays[i] || max_votes_l[i]->sequence > valid[i]->sequence ? germ::vote_code::vote : germ::vote_code::replay);
+                    vote_result (valid[i], votes_l[i].second, result, max_votes_l[i]);
+                }
+            }
+            lock.lock ();
+            active = false;
+            condition.notify_all ();
         }
-        switch (result)
+        else
         {
-            case germ::vote_code::vote:
-                node.observers.vote.notify (vote_a, endpoint_a);
-            case germ::vote_code::replay:
-                // This tries to assist rep nodes that have lost track of their highest sequence number by replaying our highest known vote back to them
-                // Only do this if the sequence number is significantly different to account for network reordering
-                // Amplify attack considerations: We're sending out a confirm_ack in response to a confirm_ack for no net traffic increase
-                if (max_vote->sequence > vote_a->sequence + 10000)
+            condition.wait (lock);
+        }
+    }
+}
+
+void germ::vote_processor::verify_votes (std::deque<std::pair<std::shared_ptr<germ::vote>, germ::endpoint>> & votes_a)
+{
+    auto size (votes_a.size ());
+    std::vector<germ::uint256_union> hashes;
+    hashes.reserve (size);
+    std::vector<unsigned char const *> messages;
+    messages.reserve (size);
+    std::vector<size_t> lengths (size, sizeof (germ::uint256_union));
+    std::vector<unsigned char const *> pub_keys;
+    pub_keys.reserve (size);
+    std::vector<unsigned char const *> signatures;
+    signatures.reserve (size);
+    std::vector<int> verifications (size, 0);
+    for (auto & i : votes_a)
+    {
+        hashes.push_back (i.first->hash ());
+        messages.push_back (hashes.back ().bytes.data ());
+        pub_keys.push_back (i.first->account.bytes.data ());
+        signatures.push_back (i.first->signature.bytes.data ());
+    }
+    // Chunks are shared between this thread and the signer pool's threads
+    node.signer.parallel ((size + verify_batch_size - 1) / verify_batch_size, [&](size_t chunk_a) {
+        auto begin (chunk_a * verify_batch_size);
+        auto count (std::min (verify_batch_size, size - begin));
+        germ::validate_message_batch (messages.data () + begin, lengths.data () + begin, pub_keys.data () + begin, signatures.data () + begin, count, verifications.data () + begin);
+    });
+    std::deque<std::pair<std::shared_ptr<germ::vote>, germ::endpoint>> result;
+    for (size_t i (0); i < size; ++i)
+    {
+        if (verifications[i] == 1)
+        {
+            result.push_back (std::move (votes_a[i]));
+        }
+        else
+        {
+            vote_result (votes_a[i].first, votes_a[i].second, germ::vote_code::invalid, nullptr);
+        }
+    }
+    node.stats.add (germ::stat::type::vote, germ::stat::detail::vote_verified, germ::stat::dir::in, result.size ());
+    votes_a.swap (result);
+}
+
+void germ::vote_processor::flush ()
+{
+    std::unique_lock<std::mutex> lock (mutex);
+    while (!stopped && (active || !votes.empty ()))
+    {
+        condition.wait (lock);
+    }
+}
+
+void germ::vote_processor::stop ()
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    stopped = true;
+    condition.notify_all ();
+}
+
+size_t germ::vote_processor::size ()
+{
+    return queued.load ();
+}
+
+germ::vote_code germ::vote_processor::vote_blocking (MDB_txn * transaction_a, std::shared_ptr<germ::vote> vote_a, germ::endpoint endpoint_a, bool validated_a)
+{
+    auto result (germ::vote_code::invalid);
+    std::shared_ptr<germ::vote> max_vote;
+    if (validated_a || !vote_a->validate ())
+    {
+        max_vote = node.store.vote_max (transaction_a, vote_a);
+        auto replay (node.active.vote (transaction_a, std::vector<std::shared_ptr<germ::vote>> (1, vote_a))[0]);
+        result = !replay || max_vote->sequence > vote_a->sequence ? germ::vote_code::vote : germ::vote_code::replay;
+    }
+    vote_result (vote_a, endpoint_a, result, max_vote);
+    return result;
+}
+
+void germ::vote_processor::vote_result (std::shared_ptr<germ::vote> vote_a, germ::endpoint const & endpoint_a, germ::vote_code result, std::shared_ptr<germ::vote> max_vote)
+{
+    switch (result)
+    {
+        case germ::vote_code::vote:
+            node.observers.vote.notify (vote_a, endpoint_a);
+        case germ::vote_code::replay:
+            // This tries to assist rep nodes that have lost track of their highest sequence number by replaying our highest known vote back to them
+            // Only do this if the sequence number is significantly different to account for network reordering
+            // Amplify attack considerations: We're sending out a confirm_ack in response to a confirm_ack for no net traffic increase
+            if (max_vote->sequence > vote_a->sequence + 10000)
+            {
+                germ::confirm_ack confirm (max_vote);
+                std::shared_ptr<std::vector<uint8_t>> bytes (new std::vector<uint8_t>);
                 {
-                    germ::confirm_ack confirm (max_vote);
-                    std::shared_ptr<std::vector<uint8_t>> bytes (new std::vector<uint8_t>);
-                    {
-                        germ::vectorstream stream (*bytes);
-                        confirm.serialize (stream);
-                    }
-                    node.network.confirm_send (confirm, bytes, endpoint_a);
+                    germ::vectorstream stream (*bytes);
+                    confirm.serialize (stream);
                 }
-            case germ::vote_code::invalid:
-                break;
-        }
+                node.network.confirm_send (confirm, bytes, endpoint_a);
+            }
+        case germ::vote_code::invalid:
+            break;
     }
     if (node.config.logging.vote_logging ())
     {
@@ -1318,7 +1517,6 @@ germ::vote_code germ::vote_processor::vote (std::shared_ptr<germ::vote> vote_a,
         }
         BOOST_LOG (node.log) << boost::str (boost::format ("Vote from: %1% sequence: %2% block: %3% status: %4%") % vote_a->account.to_account () % std::to_string (vote_a->sequence) % vote_a->block->hash ().to_string () % status);
     }
-    return result;
 }
 
 void germ::rep_crawler::add (germ::block_hash const & hash_a)
@@ -1342,6 +1540,7 @@ bool germ::rep_crawler::exists (germ::block_hash const & hash_a)
 germ::block_processor::block_processor (germ::node & node_a) :
 stopped (false),
 active (false),
+queued (0),
 node (node_a),
 next_log (std::chrono::steady_clock::now ())
 {
@@ -1362,7 +1561,7 @@ void germ::block_processor::stop ()
 void germ::block_processor::flush ()
 {
     std::unique_lock<std::mutex> lock (mutex);
-    while (!stopped && (!blocks.empty () || active))
+    while (!stopped && (!retry.empty () || !blocks.empty () || active))
     {
         condition.wait (lock);
     }
@@ -1389,9 +1588,11 @@ void germ::block_processor::add (std::shared_ptr<germ::tx> block_a, std::chrono:
 //    }
 
 
+    node.tracer.add (block_a->hash (), germ::block_stage::queued);
     {
         std::lock_guard<std::mutex> lock (mutex);
         blocks.push_front (std::make_pair (block_a, origination));
+        ++queued;
         condition.notify_all ();
     }
 }
@@ -1400,9 +1601,15 @@ void germ::block_processor::force (std::shared_ptr<germ::tx> block_a)
 {
     std::lock_guard<std::mutex> lock (mutex);
     forced.push_front (block_a);
+    ++queued;
     condition.notify_all ();
 }
 
+size_t germ::block_processor::size ()
+{
+    return queued.load ();
+}
+
 void germ::block_processor::process_blocks ()
 {
     std::unique_lock<std::mutex> lock (mutex);
@@ -1439,57 +1646,133 @@ bool germ::block_processor::should_log ()
 bool germ::block_processor::have_blocks ()
 {
     assert (!mutex.try_lock ());
-    return !blocks.empty () || !forced.empty ();
+    return !retry.empty () || !blocks.empty () || !forced.empty ();
 }
 
 void germ::block_processor::process_receive_many (std::unique_lock<std::mutex> & lock_a)
 {
+    auto & environment (node.store.environment);
+    // The map can only grow between write transactions, after running out of space wait for open transactions to finish instead of failing again
+    while (environment.grow () && environment.map_full)
     {
-        germ::transaction transaction (node.store.environment, nullptr, true);
+        lock_a.lock ();
+        auto stopped_l (stopped);
+        lock_a.unlock ();
+        if (stopped_l)
+        {
+            return;
+        }
+        std::this_thread::sleep_for (std::chrono::milliseconds (1));
+    }
+    // Blocks taken from the queues in this batch, with whether they were forced
+    std::vector<std::pair<std::pair<std::shared_ptr<germ::tx>, std::chrono::steady_clock::time_point>, bool>> batch;
+    std::vector<std::function<void (MDB_txn *)>> effects;
+    auto full (false);
+    {
+        germ::transaction transaction (environment, nullptr, true);
         auto cutoff (std::chrono::steady_clock::now () + germ::transaction_timeout);
         lock_a.lock ();
         auto count (0);
-        while (have_blocks () && count < 16384)
+        while (!full && have_blocks () && count < 16384)
         {
             if (blocks.size () > 64 && should_log ())
             {
                 BOOST_LOG (node.log) << boost::str (boost::format ("%1% blocks in processing queue") % blocks.size ());
             }
-            std::pair<std::shared_ptr<germ::tx>, std::chrono::steady_clock::time_point> block;
-            bool force (false);
-            if (forced.empty ())
+            std::pair<std::pair<std::shared_ptr<germ::tx>, std::chrono::steady_clock::time_point>, bool> item;
+            if (!retry.empty ())
+            {
+                item = retry.front ();
+                retry.pop_front ();
+            }
+            else if (forced.empty ())
             {
-                block = blocks.front ();
+                item = std::make_pair (blocks.front (), false);
                 blocks.pop_front ();
             }
             else
             {
-                block = std::make_pair (forced.front (), std::chrono::steady_clock::now ());
+                item = std::make_pair (std::make_pair (forced.front (), std::chrono::steady_clock::now ()), true);
                 forced.pop_front ();
-                force = true;
             }
+            --queued;
             lock_a.unlock ();
+            batch.push_back (item);
+            auto & block (item.first);
             auto hash (block.first->hash ());
-            if (force)
+            try
             {
-                auto successor (node.ledger.successor (transaction, block.first->root ()));
-                if (successor != nullptr && successor->hash () != hash)
+                if (item.second)
                 {
-                    // Replace our block with the winner and roll back any dependent blocks
-                    BOOST_LOG (node.log) << boost::str (boost::format ("Rolling back %1% and replacing with %2%") % successor->hash ().to_string () % hash.to_string ());
-                    node.ledger.rollback (transaction, successor->hash ());
+                    auto successor (node.ledger.successor (transaction, block.first->root ()));
+                    if (successor != nullptr && successor->hash () != hash)
+                    {
+                        // Replace our block with the winner and roll back any dependent blocks
+                        BOOST_LOG (node.log) << boost::str (boost::format ("Rolling back %1% and replacing with %2%") % successor->hash ().to_string () % hash.to_string ());
+                        node.ledger.rollback (transaction, successor->hash ());
+                    }
                 }
+                auto process_result (process_receive_one (transaction, block.first, block.second, effects));
+                (void)process_result;
+            }
+            catch (germ::map_full_error const &)
+            {
+                // The transaction can't be used any more, the whole batch is redone once the map has grown
+                full = true;
             }
-            auto process_result (process_receive_one (transaction, block.first, block.second));
-            (void)process_result;
             lock_a.lock ();
             ++count;
         }
+        lock_a.unlock ();
+        auto status (transaction.commit ());
+        assert (status == 0 || status == MDB_MAP_FULL || full);
+        full = status != 0;
+    }
+    if (!full)
+    {
+        committed (effects);
+    }
+    else if (environment.config.map_growth != 0)
+    {
+        // Nothing from the batch was written and its effects only run on commit, it's processed again first and in the same order
+        BOOST_LOG (node.log) << boost::str (boost::format ("Ledger map full, retrying %1% blocks") % batch.size ());
+        lock_a.lock ();
+        retry.insert (retry.begin (), batch.begin (), batch.end ());
+        queued += batch.size ();
+        lock_a.unlock ();
+    }
+    else
+    {
+        BOOST_LOG (node.log) << boost::str (boost::format ("Ledger map full and map_growth is 0, dropped %1% blocks") % batch.size ());
     }
-    lock_a.unlock ();
 }
 
 germ::process_return germ::block_processor::process_receive_one (MDB_txn * transaction_a, std::shared_ptr<germ::tx> block_a, std::chrono::steady_clock::time_point origination)
+{
+    auto effects (std::make_shared<std::vector<std::function<void (MDB_txn *)>>> ());
+    auto result (process_receive_one (transaction_a, block_a, origination, *effects));
+    if (!effects->empty ())
+    {
+        node.store.environment.on_commit (transaction_a, [this, effects]() {
+            committed (*effects);
+        });
+    }
+    return result;
+}
+
+void germ::block_processor::committed (std::vector<std::function<void (MDB_txn *)>> const & effects_a)
+{
+    if (!effects_a.empty ())
+    {
+        germ::read_transaction transaction (node.store.environment);
+        for (auto & i : effects_a)
+        {
+            i (transaction);
+        }
+    }
+}
+
+germ::process_return germ::block_processor::process_receive_one (MDB_txn * transaction_a, std::shared_ptr<germ::tx> block_a, std::chrono::steady_clock::time_point origination, std::vector<std::function<void (MDB_txn *)>> & effects_a)
 {
     germ::process_return result;
     auto hash (block_a->hash ());
@@ -1508,7 +1791,22 @@ germ::process_return germ::block_processor::process_receive_one (MDB_txn * trans
 //            {
 //                node.active.start (block_a);
 //            }
-            queue_unchecked (transaction_a, hash);
+            auto send (block_a->type () == germ::block_type::send);
+            // Wallet flags are stored with the block, the wallets' in-memory metadata follows once it's committed
+            node.wallets.ledger_update (transaction_a, result.account);
+            if (send)
+            {
+                node.wallets.ledger_update (transaction_a, result.pending_account);
+            }
+            effects_a.push_back ([this, hash, result, send](MDB_txn * transaction_a) {
+                node.tracer.add (hash, germ::block_stage::ledger);
+                node.wallets.ledger_updated (transaction_a, result.account);
+                if (send)
+                {
+                    node.wallets.ledger_updated (transaction_a, result.pending_account);
+                }
+            });
+            queue_unchecked (transaction_a, hash, effects_a);
             break;
         }
         case germ::process_result::gap_previous:
@@ -1518,7 +1816,9 @@ germ::process_return germ::block_processor::process_receive_one (MDB_txn * trans
                 BOOST_LOG (node.log) << boost::str (boost::format ("Gap previous for: %1%") % hash.to_string ());
             }
             node.store.unchecked_put (transaction_a, block_a->previous (), block_a);
-            node.gap_cache.add (transaction_a, block_a);
+            effects_a.push_back ([this, block_a](MDB_txn * transaction_a) {
+                node.gap_cache.add (transaction_a, block_a);
+            });
             break;
         }
         case germ::process_result::gap_source:
@@ -1528,7 +1828,9 @@ germ::process_return germ::block_processor::process_receive_one (MDB_txn * trans
                 BOOST_LOG (node.log) << boost::str (boost::format ("Gap source for: %1%") % hash.to_string ());
             }
             node.store.unchecked_put (transaction_a, node.ledger.block_source (transaction_a, *block_a), block_a);
-            node.gap_cache.add (transaction_a, block_a);
+            effects_a.push_back ([this, block_a](MDB_txn * transaction_a) {
+                node.gap_cache.add (transaction_a, block_a);
+            });
             break;
         }
         case germ::process_result::old:
@@ -1537,7 +1839,7 @@ germ::process_return germ::block_processor::process_receive_one (MDB_txn * trans
             {
                 BOOST_LOG (node.log) << boost::str (boost::format ("Old for: %1%") % block_a->hash ().to_string ());
             }
-            queue_unchecked (transaction_a, hash);
+            queue_unchecked (transaction_a, hash, effects_a);
             break;
         }
         case germ::process_result::bad_signature:
@@ -1569,7 +1871,9 @@ germ::process_return germ::block_processor::process_receive_one (MDB_txn * trans
             if (origination < std::chrono::steady_clock::now () - std::chrono::seconds (15))
             {
                 // Only let the bootstrap attempt know about forked blocks that not originate recently.
-                node.process_fork (transaction_a, block_a);
+                effects_a.push_back ([this, block_a](MDB_txn * transaction_a) {
+                    node.process_fork (transaction_a, block_a);
+                });
             }
             if (node.config.logging.ledger_logging ())
             {
@@ -1602,16 +1906,21 @@ germ::process_return germ::block_processor::process_receive_one (MDB_txn * trans
     return result;
 }
 
-void germ::block_processor::queue_unchecked (MDB_txn * transaction_a, germ::block_hash const & hash_a)
+void germ::block_processor::queue_unchecked (MDB_txn * transaction_a, germ::block_hash const & hash_a, std::vector<std::function<void (MDB_txn *)>> & effects_a)
 {
     auto cached (node.store.unchecked_get (transaction_a, hash_a));
     for (auto i (cached.begin ()), n (cached.end ()); i != n; ++i)
     {
         node.store.unchecked_del (transaction_a, hash_a, **i);
-        add (*i, std::chrono::steady_clock::time_point ());
     }
-    std::lock_guard<std::mutex> lock (node.gap_cache.mutex);
-    node.gap_cache.blocks.get<1> ().erase (hash_a);
+    effects_a.push_back ([this, hash_a, cached](MDB_txn *) {
+        for (auto & i : cached)
+        {
+            add (i, std::chrono::steady_clock::time_point ());
+        }
+        std::lock_guard<std::mutex> lock (node.gap_cache.mutex);
+        node.gap_cache.blocks.get<1> ().erase (hash_a);
+    });
 }
 
 germ::node::node (germ::node_init & init_a, boost::asio::io_service & service_a, uint16_t peering_port_a, boost::filesystem::path const & application_path_a, germ::alarm & alarm_a, germ::logging const & logging_a, germ::work_pool & work_a) :
@@ -1624,12 +1933,13 @@ service (service_a),
 config (config_a),
 alarm (alarm_a),
 work (work_a),
-store (init_a.block_store_init, application_path_a / "data.ldb", config_a.lmdb_max_dbs),
-epoch_store(init_a.epoch_store_init, application_path_a / "epoch.ldb", config_a.lmdb_max_dbs),
+store (init_a.block_store_init, application_path_a / "data.ldb", config_a.lmdb_max_dbs, config_a.lmdb_config),
+epoch_store(init_a.epoch_store_init, application_path_a / "epoch.ldb", config_a.lmdb_max_dbs, config_a.lmdb_config),
 gap_cache (*this),
 ledger (store, stats),
 active (*this),
 active_election(*this),
+epoch_builder (*this),
 network (*this, config.peering_port),
 bootstrap_initiator (*this),
 bootstrap (service_a, config.peering_port, *this),
@@ -1641,8 +1951,14 @@ vote_processor (*this),
 warmed_up (0),
 block_processor (*this),
 block_processor_thread ([this]() { this->block_processor.process_blocks (); }),
+vote_processor_thread ([this]() { this->vote_processor.process_loop (); }),
 online_reps (*this),
-stats (config.stat_config)
+stats (config.stat_config),
+signer (stats, std::min<unsigned> (4, std::thread::hardware_concurrency () / 2)),
+tracer (config.stat_config.log_interval_trace, config.stat_config.log_trace_filename),
+metrics (service_a, *this, config.metrics_config),
+subscriptions (service_a, *this, config.subscription_config),
+callback (*this)
 {
     wallets.observer = [this](bool active) {
         observers.wallet.notify (active);
@@ -1660,99 +1976,24 @@ stats (config.stat_config)
             background ([node_l, block_a, account_a, amount_a, is_state_send_a]() {
                 if (!node_l->config.callback_address.empty ())
                 {
-                    boost::property_tree::ptree event;
-                    event.add ("account", account_a.to_account ());
-                    event.add ("hash", block_a->hash ().to_string ());
+                    germ::json_writer event;
+                    event.begin_object ();
+                    event.value ("account", account_a.to_account ());
+                    event.value ("hash", block_a->hash ().to_string ());
                     std::string block_text;
                     block_a->serialize_json (block_text);
-                    event.add ("block", block_text);
-                    event.add ("amount", amount_a.to_string_dec ());
+                    event.value ("block", block_text);
+                    event.value ("amount", amount_a.to_string_dec ());
                     if (is_state_send_a)
                     {
-                        event.add ("is_send", is_state_send_a);
+                        event.value ("is_send", "true");
                     }
-                    std::stringstream ostream;
-                    boost::property_tree::write_json (ostream, event);
-                    ostream.flush ();
-                    auto body (std::make_shared<std::string> (ostream.str ()));
-                    auto address (node_l->config.callback_address);
-                    auto port (node_l->config.callback_port);
-                    auto target (std::make_shared<std::string> (node_l->config.callback_target));
-                    auto resolver (std::make_shared<boost::asio::ip::tcp::resolver> (node_l->service));
-                    resolver->async_resolve (boost::asio::ip::tcp::resolver::query (address, std::to_string (port)), [node_l, address, port, target, body, resolver](boost::system::error_code const & ec, boost::asio::ip::tcp::resolver::iterator i_a) {
-                        if (!ec)
-                        {
-                            for (auto i (i_a), n (boost::asio::ip::tcp::resolver::iterator{}); i != n; ++i)
-                            {
-                                auto sock (std::make_shared<boost::asio::ip::tcp::socket> (node_l->service));
-                                sock->async_connect (i->endpoint (), [node_l, target, body, sock, address, port](boost::system::error_code const & ec) {
-                                    if (!ec)
-                                    {
-                                        auto req (std::make_shared<boost::beast::http::request<boost::beast::http::string_body>> ());
-                                        req->method (boost::beast::http::verb::post);
-                                        req->target (*target);
-                                        req->version (11);
-                                        req->insert (boost::beast::http::field::host, address);
-                                        req->insert (boost::beast::http::field::content_type, "application/json");
-                                        req->body () = *body;
-                                        //req->prepare (*req);
-                                        //boost::beast::http::prepare(req);
-                                        req->prepare_payload ();
-                                        boost::beast::http::async_write (*sock, *req, [node_l, sock, address, port, req](boost::system::error_code const & ec, size_t bytes_transferred) {
-                                            if (!ec)
-                                            {
-                                                auto sb (std::make_shared<boost::beast::flat_buffer> ());
-                                                auto resp (std::make_shared<boost::beast::http::response<boost::beast::http::string_body>> ());
-                                                boost::beast::http::async_read (*sock, *sb, *resp, [node_l, sb, resp, sock, address, port](boost::system::error_code const & ec, size_t bytes_transferred) {
-                                                    if (!ec)
-                                                    {
-                                                        if (resp->result () == boost::beast::http::status::ok)
-                                                        {
-                                                        }
-                                                        else
-                                                        {
-                                                            if (node_l->config.logging.callback_logging ())
-                                                            {
-                                                                BOOST_LOG (node_l->log) << boost::str (boost::format ("Callback to %1%:%2% failed with status: %3%") % address % port % resp->result ());
-                                                            }
-                                                        }
-                                                    }
-                                                    else
-                                                    {
-                                                        if (node_l->config.logging.callback_logging ())
-                                                        {
-                                                            BOOST_LOG (node_l->log) << boost::str (boost::format ("Unable complete callback: %1%:%2%: %3%") % address % port % ec.message ());
-                                                        }
-                                                    };
-                                                });
-                                            }
-                                            else
-                                            {
-                                                if (node_l->config.logging.callback_logging ())
-                                                {
-                                                    BOOST_LOG (node_l->log) << boost::str (boost::format ("Unable to send callback: %1%:%2%: %3%") % address % port % ec.message ());
-                                                }
-                                            }
-                                        });
-                                    }
-                                    else
-                                    {
-                                        if (node_l->config.logging.callback_logging ())
-                                        {
-                                            BOOST_LOG (node_l->log) << boost::str (boost::format ("Unable to connect to callback address: %1%:%2%: %3%") % address % port % ec.message ());
-                                        }
-                                    }
-                                });
-                            }
-                        }
-                        else
-                        {
-                            if (node_l->config.logging.callback_logging ())
-                            {
-                                BOOST_LOG (node_l->log) << boost::str (boost::format ("Error resolving callback: %1%:%2%: %3%") % address % port % ec.message ());
-                            }
-                        }
-                    });
+                    event.end_object ();
+                    node_l->callback.post (std::make_shared<std::string> (std::move (event.output)));
+                }
+                if (node_l->config.subscription_config.enable)
+                {
+                    node_l->subscriptions.publish (block_a, account_a, amount_a, is_state_send_a);
                 }
             });
         }
@@ -1771,7 +2012,7 @@ stats (config.stat_config)
         germ::uint128_t rep_weight;
         germ::uint128_t min_rep_weight;
         {
-            germ::transaction transaction (store.environment, nullptr, false);
+            germ::read_transaction transaction (store.environment);
             rep_weight = ledger.weight (transaction, vote_a->account);
             min_rep_weight = online_reps.online_stake () / 1000;
         }
@@ -1823,7 +2064,7 @@ stats (config.stat_config)
         if (!germ::read (weight_stream, block_height))
         {
             auto max_blocks = (uint64_t)block_height.number ();
-            germ::transaction transaction (store.environment, nullptr, false);
+            germ::read_transaction transaction (store.environment);
             if (ledger.store.block_count (transaction).sum () < max_blocks)
             {
                 ledger.bootstrap_weight_max_blocks = max_blocks;
@@ -1887,7 +2128,7 @@ void germ::node::process_fork (MDB_txn * transaction_a, std::shared_ptr<germ::tx
         if (!attempt)
             return;
 
-        germ::transaction transaction (this_l->store.environment, nullptr, false);
+        germ::read_transaction transaction (this_l->store.environment);
         auto account (this_l->ledger.store.frontier_get (transaction, root));
         if (!account.is_zero ())
         {
@@ -1933,7 +2174,7 @@ void germ::gap_cache::add (MDB_txn * transaction_a, std::shared_ptr<germ::tx> bl
 void germ::gap_cache::vote (std::shared_ptr<germ::vote> vote_a)
 {
     std::lock_guard<std::mutex> lock (mutex);
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     auto hash (vote_a->block->hash ());
     auto existing (blocks.get<1> ().find (hash));
     if (existing == blocks.get<1> ().end ())
@@ -1947,7 +2188,7 @@ void germ::gap_cache::vote (std::shared_ptr<germ::vote> vote_a)
     auto node_l (node.shared ());
     auto now (std::chrono::steady_clock::now ());
     node.alarm.add (germ::rai_network == germ::germ_networks::germ_test_network ? now + std::chrono::milliseconds (5) : now + std::chrono::seconds (5), [node_l, hash]() {
-        germ::transaction transaction (node_l->store.environment, nullptr, false);
+        germ::read_transaction transaction (node_l->store.environment);
         if (node_l->store.block_exists (transaction, hash))
             return;
 
@@ -2224,12 +2465,21 @@ void germ::node::start ()
     ongoing_syn_cookie_cleanup ();
     ongoing_bootstrap ();
     ongoing_store_flush ();
+    epoch_builder.ongoing_seal ();
 //    ongoing_rep_crawl ();
     bootstrap.start ();
     backup_wallet ();
 //    active.announce_votes ();
 //    online_reps.recalculate_stake ();
     port_mapping.start ();
+    if (config.metrics_config.enable)
+    {
+        metrics.start ();
+    }
+    if (config.subscription_config.enable)
+    {
+        subscriptions.start ();
+    }
     add_initial_peers ();
     observers.started.notify ();
 }
@@ -2242,12 +2492,22 @@ void germ::node::stop ()
     {
         block_processor_thread.join ();
     }
+    vote_processor.stop ();
+    if (vote_processor_thread.joinable ())
+    {
+        vote_processor_thread.join ();
+    }
     active.stop ();
     network.stop ();
     bootstrap_initiator.stop ();
     bootstrap.stop ();
     port_mapping.stop ();
     wallets.stop ();
+    metrics.stop ();
+    subscriptions.stop ();
+    callback.stop ();
+    signer.stop ();
+    stats.stop ();
 }
 
 void germ::node::keepalive_preconfigured (std::vector<std::string> const & peers_a)
@@ -2260,26 +2520,26 @@ void germ::node::keepalive_preconfigured (std::vector<std::string> const & peers
 
 germ::block_hash germ::node::latest (germ::account const & account_a)
 {
-    germ::transaction transaction (store.environment, nullptr, false);
+    germ::read_transaction transaction (store.environment);
     return ledger.latest (transaction, account_a);
 }
 
 germ::uint128_t germ::node::balance (germ::account const & account_a)
 {
-    germ::transaction transaction (store.environment, nullptr, false);
+    germ::read_transaction transaction (store.environment);
     return ledger.account_balance (transaction, account_a);
 }
 
 std::unique_ptr<germ::tx> germ::node::block (germ::block_hash const & hash_a)
 {
-    germ::transaction transaction (store.environment, nullptr, false);
+    germ::read_transaction transaction (store.environment);
     return store.block_get (transaction, hash_a);
 }
 
 std::pair<germ::uint128_t, germ::uint128_t> germ::node::balance_pending (germ::account const & account_a)
 {
     std::pair<germ::uint128_t, germ::uint128_t> result;
-    germ::transaction transaction (store.environment, nullptr, false);
+    germ::read_transaction transaction (store.environment);
     result.first = ledger.account_balance (transaction, account_a);
     result.second = ledger.account_pending (transaction, account_a);
     return result;
@@ -2287,13 +2547,13 @@ std::pair<germ::uint128_t, germ::uint128_t> germ::node::balance_pending (germ::a
 
 germ::uint128_t germ::node::weight (germ::account const & account_a)
 {
-    germ::transaction transaction (store.environment, nullptr, false);
+    germ::read_transaction transaction (store.environment);
     return ledger.weight (transaction, account_a);
 }
 
 germ::account germ::node::representative (germ::account const & account_a)
 {
-    germ::transaction transaction (store.environment, nullptr, false);
+    germ::read_transaction transaction (store.environment);
     germ::account_info info;
     germ::account result (0);
     if (store.account_get (transaction, account_a, info))
@@ -2388,7 +2648,7 @@ void germ::node::ongoing_store_flush ()
 
 void germ::node::backup_wallet ()
 {
-    germ::transaction transaction (store.environment, nullptr, false);
+    germ::read_transaction transaction (store.environment);
     for (auto i (wallets.items.begin ()), n (wallets.items.end ()); i != n; ++i)
     {
         auto backup_path (application_path / "backup");
@@ -2736,7 +2996,7 @@ public:
         {
             auto wallet (i->second);
             if (!wallet->store.exists (transaction, account_a))
-                return;
+                continue;
 
             germ::account representative;
             germ::pending_info pending;
@@ -2784,7 +3044,7 @@ public:
         germ::block_type tx_type = tx.type();
         if (tx_type == germ::block_type::send)
         {
-            scan_receivable (tx.destination_);
+            scan_receivable (tx.destination ());
         }
         else if (tx_type == germ::block_type::receive)
         {
@@ -2801,11 +3061,13 @@ public:
 
 void germ::node::process_confirmed (std::shared_ptr<germ::tx> block_a)
 {
-    germ::transaction transaction (store.environment, nullptr, false);
+    germ::read_transaction transaction (store.environment);
     auto hash (block_a->hash ());
     if (!store.block_exists (transaction, hash))
         return;
 
+    tracer.add (hash, germ::block_stage::confirmed);
+    epoch_builder.add (hash);
     confirmed_visitor visitor (transaction, *this, block_a, hash);
     block_a->visit (visitor);
     auto account (ledger.account (transaction, hash));
@@ -2815,7 +3077,7 @@ void germ::node::process_confirmed (std::shared_ptr<germ::tx> block_a)
     is_send = ledger.is_send (transaction, *block_a);
     if (is_send)
     {
-        pending_account = block_a.get()->destination_;
+        pending_account = block_a.get()->destination ();
     }
     observers.blocks.notify (block_a, account, amount, is_send);
     if (amount <= 0)
@@ -2828,6 +3090,25 @@ void germ::node::process_confirmed (std::shared_ptr<germ::tx> block_a)
     }
 }
 
+std::vector<std::shared_ptr<germ::vote>> germ::node::votes_generate (MDB_txn * transaction_a, std::shared_ptr<germ::tx> block_a)
+{
+    std::vector<std::shared_ptr<germ::vote>> result;
+    wallets.foreach_representative (transaction_a, [this, transaction_a, &block_a, &result](germ::public_key const & pub_a, germ::raw_key const &) {
+        auto vote (std::make_shared<germ::vote> ());
+        vote->account = pub_a;
+        vote->block = block_a;
+        vote->sequence = store.vote_sequence (transaction_a, pub_a);
+        result.push_back (vote);
+    });
+    // Keys are read from the locked cache pages while signing rather than copied out for the whole batch
+    wallets.sign (transaction_a, result);
+    for (auto & vote : result)
+    {
+        store.vote_max (transaction_a, vote);
+    }
+    return result;
+}
+
 void germ::node::process_message (germ::message & message_a, germ::endpoint const & sender_a)
 {
     network_message_visitor visitor (*this, sender_a);
@@ -2875,7 +3156,7 @@ void germ::online_reps::vote (std::shared_ptr<germ::vote> const & vote_a)
     auto rep (vote_a->account);
     std::lock_guard<std::mutex> lock (mutex);
     auto now (std::chrono::steady_clock::now ());
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     auto current (reps.begin ());
     while (current != reps.end () && current->last_heard + std::chrono::seconds (germ::node::cutoff) < now)
     {
@@ -2911,7 +3192,7 @@ void germ::online_reps::recalculate_stake ()
 {
     std::lock_guard<std::mutex> lock (mutex);
     online_stake_total = 0;
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     for (auto it : reps)
     {
         online_stake_total += node.ledger.weight (transaction, it.representative);
@@ -3433,9 +3714,11 @@ bool germ::vote_info::operator< (germ::vote const & vote_a) const
 germ::election::election (germ::node & node_a, std::shared_ptr<germ::tx> block_a, std::function<void(std::shared_ptr<germ::tx>)> const & confirmation_action_a) :
 confirmation_action (confirmation_action_a),
 votes (block_a),
+tally (block_a),
 node (node_a),
 status ({ block_a, 0 }),
-confirmed (false)
+confirmed (false),
+started (std::chrono::steady_clock::now ())
 {
 }
 
@@ -3443,16 +3726,16 @@ void germ::election::compute_rep_votes (MDB_txn * transaction_a)
 {
     if (node.config.enable_voting)
     {
-        node.wallets.foreach_representative (transaction_a, [this, transaction_a](germ::public_key const & pub_a, germ::raw_key const & prv_a) {
-            auto vote (this->node.store.vote_generate (transaction_a, pub_a, prv_a, status.winner));
-            this->node.vote_processor.vote (vote, this->node.network.endpoint ());
-        });
+        for (auto & vote : node.votes_generate (transaction_a, status.winner))
+        {
+            node.vote_processor.vote_blocking (transaction_a, vote, node.network.endpoint (), true);
+        }
     }
 }
 
 void germ::election::broadcast_winner ()
 {
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     compute_rep_votes (transaction);
     node.network.republish_block (transaction, status.winner);
 }
@@ -3461,6 +3744,8 @@ void germ::election::confirm_once (MDB_txn * transaction_a)
 {
     if (!confirmed.exchange (true))
     {
+        node.active.confirmation_latency.add (std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - started));
+        node.stats.inc (germ::stat::type::election, germ::stat::detail::election_confirm);
         auto winner_l (status.winner);
         auto node_l (node.shared ());
         auto confirmation_action_l (confirmation_action);
@@ -3471,44 +3756,34 @@ void germ::election::confirm_once (MDB_txn * transaction_a)
     }
 }
 
-bool germ::election::have_quorum (germ::tally_t const & tally_a)
+bool germ::election::have_quorum ()
 {
-    auto i (tally_a.begin ());
-    auto first (i->first);
-    ++i;
-    auto second (i != tally_a.end () ? i->first : 0);
     auto delta_l (node.delta ());
-    auto result (tally_a.begin ()->first > (second + delta_l));
+    auto result (tally.winner ().first > (tally.runner_up () + delta_l));
     return result;
 }
 
 void germ::election::confirm_if_quorum (MDB_txn * transaction_a)
 {
-    auto tally_l (node.ledger.tally (transaction_a, votes));
-    assert (tally_l.size () > 0);
-    auto winner (tally_l.begin ());
-    auto block_l (winner->second);
-    status.tally = winner->first;
-    germ::uint128_t sum (0);
-    for (auto & i : tally_l)
-    {
-        sum += i.first;
-    }
-    if (sum >= node.config.online_weight_minimum.number () && !(*block_l == *status.winner))
+    auto winner (tally.winner ());
+    auto block_l (winner.second);
+    status.tally = winner.first;
+    if (tally.sum () >= node.config.online_weight_minimum.number () && !(*block_l == *status.winner))
     {
         auto node_l (node.shared ());
         node_l->block_processor.force (block_l);
         status.winner = block_l;
     }
-    if (!have_quorum (tally_l))
+    if (!have_quorum ())
         return;
 
+    node.tracer.add (status.winner->hash (), germ::block_stage::quorum);
     if (node.config.logging.vote_logging () || !votes.uncontested ())
     {
         BOOST_LOG (node.log) << boost::str (boost::format ("Vote tally for root %1%") % status.winner->root ().to_string ());
-        for (auto i (tally_l.begin ()), n (tally_l.end ()); i != n; ++i)
+        for (auto & i : tally.candidates ())
         {
-            BOOST_LOG (node.log) << boost::str (boost::format ("Block %1% weight %2%") % i->second->hash ().to_string () % i->first.convert_to<std::string> ());
+            BOOST_LOG (node.log) << boost::str (boost::format ("Block %1% weight %2%") % i.second->hash ().to_string () % i.first.convert_to<std::string> ());
         }
         for (auto i (votes.rep_votes.begin ()), n (votes.rep_votes.end ()); i != n; ++i)
         {
@@ -3520,9 +3795,13 @@ void germ::election::confirm_if_quorum (MDB_txn * transaction_a)
 
 bool germ::election::vote (std::shared_ptr<germ::vote> vote_a)
 {
-    assert (!vote_a->validate ());
+    germ::read_transaction transaction (node.store.environment);
+    return vote (transaction, vote_a);
+}
+
+bool germ::election::vote (MDB_txn * transaction, std::shared_ptr<germ::vote> vote_a)
+{
     // see republish_vote documentation for an explanation of these rules
-    germ::transaction transaction (node.store.environment, nullptr, false);
     auto replay (false);
     auto supply (node.online_reps.online_stake ());
     auto weight (node.ledger.weight (transaction, vote_a->account));
@@ -3566,8 +3845,10 @@ bool germ::election::vote (std::shared_ptr<germ::vote> vote_a)
     if (should_process)
     {
         last_votes[vote_a->account] = { std::chrono::steady_clock::now (), vote_a->sequence, vote_a->block->hash () };
+        node.tracer.add (vote_a->block->hash (), germ::block_stage::vote);
         node.network.republish_vote (vote_a);
         votes.vote (vote_a);
+        tally.vote (vote_a->account, weight, vote_a->block);
         confirm_if_quorum (transaction);
     }
     return replay;
@@ -3576,13 +3857,21 @@ bool germ::election::vote (std::shared_ptr<germ::vote> vote_a)
 void germ::active_transactions::announce_votes ()
 {
     std::vector<germ::block_hash> inactive;
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     std::lock_guard<std::mutex> lock (mutex);
     unsigned unconfirmed_count (0);
     unsigned unconfirmed_announcements (0);
-
-    for (auto i (roots.begin ()), n (roots.end ()); i != n; ++i)
+    auto now (std::chrono::steady_clock::now ());
+    // Only elections that are due are touched, announcing reorders the schedule so collect them first
+    std::vector<germ::block_hash> due;
+    for (auto i (roots.get<2> ().begin ()), n (roots.get<2> ().upper_bound (now)); i != n; ++i)
+    {
+        due.push_back (i->root);
+    }
+    for (auto & root : due)
     {
+        auto i (roots.find (root));
+        assert (i != roots.end ());
         auto election_l (i->election);
         if (!node.store.root_exists (transaction, election_l->votes.id) || (election_l->confirmed && i->announcements >= announcement_min - 1))
         {
@@ -3643,7 +3932,10 @@ void germ::active_transactions::announce_votes ()
                 }
             }
         }
-        roots.modify (i, [](germ::conflict_info & info_a) {
+        roots.modify (i, [now](germ::conflict_info & info_a) {
+            // Elections that have gone unconfirmed for long are announced less often
+            auto interval (std::chrono::milliseconds (announce_interval_ms) * (info_a.announcements > announcement_long ? announce_backoff : 1));
+            info_a.next_announce = now + interval;
             ++info_a.announcements;
         });
     }
@@ -3656,9 +3948,8 @@ void germ::active_transactions::announce_votes ()
     {
         BOOST_LOG (node.log) << boost::str (boost::format ("%1% blocks have been unconfirmed averaging %2% announcements") % unconfirmed_count % (unconfirmed_announcements / unconfirmed_count));
     }
-    auto now (std::chrono::steady_clock::now ());
     std::weak_ptr<germ::node> node_w (node.shared ());
-    node.alarm.add (now + std::chrono::milliseconds (announce_interval_ms), [node_w]() {
+    node.alarm.add (std::chrono::steady_clock::now () + std::chrono::milliseconds (announce_interval_ms), [node_w]() {
         if (auto node_l = node_w.lock ())
         {
             node_l->active.announce_votes ();
@@ -3684,31 +3975,56 @@ bool germ::active_transactions::start (std::pair<std::shared_ptr<germ::tx>, std:
     auto primary_block (blocks_a.first);
     auto root (primary_block->root ());
     auto existing (roots.find (root));
-    if (existing == roots.end ())
+    if (existing != roots.end ())
+        return true;
+
+    germ::uint128_t priority (primary_block->balance ().number ());
+    if (roots.size () >= node.config.active_elections_size)
     {
-        auto election (std::make_shared<germ::election> (node, primary_block, confirmation_action_a));
-        roots.insert (germ::conflict_info{ root, election, 0, blocks_a });
+        auto & by_priority (roots.get<1> ());
+        auto lowest (by_priority.begin ());
+        if (lowest == by_priority.end () || lowest->priority >= priority)
+        {
+            node.stats.inc (germ::stat::type::election, germ::stat::detail::election_drop);
+            return true;
+        }
+        by_priority.erase (lowest);
+        node.stats.inc (germ::stat::type::election, germ::stat::detail::election_evict);
     }
-    return existing != roots.end ();
+    auto election (std::make_shared<germ::election> (node, primary_block, confirmation_action_a));
+    roots.insert (germ::conflict_info{ root, election, 0, blocks_a, priority, std::chrono::steady_clock::now () });
+    node.stats.inc (germ::stat::type::election, germ::stat::detail::election_start);
+    node.tracer.add (primary_block->hash (), germ::block_stage::election);
+    return false;
 }
 
 // Validate a vote and apply it to the current election if one exists
 bool germ::active_transactions::vote (std::shared_ptr<germ::vote> vote_a)
 {
-    std::shared_ptr<germ::election> election;
+    germ::read_transaction transaction (node.store.environment);
+    return vote (transaction, std::vector<std::shared_ptr<germ::vote>> (1, vote_a))[0];
+}
+
+std::vector<bool> germ::active_transactions::vote (MDB_txn * transaction_a, std::vector<std::shared_ptr<germ::vote>> const & votes_a)
+{
+    std::vector<std::shared_ptr<germ::election>> elections;
+    elections.reserve (votes_a.size ());
     {
         std::lock_guard<std::mutex> lock (mutex);
-        auto root (vote_a->block->root ());
-        auto existing (roots.find (root));
-        if (existing != roots.end ())
+        for (auto & vote : votes_a)
         {
-            election = existing->election;
+            auto existing (roots.find (vote->block->root ()));
+            elections.push_back (existing != roots.end () ? existing->election : nullptr);
         }
     }
-    auto result (false);
-    if (election)
+    // Elections may call back into active_transactions when they confirm so votes are applied outside the lock
+    std::vector<bool> result (votes_a.size (), false);
+    for (size_t i (0), n (votes_a.size ()); i < n; ++i)
     {
-        result = election->vote (vote_a);
+        if (elections[i] != nullptr)
+        {
+            result[i] = elections[i]->vote (transaction_a, votes_a[i]);
+        }
     }
     return result;
 }
@@ -3731,6 +4047,12 @@ std::deque<std::shared_ptr<germ::tx>> germ::active_transactions::list_blocks ()
     return result;
 }
 
+size_t germ::active_transactions::size ()
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    return roots.size ();
+}
+
 void germ::active_transactions::erase (germ::tx const & block_a)
 {
     std::lock_guard<std::mutex> lock (mutex);
@@ -3748,7 +4070,7 @@ node (node_a)
 
 int germ::node::store_version ()
 {
-    germ::transaction transaction (store.environment, nullptr, false);
+    germ::read_transaction transaction (store.environment);
     return store.version_get (transaction);
 }
 
@@ -4174,7 +4496,7 @@ bool germ::handle_node_options (boost::program_options::variables_map & vm)
             return true;
         }
 
-        germ::transaction transaction (existing->second->store.environment, nullptr, false);
+        germ::read_transaction transaction (existing->second->store.environment);
         germ::raw_key seed;
         existing->second->store.seed (seed, transaction);
         std::cout << boost::str (boost::format ("Seed: %1%\n") % seed.data.to_string ());
@@ -4272,7 +4594,7 @@ bool germ::handle_node_options (boost::program_options::variables_map & vm)
         for (auto i (node.node->wallets.items.begin ()), n (node.node->wallets.items.end ()); i != n; ++i)
         {
             std::cout << boost::str (boost::format ("Wallet ID: %1%\n") % i->first.to_string ());
-            germ::transaction transaction (i->second->store.environment, nullptr, false);
+            germ::read_transaction transaction (i->second->store.environment);
             for (auto j (i->second->store.begin (transaction)), m (i->second->store.end ()); j != m; ++j)
             {
                 std::cout << germ::uint256_union (j->first.uint256 ()).to_account () << '\n';
@@ -4344,7 +4666,7 @@ bool germ::handle_node_options (boost::program_options::variables_map & vm)
             return true;
         }
 
-        germ::transaction transaction (wallet->second->store.environment, nullptr, false);
+        germ::read_transaction transaction (wallet->second->store.environment);
         auto representative (wallet->second->store.representative (transaction));
         std::cout << boost::str (boost::format ("Representative: %1%\n") % representative.to_account ());
     }
@@ -4392,7 +4714,7 @@ bool germ::handle_node_options (boost::program_options::variables_map & vm)
     else if (vm.count ("vote_dump") == 1)
     {
         inactive_node node (data_path);
-        germ::transaction transaction (node.node->store.environment, nullptr, false);
+        germ::read_transaction transaction (node.node->store.environment);
         for (auto i (node.node->store.vote_begin (transaction)), n (node.node->store.vote_end ()); i != n; ++i)
         {
             bool error (false);
@@ -28,6 +28,10 @@
 
 #include <src/epochstore.h>
 #include <src/node/active_elections.h>
+#include <src/node/epoch_builder.h>
+#include <src/node/metrics.hpp>
+#include <src/node/signer.hpp>
+#include <src/node/subscription.hpp>
 #include <src/node/bootstrap/bootstrap_listener.h>
 #include <src/node/bootstrap/bootstrap_initiator.h>
 
@@ -68,8 +72,9 @@ class election : public std::enable_shared_from_this<germ::election>
 public:
     election (germ::node &, std::shared_ptr<germ::tx>, std::function<void(std::shared_ptr<germ::tx>)> const &);
     bool vote (std::shared_ptr<germ::vote>);
+    bool vote (MDB_txn *, std::shared_ptr<germ::vote>);
     // Check if we have vote quorum
-    bool have_quorum (germ::tally_t const &);
+    bool have_quorum ();
     // Tell the network our view of the winner
     void broadcast_winner ();
     // Change our winner to agree with the network
@@ -77,10 +82,12 @@ public:
     // Confirm this block if quorum is met
     void confirm_if_quorum (MDB_txn *);
     germ::votes votes;
+    germ::vote_tally tally;
     germ::node & node;
     std::unordered_map<germ::account, germ::vote_info> last_votes;
     germ::election_status status;
     std::atomic<bool> confirmed;
+    std::chrono::steady_clock::time_point started;
 };
 class conflict_info
 {
@@ -90,6 +97,10 @@ public:
     // Number of announcements in a row for this fork
     unsigned announcements;
     std::pair<std::shared_ptr<germ::tx>, std::shared_ptr<germ::tx>> confirm_req_options;
+    // Balance after the primary block, elections with the least at stake are evicted first when full
+    germ::uint128_t priority;
+    // Next time this election is due to be announced
+    std::chrono::steady_clock::time_point next_announce;
 };
 // Core class for determining consensus
 // Holds all active blocks i.e. recently added blocks that need confirmation
@@ -99,6 +110,7 @@ public:
     active_transactions (germ::node &);
     // Start an election for a block
     // Call action with confirmed block, may be different than what we started with
+    // Returns true if an election for the root already exists or there was no room for it
     bool start (std::shared_ptr<germ::tx>, std::function<void(std::shared_ptr<germ::tx>)> const & = [](std::shared_ptr<germ::tx>) {});
     // Also supply alternatives to block, to confirm_req reps with if the boolean argument is true
     // Should only be used for old elections
@@ -107,18 +119,25 @@ public:
     // If this returns true, the vote is a replay
     // If this returns false, the vote may or may not be a replay
     bool vote (std::shared_ptr<germ::vote>);
+    // Apply a batch of votes, elections are looked up under a single lock. Element i is true if vote i is a replay
+    std::vector<bool> vote (MDB_txn *, std::vector<std::shared_ptr<germ::vote>> const &);
     // Is the root of this block in the roots container
     bool active (germ::tx const &);
     void announce_votes ();
     std::deque<std::shared_ptr<germ::tx>> list_blocks ();
     void erase (germ::tx const &);
+    size_t size ();
     void stop ();
     boost::multi_index_container<
     germ::conflict_info,
     boost::multi_index::indexed_by<
-    boost::multi_index::hashed_unique<boost::multi_index::member<germ::conflict_info, germ::block_hash, &germ::conflict_info::root>>>>
+    boost::multi_index::hashed_unique<boost::multi_index::member<germ::conflict_info, germ::block_hash, &germ::conflict_info::root>>,
+    boost::multi_index::ordered_non_unique<boost::multi_index::member<germ::conflict_info, germ::uint128_t, &germ::conflict_info::priority>>,
+    boost::multi_index::ordered_non_unique<boost::multi_index::member<germ::conflict_info, std::chrono::steady_clock::time_point, &germ::conflict_info::next_announce>>>>
     roots;
     std::deque<germ::election_status> confirmed;
+    // Time from election start to confirmation
+    germ::stat_histogram confirmation_latency;
     germ::node & node;
     std::mutex mutex;
     // Maximum number of conflicts to vote on per interval, lowest root hash first
@@ -128,6 +147,8 @@ public:
     // Threshold to start logging blocks haven't yet been confirmed
     static unsigned constexpr announcement_long = 20;
     static unsigned constexpr announce_interval_ms = (germ::rai_network == germ::germ_networks::germ_test_network) ? 10 : 16000;
+    // Interval multiplier for elections past announcement_long
+    static unsigned constexpr announce_backoff = 4;
     static size_t constexpr election_history_size = 2048;
 };
 class operation
@@ -493,8 +514,12 @@ public:
     std::string callback_address;
     uint16_t callback_port;
     std::string callback_target;
+    unsigned active_elections_size;
     int lmdb_max_dbs;
+    germ::lmdb_config lmdb_config;
     germ::stat_config stat_config;
+    germ::metrics_config metrics_config;
+    germ::subscription_config subscription_config;
     germ::block_hash state_block_parse_canary;
     germ::block_hash state_block_generate_canary;
     static std::chrono::seconds constexpr keepalive_period = std::chrono::seconds (60);
@@ -512,12 +537,36 @@ public:
     germ::observer_set<> disconnect;
     germ::observer_set<> started;
 };
+// Votes are queued from the network threads and verified, checked for replays and tallied in batches on a dedicated thread
 class vote_processor
 {
 public:
     vote_processor (germ::node &);
-    germ::vote_code vote (std::shared_ptr<germ::vote>, germ::endpoint);
+    // Queue a vote, it's dropped if the queue is full or, past half full, if the voter has little weight
+    void vote (std::shared_ptr<germ::vote>, germ::endpoint);
+    // Process a single vote on the calling thread
+    germ::vote_code vote_blocking (MDB_txn *, std::shared_ptr<germ::vote>, germ::endpoint, bool = false);
+    void process_loop ();
+    void flush ();
+    void stop ();
+    // Queued votes, read without taking the queue lock
+    size_t size ();
     germ::node & node;
+    // Queue depth as of the last push or drain, and its highest value so far
+    std::atomic<size_t> queued;
+    std::atomic<size_t> queued_peak;
+    static size_t constexpr max_votes = 64 * 1024;
+    // Votes handed to ed25519_sign_open_batch at once, its internal batch size
+    static size_t constexpr verify_batch_size = 64;
+
+private:
+    void verify_votes (std::deque<std::pair<std::shared_ptr<germ::vote>, germ::endpoint>> &);
+    void vote_result (std::shared_ptr<germ::vote>, germ::endpoint const &, germ::vote_code, std::shared_ptr<germ::vote>);
+    std::deque<std::pair<std::shared_ptr<germ::vote>, germ::endpoint>> votes;
+    std::condition_variable condition;
+    std::mutex mutex;
+    bool stopped;
+    bool active;
 };
 // The network is crawled for representatives by occasionally sending a unicast confirm_req for a specific block and watching to see if it's acknowledged with a vote.
 class rep_crawler
@@ -544,16 +593,25 @@ public:
     bool should_log ();
     bool have_blocks ();
     void process_blocks ();
+    // Queued blocks, read without taking the queue lock
+    size_t size ();
     germ::process_return process_receive_one (MDB_txn *, std::shared_ptr<germ::tx>, std::chrono::steady_clock::time_point = std::chrono::steady_clock::now ());
 
 private:
-    void queue_unchecked (MDB_txn *, germ::block_hash const &);
+    // In-memory effects of a processed block are queued on effects and run once its transaction commits, so a batch redone after running out of space doesn't apply them twice
+    germ::process_return process_receive_one (MDB_txn *, std::shared_ptr<germ::tx>, std::chrono::steady_clock::time_point, std::vector<std::function<void (MDB_txn *)>> &);
+    void queue_unchecked (MDB_txn *, germ::block_hash const &, std::vector<std::function<void (MDB_txn *)>> &);
+    // Runs the effects of committed blocks in a read transaction begun after the commit
+    void committed (std::vector<std::function<void (MDB_txn *)>> const &);
     void process_receive_many (std::unique_lock<std::mutex> &);
     bool stopped;
     bool active;
     std::chrono::steady_clock::time_point next_log;
     std::deque<std::pair<std::shared_ptr<germ::tx>, std::chrono::steady_clock::time_point>> blocks;
     std::deque<std::shared_ptr<germ::tx>> forced;
+    // Batches that ran out of map space, with whether each block was forced, processed before anything queued since
+    std::deque<std::pair<std::pair<std::shared_ptr<germ::tx>, std::chrono::steady_clock::time_point>, bool>> retry;
+    std::atomic<size_t> queued;
     std::condition_variable condition;
     germ::node & node;
     std::mutex mutex;
@@ -577,6 +635,8 @@ public:
     std::shared_ptr<germ::node> shared ();
     int store_version ();
     void process_confirmed (std::shared_ptr<germ::tx>);
+    // Votes for a block by every representative in an unlocked wallet, signed as one batch
+    std::vector<std::shared_ptr<germ::vote>> votes_generate (MDB_txn *, std::shared_ptr<germ::tx>);
     void process_message (germ::message &, germ::endpoint const &);
     void process_active (std::shared_ptr<germ::tx>);
     germ::process_return process (germ::tx const &);
@@ -612,6 +672,7 @@ public:
     germ::ledger ledger;
     germ::active_transactions active;
     germ::active_elections active_election;
+    germ::epoch_builder epoch_builder;
     germ::network network;
     germ::tcp_bootstrap_initiator bootstrap_initiator;
     germ::tcp_bootstrap_listener bootstrap;
@@ -625,9 +686,15 @@ public:
     unsigned warmed_up;
     germ::block_processor block_processor;
     std::thread block_processor_thread;
+    std::thread vote_processor_thread;
     germ::block_arrival block_arrival;
     germ::online_reps online_reps;
     germ::stat stats;
+    germ::signer_pool signer;
+    germ::block_tracer tracer;
+    germ::metrics_server metrics;
+    germ::subscription_server subscriptions;
+    germ::http_callback callback;
     germ::keypair node_id;
     static double constexpr price_max = 16.0;
     static double constexpr free_cutoff = 1024.0;
@@ -54,7 +54,10 @@ address (boost::asio::ip::address_v6::loopback ()),
 port (germ::rpc::rpc_port),
 enable_control (false),
 frontier_request_limit (16384),
-chain_request_limit (16384)
+chain_request_limit (16384),
+worker_threads (std::max<unsigned> (4, std::thread::hardware_concurrency ())),
+max_pipelined (16),
+idle_timeout (std::chrono::seconds (30))
 {
 }
 
@@ -63,7 +66,10 @@ address (boost::asio::ip::address_v6::loopback ()),
 port (germ::rpc::rpc_port),
 enable_control (enable_control_a),
 frontier_request_limit (16384),
-chain_request_limit (16384)
+chain_request_limit (16384),
+worker_threads (std::max<unsigned> (4, std::thread::hardware_concurrency ())),
+max_pipelined (16),
+idle_timeout (std::chrono::seconds (30))
 {
 }
 
@@ -74,6 +80,9 @@ void germ::rpc_config::serialize_json (boost::property_tree::ptree & tree_a) con
     tree_a.put ("enable_control", enable_control);
     tree_a.put ("frontier_request_limit", frontier_request_limit);
     tree_a.put ("chain_request_limit", chain_request_limit);
+    tree_a.put ("worker_threads", worker_threads);
+    tree_a.put ("max_pipelined", max_pipelined);
+    tree_a.put ("idle_timeout", idle_timeout.count ());
 }
 
 bool germ::rpc_config::deserialize_json (boost::property_tree::ptree const & tree_a)
@@ -101,6 +110,12 @@ bool germ::rpc_config::deserialize_json (boost::property_tree::ptree const & tre
             result = port > std::numeric_limits<uint16_t>::max ();
             frontier_request_limit = std::stoull (frontier_request_limit_l);
             chain_request_limit = std::stoull (chain_request_limit_l);
+            // Added after the first releases, older configs keep the defaults
+            worker_threads = tree_a.get<unsigned> ("worker_threads", worker_threads);
+            max_pipelined = tree_a.get<unsigned> ("max_pipelined", max_pipelined);
+            idle_timeout = std::chrono::seconds (tree_a.get<uint64_t> ("idle_timeout", idle_timeout.count ()));
+            result |= worker_threads == 0;
+            result |= max_pipelined == 0;
         }
         catch (std::logic_error const &)
         {
@@ -120,6 +135,8 @@ bool germ::rpc_config::deserialize_json (boost::property_tree::ptree const & tre
     return result;
 }
 
+size_t constexpr germ::rpc::max_latency_actions;
+
 germ::rpc::rpc (boost::asio::io_service & service_a, germ::node & node_a, germ::rpc_config const & config_a) :
 acceptor (service_a),
 config (config_a),
@@ -127,6 +144,11 @@ node (node_a)
 {
 }
 
+germ::rpc::~rpc ()
+{
+    stop ();
+}
+
 void germ::rpc::start ()
 {
     auto endpoint (germ::tcp_endpoint (config.address, config.port));
@@ -142,6 +164,8 @@ void germ::rpc::start ()
     }
 
     acceptor.listen ();
+    worker_work.reset (new boost::asio::io_service::work (worker_service));
+    workers.reset (new germ::thread_runner (worker_service, config.worker_threads));
     node.observers.blocks.add ([this](std::shared_ptr<germ::tx> block_a, germ::account const & account_a, germ::uint128_t const &, bool) {
         observer_action (account_a);
     });
@@ -152,6 +176,11 @@ void germ::rpc::start ()
 void germ::rpc::accept ()
 {
     auto connection (std::make_shared<germ::rpc_connection> (node, *this));
+    {
+        std::lock_guard<std::mutex> lock (connections_mutex);
+        connections.erase (std::remove_if (connections.begin (), connections.end (), [](std::weak_ptr<germ::rpc_connection> const & connection_a) { return connection_a.expired (); }), connections.end ());
+        connections.push_back (connection);
+    }
     acceptor.async_accept (connection->socket, [this, connection](boost::system::error_code const & ec) {
         if (!ec)
         {
@@ -167,15 +196,166 @@ void germ::rpc::accept ()
 
 void germ::rpc::stop ()
 {
-    acceptor.close ();
+    boost::system::error_code ec;
+    acceptor.close (ec);
+    {
+        // Keep-alive connections would otherwise outlive the server
+        std::lock_guard<std::mutex> lock (connections_mutex);
+        for (auto & i : connections)
+        {
+            auto connection (i.lock ());
+            if (connection != nullptr)
+            {
+                connection->close ();
+            }
+        }
+        connections.clear ();
+    }
+    worker_work.reset ();
+    if (workers != nullptr)
+    {
+        workers->join ();
+        workers.reset ();
+    }
+}
+
+germ::stat_histogram & germ::rpc::latency (std::string const & action_a)
+{
+    std::lock_guard<std::mutex> lock (latency_mutex);
+    auto existing (latencies.find (action_a));
+    if (existing == latencies.end ())
+    {
+        auto action_l (latencies.size () < max_latency_actions ? action_a : std::string ("other"));
+        existing = latencies.find (action_l);
+        if (existing == latencies.end ())
+        {
+            existing = latencies.insert (std::make_pair (action_l, std::make_unique<germ::stat_histogram> ())).first;
+        }
+    }
+    return *existing->second;
+}
+
+namespace
+{
+std::function<void(boost::property_tree::ptree const &)> tree_response (std::function<void(std::string const &)> const & response_body_a)
+{
+    return [response_body_a](boost::property_tree::ptree const & tree_a) {
+        std::stringstream ostream;
+        boost::property_tree::write_json (ostream, tree_a);
+        response_body_a (ostream.str ());
+    };
+}
 }
 
-germ::rpc_handler::rpc_handler (germ::node & node_a, germ::rpc & rpc_a, std::string const & body_a, std::function<void(boost::property_tree::ptree const &)> const & response_a) :
+germ::rpc_handler::rpc_handler (germ::node & node_a, germ::rpc & rpc_a, std::string const & body_a, std::function<void(std::string const &)> const & response_body_a) :
 body (body_a),
 node (node_a),
 rpc (rpc_a),
-response (response_a)
+response (tree_response (response_body_a)),
+response_body (response_body_a),
+start (std::chrono::steady_clock::now ()),
+batched (false),
+snapshot (nullptr),
+latency (nullptr)
+{
+}
+
+size_t constexpr germ::rpc_handler::batch_max;
+size_t constexpr germ::rpc_handler::batch_chunk;
+unsigned constexpr germ::rpc_handler::batch_snapshot_attempts;
+size_t constexpr germ::rpc_handler::stream_chunk;
+std::chrono::milliseconds constexpr germ::rpc_handler::read_age_max;
+size_t constexpr germ::rpc_stream::queued_max;
+std::chrono::seconds constexpr germ::rpc_stream::send_timeout;
+
+germ::rpc_stream::rpc_stream (std::chrono::steady_clock::duration timeout_a, std::function<void()> const & notify_a) :
+begun (false),
+finished (false),
+failed (false),
+active (false),
+timeout (timeout_a),
+notify (notify_a)
+{
+}
+
+bool germ::rpc_stream::write (std::string const & data_a)
+{
+    std::unique_lock<std::mutex> lock (mutex);
+    if (!condition.wait_for (lock, timeout, [this]() { return failed || queued.size () < queued_max; }))
+    {
+        failed = true;
+    }
+    auto result (failed);
+    if (!result)
+    {
+        begun = true;
+        queued.append (data_a);
+    }
+    lock.unlock ();
+    notify ();
+    return result;
+}
+
+void germ::rpc_stream::activate ()
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    active = true;
+}
+
+bool germ::rpc_stream::writable ()
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    return active;
+}
+
+void germ::rpc_stream::finish ()
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+        finished = true;
+    }
+    notify ();
+}
+
+bool germ::rpc_stream::take (std::string & data_a, bool & finished_a)
+{
+    std::unique_lock<std::mutex> lock (mutex);
+    auto result (failed);
+    if (!result)
+    {
+        data_a.swap (queued);
+        queued.clear ();
+        finished_a = finished;
+    }
+    lock.unlock ();
+    condition.notify_all ();
+    return result;
+}
+
+void germ::rpc_stream::fail ()
 {
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+        failed = true;
+    }
+    condition.notify_all ();
+}
+
+bool germ::rpc_stream::started ()
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    return begun || failed;
+}
+
+germ::rpc_read_transaction::rpc_read_transaction (germ::rpc_handler const & handler_a) :
+owned (handler_a.snapshot == nullptr ? std::make_unique<germ::read_transaction> (handler_a.node.store.environment) : nullptr),
+handle (owned != nullptr ? static_cast<MDB_txn *> (*owned) : handler_a.snapshot)
+{
+}
+
+germ::rpc_read_transaction::operator MDB_txn * () const
+{
+    return handle;
 }
 
 void germ::rpc::observer_action (germ::account const & account_a)
@@ -202,6 +382,15 @@ void germ::error_response (std::function<void(boost::property_tree::ptree const
     response_a (response_l);
 }
 
+void germ::error_response (std::function<void(std::string const &)> response_a, std::string const & message_a)
+{
+    germ::json_writer writer;
+    writer.begin_object ();
+    writer.value ("error", message_a);
+    writer.end_object ();
+    response_a (writer.output);
+}
+
 namespace
 {
 bool decode_unsigned (std::string const & text, uint64_t & number)
@@ -224,24 +413,274 @@ bool decode_unsigned (std::string const & text, uint64_t & number)
     result = result || end != text.size ();
     return result;
 }
+
+// Read-only actions which respond before returning, the only ones a batch runs
+bool batchable (std::string const & action_a)
+{
+    return action_a == "account_balance" || action_a == "account_block_count" || action_a == "account_info" || action_a == "accounts_balances" || action_a == "block_account" || action_a == "blocks_info" || action_a == "pending" || action_a == "pending_exists";
+}
+
+// Accessors for actions reading document, a missing or malformed field throws like property_tree's get and is answered by process_request
+std::string request_field (germ::json_document const & document_a, std::string const & path_a)
+{
+    std::string result;
+    if (!document_a.root ().get (path_a, result))
+    {
+        throw std::runtime_error ("Missing field " + path_a);
+    }
+    return result;
+}
+
+bool request_flag (germ::json_document const & document_a, std::string const & path_a, bool default_a)
+{
+    auto result (default_a);
+    std::string text;
+    if (document_a.root ().get (path_a, text))
+    {
+        if (text == "true" || text == "1")
+        {
+            result = true;
+        }
+        else if (text == "false" || text == "0")
+        {
+            result = false;
+        }
+        else
+        {
+            throw std::runtime_error ("Invalid flag " + path_a);
+        }
+    }
+    return result;
+}
+
+germ::json_value const & request_child (germ::json_document const & document_a, std::string const & path_a)
+{
+    auto result (document_a.root ().find (path_a));
+    if (result == nullptr || !result->is_container ())
+    {
+        throw std::runtime_error ("Missing field " + path_a);
+    }
+    return *result;
+}
+
+// Resume point returned by an earlier response, key and skip are left alone if the request has none. Returns true if it's malformed
+bool request_cursor (boost::property_tree::ptree const & request_a, germ::uint256_union & key_a, uint64_t & skip_a)
+{
+    auto result (false);
+    boost::optional<std::string> cursor_text (request_a.get_optional<std::string> ("cursor"));
+    if (cursor_text.is_initialized ())
+    {
+        auto & text (cursor_text.get ());
+        result = text.size () != 80 || key_a.decode_hex (text.substr (0, 64));
+        if (!result)
+        {
+            try
+            {
+                size_t end;
+                skip_a = std::stoull (text.substr (64), &end, 16);
+                result = end != 16;
+            }
+            catch (std::logic_error const &)
+            {
+                result = true;
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * Walks a table keyed by 256 bit values from a cursor position. The read transaction is replaced once it's older than
+ * rpc_handler::read_age_max and the walk carries on from the same entry in the new snapshot. It's also released while the
+ * output blocks on a slow client, the next step seeks back to the entry in a new one.
+ */
+class table_walk
+{
+public:
+    table_walk (germ::mdb_env & environment_a, MDB_dbi table_a, germ::uint256_union const & key_a, uint64_t skip_a) :
+    key (key_a),
+    skip (skip_a),
+    environment (environment_a),
+    table (table_a),
+    iterator (nullptr)
+    {
+        seek ();
+    }
+    bool done () const
+    {
+        return iterator == germ::store_iterator (nullptr);
+    }
+    germ::mdb_val const & value ()
+    {
+        return iterator->second;
+    }
+    MDB_txn * transaction () const
+    {
+        return *current;
+    }
+    void next ()
+    {
+        // Seeking back lands past the current entry if it was deleted meanwhile, which is already the next one
+        if (current != nullptr || seek ())
+        {
+            ++iterator;
+            position ();
+        }
+        if (!done () && std::chrono::steady_clock::now () - opened > germ::rpc_handler::read_age_max)
+        {
+            seek ();
+        }
+    }
+    // Closes the transaction until the next step, value and transaction can't be used in between
+    void release ()
+    {
+        iterator = germ::store_iterator (nullptr);
+        current.reset ();
+    }
+    // Resume point of the current entry
+    std::string cursor () const
+    {
+        return key.to_string () + boost::str (boost::format ("%016x") % skip);
+    }
+    germ::uint256_union key;
+    // Entries passed under the same key before the current one, only nonzero in tables with duplicate keys
+    uint64_t skip;
+
+private:
+    // Returns true if the walk is still on the entry at the cursor
+    bool seek ()
+    {
+        // The cursor has to be closed before its transaction is released
+        release ();
+        current = std::make_unique<germ::read_transaction> (environment);
+        opened = std::chrono::steady_clock::now ();
+        iterator = germ::store_iterator (*current, table, germ::mdb_val (key));
+        uint64_t skipped (0);
+        for (; skipped < skip && !done () && iterator->first.uint256 () == key; ++skipped)
+        {
+            ++iterator;
+        }
+        auto result (!done () && iterator->first.uint256 () == key);
+        if (!done () && !result)
+        {
+            key = iterator->first.uint256 ();
+            skip = 0;
+        }
+        return result;
+    }
+    void position ()
+    {
+        if (!done ())
+        {
+            auto key_l (iterator->first.uint256 ());
+            if (key_l == key)
+            {
+                ++skip;
+            }
+            else
+            {
+                key = key_l;
+                skip = 0;
+            }
+        }
+    }
+    germ::mdb_env & environment;
+    MDB_dbi table;
+    std::unique_ptr<germ::read_transaction> current;
+    germ::store_iterator iterator;
+    std::chrono::steady_clock::time_point opened;
+};
+
+/**
+ * Output of a ledger-wide action. Once it grows past rpc_handler::stream_chunk it's handed to the connection in chunks
+ * if the connection can stream, otherwise it's sent whole when finished.
+ */
+class streamed_response
+{
+public:
+    streamed_response (germ::rpc_handler & handler_a) :
+    handler (handler_a),
+    streaming (false)
+    {
+    }
+    // Returns true if the client went away and the action should stop. Writing can wait on the client so release_a is
+    // called first to let go of read transactions
+    bool flush (std::function<void()> const & release_a)
+    {
+        auto result (false);
+        if (handler.stream != nullptr && writer.output.size () >= germ::rpc_handler::stream_chunk && handler.stream->writable ())
+        {
+            streaming = true;
+            release_a ();
+            result = handler.stream->write (writer.take ());
+        }
+        return result;
+    }
+    bool flush (table_walk & walk_a)
+    {
+        return flush ([&walk_a]() { walk_a.release (); });
+    }
+    void finish ()
+    {
+        if (!streaming)
+        {
+            handler.response_body (writer.output);
+        }
+        else
+        {
+            if (!handler.stream->write (writer.take ()))
+            {
+                handler.stream->finish ();
+            }
+            // A streamed body doesn't go through response_body so its latency is recorded here
+            if (handler.latency != nullptr)
+            {
+                handler.latency->add (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - handler.start).count ());
+            }
+        }
+    }
+    germ::json_writer writer;
+
+private:
+    germ::rpc_handler & handler;
+    bool streaming;
+};
+
+void ledger_entry (germ::json_writer & writer_a, germ::ledger & ledger_a, MDB_txn * transaction_a, germ::account const & account_a, germ::account_info const & info_a, bool weight_a, bool pending_a)
+{
+    writer_a.begin_object (account_a.to_account ());
+    info_a.serialize_json (writer_a);
+    if (weight_a)
+    {
+        writer_a.value ("weight", ledger_a.weight (transaction_a, account_a).convert_to<std::string> ());
+    }
+    if (pending_a)
+    {
+        writer_a.value ("pending", ledger_a.account_pending (transaction_a, account_a).convert_to<std::string> ());
+    }
+    writer_a.end_object ();
+}
 }
 
 void germ::rpc_handler::account_balance ()
 {
-    std::string account_text (request.get<std::string> ("account"));
+    std::string account_text (request_field (*document, "account"));
     germ::uint256_union account;
     auto error (account.decode_account (account_text));
     if (!error)
     {
-        auto balance (node.balance_pending (account));
-        boost::property_tree::ptree response_l;
-        response_l.put ("balance", balance.first.convert_to<std::string> ());
-        response_l.put ("pending", balance.second.convert_to<std::string> ());
-        response (response_l);
+        germ::rpc_read_transaction transaction (*this);
+        auto balance (std::make_pair (node.ledger.account_balance (transaction, account), node.ledger.account_pending (transaction, account)));
+        germ::json_writer writer;
+        writer.begin_object ();
+        writer.value ("balance", balance.first.convert_to<std::string> ());
+        writer.value ("pending", balance.second.convert_to<std::string> ());
+        writer.end_object ();
+        response_body (writer.output);
     }
     else
     {
-        error_response (response, "Bad account number");
+        error_response (response_body, "Bad account number");
     }
 }
 
@@ -256,7 +695,7 @@ void germ::rpc_handler::account_block_count ()
         return;
     }
 
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::rpc_read_transaction transaction (*this);
     germ::account_info info;
     if (!node.store.account_get (transaction, account, info))
     {
@@ -325,46 +764,40 @@ void germ::rpc_handler::account_get ()
 
 void germ::rpc_handler::account_info ()
 {
-    std::string account_text (request.get<std::string> ("account"));
+    std::string account_text (request_field (*document, "account"));
     germ::uint256_union account;
     auto error (account.decode_account (account_text));
     if (error)
     {
-        error_response (response, "Bad account number");
+        error_response (response_body, "Bad account number");
         return;
     }
 
-//    const bool representative = request.get<bool> ("representative", false);
-    const bool weight = request.get<bool> ("weight", false);
-    const bool pending = request.get<bool> ("pending", false);
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    const bool weight = request_flag (*document, "weight", false);
+    const bool pending = request_flag (*document, "pending", false);
+    germ::rpc_read_transaction transaction (*this);
     germ::account_info info;
     if (!node.store.account_get (transaction, account, info))
     {
-        error_response (response, "Account not found");
+        error_response (response_body, "Account not found");
         return;
     }
 
-    boost::property_tree::ptree response_l;
-    response_l.put ("frontier", info.head.to_string ());
-    response_l.put ("open_block", info.open_block.to_string ());
-//    response_l.put ("representative_block", info.rep_block.to_string ());
-    std::string balance;
-    germ::uint128_union (info.balance).encode_dec (balance);
-    response_l.put ("balance", balance);
-    response_l.put ("modified_timestamp", std::to_string (info.modified));
-    response_l.put ("block_count", std::to_string (info.block_count));
+    germ::json_writer writer;
+    writer.begin_object ();
+    info.serialize_json (writer);
     if (weight)
     {
         auto account_weight (node.ledger.weight (transaction, account));
-        response_l.put ("weight", account_weight.convert_to<std::string> ());
+        writer.value ("weight", account_weight.convert_to<std::string> ());
     }
     if (pending)
     {
         auto account_pending (node.ledger.account_pending (transaction, account));
-        response_l.put ("pending", account_pending.convert_to<std::string> ());
+        writer.value ("pending", account_pending.convert_to<std::string> ());
     }
-    response (response_l);
+    writer.end_object ();
+    response_body (writer.output);
 }
 
 void germ::rpc_handler::account_key ()
@@ -404,7 +837,7 @@ void germ::rpc_handler::account_list ()
 
     boost::property_tree::ptree response_l;
     boost::property_tree::ptree accounts;
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     for (auto i (existing->second->store.begin (transaction)), j (existing->second->store.end ()); i != j; ++i)
     {
         boost::property_tree::ptree entry;
@@ -467,6 +900,11 @@ void germ::rpc_handler::account_move ()
     }
     germ::transaction transaction (node.store.environment, nullptr, true);
     auto error_moved (wallet_acc->store.move (transaction, source_acc->store, accounts));
+    for (auto & account : accounts)
+    {
+        wallet_acc->metadata_update (transaction, account);
+        source_acc->metadata_update (transaction, account);
+    }
     boost::property_tree::ptree response_l;
     response_l.put ("moved", error_moved ? "0" : "1");
     response (response_l);
@@ -537,7 +975,7 @@ void germ::rpc_handler::account_representative ()
         return;
     }
 
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     germ::account_info info;
     auto found (node.store.account_get (transaction, account, info));
     if (!found)
@@ -651,28 +1089,29 @@ void germ::rpc_handler::account_weight ()
 
 void germ::rpc_handler::accounts_balances ()
 {
-    boost::property_tree::ptree response_l;
-    boost::property_tree::ptree balances;
-    for (auto & accounts : request.get_child ("accounts"))
+    auto & accounts (request_child (*document, "accounts"));
+    germ::rpc_read_transaction transaction (*this);
+    germ::json_writer writer;
+    writer.begin_object ();
+    writer.begin_object ("balances");
+    for (auto i (accounts.child); i != nullptr; i = i->next)
     {
-        std::string account_text = accounts.second.data ();
         germ::uint256_union account;
-        auto error (account.decode_account (account_text));
-        if (!error)
-        {
-            boost::property_tree::ptree entry;
-            auto balance (node.balance_pending (account));
-            entry.put ("balance", balance.first.convert_to<std::string> ());
-            entry.put ("pending", balance.second.convert_to<std::string> ());
-            balances.push_back (std::make_pair (account.to_account (), entry));
-        }
-        else
+        auto error (account.decode_account (i->string ()));
+        if (error)
         {
-            error_response (response, "Bad account number");
+            error_response (response_body, "Bad account number");
+            return;
         }
+        auto balance (std::make_pair (node.ledger.account_balance (transaction, account), node.ledger.account_pending (transaction, account)));
+        writer.begin_object (account.to_account ());
+        writer.value ("balance", balance.first.convert_to<std::string> ());
+        writer.value ("pending", balance.second.convert_to<std::string> ());
+        writer.end_object ();
     }
-    response_l.add_child ("balances", balances);
-    response (response_l);
+    writer.end_object ();
+    writer.end_object ();
+    response_body (writer.output);
 }
 
 void germ::rpc_handler::accounts_create ()
@@ -729,7 +1168,7 @@ void germ::rpc_handler::accounts_frontiers ()
 {
     boost::property_tree::ptree response_l;
     boost::property_tree::ptree frontiers;
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     for (auto & accounts : request.get_child ("accounts"))
     {
         std::string account_text = accounts.second.data ();
@@ -777,7 +1216,7 @@ void germ::rpc_handler::accounts_pending ()
     const bool source = request.get<bool> ("source", false);
     boost::property_tree::ptree response_l;
     boost::property_tree::ptree pending;
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     for (auto & accounts : request.get_child ("accounts"))
     {
         std::string account_text = accounts.second.data ();
@@ -790,30 +1229,35 @@ void germ::rpc_handler::accounts_pending ()
 
         boost::property_tree::ptree peers_l;
         germ::account end (account.number () + 1);
-        for (auto i (node.store.pending_begin (transaction, germ::pending_key (account, 0))), n (node.store.pending_begin (transaction, germ::pending_key (end, 0))); i != n && peers_l.size () < count; ++i)
+        // Entries are only scanned when the aggregate can satisfy the threshold
+        auto receivable (node.store.receivable_get (transaction, account));
+        if (receivable.count != 0 && receivable.total.number () >= threshold.number ())
         {
-            germ::pending_key key (i->first);
-            if (threshold.is_zero () && !source)
-            {
-                boost::property_tree::ptree entry;
-                entry.put ("", key.hash.to_string ());
-                peers_l.push_back (std::make_pair ("", entry));
-            }
-            else
+            for (auto i (node.store.pending_begin (transaction, germ::pending_key (account, 0))), n (node.store.pending_begin (transaction, germ::pending_key (end, 0))); i != n && peers_l.size () < count; ++i)
             {
-                germ::pending_info info (i->second);
-                if (info.amount.number () >= threshold.number ())
+                germ::pending_key key (i->first);
+                if (threshold.is_zero () && !source)
                 {
-                    if (source)
-                    {
-                        boost::property_tree::ptree pending_tree;
-                        pending_tree.put ("amount", info.amount.number ().convert_to<std::string> ());
-                        pending_tree.put ("source", info.source.to_account ());
-                        peers_l.add_child (key.hash.to_string (), pending_tree);
-                    }
-                    else
+                    boost::property_tree::ptree entry;
+                    entry.put ("", key.hash.to_string ());
+                    peers_l.push_back (std::make_pair ("", entry));
+                }
+                else
+                {
+                    germ::pending_info info (i->second);
+                    if (info.amount.number () >= threshold.number ())
                     {
-                        peers_l.put (key.hash.to_string (), info.amount.number ().convert_to<std::string> ());
+                        if (source)
+                        {
+                            boost::property_tree::ptree pending_tree;
+                            pending_tree.put ("amount", info.amount.number ().convert_to<std::string> ());
+                            pending_tree.put ("source", info.source.to_account ());
+                            peers_l.add_child (key.hash.to_string (), pending_tree);
+                        }
+                        else
+                        {
+                            peers_l.put (key.hash.to_string (), info.amount.number ().convert_to<std::string> ());
+                        }
                     }
                 }
             }
@@ -836,6 +1280,107 @@ void germ::rpc_handler::available_supply ()
     response (response_l);
 }
 
+namespace
+{
+class batch_state
+{
+public:
+    std::vector<std::string> requests;
+    std::vector<std::string> responses;
+    // One per chunk, all begun on the same commit
+    std::vector<std::unique_ptr<germ::read_transaction>> transactions;
+    std::atomic<size_t> remaining;
+};
+
+void batch_run (germ::rpc_handler & handler_a, std::shared_ptr<batch_state> state_a, size_t begin_a, size_t end_a, MDB_txn * transaction_a)
+{
+    for (auto i (begin_a); i < end_a; ++i)
+    {
+        auto item (std::make_shared<germ::rpc_handler> (handler_a.node, handler_a.rpc, state_a->requests[i], [state_a, i](std::string const & body_a) {
+            state_a->responses[i] = body_a;
+        }));
+        item->batched = true;
+        item->snapshot = transaction_a;
+        item->process_request ();
+    }
+}
+
+void batch_finish (germ::rpc_handler & handler_a, std::shared_ptr<batch_state> state_a)
+{
+    germ::json_writer writer;
+    writer.begin_object ();
+    writer.begin_array ("responses");
+    for (auto & i : state_a->responses)
+    {
+        if (!i.empty ())
+        {
+            writer.raw (i);
+        }
+        else
+        {
+            writer.begin_object ();
+            writer.value ("error", "No response");
+            writer.end_object ();
+        }
+    }
+    writer.end_array ();
+    writer.end_object ();
+    handler_a.response_body (writer.output);
+}
+}
+
+void germ::rpc_handler::batch ()
+{
+    auto & requests (request_child (*document, "requests"));
+    auto state (std::make_shared<batch_state> ());
+    for (auto i (requests.child); i != nullptr; i = i->next)
+    {
+        state->requests.push_back (std::string (i->data, i->size));
+    }
+    if (state->requests.size () > batch_max)
+    {
+        error_response (response_body, "Too many requests in batch");
+        return;
+    }
+    state->responses.resize (state->requests.size ());
+    // Items are split across the worker pool, each chunk reading through its own transaction
+    auto chunks (std::max<size_t> (1, std::min<size_t> (rpc.config.worker_threads, (state->requests.size () + batch_chunk - 1) / batch_chunk)));
+    // The transactions are all begun before any work is handed out and only kept if they see the same commit, otherwise the batch runs serially as one chunk
+    for (auto attempt (0u); chunks > 1 && state->transactions.empty () && attempt < batch_snapshot_attempts; ++attempt)
+    {
+        for (size_t i (0); i < chunks; ++i)
+        {
+            state->transactions.push_back (std::unique_ptr<germ::read_transaction> (new germ::read_transaction (node.store.environment)));
+        }
+        auto id (mdb_txn_id (*state->transactions.front ()));
+        if (std::any_of (state->transactions.begin (), state->transactions.end (), [id](std::unique_ptr<germ::read_transaction> const & transaction_a) { return mdb_txn_id (*transaction_a) != id; }))
+        {
+            state->transactions.clear ();
+        }
+    }
+    if (state->transactions.empty ())
+    {
+        chunks = 1;
+        state->transactions.push_back (std::unique_ptr<germ::read_transaction> (new germ::read_transaction (node.store.environment)));
+    }
+    state->remaining = chunks;
+    auto this_l (shared_from_this ());
+    for (size_t i (0); i < chunks; ++i)
+    {
+        auto begin (state->requests.size () * i / chunks);
+        auto end (state->requests.size () * (i + 1) / chunks);
+        rpc.background ([this_l, state, i, begin, end]() {
+            batch_run (*this_l, state, begin, end, *state->transactions[i]);
+            // Released as soon as the chunk is done so it doesn't hold back page reuse while the others finish
+            state->transactions[i].reset ();
+            if (--state->remaining == 0)
+            {
+                batch_finish (*this_l, state);
+            }
+        });
+    }
+}
+
 void germ::rpc_handler::block ()
 {
     std::string hash_text (request.get<std::string> ("hash"));
@@ -847,7 +1392,7 @@ void germ::rpc_handler::block ()
         return;
     }
 
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     auto block (node.store.block_get (transaction, hash));
     if (block == nullptr)
     {
@@ -872,7 +1417,7 @@ void germ::rpc_handler::block_confirm ()
         return;
     }
 
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     auto block_l (node.store.block_get (transaction, hash_l));
     if (block_l == nullptr)
     {
@@ -891,7 +1436,7 @@ void germ::rpc_handler::blocks ()
     std::vector<std::string> hashes;
     boost::property_tree::ptree response_l;
     boost::property_tree::ptree blocks;
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     for (boost::property_tree::ptree::value_type & hashes : request.get_child ("hashes"))
     {
         std::string hash_text = hashes.second.data ();
@@ -920,39 +1465,40 @@ void germ::rpc_handler::blocks ()
 
 void germ::rpc_handler::blocks_info ()
 {
-    const bool pending = request.get<bool> ("pending", false);
-    const bool source = request.get<bool> ("source", false);
-    const bool balance = request.get<bool> ("balance", false);
-    std::vector<std::string> hashes;
-    boost::property_tree::ptree response_l;
-    boost::property_tree::ptree blocks;
-    germ::transaction transaction (node.store.environment, nullptr, false);
-    for (boost::property_tree::ptree::value_type & hashes : request.get_child ("hashes"))
-    {
-        std::string hash_text = hashes.second.data ();
+    const bool pending = request_flag (*document, "pending", false);
+    const bool source = request_flag (*document, "source", false);
+    const bool balance = request_flag (*document, "balance", false);
+    auto & hashes (request_child (*document, "hashes"));
+    germ::json_writer writer;
+    writer.begin_object ();
+    writer.begin_object ("blocks");
+    germ::rpc_read_transaction transaction (*this);
+    for (auto i (hashes.child); i != nullptr; i = i->next)
+    {
+        std::string hash_text (i->string ());
         germ::uint256_union hash;
         auto error (hash.decode_hex (hash_text));
         if (error)
         {
-            error_response (response, "Bad hash number");
-            continue;
+            error_response (response_body, "Bad hash number");
+            return;
         }
 
         auto block (node.store.block_get (transaction, hash));
         if (block == nullptr)
         {
-            error_response (response, "Block not found");
-            continue;
+            error_response (response_body, "Block not found");
+            return;
         }
 
-        boost::property_tree::ptree entry;
+        writer.begin_object (hash_text);
         auto account (node.ledger.account (transaction, hash));
-        entry.put ("block_account", account.to_account ());
+        writer.value ("block_account", account.to_account ());
         auto amount (node.ledger.amount (transaction, hash));
-        entry.put ("amount", amount.convert_to<std::string> ());
+        writer.value ("amount", amount.convert_to<std::string> ());
         std::string contents;
         block->serialize_json (contents);
-        entry.put ("contents", contents);
+        writer.value ("contents", contents);
         if (pending)
         {
             bool exists (false);
@@ -961,31 +1507,31 @@ void germ::rpc_handler::blocks_info ()
             {
                 exists = node.store.pending_exists (transaction, germ::pending_key (destination, hash));
             }
-            entry.put ("pending", exists ? "1" : "0");
+            writer.value ("pending", exists ? "1" : "0");
         }
         if (source)
         {
             germ::block_hash source_hash (node.ledger.block_source (transaction, *block));
-            std::unique_ptr<germ::tx> block_a (node.store.block_get (transaction, source_hash));
-            if (block_a != nullptr)
+            if (node.store.block_exists (transaction, source_hash))
             {
                 auto source_account (node.ledger.account (transaction, source_hash));
-                entry.put ("source_account", source_account.to_account ());
+                writer.value ("source_account", source_account.to_account ());
             }
             else
             {
-                entry.put ("source_account", "0");
+                writer.value ("source_account", "0");
             }
         }
         if (balance)
         {
             auto balance (node.ledger.balance (transaction, hash));
-            entry.put ("balance", balance.convert_to<std::string> ());
+            writer.value ("balance", balance.convert_to<std::string> ());
         }
-        blocks.push_back (std::make_pair (hash_text, entry));
+        writer.end_object ();
     }
-    response_l.add_child ("blocks", blocks);
-    response (response_l);
+    writer.end_object ();
+    writer.end_object ();
+    response_body (writer.output);
 }
 
 void germ::rpc_handler::block_account ()
@@ -998,7 +1544,7 @@ void germ::rpc_handler::block_account ()
         return;
     }
 
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::rpc_read_transaction transaction (*this);
     if (!node.store.block_exists (transaction, hash))
     {
         error_response (response, "Block not found");
@@ -1013,7 +1559,7 @@ void germ::rpc_handler::block_account ()
 
 void germ::rpc_handler::block_count ()
 {
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     boost::property_tree::ptree response_l;
     response_l.put ("count", std::to_string (node.store.block_count (transaction).sum ()));
     response_l.put ("unchecked", std::to_string (node.store.unchecked_count (transaction)));
@@ -1022,7 +1568,7 @@ void germ::rpc_handler::block_count ()
 
 void germ::rpc_handler::block_count_type ()
 {
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     germ::block_counts count (node.store.block_count (transaction));
     boost::property_tree::ptree response_l;
     response_l.put ("send", std::to_string (count.send));
@@ -1121,7 +1667,7 @@ void germ::rpc_handler::block_create ()
         auto existing (node.wallets.items.find (wallet));
         if (existing != node.wallets.items.end ())
         {
-            germ::transaction transaction (node.store.environment, nullptr, false);
+            germ::read_transaction transaction (node.store.environment);
             auto unlock_check (existing->second->store.valid_password (transaction));
             if (unlock_check)
             {
@@ -1204,14 +1750,14 @@ void germ::rpc_handler::block_create ()
     // Fetching account balance & previous for send blocks (if aren't given directly)
     if (!previous_text.is_initialized () && !balance_text.is_initialized ())
     {
-        germ::transaction transaction (node.store.environment, nullptr, false);
+        germ::read_transaction transaction (node.store.environment);
         previous = node.ledger.latest (transaction, pub);
         balance = node.ledger.account_balance (transaction, pub);
     }
         // Double check current balance if previous block is specified
     else if (previous_text.is_initialized () && balance_text.is_initialized () && type == "send")
     {
-        germ::transaction transaction (node.store.environment, nullptr, false);
+        germ::read_transaction transaction (node.store.environment);
         if (node.store.block_exists (transaction, previous) && node.store.block_balance (transaction, previous) != balance.number ())
         {
             error_response (response, "Balance mismatch for previous block");
@@ -1445,7 +1991,18 @@ void germ::rpc_handler::successors ()
 
     boost::property_tree::ptree response_l;
     boost::property_tree::ptree blocks;
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
+    germ::height_info height_info;
+    if (node.store.block_height_get (transaction, block, height_info))
+    {
+        // Successors are the blocks at increasing heights of the same account
+        for (auto height (height_info.height); !block.is_zero () && blocks.size () < count; block = node.store.block_at_height (transaction, height_info.account, ++height))
+        {
+            boost::property_tree::ptree entry;
+            entry.put ("", block.to_string ());
+            blocks.push_back (std::make_pair ("", entry));
+        }
+    }
     while (!block.is_zero () && blocks.size () < count)
     {
         auto block_l (node.store.block_get (transaction, block));
@@ -1518,7 +2075,19 @@ void germ::rpc_handler::chain ()
 
     boost::property_tree::ptree response_l;
     boost::property_tree::ptree blocks;
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
+    germ::height_info height_info;
+    if (node.store.block_height_get (transaction, block, height_info))
+    {
+        // The height index lists the chain from `block' down to the open block without deserializing it
+        block.clear ();
+        for (auto i (node.store.height_begin (transaction, height_info.account, height_info.height)), n (node.store.height_end ()); i != n && blocks.size () < count && germ::height_key (i->first).account == height_info.account; ++i)
+        {
+            boost::property_tree::ptree entry;
+            entry.put ("", germ::block_hash (i->second.uint256 ()).to_string ());
+            blocks.push_back (std::make_pair ("", entry));
+        }
+    }
     while (!block.is_zero () && blocks.size () < count)
     {
         auto block_l (node.store.block_get (transaction, block));
@@ -1556,6 +2125,26 @@ void germ::rpc_handler::confirmation_history ()
     response (response_l);
 }
 
+void germ::rpc_handler::confirmation_latency ()
+{
+    boost::property_tree::ptree response_l;
+    response_l.put ("traced", std::to_string (node.tracer.traced.load ()));
+    boost::property_tree::ptree stages;
+    for (size_t i (0); i < germ::block_tracer::stage_count; ++i)
+    {
+        // Microseconds from the first recorded stage of each block
+        auto & histogram (node.tracer.histograms[i]);
+        boost::property_tree::ptree stage;
+        stage.put ("count", std::to_string (histogram.total ()));
+        stage.put ("p50", std::to_string (histogram.percentile (0.5)));
+        stage.put ("p90", std::to_string (histogram.percentile (0.9)));
+        stage.put ("p99", std::to_string (histogram.percentile (0.99)));
+        stages.add_child (germ::block_tracer::stage_to_string (static_cast<germ::block_stage> (i)), stage);
+    }
+    response_l.add_child ("stages", stages);
+    response (response_l);
+}
+
 void germ::rpc_handler::delegators ()
 {
     std::string account_text (request.get<std::string> ("account"));
@@ -1569,7 +2158,7 @@ void germ::rpc_handler::delegators ()
 
     boost::property_tree::ptree response_l;
     boost::property_tree::ptree delegators;
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
 //    for (auto i (node.store.latest_begin (transaction)), n (node.store.latest_end ()); i != n; ++i)
 //    {
 //        germ::account_info info (i->second);
@@ -1598,7 +2187,7 @@ void germ::rpc_handler::delegators_count ()
     }
 
     uint64_t count (0);
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
 //    for (auto i (node.store.latest_begin (transaction)), n (node.store.latest_end ()); i != n; ++i)
 //    {
 //        germ::account_info info (i->second);
@@ -1650,17 +2239,119 @@ void germ::rpc_handler::deterministic_key ()
     response (response_l);
 }
 
+void germ::rpc_handler::epoch_proof ()
+{
+    std::string hash_text (request.get<std::string> ("hash"));
+    germ::block_hash hash;
+    if (hash.decode_hex (hash_text))
+    {
+        error_response (response, "Bad hash number");
+        return;
+    }
+
+    germ::read_transaction transaction (node.epoch_store.environment);
+    germ::epoch_tx_info info;
+    if (!node.epoch_store.tx_epoch_get (transaction, hash, info))
+    {
+        error_response (response, "Transaction not in any epoch");
+        return;
+    }
+    boost::optional<std::string> epoch_text (request.get_optional<std::string> ("epoch"));
+    if (epoch_text.is_initialized ())
+    {
+        germ::epoch_hash epoch_hash;
+        if (epoch_hash.decode_hex (epoch_text.get ()))
+        {
+            error_response (response, "Bad epoch hash");
+            return;
+        }
+        if (epoch_hash != info.epoch)
+        {
+            error_response (response, "Transaction not in epoch");
+            return;
+        }
+    }
+    auto epoch (node.epoch_store.block_get (transaction, info.epoch));
+    if (epoch == nullptr)
+    {
+        error_response (response, "Epoch not found");
+        return;
+    }
+
+    germ::merkle_tree tree (epoch->txs ());
+    boost::property_tree::ptree response_l;
+    response_l.put ("epoch", info.epoch.to_string ());
+    response_l.put ("root", tree.root ().to_string ());
+    response_l.put ("index", std::to_string (info.index));
+    response_l.put ("count", std::to_string (epoch->txs ().size ()));
+    boost::property_tree::ptree proof;
+    for (auto & i : tree.proof (info.index))
+    {
+        boost::property_tree::ptree entry;
+        entry.put ("", i.to_string ());
+        proof.push_back (std::make_pair ("", entry));
+    }
+    response_l.add_child ("proof", proof);
+    response (response_l);
+}
+
+void germ::rpc_handler::epochs_range ()
+{
+    uint64_t from_time;
+    uint64_t to_time;
+    if (decode_unsigned (request.get<std::string> ("from_time"), from_time) || decode_unsigned (request.get<std::string> ("to_time"), to_time))
+    {
+        error_response (response, "Bad time range");
+        return;
+    }
+    uint64_t count (std::numeric_limits<uint64_t>::max ());
+    boost::optional<std::string> count_text (request.get_optional<std::string> ("count"));
+    if (count_text.is_initialized () && decode_unsigned (count_text.get (), count))
+    {
+        error_response (response, "Invalid count limit");
+        return;
+    }
+
+    boost::property_tree::ptree response_l;
+    boost::property_tree::ptree epochs;
+    germ::read_transaction transaction (node.epoch_store.environment);
+    for (auto i (node.epoch_store.time_begin (transaction, from_time)), n (node.epoch_store.time_end ()); i != n && epochs.size () < count; ++i)
+    {
+        germ::epoch_time_key key (i->first);
+        if (key.timestamp () > to_time)
+        {
+            break;
+        }
+        boost::property_tree::ptree entry;
+        entry.put ("hash", i->second.uint256 ().to_string ());
+        entry.put ("height", std::to_string (key.height ()));
+        entry.put ("timestamp", std::to_string (key.timestamp ()));
+        epochs.push_back (std::make_pair ("", entry));
+    }
+    response_l.add_child ("epochs", epochs);
+    response (response_l);
+}
+
 void germ::rpc_handler::frontiers ()
 {
-    std::string account_text (request.get<std::string> ("account"));
-    std::string count_text (request.get<std::string> ("count"));
-    germ::account start;
-    if (start.decode_account (account_text))
+    germ::account start (0);
+    uint64_t skip (0);
+    if (!request.get_optional<std::string> ("cursor").is_initialized ())
+    {
+        std::string account_text (request.get<std::string> ("account"));
+        if (start.decode_account (account_text))
+        {
+            error_response (response, "Invalid starting account");
+            return;
+        }
+    }
+    if (request_cursor (request, start, skip))
     {
-        error_response (response, "Invalid starting account");
+        error_response (response, "Invalid cursor");
         return;
     }
 
+    std::string count_text (request.get<std::string> ("count"));
     uint64_t count;
     if (decode_unsigned (count_text, count))
     {
@@ -1668,20 +2359,31 @@ void germ::rpc_handler::frontiers ()
         return;
     }
 
-    boost::property_tree::ptree response_l;
-    boost::property_tree::ptree frontiers;
-    germ::transaction transaction (node.store.environment, nullptr, false);
-    for (auto i (node.store.latest_begin (transaction, start)), n (node.store.latest_end ()); i != n && frontiers.size () < count; ++i)
+    streamed_response output (*this);
+    auto & writer (output.writer);
+    writer.begin_object ();
+    writer.begin_object ("frontiers");
+    table_walk walk (node.store.environment, node.store.accounts, start, skip);
+    for (uint64_t written (0); !walk.done () && written < count; walk.next (), ++written)
+    {
+        writer.value (germ::account (walk.key).to_account (), germ::account_info (walk.value ()).head.to_string ());
+        if (output.flush (walk))
+        {
+            break;
+        }
+    }
+    writer.end_object ();
+    if (!walk.done ())
     {
-        frontiers.put (germ::account (i->first.uint256 ()).to_account (), germ::account_info (i->second).head.to_string ());
+        writer.value ("cursor", walk.cursor ());
     }
-    response_l.add_child ("frontiers", frontiers);
-    response (response_l);
+    writer.end_object ();
+    output.finish ();
 }
 
 void germ::rpc_handler::account_count ()
 {
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     auto size (node.store.account_count (transaction));
     boost::property_tree::ptree response_l;
     response_l.put ("count", std::to_string (size));
@@ -1693,7 +2395,7 @@ namespace
 class history_visitor : public germ::block_visitor
 {
 public:
-    history_visitor (germ::rpc_handler & handler_a, bool raw_a, germ::transaction & transaction_a, boost::property_tree::ptree & tree_a, germ::block_hash const & hash_a) :
+    history_visitor (germ::rpc_handler & handler_a, bool raw_a, MDB_txn * transaction_a, boost::property_tree::ptree & tree_a, germ::block_hash const & hash_a) :
     handler (handler_a),
     raw (raw_a),
     transaction (transaction_a),
@@ -1819,16 +2521,16 @@ public:
             tree.put("type", "receive");
         }
 
-        tree.put("previous", tx.previous_.to_string());
-        tree.put("destination", tx.destination_.to_account());
-        tree.put("source", tx.source_.to_string());
-        tree.put("balance", tx.balance_.to_string());
+        tree.put("previous", tx.previous ().to_string());
+        tree.put("destination", tx.destination ().to_account());
+        tree.put("source", tx.source ().to_string());
+        tree.put("balance", tx.balance ().to_string());
 
         boost::property_tree::ptree tx_info;
-        tx_info.put("value", germ::to_string_hex(tx.tx_info.value));
-        tx_info.put("data", tx.tx_info.data);
-        tx_info.put("gas", germ::to_string_hex(tx.tx_info.gas));
-        tx_info.put("gasprice", germ::to_string_hex(tx.tx_info.gas_price));
+        tx_info.put("value", germ::to_string_hex(tx.tx_info ().value));
+        tx_info.put("data", tx.tx_info ().data);
+        tx_info.put("gas", germ::to_string_hex(tx.tx_info ().gas));
+        tx_info.put("gasprice", germ::to_string_hex(tx.tx_info ().gas_price));
 
         tree.put_child("tx_info", tx_info);
 
@@ -1837,7 +2539,7 @@ public:
 
     germ::rpc_handler & handler;
     bool raw;
-    germ::transaction & transaction;
+    MDB_txn * transaction;
     boost::property_tree::ptree & tree;
     germ::block_hash const & hash;
 };
@@ -1851,7 +2553,7 @@ void germ::rpc_handler::account_history ()
     auto error (false);
     germ::block_hash hash;
     auto head_str (request.get_optional<std::string> ("head"));
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     if (head_str)
     {
         error = hash.decode_hex (*head_str);
@@ -1905,32 +2607,59 @@ void germ::rpc_handler::account_history ()
     }
 
     response_l.put ("account", account_text);
-    auto block (node.store.block_get (transaction, hash));
-    while (block != nullptr && count > 0)
+    auto history_entry = [&](germ::tx const & block_a) {
+        boost::property_tree::ptree entry;
+        history_visitor visitor (*this, output_raw, transaction, entry, hash);
+        block_a.visit (visitor);
+        if (!entry.empty ())
+        {
+            entry.put ("hash", hash.to_string ());
+            if (output_raw)
+            {
+//                entry.put ("work", germ::to_string_hex (block_a.block_work ()));
+                entry.put ("signature", block_a.block_signature ().to_string ());
+            }
+            history.push_back (std::make_pair ("", entry));
+        }
+    };
+    germ::height_info height_info;
+    if (!hash.is_zero () && node.store.block_height_get (transaction, hash, height_info))
     {
-        if (offset > 0)
+        // Seek past `offset' blocks through the height index and walk the chain with a cursor
+        hash.clear ();
+        if (offset < height_info.height)
         {
-            --offset;
+            for (auto i (node.store.height_begin (transaction, height_info.account, height_info.height - offset)), n (node.store.height_end ()); i != n && count > 0; ++i)
+            {
+                if (germ::height_key (i->first).account != height_info.account)
+                    break;
+
+                hash = i->second.uint256 ();
+                auto block (node.store.block_get (transaction, hash));
+                assert (block != nullptr);
+                history_entry (*block);
+                hash = block->previous ();
+                --count;
+            }
         }
-        else
+    }
+    else
+    {
+        auto block (node.store.block_get (transaction, hash));
+        while (block != nullptr && count > 0)
         {
-            boost::property_tree::ptree entry;
-            history_visitor visitor (*this, output_raw, transaction, entry, hash);
-            block->visit (visitor);
-            if (!entry.empty ())
+            if (offset > 0)
             {
-                entry.put ("hash", hash.to_string ());
-                if (output_raw)
-                {
-//                    entry.put ("work", germ::to_string_hex (block->block_work ()));
-                    entry.put ("signature", block->block_signature ().to_string ());
-                }
-                history.push_back (std::make_pair ("", entry));
+                --offset;
             }
-            --count;
+            else
+            {
+                history_entry (*block);
+                --count;
+            }
+            hash = block->previous ();
+            block = node.store.block_get (transaction, hash);
         }
-        hash = block->previous ();
-        block = node.store.block_get (transaction, hash);
     }
     response_l.add_child ("history", history);
     if (!hash.is_zero ())
@@ -2001,6 +2730,7 @@ void germ::rpc_handler::ledger ()
     }
 
     germ::account start (0);
+    uint64_t skip (0);
     uint64_t count (std::numeric_limits<uint64_t>::max ());
     boost::optional<std::string> account_text (request.get_optional<std::string> ("account"));
     if (account_text.is_initialized ())
@@ -2009,8 +2739,14 @@ void germ::rpc_handler::ledger ()
         if (error)
         {
             error_response (response, "Invalid starting account");
+            return;
         }
     }
+    if (request_cursor (request, start, skip))
+    {
+        error_response (response, "Invalid cursor");
+        return;
+    }
     boost::optional<std::string> count_text (request.get_optional<std::string> ("count"));
     if (count_text.is_initialized ())
     {
@@ -2018,6 +2754,7 @@ void germ::rpc_handler::ledger ()
         if (error_count)
         {
             error_response (response, "Invalid count limit");
+            return;
         }
     }
     uint64_t modified_since (0);
@@ -2030,51 +2767,38 @@ void germ::rpc_handler::ledger ()
 //    const bool representative = request.get<bool> ("representative", false);
     const bool weight = request.get<bool> ("weight", false);
     const bool pending = request.get<bool> ("pending", false);
-    boost::property_tree::ptree response_a;
-    boost::property_tree::ptree response_l;
-    boost::property_tree::ptree accounts;
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    streamed_response output (*this);
+    auto & writer (output.writer);
+    writer.begin_object ();
+    writer.begin_object ("accounts");
     if (!sorting) // Simple
     {
-        for (auto i (node.store.latest_begin (transaction, start)), n (node.store.latest_end ()); i != n && accounts.size () < count; ++i)
+        table_walk walk (node.store.environment, node.store.accounts, start, skip);
+        for (uint64_t written (0); !walk.done () && written < count; walk.next ())
         {
-            germ::account_info info (i->second);
+            germ::account_info info (walk.value ());
             if (info.modified >= modified_since)
             {
-                germ::account account (i->first.uint256 ());
-                boost::property_tree::ptree response_l;
-                response_l.put ("frontier", info.head.to_string ());
-                response_l.put ("open_block", info.open_block.to_string ());
-//                response_l.put ("representative_block", info.rep_block.to_string ());
-                std::string balance;
-                germ::uint128_union (info.balance).encode_dec (balance);
-                response_l.put ("balance", balance);
-                response_l.put ("modified_timestamp", std::to_string (info.modified));
-                response_l.put ("block_count", std::to_string (info.block_count));
-//                if (representative)
-//                {
-//                    auto block (node.store.block_get (transaction, info.rep_block));
-//                    assert (block != nullptr);
-//                    response_l.put ("representative", block->representative ().to_account ());
-//                }
-                if (weight)
-                {
-                    auto account_weight (node.ledger.weight (transaction, account));
-                    response_l.put ("weight", account_weight.convert_to<std::string> ());
-                }
-                if (pending)
+                ledger_entry (writer, node.ledger, walk.transaction (), walk.key, info, weight, pending);
+                ++written;
+                if (output.flush (walk))
                 {
-                    auto account_pending (node.ledger.account_pending (transaction, account));
-                    response_l.put ("pending", account_pending.convert_to<std::string> ());
+                    break;
                 }
-                accounts.push_back (std::make_pair (account.to_account (), response_l));
             }
         }
+        writer.end_object ();
+        if (!walk.done ())
+        {
+            writer.value ("cursor", walk.cursor ());
+        }
     }
     else // Sorting
     {
+        // Ordering by balance needs every account up front so there's no cursor, count still limits the output
+        auto transaction (std::make_unique<germ::read_transaction> (node.store.environment));
         std::vector<std::pair<germ::uint128_union, germ::account>> ledger_l;
-        for (auto i (node.store.latest_begin (transaction, start)), n (node.store.latest_end ()); i != n; ++i)
+        for (auto i (node.store.latest_begin (*transaction, start)), n (node.store.latest_end ()); i != n; ++i)
         {
             germ::account_info info (i->second);
             germ::uint128_union balance (info.balance);
@@ -2086,39 +2810,24 @@ void germ::rpc_handler::ledger ()
         std::sort (ledger_l.begin (), ledger_l.end ());
         std::reverse (ledger_l.begin (), ledger_l.end ());
         germ::account_info info;
-        for (auto i (ledger_l.begin ()), n (ledger_l.end ()); i != n && accounts.size () < count; ++i)
-        {
-            node.store.account_get (transaction, i->second, info);
-            germ::account account (i->second);
-            response_l.put ("frontier", info.head.to_string ());
-            response_l.put ("open_block", info.open_block.to_string ());
-//            response_l.put ("representative_block", info.rep_block.to_string ());
-            std::string balance;
-            (i->first).encode_dec (balance);
-            response_l.put ("balance", balance);
-            response_l.put ("modified_timestamp", std::to_string (info.modified));
-            response_l.put ("block_count", std::to_string (info.block_count));
-//            if (representative)
-//            {
-//                auto block (node.store.block_get (transaction, info.rep_block));
-//                assert (block != nullptr);
-//                response_l.put ("representative", block->representative ().to_account ());
-//            }
-            if (weight)
+        uint64_t written (0);
+        for (auto i (ledger_l.begin ()), n (ledger_l.end ()); i != n && written < count; ++i, ++written)
+        {
+            if (transaction == nullptr)
             {
-                auto account_weight (node.ledger.weight (transaction, account));
-                response_l.put ("weight", account_weight.convert_to<std::string> ());
+                transaction = std::make_unique<germ::read_transaction> (node.store.environment);
             }
-            if (pending)
+            node.store.account_get (*transaction, i->second, info);
+            ledger_entry (writer, node.ledger, *transaction, i->second, info, weight, pending);
+            if (output.flush ([&transaction]() { transaction.reset (); }))
             {
-                auto account_pending (node.ledger.account_pending (transaction, account));
-                response_l.put ("pending", account_pending.convert_to<std::string> ());
+                break;
             }
-            accounts.push_back (std::make_pair (account.to_account (), response_l));
         }
+        writer.end_object ();
     }
-    response_a.add_child ("accounts", accounts);
-    response (response_a);
+    writer.end_object ();
+    output.finish ();
 }
 
 void germ::rpc_handler::mrai_from_raw ()
@@ -2274,7 +2983,7 @@ void germ::rpc_handler::password_valid (bool wallet_locked = false)
         return;
     }
 
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     boost::property_tree::ptree response_l;
     auto valid (existing->second->store.valid_password (transaction));
     if (!wallet_locked)
@@ -2305,71 +3014,88 @@ void germ::rpc_handler::peers ()
 
 void germ::rpc_handler::pending ()
 {
-    std::string account_text (request.get<std::string> ("account"));
+    std::string account_text (request_field (*document, "account"));
     germ::account account;
     if (account.decode_account (account_text))
     {
-        error_response (response, "Bad account number");
+        error_response (response_body, "Bad account number");
         return;
     }
 
     uint64_t count (std::numeric_limits<uint64_t>::max ());
     germ::uint128_union threshold (0);
-    boost::optional<std::string> count_text (request.get_optional<std::string> ("count"));
-    if (count_text.is_initialized ())
+    std::string count_text;
+    if (document->root ().get ("count", count_text) && decode_unsigned (count_text, count))
     {
-        auto error (decode_unsigned (count_text.get (), count));
-        if (error)
-        {
-            error_response (response, "Invalid count limit");
-        }
+        error_response (response_body, "Invalid count limit");
+        return;
     }
-    boost::optional<std::string> threshold_text (request.get_optional<std::string> ("threshold"));
-    if (threshold_text.is_initialized ())
+    std::string threshold_text;
+    if (document->root ().get ("threshold", threshold_text) && threshold.decode_dec (threshold_text))
     {
-        auto error_threshold (threshold.decode_dec (threshold_text.get ()));
-        if (error_threshold)
-        {
-            error_response (response, "Bad threshold number");
-        }
+        error_response (response_body, "Bad threshold number");
+        return;
+    }
+    const bool source = request_flag (*document, "source", false);
+    // Plain hashes are listed as an array, amounts and sources are keyed by hash
+    const bool hashes_only (threshold.is_zero () && !source);
+    germ::json_writer writer;
+    writer.begin_object ();
+    if (hashes_only)
+    {
+        writer.begin_array ("blocks");
+    }
+    else
+    {
+        writer.begin_object ("blocks");
     }
-    const bool source = request.get<bool> ("source", false);
-    boost::property_tree::ptree response_l;
-    boost::property_tree::ptree peers_l;
     {
-        germ::transaction transaction (node.store.environment, nullptr, false);
+        germ::rpc_read_transaction transaction (*this);
         germ::account end (account.number () + 1);
-        for (auto i (node.store.pending_begin (transaction, germ::pending_key (account, 0))), n (node.store.pending_begin (transaction, germ::pending_key (end, 0))); i != n && peers_l.size () < count; ++i)
+        auto receivable (node.store.receivable_get (transaction, account));
+        if (receivable.count != 0 && receivable.total.number () >= threshold.number ())
         {
-            germ::pending_key key (i->first);
-            if (threshold.is_zero () && !source)
+            uint64_t written (0);
+            for (auto i (node.store.pending_begin (transaction, germ::pending_key (account, 0))), n (node.store.pending_begin (transaction, germ::pending_key (end, 0))); i != n && written < count; ++i)
             {
-                boost::property_tree::ptree entry;
-                entry.put ("", key.hash.to_string ());
-                peers_l.push_back (std::make_pair ("", entry));
-            }
-            else
-            {
-                germ::pending_info info (i->second);
-                if (info.amount.number () >= threshold.number ())
+                germ::pending_key key (i->first);
+                if (hashes_only)
                 {
-                    if (source)
-                    {
-                        boost::property_tree::ptree pending_tree;
-                        pending_tree.put ("amount", info.amount.number ().convert_to<std::string> ());
-                        pending_tree.put ("source", info.source.to_account ());
-                        peers_l.add_child (key.hash.to_string (), pending_tree);
-                    }
-                    else
+                    writer.value (key.hash.to_string ());
+                    ++written;
+                }
+                else
+                {
+                    germ::pending_info info (i->second);
+                    if (info.amount.number () >= threshold.number ())
                     {
-                        peers_l.put (key.hash.to_string (), info.amount.number ().convert_to<std::string> ());
+                        if (source)
+                        {
+                            writer.begin_object (key.hash.to_string ());
+                            writer.value ("amount", info.amount.number ().convert_to<std::string> ());
+                            writer.value ("source", info.source.to_account ());
+                            writer.end_object ();
+                        }
+                        else
+                        {
+                            writer.value (key.hash.to_string (), info.amount.number ().convert_to<std::string> ());
+                        }
+                        ++written;
                     }
                 }
             }
         }
     }
-    response_l.add_child ("blocks", peers_l);
-    response (response_l);
+    if (hashes_only)
+    {
+        writer.end_array ();
+    }
+    else
+    {
+        writer.end_object ();
+    }
+    writer.end_object ();
+    response_body (writer.output);
 }
 
 void germ::rpc_handler::pending_exists ()
@@ -2383,7 +3109,7 @@ void germ::rpc_handler::pending_exists ()
         return;
     }
 
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::rpc_read_transaction transaction (*this);
     auto block (node.store.block_get (transaction, hash));
     if (block == nullptr)
     {
@@ -2515,7 +3241,7 @@ void germ::rpc_handler::payment_end ()
         return;
     }
 
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     auto existing (node.wallets.items.find (id));
     if (existing == node.wallets.items.end ())
     {
@@ -2587,23 +3313,29 @@ void germ::rpc_handler::payment_wait ()
 
 void germ::rpc_handler::process ()
 {
-    std::string block_text (request.get<std::string> ("block"));
-    boost::property_tree::ptree block_l;
-    std::stringstream block_stream (block_text);
-    boost::property_tree::read_json (block_stream, block_l);
-    std::shared_ptr<germ::tx> block (germ::deserialize_block_json (block_l));
+    std::string block_text (request_field (*document, "block"));
+    auto error (false);
+    germ::json_document block_document (error, block_text);
+    std::shared_ptr<germ::tx> block (error ? nullptr : germ::deserialize_block_json (block_document.root ()));
     if (block == nullptr)
     {
-        error_response (response, "Block is invalid");
+        error_response (response_body, "Block is invalid");
         return;
     }
 
 //    if (!germ::work_validate (*block))
 //    {
-//        error_response (response, "Block work is invalid");
+//        error_response (response_body, "Block work is invalid");
 //        return;
 //    }
 
+    auto process_hash ([this](germ::block_hash const & hash_a) {
+        germ::json_writer writer;
+        writer.begin_object ();
+        writer.value ("hash", hash_a.to_string ());
+        writer.end_object ();
+        response_body (writer.output);
+    });
     auto hash (block->hash ());
     node.block_arrival.add (hash);
     germ::process_return result;
@@ -2615,62 +3347,58 @@ void germ::rpc_handler::process ()
     {
         case germ::process_result::progress:
         {
-            boost::property_tree::ptree response_l;
-            response_l.put ("hash", hash.to_string ());
-            response (response_l);
+            process_hash (hash);
             break;
         }
         case germ::process_result::gap_previous:
         {
-            error_response (response, "Gap previous block");
+            error_response (response_body, "Gap previous block");
             break;
         }
         case germ::process_result::gap_source:
         {
-            error_response (response, "Gap source block");
+            error_response (response_body, "Gap source block");
             break;
         }
         case germ::process_result::old:
         {
-            error_response (response, "Old block");
+            error_response (response_body, "Old block");
             break;
         }
         case germ::process_result::bad_signature:
         {
-            error_response (response, "Bad signature");
+            error_response (response_body, "Bad signature");
             break;
         }
         case germ::process_result::negative_spend:
         {
             // TODO once we get RPC versioning, this should be changed to "negative spend"
-            error_response (response, "Overspend");
+            error_response (response_body, "Overspend");
             break;
         }
         case germ::process_result::unreceivable:
         {
-            error_response (response, "Unreceivable");
+            error_response (response_body, "Unreceivable");
             break;
         }
         case germ::process_result::fork:
         {
-            const bool force = request.get<bool> ("force", false);
+            const bool force = request_flag (*document, "force", false);
             if (force && rpc.config.enable_control)
             {
                 node.active.erase (*block);
                 node.block_processor.force (block);
-                boost::property_tree::ptree response_l;
-                response_l.put ("hash", hash.to_string ());
-                response (response_l);
+                process_hash (hash);
             }
             else
             {
-                error_response (response, "Fork");
+                error_response (response_body, "Fork");
             }
             break;
         }
         default:
         {
-            error_response (response, "Error processing block");
+            error_response (response_body, "Error processing block");
             break;
         }
     }
@@ -2782,7 +3510,7 @@ void germ::rpc_handler::receive ()
         return;
     }
 
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     auto account_check (existing->second->store.find (transaction, account));
     if (account_check == existing->second->store.end ())
     {
@@ -2914,7 +3642,7 @@ void germ::rpc_handler::representatives ()
     const bool sorting = request.get<bool> ("sorting", false);
     boost::property_tree::ptree response_l;
     boost::property_tree::ptree representatives;
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
 //    if (!sorting) // Simple
 //    {
 //        for (auto i (node.store.representation_begin (transaction)), n (node.store.representation_end ()); i != n && representatives.size () < count; ++i)
@@ -3000,7 +3728,7 @@ void germ::rpc_handler::republish ()
 
     boost::property_tree::ptree response_l;
     boost::property_tree::ptree blocks;
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     auto block (node.store.block_get (transaction, hash));
     if (block == nullptr)
     {
@@ -3237,6 +3965,101 @@ void germ::rpc_handler::send ()
                                   work == 0, send_id);
 }
 
+namespace
+{
+char const * send_status_text (germ::send_status status_a)
+{
+    switch (status_a)
+    {
+        case germ::send_status::sent:
+            return "sent";
+        case germ::send_status::duplicate:
+            return "duplicate";
+        case germ::send_status::rejected:
+            return "rejected";
+        case germ::send_status::locked:
+            return "locked";
+        case germ::send_status::not_found:
+            return "not_found";
+        case germ::send_status::insufficient_balance:
+            return "insufficient_balance";
+        case germ::send_status::error:
+            break;
+    }
+    return "error";
+}
+}
+
+void germ::rpc_handler::send_batch ()
+{
+    if (!rpc.config.enable_control)
+    {
+        error_response (response, "RPC control is disabled");
+        return;
+    }
+
+    std::string wallet_text (request.get<std::string> ("wallet"));
+    germ::uint256_union wallet;
+    auto error (wallet.decode_hex (wallet_text));
+    if (error)
+    {
+        error_response (response, "Bad wallet number");
+        return;
+    }
+
+    auto existing (node.wallets.items.find (wallet));
+    if (existing == node.wallets.items.end ())
+    {
+        error_response (response, "Wallet not found");
+        return;
+    }
+
+    std::vector<germ::send_item> items;
+    for (auto & i : request.get_child ("sends"))
+    {
+        germ::send_item item;
+        if (item.source.decode_account (i.second.get<std::string> ("source")))
+        {
+            error_response (response, "Bad source account");
+            return;
+        }
+        if (item.destination.decode_account (i.second.get<std::string> ("destination")))
+        {
+            error_response (response, "Bad destination account");
+            return;
+        }
+        germ::amount amount;
+        if (amount.decode_dec (i.second.get<std::string> ("amount")))
+        {
+            error_response (response, "Bad amount format");
+            return;
+        }
+        item.amount = amount.number ();
+        item.id = i.second.get_optional<std::string> ("id");
+        items.push_back (item);
+    }
+
+    auto response_a (response_body);
+    existing->second->send_batch_async (items, [response_a](std::vector<germ::send_result> const & results_a) {
+        germ::json_writer writer;
+        writer.begin_object ();
+        writer.begin_array ("results");
+        for (auto & i : results_a)
+        {
+            writer.begin_object ();
+            writer.value ("status", send_status_text (i.status));
+            if (i.block != nullptr)
+            {
+                writer.value ("block", i.block->hash ().to_string ());
+            }
+            writer.end_object ();
+        }
+        writer.end_array ();
+        writer.end_object ();
+        response_a (writer.output);
+    });
+}
+
 void germ::rpc_handler::stats ()
 {
     bool error = false;
@@ -3250,6 +4073,79 @@ void germ::rpc_handler::stats ()
     {
         node.stats.log_samples (*sink);
     }
+    else if (type == "lmdb")
+    {
+        auto & environment (node.store.environment);
+        MDB_envinfo info;
+        auto status (mdb_env_info (environment, &info));
+        assert (status == 0);
+        boost::property_tree::ptree response_l;
+        response_l.put ("readers_active", std::to_string (environment.readers_active.load ()));
+        response_l.put ("readers_created", std::to_string (environment.readers_created.load ()));
+        response_l.put ("readers_discarded", std::to_string (environment.readers_discarded.load ()));
+        {
+            std::lock_guard<std::mutex> lock (environment.read_pool_mutex);
+            response_l.put ("readers_pooled", std::to_string (environment.read_pool.size ()));
+        }
+        response_l.put ("reader_slots_used", std::to_string (info.me_numreaders));
+        response_l.put ("reader_slots_max", std::to_string (info.me_maxreaders));
+        response_l.put ("map_size", std::to_string (info.me_mapsize));
+        response (response_l);
+        return;
+    }
+    else if (type == "votes")
+    {
+        boost::property_tree::ptree response_l;
+        response_l.put ("queue", std::to_string (node.vote_processor.size ()));
+        response_l.put ("queue_peak", std::to_string (node.vote_processor.queued_peak.load ()));
+        response_l.put ("queue_max", std::to_string (germ::vote_processor::max_votes));
+        response_l.put ("verified", std::to_string (node.stats.count (germ::stat::type::vote, germ::stat::detail::vote_verified)));
+        response_l.put ("overflow", std::to_string (node.stats.count (germ::stat::type::vote, germ::stat::detail::vote_overflow)));
+        response (response_l);
+        return;
+    }
+    else if (type == "elections")
+    {
+        boost::property_tree::ptree response_l;
+        response_l.put ("active", std::to_string (node.active.size ()));
+        response_l.put ("active_max", std::to_string (node.config.active_elections_size));
+        response_l.put ("started", std::to_string (node.stats.count (germ::stat::type::election, germ::stat::detail::election_start)));
+        response_l.put ("dropped", std::to_string (node.stats.count (germ::stat::type::election, germ::stat::detail::election_drop)));
+        response_l.put ("evicted", std::to_string (node.stats.count (germ::stat::type::election, germ::stat::detail::election_evict)));
+        response_l.put ("confirmed", std::to_string (node.stats.count (germ::stat::type::election, germ::stat::detail::election_confirm)));
+        boost::property_tree::ptree latency_l;
+        auto & latency (node.active.confirmation_latency);
+        for (size_t i (0); i < germ::stat_histogram::bucket_count; ++i)
+        {
+            boost::property_tree::ptree entry;
+            entry.put ("lt_ms", i + 1 < germ::stat_histogram::bucket_count ? std::to_string (germ::stat_histogram::bucket_limit (i)) : "inf");
+            entry.put ("count", std::to_string (latency.buckets[i].load ()));
+            latency_l.push_back (std::make_pair ("", entry));
+        }
+        response_l.add_child ("confirmation_latency", latency_l);
+        response (response_l);
+        return;
+    }
+    else if (type == "rpc")
+    {
+        // Microseconds from a request being handed to the workers to its response, per action
+        boost::property_tree::ptree response_l;
+        boost::property_tree::ptree actions;
+        std::unique_lock<std::mutex> lock (rpc.latency_mutex);
+        for (auto & i : rpc.latencies)
+        {
+            boost::property_tree::ptree action;
+            action.put ("count", std::to_string (i.second->total ()));
+            action.put ("p50", std::to_string (i.second->percentile (0.5)));
+            action.put ("p90", std::to_string (i.second->percentile (0.9)));
+            action.put ("p99", std::to_string (i.second->percentile (0.99)));
+            actions.add_child (i.first, action);
+        }
+        lock.unlock ();
+        response_l.add_child ("actions", actions);
+        response (response_l);
+        return;
+    }
     else
     {
         error = true;
@@ -3278,6 +4174,34 @@ void germ::rpc_handler::stop ()
     }
 }
 
+void germ::rpc_handler::tx_epoch ()
+{
+    std::string hash_text (request.get<std::string> ("hash"));
+    germ::block_hash hash;
+    if (hash.decode_hex (hash_text))
+    {
+        error_response (response, "Bad hash number");
+        return;
+    }
+
+    germ::read_transaction transaction (node.epoch_store.environment);
+    germ::epoch_tx_info info;
+    if (!node.epoch_store.tx_epoch_get (transaction, hash, info))
+    {
+        error_response (response, "Transaction not in any epoch");
+        return;
+    }
+    germ::epoch_height_info height;
+    auto found (node.epoch_store.height_get (transaction, info.epoch, height));
+    assert (found);
+    boost::property_tree::ptree response_l;
+    response_l.put ("epoch", info.epoch.to_string ());
+    response_l.put ("index", std::to_string (info.index));
+    response_l.put ("height", std::to_string (height.height));
+    response_l.put ("timestamp", std::to_string (height.timestamp));
+    response (response_l);
+}
+
 void germ::rpc_handler::unchecked ()
 {
     uint64_t count (std::numeric_limits<uint64_t>::max ());
@@ -3288,21 +4212,40 @@ void germ::rpc_handler::unchecked ()
         if (error)
         {
             error_response (response, "Invalid count limit");
+            return;
         }
     }
-    boost::property_tree::ptree response_l;
-    boost::property_tree::ptree unchecked;
-    germ::transaction transaction (node.store.environment, nullptr, false);
-    for (auto i (node.store.unchecked_begin (transaction)), n (node.store.unchecked_end ()); i != n && unchecked.size () < count; ++i)
+    germ::uint256_union key (0);
+    uint64_t skip (0);
+    if (request_cursor (request, key, skip))
     {
-        germ::bufferstream stream (reinterpret_cast<uint8_t const *> (i->second.data ()), i->second.size ());
+        error_response (response, "Invalid cursor");
+        return;
+    }
+    streamed_response output (*this);
+    auto & writer (output.writer);
+    writer.begin_object ();
+    writer.begin_object ("blocks");
+    table_walk walk (node.store.environment, node.store.unchecked, key, skip);
+    for (uint64_t written (0); !walk.done () && written < count; walk.next (), ++written)
+    {
+        germ::bufferstream stream (reinterpret_cast<uint8_t const *> (walk.value ().data ()), walk.value ().size ());
         auto block (germ::deserialize_block (stream));
         std::string contents;
         block->serialize_json (contents);
-        unchecked.put (block->hash ().to_string (), contents);
+        writer.value (block->hash ().to_string (), contents);
+        if (output.flush (walk))
+        {
+            break;
+        }
     }
-    response_l.add_child ("blocks", unchecked);
-    response (response_l);
+    writer.end_object ();
+    if (!walk.done ())
+    {
+        writer.value ("cursor", walk.cursor ());
+    }
+    writer.end_object ();
+    output.finish ();
 }
 
 void germ::rpc_handler::unchecked_clear ()
@@ -3333,7 +4276,7 @@ void germ::rpc_handler::unchecked_get ()
     }
 
     boost::property_tree::ptree response_l;
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     for (auto i (node.store.unchecked_begin (transaction)), n (node.store.unchecked_end ()); i != n; ++i)
     {
         germ::bufferstream stream (reinterpret_cast<uint8_t const *> (i->second.data ()), i->second.size ());
@@ -3359,6 +4302,7 @@ void germ::rpc_handler::unchecked_keys ()
 {
     uint64_t count (std::numeric_limits<uint64_t>::max ());
     germ::uint256_union key (0);
+    uint64_t skip (0);
     boost::optional<std::string> count_text (request.get_optional<std::string> ("count"));
     if (count_text.is_initialized ())
     {
@@ -3366,6 +4310,7 @@ void germ::rpc_handler::unchecked_keys ()
         if (error)
         {
             error_response (response, "Invalid count limit");
+            return;
         }
     }
     boost::optional<std::string> hash_text (request.get_optional<std::string> ("key"));
@@ -3375,25 +4320,42 @@ void germ::rpc_handler::unchecked_keys ()
         if (error_hash)
         {
             error_response (response, "Bad key hash number");
+            return;
         }
     }
-    boost::property_tree::ptree response_l;
-    boost::property_tree::ptree unchecked;
-    germ::transaction transaction (node.store.environment, nullptr, false);
-    for (auto i (node.store.unchecked_begin (transaction, key)), n (node.store.unchecked_end ()); i != n && unchecked.size () < count; ++i)
+    if (request_cursor (request, key, skip))
     {
-        boost::property_tree::ptree entry;
-        germ::bufferstream stream (reinterpret_cast<uint8_t const *> (i->second.data ()), i->second.size ());
+        error_response (response, "Invalid cursor");
+        return;
+    }
+    streamed_response output (*this);
+    auto & writer (output.writer);
+    writer.begin_object ();
+    writer.begin_array ("unchecked");
+    table_walk walk (node.store.environment, node.store.unchecked, key, skip);
+    for (uint64_t written (0); !walk.done () && written < count; walk.next (), ++written)
+    {
+        germ::bufferstream stream (reinterpret_cast<uint8_t const *> (walk.value ().data ()), walk.value ().size ());
         auto block (germ::deserialize_block (stream));
         std::string contents;
         block->serialize_json (contents);
-        entry.put ("key", germ::block_hash (i->first.uint256 ()).to_string ());
-        entry.put ("hash", block->hash ().to_string ());
-        entry.put ("contents", contents);
-        unchecked.push_back (std::make_pair ("", entry));
+        writer.begin_object ();
+        writer.value ("key", walk.key.to_string ());
+        writer.value ("hash", block->hash ().to_string ());
+        writer.value ("contents", contents);
+        writer.end_object ();
+        if (output.flush (walk))
+        {
+            break;
+        }
     }
-    response_l.add_child ("unchecked", unchecked);
-    response (response_l);
+    writer.end_array ();
+    if (!walk.done ())
+    {
+        writer.value ("cursor", walk.cursor ());
+    }
+    writer.end_object ();
+    output.finish ();
 }
 
 void germ::rpc_handler::version ()
@@ -3531,7 +4493,7 @@ void germ::rpc_handler::wallet_balance_total ()
 
     germ::uint128_t balance (0);
     germ::uint128_t pending (0);
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     for (auto i (existing->second->store.begin (transaction)), n (existing->second->store.end ()); i != n; ++i)
     {
         germ::account account (i->first.uint256 ());
@@ -3574,7 +4536,7 @@ void germ::rpc_handler::wallet_balances ()
 
     boost::property_tree::ptree response_l;
     boost::property_tree::ptree balances;
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     for (auto i (existing->second->store.begin (transaction)), n (existing->second->store.end ()); i != n; ++i)
     {
         germ::account account (i->first.uint256 ());
@@ -3676,7 +4638,7 @@ void germ::rpc_handler::wallet_contains ()
         return;
     }
 
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     auto exists (existing->second->store.find (transaction, account) != existing->second->store.end ());
     boost::property_tree::ptree response_l;
     response_l.put ("exists", exists ? "1" : "0");
@@ -3693,7 +4655,7 @@ void germ::rpc_handler::wallet_create ()
 
     germ::keypair wallet_id;
     node.wallets.create (wallet_id.pub);
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     auto existing (node.wallets.items.find (wallet_id.pub));
     if (existing == node.wallets.items.end ())
     {
@@ -3753,7 +4715,7 @@ void germ::rpc_handler::wallet_export ()
         return;
     }
 
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     std::string json;
     existing->second->store.serialize_json (transaction, json);
     boost::property_tree::ptree response_l;
@@ -3781,7 +4743,7 @@ void germ::rpc_handler::wallet_frontiers ()
 
     boost::property_tree::ptree response_l;
     boost::property_tree::ptree frontiers;
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     for (auto i (existing->second->store.begin (transaction)), n (existing->second->store.end ()); i != n; ++i)
     {
         germ::account account (i->first.uint256 ());
@@ -3813,7 +4775,7 @@ void germ::rpc_handler::wallet_key_valid ()
         return;
     }
 
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     auto valid (existing->second->store.valid_password (transaction));
     boost::property_tree::ptree response_l;
     response_l.put ("valid", valid ? "1" : "0");
@@ -3831,6 +4793,13 @@ void germ::rpc_handler::wallet_ledger ()
     {
         modified_since = strtoul (modified_since_text.get ().c_str (), NULL, 10);
     }
+    uint64_t count (std::numeric_limits<uint64_t>::max ());
+    boost::optional<std::string> count_text (request.get_optional<std::string> ("count"));
+    if (count_text.is_initialized () && decode_unsigned (count_text.get (), count))
+    {
+        error_response (response, "Invalid count limit");
+        return;
+    }
     std::string wallet_text (request.get<std::string> ("wallet"));
     germ::uint256_union wallet;
     auto error (wallet.decode_hex (wallet_text));
@@ -3847,48 +4816,42 @@ void germ::rpc_handler::wallet_ledger ()
         return;
     }
 
-    boost::property_tree::ptree response_l;
-    boost::property_tree::ptree accounts;
-    germ::transaction transaction (node.store.environment, nullptr, false);
-    for (auto i (existing->second->store.begin (transaction)), n (existing->second->store.end ()); i != n; ++i)
+    germ::uint256_union start (germ::wallet_store::special_count);
+    uint64_t skip (0);
+    if (request_cursor (request, start, skip))
     {
-        germ::account account (i->first.uint256 ());
+        error_response (response, "Invalid cursor");
+        return;
+    }
+    streamed_response output (*this);
+    auto & writer (output.writer);
+    writer.begin_object ();
+    writer.begin_object ("accounts");
+    table_walk walk (node.store.environment, existing->second->store.handle, start, skip);
+    for (uint64_t written (0); !walk.done () && written < count; walk.next ())
+    {
+        germ::account account (walk.key);
         germ::account_info info;
-        if (node.store.account_get (transaction, account, info))
+        if (node.store.account_get (walk.transaction (), account, info))
         {
             if (info.modified >= modified_since)
             {
-                boost::property_tree::ptree entry;
-                entry.put ("frontier", info.head.to_string ());
-                entry.put ("open_block", info.open_block.to_string ());
-//                entry.put ("representative_block", info.rep_block.to_string ());
-                std::string balance;
-                germ::uint128_union (info.balance).encode_dec (balance);
-                entry.put ("balance", balance);
-                entry.put ("modified_timestamp", std::to_string (info.modified));
-                entry.put ("block_count", std::to_string (info.block_count));
-//                if (representative)
-//                {
-//                    auto block (node.store.block_get (transaction, info.rep_block));
-//                    assert (block != nullptr);
-//                    entry.put ("representative", block->representative ().to_account ());
-//                }
-                if (weight)
-                {
-                    auto account_weight (node.ledger.weight (transaction, account));
-                    entry.put ("weight", account_weight.convert_to<std::string> ());
-                }
-                if (pending)
+                ledger_entry (writer, node.ledger, walk.transaction (), account, info, weight, pending);
+                ++written;
+                if (output.flush (walk))
                 {
-                    auto account_pending (node.ledger.account_pending (transaction, account));
-                    entry.put ("pending", account_pending.convert_to<std::string> ());
+                    break;
                 }
-                accounts.push_back (std::make_pair (account.to_account (), entry));
             }
         }
     }
-    response_l.add_child ("accounts", accounts);
-    response (response_l);
+    writer.end_object ();
+    if (!walk.done ())
+    {
+        writer.value ("cursor", walk.cursor ());
+    }
+    writer.end_object ();
+    output.finish ();
 }
 
 void germ::rpc_handler::wallet_lock ()
@@ -3916,9 +4879,7 @@ void germ::rpc_handler::wallet_lock ()
     }
 
     boost::property_tree::ptree response_l;
-    germ::raw_key empty;
-    empty.data.clear ();
-    existing->second->store.password.value_set (empty);
+    existing->second->lock ();
     response_l.put ("locked", "1");
     response (response_l);
 }
@@ -3964,36 +4925,40 @@ void germ::rpc_handler::wallet_pending ()
     const bool source = request.get<bool> ("source", false);
     boost::property_tree::ptree response_l;
     boost::property_tree::ptree pending;
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     for (auto i (existing->second->store.begin (transaction)), n (existing->second->store.end ()); i != n; ++i)
     {
         germ::account account (i->first.uint256 ());
         boost::property_tree::ptree peers_l;
         germ::account end (account.number () + 1);
-        for (auto ii (node.store.pending_begin (transaction, germ::pending_key (account, 0))), nn (node.store.pending_begin (transaction, germ::pending_key (end, 0))); ii != nn && peers_l.size () < count; ++ii)
+        auto receivable (node.store.receivable_get (transaction, account));
+        if (receivable.count != 0 && receivable.total.number () >= threshold.number ())
         {
-            germ::pending_key key (ii->first);
-            if (threshold.is_zero () && !source)
-            {
-                boost::property_tree::ptree entry;
-                entry.put ("", key.hash.to_string ());
-                peers_l.push_back (std::make_pair ("", entry));
-            }
-            else
+            for (auto ii (node.store.pending_begin (transaction, germ::pending_key (account, 0))), nn (node.store.pending_begin (transaction, germ::pending_key (end, 0))); ii != nn && peers_l.size () < count; ++ii)
             {
-                germ::pending_info info (ii->second);
-                if (info.amount.number () >= threshold.number ())
+                germ::pending_key key (ii->first);
+                if (threshold.is_zero () && !source)
                 {
-                    if (source)
-                    {
-                        boost::property_tree::ptree pending_tree;
-                        pending_tree.put ("amount", info.amount.number ().convert_to<std::string> ());
-                        pending_tree.put ("source", info.source.to_account ());
-                        peers_l.add_child (key.hash.to_string (), pending_tree);
-                    }
-                    else
+                    boost::property_tree::ptree entry;
+                    entry.put ("", key.hash.to_string ());
+                    peers_l.push_back (std::make_pair ("", entry));
+                }
+                else
+                {
+                    germ::pending_info info (ii->second);
+                    if (info.amount.number () >= threshold.number ())
                     {
-                        peers_l.put (key.hash.to_string (), info.amount.number ().convert_to<std::string> ());
+                        if (source)
+                        {
+                            boost::property_tree::ptree pending_tree;
+                            pending_tree.put ("amount", info.amount.number ().convert_to<std::string> ());
+                            pending_tree.put ("source", info.source.to_account ());
+                            peers_l.add_child (key.hash.to_string (), pending_tree);
+                        }
+                        else
+                        {
+                            peers_l.put (key.hash.to_string (), info.amount.number ().convert_to<std::string> ());
+                        }
                     }
                 }
             }
@@ -4025,7 +4990,7 @@ void germ::rpc_handler::wallet_representative ()
         return;
     }
 
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     boost::property_tree::ptree response_l;
 //    response_l.put ("representative", existing->second->store.representative (transaction).to_account ());
     response_l.put ("representative", "");
@@ -4107,7 +5072,7 @@ void germ::rpc_handler::wallet_republish ()
 
     boost::property_tree::ptree response_l;
     boost::property_tree::ptree blocks;
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     for (auto i (existing->second->store.begin (transaction)), n (existing->second->store.end ()); i != n; ++i)
     {
         germ::account account (i->first.uint256 ());
@@ -4161,7 +5126,7 @@ void germ::rpc_handler::wallet_work_get ()
 
     boost::property_tree::ptree response_l;
     boost::property_tree::ptree works;
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     for (auto i (existing->second->store.begin (transaction)), n (existing->second->store.end ()); i != n; ++i)
     {
         germ::account account (i->first.uint256 ());
@@ -4269,7 +5234,7 @@ void germ::rpc_handler::work_get ()
         return;
     }
 
-    germ::transaction transaction (node.store.environment, nullptr, false);
+    germ::read_transaction transaction (node.store.environment);
     auto account_check (existing->second->store.find (transaction, account));
     if (account_check == existing->second->store.end ())
     {
@@ -4426,7 +5391,12 @@ void germ::rpc_handler::work_peers_clear ()
 germ::rpc_connection::rpc_connection (germ::node & node_a, germ::rpc & rpc_a) :
 node (node_a.shared ()),
 rpc (rpc_a),
-socket (node_a.service)
+socket (node_a.service),
+strand (node_a.service),
+idle_timer (node_a.service),
+reading (false),
+writing (false),
+finished (false)
 {
     responded.clear ();
 }
@@ -4456,45 +5426,242 @@ void germ::rpc_connection::write_result (std::string body, unsigned version)
     }
 }
 
+void germ::rpc_connection::close ()
+{
+    auto this_l (shared_from_this ());
+    strand.dispatch ([this_l]() {
+        this_l->finished = true;
+        boost::system::error_code ec;
+        this_l->idle_timer.cancel (ec);
+        this_l->socket.shutdown (boost::asio::ip::tcp::socket::shutdown_both, ec);
+        this_l->socket.close (ec);
+    });
+}
+
+void germ::rpc_connection::idle ()
+{
+    // Slow actions and responses still being written are not idleness, the timer only runs while waiting on the client
+    if (reading && responses.empty ())
+    {
+        auto this_l (shared_from_this ());
+        idle_timer.expires_from_now (rpc.config.idle_timeout);
+        idle_timer.async_wait (strand.wrap ([this_l](boost::system::error_code const & ec) {
+            // A wait that completed just before being re-armed still reports success, so check the deadline itself
+            if (!ec && this_l->reading && this_l->responses.empty () && this_l->idle_timer.expires_at () <= std::chrono::steady_clock::now ())
+            {
+                this_l->socket.close ();
+            }
+        }));
+    }
+}
+
 void germ::rpc_connection::read ()
 {
     auto this_l (shared_from_this ());
-    boost::beast::http::async_read (socket, buffer, request, [this_l](boost::system::error_code const & ec, size_t bytes_transferred) {
+    auto request_l (std::make_shared<boost::beast::http::request<boost::beast::http::string_body>> ());
+    reading = true;
+    idle ();
+    boost::beast::http::async_read (socket, buffer, *request_l, strand.wrap ([this_l, request_l](boost::system::error_code const & ec, size_t bytes_transferred) {
+        this_l->reading = false;
+        this_l->idle_timer.cancel ();
         if (ec)
         {
-            BOOST_LOG (this_l->node->log) << "RPC read error: " << ec.message ();
+            // The client closing or the idle timer firing is the normal end of a keep-alive connection
+            if (ec != boost::beast::http::error::end_of_stream && ec != boost::asio::error::operation_aborted)
+            {
+                BOOST_LOG (this_l->node->log) << "RPC read error: " << ec.message ();
+            }
+            this_l->finished = true;
             return;
         }
+        auto pending (std::make_shared<germ::rpc_connection::pipelined> ());
+        pending->keep_alive = request_l->keep_alive ();
+        this_l->finished = !pending->keep_alive;
+        this_l->responses.push_back (pending);
+        // Lets the response stream if it's the only one outstanding
+        this_l->write_next ();
+        this_l->rpc.background ([this_l, request_l, pending]() {
+            this_l->handle (request_l, pending);
+        });
+        // Read ahead while the pipeline has room, otherwise reading resumes as responses are written
+        if (!this_l->finished && this_l->responses.size () < this_l->rpc.config.max_pipelined)
+        {
+            this_l->read ();
+        }
+    }));
+}
 
-        this_l->node->background ([this_l]() {
-            auto start (std::chrono::steady_clock::now ());
-            auto version (this_l->request.version ());
-            auto response_handler ([this_l, version, start](boost::property_tree::ptree const & tree_a) {
-
-                std::stringstream ostream;
-                boost::property_tree::write_json (ostream, tree_a);
-                ostream.flush ();
-                auto body (ostream.str ());
-                this_l->write_result (body, version);
-                boost::beast::http::async_write (this_l->socket, this_l->res, [this_l](boost::system::error_code const & ec, size_t bytes_transferred) {
+void germ::rpc_connection::handle (std::shared_ptr<boost::beast::http::request<boost::beast::http::string_body>> request_a, std::shared_ptr<germ::rpc_connection::pipelined> pending_a)
+{
+    auto this_l (shared_from_this ());
+    auto start (std::chrono::steady_clock::now ());
+    auto version (request_a->version ());
+    if (version >= 11)
+    {
+        std::weak_ptr<germ::rpc_connection> this_w (this_l);
+        pending_a->stream = std::make_shared<germ::rpc_stream> (germ::rpc_stream::send_timeout, [this_w]() {
+            auto this_l (this_w.lock ());
+            if (this_l != nullptr)
+            {
+                this_l->strand.post ([this_l]() {
+                    this_l->write_next ();
                 });
-
-                if (this_l->node->config.logging.log_rpc ())
-                {
-                    BOOST_LOG (this_l->node->log) << boost::str (boost::format ("RPC request %2% completed in: %1% microseconds") % std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - start).count () % boost::io::group (std::hex, std::showbase, reinterpret_cast<uintptr_t> (this_l.get ())));
-                }
-            });
-            if (this_l->request.method () == boost::beast::http::verb::post)
+            }
+        });
+    }
+    auto response_handler ([this_l, pending_a, version, start](std::string const & body_a) {
+        auto response (std::make_shared<boost::beast::http::response<boost::beast::http::string_body>> ());
+        response->set ("Content-Type", "application/json");
+        response->set ("Access-Control-Allow-Origin", "*");
+        response->set ("Access-Control-Allow-Headers", "Accept, Accept-Language, Content-Language, Content-Type");
+        response->result (boost::beast::http::status::ok);
+        response->version (version);
+        response->keep_alive (pending_a->keep_alive);
+        response->body () = body_a;
+        response->prepare_payload ();
+        this_l->strand.post ([this_l, pending_a, response]() {
+            assert (pending_a->response == nullptr && "RPC already responded and should only respond once");
+            if (pending_a->stream != nullptr && pending_a->stream->started ())
             {
-                auto handler (std::make_shared<germ::rpc_handler> (*this_l->node, this_l->rpc, this_l->request.body (), response_handler));
-                handler->process_request ();
+                // The action failed part way through streaming, closing the connection tells the client the body is incomplete
+                pending_a->stream->fail ();
             }
             else
             {
-                error_response (response_handler, "Can only POST requests");
+                pending_a->response = response;
             }
+            this_l->write_next ();
         });
+
+        if (this_l->node->config.logging.log_rpc ())
+        {
+            BOOST_LOG (this_l->node->log) << boost::str (boost::format ("RPC request %2% completed in: %1% microseconds") % std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - start).count () % boost::io::group (std::hex, std::showbase, reinterpret_cast<uintptr_t> (this_l.get ())));
+        }
     });
+    if (request_a->method () == boost::beast::http::verb::post)
+    {
+        auto handler (std::make_shared<germ::rpc_handler> (*node, rpc, request_a->body (), response_handler));
+        handler->stream = pending_a->stream;
+        handler->process_request ();
+    }
+    else
+    {
+        error_response (response_handler, "Can only POST requests");
+    }
+}
+
+void germ::rpc_connection::write_next ()
+{
+    if (!writing && !responses.empty ())
+    {
+        auto this_l (shared_from_this ());
+        auto pending (responses.front ());
+        if (pending->stream != nullptr)
+        {
+            pending->stream->activate ();
+        }
+        if (pending->response != nullptr)
+        {
+            writing = true;
+            boost::beast::http::async_write (socket, *pending->response, strand.wrap ([this_l, pending](boost::system::error_code const & ec, size_t bytes_transferred) {
+                this_l->written (pending, ec);
+            }));
+        }
+        else if (pending->stream != nullptr && pending->stream->started ())
+        {
+            write_stream (pending);
+        }
+    }
+}
+
+void germ::rpc_connection::write_stream (std::shared_ptr<germ::rpc_connection::pipelined> pending_a)
+{
+    auto this_l (shared_from_this ());
+    if (pending_a->header == nullptr)
+    {
+        pending_a->header = std::make_shared<boost::beast::http::response<boost::beast::http::empty_body>> ();
+        auto & header (*pending_a->header);
+        header.set ("Content-Type", "application/json");
+        header.set ("Access-Control-Allow-Origin", "*");
+        header.set ("Access-Control-Allow-Headers", "Accept, Accept-Language, Content-Language, Content-Type");
+        header.result (boost::beast::http::status::ok);
+        header.version (11);
+        header.keep_alive (pending_a->keep_alive);
+        header.chunked (true);
+        pending_a->serializer = std::make_shared<boost::beast::http::response_serializer<boost::beast::http::empty_body>> (header);
+        writing = true;
+        boost::beast::http::async_write_header (socket, *pending_a->serializer, strand.wrap ([this_l, pending_a](boost::system::error_code const & ec, size_t bytes_transferred) {
+            this_l->writing = false;
+            if (!ec)
+            {
+                this_l->write_next ();
+            }
+            else
+            {
+                this_l->written (pending_a, ec);
+            }
+        }));
+    }
+    else
+    {
+        auto chunk (std::make_shared<std::string> ());
+        auto complete (false);
+        if (pending_a->stream->take (*chunk, complete))
+        {
+            // Ending the body normally would make a truncated response look complete
+            written (pending_a, boost::asio::error::operation_aborted);
+        }
+        else if (!chunk->empty ())
+        {
+            writing = true;
+            boost::asio::async_write (socket, boost::beast::http::make_chunk (boost::asio::buffer (*chunk)), strand.wrap ([this_l, pending_a, chunk](boost::system::error_code const & ec, size_t bytes_transferred) {
+                this_l->writing = false;
+                if (!ec)
+                {
+                    this_l->write_next ();
+                }
+                else
+                {
+                    this_l->written (pending_a, ec);
+                }
+            }));
+        }
+        else if (complete)
+        {
+            writing = true;
+            boost::asio::async_write (socket, boost::beast::http::make_chunk_last (), strand.wrap ([this_l, pending_a](boost::system::error_code const & ec, size_t bytes_transferred) {
+                this_l->written (pending_a, ec);
+            }));
+        }
+    }
+}
+
+void germ::rpc_connection::written (std::shared_ptr<germ::rpc_connection::pipelined> pending_a, boost::system::error_code const & ec)
+{
+    writing = false;
+    responses.pop_front ();
+    if (ec || !pending_a->keep_alive)
+    {
+        if (ec && pending_a->stream != nullptr)
+        {
+            pending_a->stream->fail ();
+        }
+        finished = true;
+        boost::system::error_code ignored;
+        socket.shutdown (boost::asio::ip::tcp::socket::shutdown_send, ignored);
+        return;
+    }
+    // Resume reading once backpressure eases
+    if (!reading && !finished && responses.size () < rpc.config.max_pipelined)
+    {
+        read ();
+    }
+    else
+    {
+        // A read ahead that was left waiting behind outstanding responses starts timing out once they are all written
+        idle ();
+    }
+    write_next ();
 }
 
 namespace
@@ -4511,9 +5678,35 @@ void germ::rpc_handler::process_request ()
 {
     try
     {
-        std::stringstream istream (body);
-        boost::property_tree::read_json (istream, request);
-        std::string action (request.get<std::string> ("action"));
+        auto error (false);
+        document = std::make_unique<germ::json_document> (error, body);
+        std::string action;
+        if (error || !document->root ().get ("action", action))
+        {
+            error_response (response, "Unable to parse JSON");
+            return;
+        }
+        auto & latency_l (rpc.latency (action));
+        latency = &latency_l;
+        auto start_l (start);
+        auto response_body_l (response_body);
+        response_body = [&latency_l, start_l, response_body_l](std::string const & body_a) {
+            latency_l.add (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - start_l).count ());
+            response_body_l (body_a);
+        };
+        response = tree_response (response_body);
+        // Hot actions read document and write their response with json_writer, the rest still go through property_tree
+        auto direct (action == "account_balance" || action == "account_info" || action == "accounts_balances" || action == "batch" || action == "blocks_info" || action == "pending" || action == "process");
+        if (batched && !batchable (action))
+        {
+            error_response (response_body, "Action not available in batch");
+            return;
+        }
+        if (!direct)
+        {
+            std::stringstream istream (body);
+            boost::property_tree::read_json (istream, request);
+        }
         if (action == "password_enter")
         {
             password_enter ();
@@ -4612,6 +5805,10 @@ void germ::rpc_handler::process_request ()
         {
             available_supply ();
         }
+        else if (action == "batch")
+        {
+            batch ();
+        }
         else if (action == "block")
         {
             block ();
@@ -4680,6 +5877,18 @@ void germ::rpc_handler::process_request ()
         {
             confirmation_history ();
         }
+        else if (action == "confirmation_latency")
+        {
+            confirmation_latency ();
+        }
+        else if (action == "epoch_proof")
+        {
+            epoch_proof ();
+        }
+        else if (action == "epochs_range")
+        {
+            epochs_range ();
+        }
         else if (action == "frontiers")
         {
             frontiers ();
@@ -4813,6 +6022,10 @@ void germ::rpc_handler::process_request ()
         {
             send ();
         }
+        else if (action == "send_batch")
+        {
+            send_batch ();
+        }
         else if (action == "stats")
         {
             stats ();
@@ -4821,6 +6034,10 @@ void germ::rpc_handler::process_request ()
         {
             stop ();
         }
+        else if (action == "tx_epoch")
+        {
+            tx_epoch ();
+        }
         else if (action == "unchecked")
         {
             unchecked ();
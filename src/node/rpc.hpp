@@ -5,13 +5,20 @@
 #include <boost/beast.hpp>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <src/lib/json.hpp>
+#include <src/node/stats.hpp>
 #include <src/node/utility.hpp>
 #include <unordered_map>
 
 namespace germ
 {
 void error_response (std::function<void(boost::property_tree::ptree const &)> response_a, std::string const & message_a);
+void error_response (std::function<void(std::string const &)> response_a, std::string const & message_a);
 class node;
+class thread_runner;
 /** Configuration options for RPC TLS */
 class rpc_secure_config
 {
@@ -47,6 +54,12 @@ public:
     bool enable_control;
     uint64_t frontier_request_limit;
     uint64_t chain_request_limit;
+    /** Threads handling requests, separate from the node's I/O threads */
+    unsigned worker_threads;
+    /** Requests read ahead on a connection before reading pauses until responses are written */
+    unsigned max_pipelined;
+    /** Idle keep-alive connections are closed after this long */
+    std::chrono::seconds idle_timeout;
     rpc_secure_config secure;
 };
 enum class payment_status
@@ -61,15 +74,66 @@ enum class payment_status
 };
 class wallet;
 class payment_observer;
+/**
+ * Body of a response sent with chunked transfer encoding while the action is still producing it.
+ * Writers block while too much is queued, so a slow client holds back iteration rather than growing node memory.
+ */
+class rpc_stream
+{
+public:
+    rpc_stream (std::chrono::steady_clock::duration, std::function<void()> const &);
+    // Queues part of the body, returns true if the client went away or stopped reading for longer than the timeout
+    bool write (std::string const &);
+    // Connection side, called once the response is first in line to be written
+    void activate ();
+    // True once the response is first in line, until then the action keeps its output buffered so it never waits behind earlier responses
+    bool writable ();
+    void finish ();
+    // Connection side, moves out everything queued and sets whether the body is complete. Returns true if the stream failed
+    bool take (std::string &, bool &);
+    void fail ();
+    bool started ();
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::string queued;
+    bool begun;
+    bool finished;
+    bool failed;
+    bool active;
+    std::chrono::steady_clock::duration timeout;
+    // Wakes the connection when there is something to write
+    std::function<void()> notify;
+    static size_t constexpr queued_max = 1024 * 1024;
+    // Longest a write waits for the client to drain queued output, kept short as the action holds an RPC worker meanwhile
+    static std::chrono::seconds constexpr send_timeout = std::chrono::seconds (5);
+};
+class rpc_connection;
 class rpc
 {
 public:
     rpc (boost::asio::io_service &, germ::node &, germ::rpc_config const &);
+    virtual ~rpc ();
     void start ();
     virtual void accept ();
     void stop ();
     void observer_action (germ::account const &);
+    template <typename T>
+    void background (T action_a)
+    {
+        worker_service.post (action_a);
+    }
+    // Latency histogram of an action in microseconds
+    germ::stat_histogram & latency (std::string const &);
     boost::asio::ip::tcp::acceptor acceptor;
+    boost::asio::io_service worker_service;
+    std::unique_ptr<boost::asio::io_service::work> worker_work;
+    std::unique_ptr<germ::thread_runner> workers;
+    std::mutex connections_mutex;
+    std::vector<std::weak_ptr<germ::rpc_connection>> connections;
+    std::mutex latency_mutex;
+    std::map<std::string, std::unique_ptr<germ::stat_histogram>> latencies;
+    // Distinct actions tracked before the rest share one histogram, actions come from untrusted input
+    static size_t constexpr max_latency_actions = 256;
     std::mutex mutex;
     std::unordered_map<germ::account, std::shared_ptr<germ::payment_observer>> payment_observers;
     germ::rpc_config config;
@@ -77,6 +141,10 @@ public:
     bool on;
     static uint16_t const rpc_port = germ::rai_network == germ::germ_networks::germ_live_network ? 7076 : 55000;
 };
+/**
+ * A plain connection is kept alive between requests and requests may be pipelined, each is handled on the RPC workers
+ * and responses are written back in request order. Socket work and the response queue are serialized by a strand.
+ */
 class rpc_connection : public std::enable_shared_from_this<germ::rpc_connection>
 {
 public:
@@ -84,6 +152,7 @@ public:
     virtual void parse_connection ();
     virtual void read ();
     virtual void write_result (std::string body, unsigned version);
+    void close ();
     std::shared_ptr<germ::node> node;
     germ::rpc & rpc;
     boost::asio::ip::tcp::socket socket;
@@ -91,6 +160,31 @@ public:
     boost::beast::http::request<boost::beast::http::string_body> request;
     boost::beast::http::response<boost::beast::http::string_body> res;
     std::atomic_flag responded;
+
+private:
+    class pipelined
+    {
+    public:
+        bool keep_alive;
+        // Null until the request has been handled
+        std::shared_ptr<boost::beast::http::response<boost::beast::http::string_body>> response;
+        // Set for HTTP/1.1 requests, used instead of response if the action starts streaming
+        std::shared_ptr<germ::rpc_stream> stream;
+        std::shared_ptr<boost::beast::http::response<boost::beast::http::empty_body>> header;
+        std::shared_ptr<boost::beast::http::response_serializer<boost::beast::http::empty_body>> serializer;
+    };
+    void handle (std::shared_ptr<boost::beast::http::request<boost::beast::http::string_body>>, std::shared_ptr<germ::rpc_connection::pipelined>);
+    void idle ();
+    void write_next ();
+    void write_stream (std::shared_ptr<germ::rpc_connection::pipelined>);
+    void written (std::shared_ptr<germ::rpc_connection::pipelined>, boost::system::error_code const &);
+    boost::asio::io_service::strand strand;
+    boost::asio::steady_timer idle_timer;
+    std::deque<std::shared_ptr<germ::rpc_connection::pipelined>> responses;
+    bool reading;
+    bool writing;
+    // Set once no more requests will be read, after a request without keep-alive or a read error
+    bool finished;
 };
 class payment_observer : public std::enable_shared_from_this<germ::payment_observer>
 {
@@ -112,7 +206,7 @@ public:
 class rpc_handler : public std::enable_shared_from_this<germ::rpc_handler>
 {
 public:
-    rpc_handler (germ::node &, germ::rpc &, std::string const &, std::function<void(boost::property_tree::ptree const &)> const &);
+    rpc_handler (germ::node &, germ::rpc &, std::string const &, std::function<void(std::string const &)> const &);
     void process_request ();
     void account_balance ();
     void account_block_count ();
@@ -133,6 +227,7 @@ public:
     void accounts_frontiers ();
     void accounts_pending ();
     void available_supply ();
+    void batch ();
     void block ();
     void block_confirm ();
     void blocks ();
@@ -146,9 +241,12 @@ public:
     void bootstrap_any ();
     void chain ();
     void confirmation_history ();
+    void confirmation_latency ();
     void delegators ();
     void delegators_count ();
     void deterministic_key ();
+    void epoch_proof ();
+    void epochs_range ();
     void frontiers ();
     void history ();
     void keepalive ();
@@ -181,9 +279,11 @@ public:
     void search_pending ();
     void search_pending_all ();
     void send ();
+    void send_batch ();
     void stats ();
     void stop ();
     void successors ();
+    void tx_epoch ();
     void unchecked ();
     void unchecked_clear ();
     void unchecked_get ();
@@ -220,7 +320,40 @@ public:
     germ::node & node;
     germ::rpc & rpc;
     boost::property_tree::ptree request;
+    // Parsed in place over body, actions which write their response with json_writer read from it and request stays empty
+    std::unique_ptr<germ::json_document> document;
     std::function<void(boost::property_tree::ptree const &)> response;
+    std::function<void(std::string const &)> response_body;
+    // Set when the connection can take a chunked response, ledger-wide actions write through it as they iterate
+    std::shared_ptr<germ::rpc_stream> stream;
+    std::chrono::steady_clock::time_point start;
+    // Set for items of a batch, only read-only actions answering synchronously are run
+    bool batched;
+    // Read transaction shared by the items of a batch, nullptr otherwise
+    MDB_txn * snapshot;
+    // Histogram of the action once it's been parsed
+    germ::stat_histogram * latency;
+    // Requests accepted by one batch action
+    static size_t constexpr batch_max = 16 * 1024;
+    // Items per worker below which a batch isn't split further
+    static size_t constexpr batch_chunk = 64;
+    // Times a batch begins a read transaction per chunk looking for them all on the same commit before it runs as one chunk
+    static unsigned constexpr batch_snapshot_attempts = 4;
+    // Output built up before a streaming action hands it to the connection
+    static size_t constexpr stream_chunk = 64 * 1024;
+    // Ledger-wide walks swap their read transaction for a new one once it's this old so LMDB can reuse freed pages
+    static std::chrono::milliseconds constexpr read_age_max = std::chrono::milliseconds (500);
+};
+/**
+ * Read transaction of an RPC action, the batch snapshot when the action is part of one, otherwise one from the pool
+ */
+class rpc_read_transaction
+{
+public:
+    rpc_read_transaction (germ::rpc_handler const &);
+    operator MDB_txn * () const;
+    std::unique_ptr<germ::read_transaction> owned;
+    MDB_txn * handle;
 };
 /** Returns the correct RPC implementation based on TLS configuration */
 std::unique_ptr<germ::rpc> get_rpc (boost::asio::io_service & service_a, germ::node & node_a, germ::rpc_config const & config_a);
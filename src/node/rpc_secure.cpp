@@ -153,15 +153,11 @@ void germ::rpc_connection_secure::read ()
             return;
         }
 
-        this_l->node->background ([this_l]() {
+        this_l->rpc.background ([this_l]() {
             auto start (std::chrono::steady_clock::now ());
             auto version (this_l->request.version ());
-            auto response_handler ([this_l, version, start](boost::property_tree::ptree const & tree_a) {
-                std::stringstream ostream;
-                boost::property_tree::write_json (ostream, tree_a);
-                ostream.flush ();
-                auto body (ostream.str ());
-                this_l->write_result (body, version);
+            auto response_handler ([this_l, version, start](std::string const & body_a) {
+                this_l->write_result (body_a, version);
                 boost::beast::http::async_write (this_l->stream, this_l->res, [this_l](boost::system::error_code const & ec, size_t bytes_transferred) {
 
                     // Perform the SSL shutdown
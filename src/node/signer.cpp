@@ -0,0 +1,241 @@
+#include <src/node/signer.hpp>
+
+#include <src/node/working.hpp>
+
+#include <atomic>
+
+size_t constexpr germ::signer_cache::page_keys;
+size_t constexpr germ::signer_pool::chunk_size;
+
+germ::signer_cache::signer_cache () :
+keys (nullptr),
+capacity (0)
+{
+}
+
+germ::signer_cache::~signer_cache ()
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    wipe ();
+    if (keys != nullptr)
+    {
+        germ::locked_free (keys, capacity * sizeof (germ::uint256_union));
+    }
+}
+
+bool germ::signer_cache::find (germ::account const & account_a, germ::raw_key & prv_a)
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    auto existing (slots.find (account_a));
+    auto result (existing != slots.end ());
+    if (result)
+    {
+        prv_a.data = keys[existing->second];
+    }
+    return result;
+}
+
+bool germ::signer_cache::insert (germ::account const & account_a, germ::raw_key const & prv_a)
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    auto result (false);
+    auto existing (slots.find (account_a));
+    if (existing != slots.end ())
+    {
+        keys[existing->second] = prv_a.data;
+    }
+    else
+    {
+        if (slots.size () == capacity)
+        {
+            // Keys move to a new locked buffer twice the size and the old one is wiped before it's released
+            auto capacity_l (capacity == 0 ? page_keys : capacity * 2);
+            auto keys_l (static_cast<germ::uint256_union *> (germ::locked_alloc (capacity_l * sizeof (germ::uint256_union))));
+            if (keys_l != nullptr)
+            {
+                if (keys != nullptr)
+                {
+                    std::copy (keys, keys + capacity, keys_l);
+                    wipe ();
+                    germ::locked_free (keys, capacity * sizeof (germ::uint256_union));
+                }
+                keys = keys_l;
+                capacity = capacity_l;
+            }
+            else
+            {
+                // The keys already held stay usable, this one is decrypted again each time it's needed
+                result = true;
+            }
+        }
+        if (!result)
+        {
+            auto slot (slots.size ());
+            keys[slot] = prv_a.data;
+            slots[account_a] = slot;
+        }
+    }
+    return result;
+}
+
+void germ::signer_cache::sign (germ::signer_pool & pool_a, std::vector<std::shared_ptr<germ::vote>> const & votes_a, std::vector<uint8_t> & signed_a)
+{
+    assert (votes_a.size () == signed_a.size ());
+    // Held for the whole batch so the slots can't be wiped or moved while they're read
+    std::lock_guard<std::mutex> lock (mutex);
+    std::vector<std::shared_ptr<germ::vote>> votes;
+    std::vector<germ::uint256_union const *> keys_l;
+    for (size_t i (0), n (votes_a.size ()); i < n; ++i)
+    {
+        if (!signed_a[i])
+        {
+            auto existing (slots.find (votes_a[i]->account));
+            if (existing != slots.end ())
+            {
+                votes.push_back (votes_a[i]);
+                keys_l.push_back (keys + existing->second);
+                signed_a[i] = 1;
+            }
+        }
+    }
+    if (!votes.empty ())
+    {
+        pool_a.sign (votes, keys_l);
+    }
+}
+
+void germ::signer_cache::clear ()
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    wipe ();
+    slots.clear ();
+}
+
+size_t germ::signer_cache::size ()
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    return slots.size ();
+}
+
+void germ::signer_cache::wipe ()
+{
+    for (size_t i (0); i < capacity; ++i)
+    {
+        keys[i].clear ();
+    }
+}
+
+germ::signer_pool::signer_pool (germ::stat & stats_a, unsigned threads_a) :
+stats (stats_a),
+stopped (false)
+{
+    for (auto i (0u); i < threads_a; ++i)
+    {
+        threads.push_back (std::thread ([this]() { run (); }));
+    }
+}
+
+germ::signer_pool::~signer_pool ()
+{
+    stop ();
+}
+
+void germ::signer_pool::sign (std::vector<std::shared_ptr<germ::vote>> const & votes_a, std::vector<germ::uint256_union const *> const & keys_a)
+{
+    assert (votes_a.size () == keys_a.size ());
+    auto size (votes_a.size ());
+    parallel ((size + chunk_size - 1) / chunk_size, [&votes_a, &keys_a, size](size_t chunk_a) {
+        auto end (std::min (size, (chunk_a + 1) * chunk_size));
+        // A key is copied onto the stack only while it's used and is wiped as it goes out of scope
+        germ::raw_key prv;
+        for (auto i (chunk_a * chunk_size); i < end; ++i)
+        {
+            auto & vote (*votes_a[i]);
+            prv.data = *keys_a[i];
+            vote.signature = germ::sign_message (prv, vote.account, vote.hash ());
+        }
+    });
+    stats.add (germ::stat::type::vote, germ::stat::detail::vote_signed, germ::stat::dir::out, size);
+    stats.inc (germ::stat::type::vote, germ::stat::detail::vote_sign_batch, germ::stat::dir::out);
+}
+
+void germ::signer_pool::parallel (size_t chunks_a, std::function<void (size_t)> const & action_a)
+{
+    if (chunks_a > 1 && !threads.empty ())
+    {
+        // Chunks are claimed from a shared counter so the caller keeps working while it waits
+        std::atomic<size_t> next (0);
+        size_t finished (0);
+        std::mutex finished_mutex;
+        std::condition_variable finished_condition;
+        auto claim ([&next, &action_a, chunks_a]() {
+            for (auto chunk (next++); chunk < chunks_a; chunk = next++)
+            {
+                action_a (chunk);
+            }
+        });
+        size_t helpers (0);
+        {
+            std::lock_guard<std::mutex> lock (mutex);
+            // Queued tasks always run, the threads drain them before exiting
+            helpers = stopped ? 0 : std::min (threads.size (), chunks_a - 1);
+            for (size_t i (0); i < helpers; ++i)
+            {
+                tasks.push_back ([&claim, &finished, &finished_mutex, &finished_condition]() {
+                    claim ();
+                    std::lock_guard<std::mutex> lock (finished_mutex);
+                    ++finished;
+                    finished_condition.notify_all ();
+                });
+            }
+        }
+        condition.notify_all ();
+        claim ();
+        // Helpers hold references into this frame until they finish
+        std::unique_lock<std::mutex> lock (finished_mutex);
+        finished_condition.wait (lock, [&finished, helpers]() { return finished == helpers; });
+    }
+    else
+    {
+        for (size_t i (0); i < chunks_a; ++i)
+        {
+            action_a (i);
+        }
+    }
+}
+
+void germ::signer_pool::stop ()
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+        stopped = true;
+    }
+    condition.notify_all ();
+    for (auto & i : threads)
+    {
+        if (i.joinable ())
+        {
+            i.join ();
+        }
+    }
+}
+
+void germ::signer_pool::run ()
+{
+    std::unique_lock<std::mutex> lock (mutex);
+    while (!stopped || !tasks.empty ())
+    {
+        if (!tasks.empty ())
+        {
+            auto task (std::move (tasks.front ()));
+            tasks.pop_front ();
+            lock.unlock ();
+            task ();
+            lock.lock ();
+        }
+        else
+        {
+            condition.wait (lock);
+        }
+    }
+}
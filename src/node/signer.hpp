@@ -0,0 +1,69 @@
+#pragma once
+
+#include <src/common.hpp>
+#include <src/node/stats.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace germ
+{
+class signer_pool;
+/**
+ * Decrypted private keys of the representatives in an unlocked wallet, so a vote doesn't decrypt its key every time.
+ * Keys are held in whole pages locked against swapping and are wiped when the wallet is locked or the cache is destroyed.
+ */
+class signer_cache
+{
+public:
+    signer_cache ();
+    ~signer_cache ();
+    // Copies out the key for an account, returns true if it's held
+    bool find (germ::account const &, germ::raw_key &);
+    // Returns true if the key couldn't be held because no more locked pages could be allocated
+    bool insert (germ::account const &, germ::raw_key const &);
+    // Signs the votes whose keys are held straight from their slots and sets their flags, votes already flagged are skipped
+    void sign (germ::signer_pool &, std::vector<std::shared_ptr<germ::vote>> const &, std::vector<uint8_t> &);
+    // Wipes every key
+    void clear ();
+    size_t size ();
+    static size_t constexpr page_keys = 4096 / sizeof (germ::uint256_union);
+
+private:
+    void wipe ();
+    std::mutex mutex;
+    std::unordered_map<germ::account, size_t> slots;
+    germ::uint256_union * keys;
+    size_t capacity;
+};
+/**
+ * Signs and verifies batches on dedicated threads.
+ * Small batches are handled by the caller, larger ones are split into chunks shared between the caller and the threads.
+ */
+class signer_pool
+{
+public:
+    signer_pool (germ::stat &, unsigned);
+    ~signer_pool ();
+    // Signs each vote with the key at the same position, the keys mustn't move or change until it returns
+    void sign (std::vector<std::shared_ptr<germ::vote>> const &, std::vector<germ::uint256_union const *> const &);
+    // Calls the action with every chunk index below the count and returns once all have run, the caller takes chunks too
+    void parallel (size_t, std::function<void (size_t)> const &);
+    void stop ();
+    germ::stat & stats;
+    // Votes signed by one thread at a time, batches this size or smaller aren't handed off
+    static size_t constexpr chunk_size = 8;
+
+private:
+    void run ();
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::function<void()>> tasks;
+    bool stopped;
+    std::vector<std::thread> threads;
+};
+}
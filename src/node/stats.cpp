@@ -1,6 +1,7 @@
 #include <boost/asio.hpp>
 #include <boost/format.hpp>
 #include <boost/property_tree/json_parser.hpp>
+#include <cassert>
 #include <ctime>
 #include <fstream>
 #include <iostream>
@@ -8,6 +9,140 @@
 #include <sstream>
 #include <tuple>
 
+size_t constexpr germ::stat_histogram::bucket_count;
+size_t constexpr germ::block_tracer::stage_count;
+size_t constexpr germ::block_tracer::slot_count;
+uint64_t constexpr germ::block_tracer::slot_claiming;
+size_t constexpr germ::stat::type_count;
+size_t constexpr germ::stat::detail_count;
+size_t constexpr germ::stat::dir_count;
+size_t constexpr germ::stat::key_count;
+size_t constexpr germ::stat::stripe_stride;
+
+germ::block_tracer::block_tracer (size_t sample_interval_a, std::string const & filename_a) :
+traced (0),
+slots (new slot[slot_count]),
+start (std::chrono::steady_clock::now ()),
+sample_interval (sample_interval_a)
+{
+    for (size_t i (0); i < slot_count; ++i)
+    {
+        slots[i].tag = 0;
+        for (auto & j : slots[i].stamps)
+        {
+            j = 0;
+        }
+    }
+    if (sample_interval > 0 && !filename_a.empty ())
+    {
+        trace_log.open (filename_a, std::ofstream::out | std::ofstream::app);
+    }
+}
+
+void germ::block_tracer::add (germ::block_hash const & hash_a, germ::block_stage stage_a)
+{
+    assert (stage_a < germ::block_stage::count);
+    // Tags are odd, zero marks a free slot and slot_claiming one being reset
+    auto tag (hash_a.qwords[0] | 1);
+    auto & slot_l (slots[hash_a.qwords[1] % slot_count]);
+    auto current (slot_l.tag.load ());
+    if (current != tag)
+    {
+        if (stage_a > germ::block_stage::election)
+            return;
+
+        // Only the thread that swaps in the claiming marker resets the stamps, any other add to the slot meanwhile is dropped
+        if (current == slot_claiming || !slot_l.tag.compare_exchange_strong (current, slot_claiming))
+            return;
+
+        for (auto & i : slot_l.stamps)
+        {
+            i = 0;
+        }
+        slot_l.tag = tag;
+    }
+    uint64_t now (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - start).count () + 1);
+    uint64_t unset (0);
+    // Only the first time a stage is reached counts
+    if (slot_l.stamps[static_cast<size_t> (stage_a)].compare_exchange_strong (unset, now) && stage_a == germ::block_stage::confirmed)
+    {
+        complete (hash_a, tag, slot_l);
+    }
+}
+
+void germ::block_tracer::complete (germ::block_hash const & hash_a, uint64_t tag_a, germ::block_tracer::slot & slot_a)
+{
+    std::array<uint64_t, stage_count> stamps;
+    uint64_t first (std::numeric_limits<uint64_t>::max ());
+    for (size_t i (0); i < stage_count; ++i)
+    {
+        stamps[i] = slot_a.stamps[i].load ();
+        if (stamps[i] != 0)
+        {
+            first = std::min (first, stamps[i]);
+        }
+    }
+    // Freed only if no other block has claimed the slot since
+    slot_a.tag.compare_exchange_strong (tag_a, 0);
+    for (size_t i (0); i < stage_count; ++i)
+    {
+        if (stamps[i] != 0)
+        {
+            histograms[i].add (stamps[i] - first);
+        }
+    }
+    auto count (++traced);
+    if (sample_interval > 0 && count % sample_interval == 0)
+    {
+        std::lock_guard<std::mutex> lock (trace_mutex);
+        if (trace_log.is_open ())
+        {
+            trace_log << hash_a.to_string ();
+            for (size_t i (0); i < stage_count; ++i)
+            {
+                if (stamps[i] != 0)
+                {
+                    trace_log << ' ' << stage_to_string (static_cast<germ::block_stage> (i)) << '=' << stamps[i] - first;
+                }
+            }
+            trace_log << std::endl;
+        }
+    }
+}
+
+std::string germ::block_tracer::stage_to_string (germ::block_stage stage_a)
+{
+    std::string result;
+    switch (stage_a)
+    {
+        case germ::block_stage::arrival:
+            result = "arrival";
+            break;
+        case germ::block_stage::queued:
+            result = "queued";
+            break;
+        case germ::block_stage::ledger:
+            result = "ledger";
+            break;
+        case germ::block_stage::election:
+            result = "election";
+            break;
+        case germ::block_stage::vote:
+            result = "vote";
+            break;
+        case germ::block_stage::quorum:
+            result = "quorum";
+            break;
+        case germ::block_stage::confirmed:
+            result = "confirmed";
+            break;
+        case germ::block_stage::count:
+            assert (false);
+            break;
+    }
+    return result;
+}
+
 bool germ::stat_config::deserialize_json (boost::property_tree::ptree & tree_a)
 {
     bool error = false;
@@ -29,9 +164,12 @@ bool germ::stat_config::deserialize_json (boost::property_tree::ptree & tree_a)
         log_rotation_count = log_l->get<size_t> ("rotation_count", log_rotation_count);
         log_counters_filename = log_l->get<std::string> ("filename_counters", log_counters_filename);
         log_samples_filename = log_l->get<std::string> ("filename_samples", log_samples_filename);
+        log_interval_trace = log_l->get<size_t> ("interval_trace", log_interval_trace);
+        log_trace_filename = log_l->get<std::string> ("filename_trace", log_trace_filename);
 
-        // Don't allow specifying the same file name for counter and samples logs
+        // Don't allow specifying the same file name for counter, samples or trace logs
         error = (log_counters_filename == log_samples_filename);
+        error |= (log_trace_filename == log_counters_filename || log_trace_filename == log_samples_filename);
     }
 
     return error;
@@ -139,9 +277,65 @@ public:
     }
 };
 
+germ::stat::stat () :
+stat (germ::stat_config ())
+{
+}
+
 germ::stat::stat (germ::stat_config config) :
-config (config)
+config (config),
+stripe_count (std::max<size_t> (1, std::thread::hardware_concurrency ())),
+counters (new std::atomic<uint64_t>[stripe_count * stripe_stride]),
+stopped (false)
 {
+    for (size_t i (0), n (stripe_count * stripe_stride); i < n; ++i)
+    {
+        counters[i] = 0;
+    }
+    if (config.log_interval_counters > 0)
+    {
+        log_count = log_sink_file (config.log_counters_filename);
+    }
+    if (config.log_interval_samples > 0)
+    {
+        log_sample = log_sink_file (config.log_samples_filename);
+    }
+    thread = std::thread ([this]() { run (); });
+}
+
+germ::stat::~stat ()
+{
+    stop ();
+}
+
+void germ::stat::stop ()
+{
+    {
+        std::lock_guard<std::mutex> lock (stat_mutex);
+        stopped = true;
+        condition.notify_all ();
+    }
+    if (thread.joinable ())
+    {
+        thread.join ();
+    }
+}
+
+size_t germ::stat::stripe () const
+{
+    static std::atomic<size_t> next_thread (0);
+    static thread_local size_t thread_index (next_thread++);
+    return thread_index % stripe_count;
+}
+
+uint64_t germ::stat::aggregate (size_t index) const
+{
+    uint64_t result (0);
+    for (size_t i (0); i < stripe_count; ++i)
+    {
+        result += counters[i * stripe_stride + index].load (std::memory_order_relaxed);
+    }
+    return result;
 }
 
 std::shared_ptr<germ::stat_entry> germ::stat::get_entry (uint32_t key)
@@ -176,7 +370,7 @@ std::unique_ptr<germ::stat_log_sink> germ::stat::log_sink_json ()
     return std::make_unique<json_writer> ();
 }
 
-std::unique_ptr<germ::stat_log_sink> log_sink_file (std::string filename)
+std::unique_ptr<germ::stat_log_sink> germ::stat::log_sink_file (std::string filename)
 {
     return std::make_unique<file_writer> (filename);
 }
@@ -184,6 +378,7 @@ std::unique_ptr<germ::stat_log_sink> log_sink_file (std::string filename)
 void germ::stat::log_counters (stat_log_sink & sink)
 {
     std::unique_lock<std::mutex> lock (stat_mutex);
+    refresh_impl ();
     log_counters_impl (sink);
 }
 
@@ -219,6 +414,7 @@ void germ::stat::log_counters_impl (stat_log_sink & sink)
 void germ::stat::log_samples (stat_log_sink & sink)
 {
     std::unique_lock<std::mutex> lock (stat_mutex);
+    refresh_impl ();
     log_samples_impl (sink);
 }
 
@@ -256,55 +452,88 @@ void germ::stat::log_samples_impl (stat_log_sink & sink)
 
 void germ::stat::update (uint32_t key_a, uint64_t value)
 {
-    static file_writer log_count (config.log_counters_filename);
-    static file_writer log_sample (config.log_samples_filename);
+    counters[stripe () * stripe_stride + index_of (key_a)].fetch_add (value, std::memory_order_relaxed);
+}
 
+void germ::stat::refresh_impl ()
+{
     auto now (std::chrono::steady_clock::now ());
-
-    std::unique_lock<std::mutex> lock (stat_mutex);
-    auto entry (get_entry_impl (key_a, config.interval, config.capacity));
-
-    // Counters
-    auto old (entry->counter.value);
-    entry->counter.add (value);
-    entry->count_observers.notify (old, entry->counter.value);
-
-    std::chrono::duration<double, std::milli> duration = now - log_last_count_writeout;
-    if (config.log_interval_counters > 0 && duration.count () > config.log_interval_counters)
+    auto walltime (std::chrono::system_clock::now ());
+    for (size_t i (0); i < key_count; ++i)
     {
-        log_counters_impl (log_count);
-        log_last_count_writeout = now;
-    }
+        auto value (aggregate (i));
+        auto key (key_at (i));
+        auto existing (entries.find (key));
+        if (value == 0 && existing == entries.end ())
+        {
+            continue;
+        }
+        auto entry (existing != entries.end () ? existing->second : get_entry_impl (key, config.interval, config.capacity));
 
-    // Samples
-    if (!config.sampling_enabled || entry->sample_interval <= 0)
-        return;
+        // Counters
+        auto old (entry->counter.value);
+        if (value != old)
+        {
+            entry->counter.value = value;
+            entry->counter.timestamp = walltime;
+            entry->count_observers.notify (old, value);
+        }
 
-    entry->sample_current.add (value, false);
+        // Samples
+        if (!config.sampling_enabled || entry->sample_interval <= 0)
+            continue;
 
-    std::chrono::duration<double, std::milli> duration_s = now - entry->sample_start_time;
-    if (duration_s.count () > entry->sample_interval)
-    {
-        entry->sample_start_time = now;
+        entry->sample_current.add (value - old, false);
 
-        // Make a snapshot of samples for thread safety and to get a stable container
-        entry->sample_current.timestamp = std::chrono::system_clock::now ();
-        entry->samples.push_back (entry->sample_current);
-        entry->sample_current.value = 0;
+        std::chrono::duration<double, std::milli> duration_s = now - entry->sample_start_time;
+        if (duration_s.count () > entry->sample_interval)
+        {
+            entry->sample_start_time = now;
+
+            // Make a snapshot of samples for thread safety and to get a stable container
+            entry->sample_current.timestamp = walltime;
+            entry->samples.push_back (entry->sample_current);
+            entry->sample_current.value = 0;
+
+            if (entry->sample_observers.observers.size () > 0)
+            {
+                auto snapshot (entry->samples);
+                entry->sample_observers.notify (snapshot);
+            }
+        }
+    }
+}
 
-        if (entry->sample_observers.observers.size () > 0)
+void germ::stat::run ()
+{
+    // Tick at the finest configured interval, but at least every second so count observers stay timely
+    size_t tick (1000);
+    for (auto interval : { config.sampling_enabled ? config.interval : 0, config.log_interval_counters, config.log_interval_samples })
+    {
+        if (interval > 0)
         {
-            auto snapshot (entry->samples);
-            entry->sample_observers.notify (snapshot);
+            tick = std::min (tick, interval);
         }
+    }
+    std::unique_lock<std::mutex> lock (stat_mutex);
+    while (!stopped)
+    {
+        refresh_impl ();
 
-        // Log sink
-        duration_s = now - log_last_sample_writeout;
-        if (config.log_interval_samples > 0 && duration_s.count () > config.log_interval_samples)
+        auto now (std::chrono::steady_clock::now ());
+        std::chrono::duration<double, std::milli> duration = now - log_last_count_writeout;
+        if (log_count != nullptr && duration.count () > config.log_interval_counters)
+        {
+            log_counters_impl (*log_count);
+            log_last_count_writeout = now;
+        }
+        duration = now - log_last_sample_writeout;
+        if (log_sample != nullptr && duration.count () > config.log_interval_samples)
         {
-            log_samples_impl (log_sample);
+            log_samples_impl (*log_sample);
             log_last_sample_writeout = now;
         }
+        condition.wait_for (lock, std::chrono::milliseconds (tick));
     }
 }
 
@@ -341,6 +570,12 @@ std::string germ::stat::type_to_string (uint32_t key)
         case germ::stat::type::message:
             res = "message";
             break;
+        case germ::stat::type::election:
+            res = "election";
+            break;
+        case germ::stat::type::count:
+            assert (false);
+            break;
     }
     return res;
 }
@@ -435,6 +670,36 @@ std::string germ::stat::detail_to_string (uint32_t key)
         case germ::stat::detail::vote_invalid:
             res = "vote_invalid";
             break;
+        case germ::stat::detail::vote_overflow:
+            res = "vote_overflow";
+            break;
+        case germ::stat::detail::vote_verified:
+            res = "vote_verified";
+            break;
+        case germ::stat::detail::vote_signed:
+            res = "vote_signed";
+            break;
+        case germ::stat::detail::vote_sign_batch:
+            res = "vote_sign_batch";
+            break;
+        case germ::stat::detail::vote_key_decrypt:
+            res = "vote_key_decrypt";
+            break;
+        case germ::stat::detail::election_start:
+            res = "election_start";
+            break;
+        case germ::stat::detail::election_drop:
+            res = "election_drop";
+            break;
+        case germ::stat::detail::election_evict:
+            res = "election_evict";
+            break;
+        case germ::stat::detail::election_confirm:
+            res = "election_confirm";
+            break;
+        case germ::stat::detail::count:
+            assert (false);
+            break;
     }
     return res;
 }
@@ -451,6 +716,9 @@ std::string germ::stat::dir_to_string (uint32_t key)
         case germ::stat::dir::out:
             res = "out";
             break;
+        case germ::stat::dir::count:
+            assert (false);
+            break;
     }
     return res;
 }
@@ -1,14 +1,20 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <boost/circular_buffer.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <fstream>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <src/lib/numbers.hpp>
 #include <src/lib/utility.hpp>
 #include <string>
+#include <thread>
 #include <unordered_map>
 
 namespace germ
@@ -52,6 +58,12 @@ public:
 
     /** Filename for the sampling log */
     std::string log_samples_filename{ "samples.stat" };
+
+    /** Write the stage timestamps of every Nth confirmed block to the trace log. Default is 0 (no tracing) */
+    size_t log_interval_trace{ 0 };
+
+    /** Filename for the block trace log */
+    std::string log_trace_filename{ "trace.stat" };
 };
 
 /** Value and wall time of measurement */
@@ -95,16 +107,133 @@ public:
     /** Value within the current sample interval */
     stat_datapoint sample_current;
 
-    /** Counting value for this entry, including the time of last update. This is never reset and only increases. */
+    /** Counting value for this entry as of the last aggregation, including when it last changed. This is never reset and only increases. */
     stat_datapoint counter;
 
     /** Zero or more observers for samples. Called at the end of the sample interval. */
     germ::observer_set<boost::circular_buffer<stat_datapoint> &> sample_observers;
 
-    /** Observers for count. Called on each update. */
+    /** Observers for count. Called when an aggregation finds the count changed. */
     germ::observer_set<uint64_t, uint64_t> count_observers;
 };
 
+/**
+ * Distribution of values in power of two buckets, safe to update from multiple threads.
+ * Bucket 0 counts zeros, bucket i counts values in [2^(i-1), 2^i) and the last bucket everything above.
+ */
+class stat_histogram
+{
+public:
+    stat_histogram ()
+    {
+        for (auto & i : buckets)
+        {
+            i = 0;
+        }
+    }
+
+    inline void add (uint64_t value)
+    {
+        size_t index (0);
+        for (auto remaining (value); remaining > 0 && index < bucket_count - 1; remaining >>= 1)
+        {
+            ++index;
+        }
+        ++buckets[index];
+    }
+
+    inline void add (std::chrono::milliseconds value)
+    {
+        add (static_cast<uint64_t> (value.count ()));
+    }
+
+    /** Number of values added */
+    inline uint64_t total () const
+    {
+        uint64_t result (0);
+        for (auto & i : buckets)
+        {
+            result += i.load ();
+        }
+        return result;
+    }
+
+    /** Upper bound of the bucket holding the value at \p fraction (0 to 1) of the distribution, 0 if empty */
+    inline uint64_t percentile (double fraction) const
+    {
+        uint64_t result (0);
+        auto total_l (total ());
+        if (total_l != 0)
+        {
+            auto target (static_cast<uint64_t> (std::ceil (fraction * total_l)));
+            uint64_t seen (0);
+            for (size_t i (0); i < bucket_count && (seen < target || seen == 0); ++i)
+            {
+                seen += buckets[i].load ();
+                result = bucket_limit (i);
+            }
+        }
+        return result;
+    }
+
+    /** Exclusive upper bound of bucket \p index, the last bucket is unbounded */
+    static inline uint64_t bucket_limit (size_t index)
+    {
+        return uint64_t (1) << index;
+    }
+
+    static size_t constexpr bucket_count = 32;
+    std::array<std::atomic<uint64_t>, bucket_count> buckets;
+};
+
+/** Points in a block's life from arrival to confirmation, in the order they normally happen */
+enum class block_stage : uint8_t
+{
+    arrival, // Received in a publish message
+    queued, // Added to the block processor
+    ledger, // Inserted into the ledger
+    election, // Election started
+    vote, // First vote applied to the election
+    quorum, // Election reached quorum
+    confirmed, // Confirmation processed by the node
+    count
+};
+
+/**
+ * Records when blocks reach each stage, without locking, in a fixed ring of slots indexed by block hash.
+ * A block claims its slot with a compare-and-swap on the first stage up to election, a colliding block takes
+ * the slot over so a trace is occasionally lost. On confirmation the microseconds from the block's first recorded stage
+ * to every other stage go into per-stage histograms and every Nth trace is appended to the trace log.
+ */
+class block_tracer
+{
+public:
+    block_tracer (size_t sample_interval = 0, std::string const & filename = "");
+    void add (germ::block_hash const &, germ::block_stage);
+    static std::string stage_to_string (germ::block_stage);
+    static size_t constexpr stage_count = static_cast<size_t> (germ::block_stage::count);
+    static size_t constexpr slot_count = 16 * 1024;
+    std::array<germ::stat_histogram, stage_count> histograms;
+    /** Number of blocks traced through to confirmation */
+    std::atomic<uint64_t> traced;
+
+private:
+    class slot
+    {
+    public:
+        std::atomic<uint64_t> tag;
+        // Microseconds since the tracer started plus one, zero if the stage wasn't reached
+        std::array<std::atomic<uint64_t>, stage_count> stamps;
+    };
+    void complete (germ::block_hash const &, uint64_t, germ::block_tracer::slot &);
+    static uint64_t constexpr slot_claiming = 2;
+    std::unique_ptr<slot[]> slots;
+    std::chrono::steady_clock::time_point start;
+    size_t sample_interval;
+    std::mutex trace_mutex;
+    std::ofstream trace_log;
+};
+
 /** Log sink interface */
 class stat_log_sink
 {
@@ -169,6 +298,11 @@ protected:
  * Collects counts and samples for inbound and outbound traffic, blocks, errors, and so on.
  * Stats can be queried and observed on a type level (such as message and ledger) as well as a more
  * specific detail level (such as send blocks)
+ *
+ * Every type/detail/direction combination has a fixed counter slot in each of a set of stripes, a thread
+ * always adds to the same stripe so updates are a relaxed atomic add without locks or clock reads.
+ * Counts are summed over the stripes when read. Samples, count observers and log writeouts are driven
+ * from a background thread which aggregates the counters every tick.
  */
 class stat
 {
@@ -184,7 +318,9 @@ public:
         rollback,
         bootstrap,
         vote,
-        peering
+        peering,
+        election,
+        count
     };
 
     /** Optional detail type */
@@ -227,22 +363,33 @@ public:
         vote_valid,
         vote_replay,
         vote_invalid,
+        vote_overflow,
+        vote_verified,
+        vote_signed,
+        vote_sign_batch,
+        vote_key_decrypt,
 
         // peering
         handshake,
+
+        // election specific
+        election_start,
+        election_drop,
+        election_evict,
+        election_confirm,
+        count
     };
 
     /** Direction of the stat. If the direction is irrelevant, use in */
     enum class dir : uint8_t
     {
         in,
-        out
+        out,
+        count
     };
 
     /** Constructor using the default config values */
-    stat ()
-    {
-    }
+    stat ();
 
     /**
      * Initialize stats with a config.
@@ -250,6 +397,11 @@ public:
      */
     stat (germ::stat_config config);
 
+    ~stat ();
+
+    /** Stops the background thread. Counters can still be updated and read, but observers and file logs are no longer driven. */
+    void stop ();
+
     /**
      * Call this to override the default sample interval and capacity, for a specific stat entry.
      * This must be called before any stat entries are added, as part of the node initialiation.
@@ -357,10 +509,10 @@ public:
     /** Returns current value for the given counter at the detail level */
     inline uint64_t count (stat::type type, stat::detail detail, stat::dir dir = stat::dir::in)
     {
-        return get_entry (key_of (type, detail, dir))->counter.value;
+        return aggregate (index_of (key_of (type, detail, dir)));
     }
 
-    /** Log counters to the given log link */
+    /** Log counters to the given log link. Counters are aggregated first so the output is current. */
     void log_counters (stat_log_sink & sink);
 
     /** Log samples to the given log sink */
@@ -378,11 +530,36 @@ private:
     static std::string dir_to_string (uint32_t key);
 
     /** Constructs a key given type, detail and direction. This is used as input to update(...) and get_entry(...) */
-    inline uint32_t key_of (stat::type type, stat::detail detail, stat::dir dir) const
+    static inline uint32_t key_of (stat::type type, stat::detail detail, stat::dir dir)
     {
         return static_cast<uint8_t> (type) << 16 | static_cast<uint8_t> (detail) << 8 | static_cast<uint8_t> (dir);
     }
 
+    static size_t constexpr type_count = static_cast<size_t> (stat::type::count);
+    static size_t constexpr detail_count = static_cast<size_t> (stat::detail::count);
+    static size_t constexpr dir_count = static_cast<size_t> (stat::dir::count);
+    static size_t constexpr key_count = type_count * detail_count * dir_count;
+    /** Each stripe's counters are followed by a cache line of padding so two stripes never share a line */
+    static size_t constexpr stripe_stride = key_count + 64 / sizeof (uint64_t);
+
+    /** Dense counter slot of a key, ordered the same as keys */
+    static inline size_t index_of (uint32_t key)
+    {
+        return ((key >> 16 & 0xff) * detail_count + (key >> 8 & 0xff)) * dir_count + (key & 0xff);
+    }
+
+    /** Key of a dense counter slot */
+    static inline uint32_t key_at (size_t index)
+    {
+        return static_cast<uint32_t> (index / (detail_count * dir_count) << 16 | index / dir_count % detail_count << 8 | index % dir_count);
+    }
+
+    /** Sum of a counter slot over all stripes */
+    uint64_t aggregate (size_t index) const;
+
+    /** Stripe the calling thread adds to */
+    size_t stripe () const;
+
     /** Get entry for key, creating a new entry if necessary, using interval and sample count from config */
     std::shared_ptr<germ::stat_entry> get_entry (uint32_t key);
 
@@ -393,12 +570,18 @@ private:
     std::shared_ptr<germ::stat_entry> get_entry_impl (uint32_t key, size_t sample_interval, size_t max_samples);
 
     /**
-     * Update count and sample and call any observers on the key
+     * Add to the calling thread's counter for the key. Samples and observers catch up on the next aggregation.
      * @param key a key constructor from stat::type, stat::detail and stat::direction
      * @value Amount to add to the counter
      */
     void update (uint32_t key, uint64_t value);
 
+    /** Aggregates the counters into the entries, notifies count observers and closes finished sample intervals */
+    void refresh_impl ();
+
+    /** Background loop aggregating counters and writing the file logs */
+    void run ();
+
     /** Unlocked implementation of log_counters() to avoid using recursive locking */
     void log_counters_impl (stat_log_sink & sink);
 
@@ -408,12 +591,25 @@ private:
     /** Configuration deserialized from config.json */
     germ::stat_config config;
 
+    /** Number of counter stripes, one per hardware thread */
+    size_t stripe_count;
+
+    /** Counters of every stripe, stripe_stride apart */
+    std::unique_ptr<std::atomic<uint64_t>[]> counters;
+
     /** Stat entries are sorted by key to simplify processing of log output */
     std::map<uint32_t, std::shared_ptr<germ::stat_entry>> entries;
     std::chrono::steady_clock::time_point log_last_count_writeout{ std::chrono::steady_clock::now () };
     std::chrono::steady_clock::time_point log_last_sample_writeout{ std::chrono::steady_clock::now () };
 
-    /** All access to stat is thread safe, including calls from observers on the same thread */
+    /** File sinks for periodic writeout, only opened if the respective log interval is set */
+    std::unique_ptr<stat_log_sink> log_count;
+    std::unique_ptr<stat_log_sink> log_sample;
+
+    /** Guards the entries and sinks, observers are called with it held */
     std::mutex stat_mutex;
+    std::condition_variable condition;
+    bool stopped;
+    std::thread thread;
 };
 }
@@ -0,0 +1,649 @@
+#include <src/node/subscription.hpp>
+
+#include <src/lib/json.hpp>
+#include <src/node/node.hpp>
+
+germ::subscription_config::subscription_config () :
+enable (false),
+address (boost::asio::ip::address_v6::loopback ()),
+port (germ::subscription_server::subscription_port),
+queue_max (4096),
+history (64 * 1024),
+batch_max (256)
+{
+}
+
+void germ::subscription_config::serialize_json (boost::property_tree::ptree & tree_a) const
+{
+    tree_a.put ("enable", enable);
+    tree_a.put ("address", address.to_string ());
+    tree_a.put ("port", std::to_string (port));
+    tree_a.put ("queue_max", std::to_string (queue_max));
+    tree_a.put ("history", std::to_string (history));
+    tree_a.put ("batch_max", std::to_string (batch_max));
+}
+
+bool germ::subscription_config::deserialize_json (boost::property_tree::ptree const & tree_a)
+{
+    auto result (false);
+    try
+    {
+        enable = tree_a.get<bool> ("enable");
+        auto address_l (tree_a.get<std::string> ("address"));
+        auto port_l (tree_a.get<std::string> ("port"));
+        auto queue_max_l (tree_a.get<std::string> ("queue_max"));
+        auto history_l (tree_a.get<std::string> ("history"));
+        auto batch_max_l (tree_a.get<std::string> ("batch_max"));
+        try
+        {
+            port = std::stoul (port_l);
+            queue_max = std::stoul (queue_max_l);
+            history = std::stoul (history_l);
+            batch_max = std::stoul (batch_max_l);
+            result = port > std::numeric_limits<uint16_t>::max () || queue_max == 0 || batch_max == 0;
+        }
+        catch (std::logic_error const &)
+        {
+            result = true;
+        }
+        boost::system::error_code ec;
+        address = boost::asio::ip::address_v6::from_string (address_l, ec);
+        if (ec)
+        {
+            result = true;
+        }
+    }
+    catch (std::runtime_error const &)
+    {
+        result = true;
+    }
+    return result;
+}
+
+germ::subscription_server::subscription_server (boost::asio::io_service & service_a, germ::node & node_a, germ::subscription_config const & config_a) :
+acceptor (service_a),
+config (config_a),
+node (node_a),
+epoch ([]() {
+    uint64_t result;
+    germ::random_pool.GenerateBlock (reinterpret_cast<uint8_t *> (&result), sizeof (result));
+    return result;
+}()),
+sequence (0)
+{
+}
+
+void germ::subscription_server::start ()
+{
+    auto endpoint (germ::tcp_endpoint (config.address, config.port));
+    acceptor.open (endpoint.protocol ());
+    acceptor.set_option (boost::asio::ip::tcp::acceptor::reuse_address (true));
+
+    boost::system::error_code ec;
+    acceptor.bind (endpoint, ec);
+    if (ec)
+    {
+        BOOST_LOG (node.log) << boost::str (boost::format ("Error while binding for subscriptions on port %1%: %2%") % endpoint.port () % ec.message ());
+        throw std::runtime_error (ec.message ());
+    }
+
+    acceptor.listen ();
+    accept ();
+}
+
+void germ::subscription_server::accept ()
+{
+    auto socket (std::make_shared<boost::asio::ip::tcp::socket> (node.service));
+    acceptor.async_accept (*socket, [this, socket](boost::system::error_code const & ec) {
+        if (!ec)
+        {
+            accept ();
+            auto session (std::make_shared<germ::subscription_session> (*this, std::move (*socket)));
+            {
+                std::lock_guard<std::mutex> lock (mutex);
+                sessions.push_back (session);
+            }
+            session->start ();
+        }
+        else if (ec != boost::asio::error::operation_aborted)
+        {
+            BOOST_LOG (this->node.log) << boost::str (boost::format ("Error accepting subscription connections: %1%") % ec);
+        }
+    });
+}
+
+void germ::subscription_server::stop ()
+{
+    boost::system::error_code ec;
+    acceptor.close (ec);
+    std::lock_guard<std::mutex> lock (mutex);
+    for (auto & i : sessions)
+    {
+        auto session (i.lock ());
+        if (session != nullptr)
+        {
+            session->close ();
+        }
+    }
+    sessions.clear ();
+}
+
+void germ::subscription_server::publish (std::shared_ptr<germ::tx> block_a, germ::account const & account_a, germ::amount const & amount_a, bool is_send_a)
+{
+    std::string block_text;
+    block_a->serialize_json (block_text);
+    auto event (std::make_shared<germ::confirmation_event> ());
+    event->account = account_a;
+    event->destination = is_send_a ? block_a->destination () : germ::account (0);
+    std::lock_guard<std::mutex> lock (mutex);
+    event->sequence = ++sequence;
+    germ::json_writer writer;
+    writer.begin_object ();
+    writer.value ("sequence", std::to_string (event->sequence));
+    writer.value ("account", account_a.to_account ());
+    writer.value ("hash", block_a->hash ().to_string ());
+    writer.value ("block", block_text);
+    writer.value ("amount", amount_a.to_string_dec ());
+    if (is_send_a)
+    {
+        writer.value ("is_send", "true");
+    }
+    writer.end_object ();
+    event->json = std::move (writer.output);
+    history.push_back (event);
+    while (history.size () > config.history)
+    {
+        history.pop_front ();
+    }
+    // Pushed while holding the lock so every session receives events in sequence order
+    for (auto i (sessions.begin ()); i != sessions.end ();)
+    {
+        auto session (i->lock ());
+        if (session != nullptr)
+        {
+            session->push (event);
+            ++i;
+        }
+        else
+        {
+            i = sessions.erase (i);
+        }
+    }
+}
+
+uint64_t germ::subscription_server::replay (uint64_t after_a, std::vector<std::shared_ptr<germ::confirmation_event const>> & events_a, uint64_t & newest_a)
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    newest_a = sequence;
+    auto oldest (history.empty () ? sequence + 1 : history.front ()->sequence);
+    // Sequence numbers in the history are contiguous so the first one wanted can be indexed directly
+    auto begin (after_a < oldest ? 0 : std::min<uint64_t> (after_a - oldest + 1, history.size ()));
+    for (auto i (begin); i < history.size (); ++i)
+    {
+        events_a.push_back (history[i]);
+    }
+    return oldest;
+}
+
+size_t germ::subscription_server::size ()
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    size_t result (0);
+    for (auto & i : sessions)
+    {
+        result += i.expired () ? 0 : 1;
+    }
+    return result;
+}
+
+germ::subscription_session::subscription_session (germ::subscription_server & server_a, boost::asio::ip::tcp::socket socket_a) :
+server (server_a),
+stream (std::move (socket_a)),
+strand (server_a.node.service),
+subscribed (false),
+writing (false),
+last_sequence (0),
+dropped (0)
+{
+}
+
+void germ::subscription_session::start ()
+{
+    auto this_l (shared_from_this ());
+    stream.read_message_max (64 * 1024);
+    stream.async_accept (strand.wrap ([this_l](boost::system::error_code const & ec) {
+        if (!ec)
+        {
+            this_l->read ();
+        }
+    }));
+}
+
+void germ::subscription_session::read ()
+{
+    auto this_l (shared_from_this ());
+    stream.async_read (buffer, strand.wrap ([this_l](boost::system::error_code const & ec, size_t size_a) {
+        if (!ec)
+        {
+            std::string text (boost::asio::buffers_begin (this_l->buffer.data ()), boost::asio::buffers_end (this_l->buffer.data ()));
+            this_l->buffer.consume (this_l->buffer.size ());
+            this_l->subscribe (text);
+            this_l->read ();
+        }
+    }));
+}
+
+void germ::subscription_session::subscribe (std::string const & text_a)
+{
+    auto error (false);
+    germ::json_document document (error, text_a);
+    std::string action;
+    error = error || !document.root ().get ("action", action) || action != "subscribe";
+    std::unordered_set<germ::account> accounts_l;
+    auto accounts_node (!error ? document.root ().find ("accounts") : nullptr);
+    for (auto i (!error && accounts_node != nullptr ? accounts_node->child : nullptr); i != nullptr && !error; i = i->next)
+    {
+        germ::account account;
+        error = account.decode_account (i->string ());
+        accounts_l.insert (account);
+    }
+    std::string sequence_text;
+    auto resume (!error && document.root ().get ("sequence", sequence_text));
+    uint64_t after (0);
+    std::string epoch_text;
+    auto has_epoch (resume && document.root ().get ("epoch", epoch_text));
+    uint64_t epoch (0);
+    if (resume)
+    {
+        try
+        {
+            after = std::stoull (sequence_text);
+            epoch = has_epoch ? std::stoull (epoch_text) : 0;
+        }
+        catch (std::logic_error const &)
+        {
+            error = true;
+        }
+    }
+    germ::json_writer writer;
+    writer.begin_object ();
+    if (!error)
+    {
+        accounts = std::move (accounts_l);
+        subscribed = true;
+        queue.clear ();
+        std::vector<std::shared_ptr<germ::confirmation_event const>> events;
+        // A sequence from an earlier run can't be resumed from, everything still in the history is sent instead
+        auto stale (has_epoch && epoch != server.epoch);
+        // Without a sequence only events published from now on are sent
+        auto oldest (server.replay (resume ? (stale ? 0 : after) : std::numeric_limits<uint64_t>::max (), events, last_sequence));
+        if (resume && !stale && after > last_sequence)
+        {
+            // Newer than anything published, the client last saw a previous run that didn't report an epoch
+            stale = true;
+            events.clear ();
+            oldest = server.replay (0, events, last_sequence);
+        }
+        writer.value ("type", "subscribed");
+        writer.value ("sequence", std::to_string (last_sequence));
+        writer.value ("epoch", std::to_string (server.epoch));
+        if (resume)
+        {
+            // False when events after the requested sequence already fell out of the history or belong to another run
+            writer.value ("resumed", !stale && after + 1 >= oldest ? "true" : "false");
+        }
+        writer.end_object ();
+        control.push_back (std::move (writer.output));
+        for (auto & i : events)
+        {
+            enqueue (i);
+        }
+        // Events pushed before the replay was taken are skipped by sequence when they reach the strand
+        last_sequence = std::max (last_sequence, events.empty () ? 0 : events.back ()->sequence);
+    }
+    else
+    {
+        writer.value ("type", "error");
+        writer.value ("error", "Invalid subscription");
+        writer.end_object ();
+        control.push_back (std::move (writer.output));
+    }
+    write_next ();
+}
+
+void germ::subscription_session::push (std::shared_ptr<germ::confirmation_event const> event_a)
+{
+    auto this_l (shared_from_this ());
+    strand.post ([this_l, event_a]() {
+        if (this_l->subscribed && event_a->sequence > this_l->last_sequence)
+        {
+            this_l->last_sequence = event_a->sequence;
+            this_l->enqueue (event_a);
+            this_l->write_next ();
+        }
+    });
+}
+
+void germ::subscription_session::enqueue (std::shared_ptr<germ::confirmation_event const> event_a)
+{
+    auto matches (accounts.empty () || accounts.count (event_a->account) != 0 || (!event_a->destination.is_zero () && accounts.count (event_a->destination) != 0));
+    if (matches)
+    {
+        queue.push_back (event_a);
+        if (queue.size () > server.config.queue_max)
+        {
+            queue.pop_front ();
+            ++dropped;
+        }
+    }
+}
+
+void germ::subscription_session::write_next ()
+{
+    if (!writing && (!control.empty () || !queue.empty ()))
+    {
+        auto message (std::make_shared<std::string> ());
+        if (!control.empty ())
+        {
+            *message = std::move (control.front ());
+            control.pop_front ();
+        }
+        else
+        {
+            germ::json_writer writer;
+            writer.begin_object ();
+            writer.value ("type", "confirmations");
+            writer.value ("dropped", std::to_string (dropped));
+            writer.begin_array ("events");
+            for (size_t i (0); i < server.config.batch_max && !queue.empty (); ++i)
+            {
+                writer.raw (queue.front ()->json);
+                queue.pop_front ();
+            }
+            writer.end_array ();
+            writer.end_object ();
+            dropped = 0;
+            *message = std::move (writer.output);
+        }
+        writing = true;
+        stream.text (true);
+        auto this_l (shared_from_this ());
+        stream.async_write (boost::asio::buffer (*message), strand.wrap ([this_l, message](boost::system::error_code const & ec, size_t size_a) {
+            this_l->writing = false;
+            if (!ec)
+            {
+                this_l->write_next ();
+            }
+        }));
+    }
+}
+
+void germ::subscription_session::close ()
+{
+    auto this_l (shared_from_this ());
+    strand.post ([this_l]() {
+        boost::system::error_code ignored;
+        this_l->stream.next_layer ().close (ignored);
+    });
+}
+
+size_t constexpr germ::http_callback::connections_max;
+size_t constexpr germ::http_callback::queue_max;
+
+germ::http_callback::http_callback (germ::node & node_a) :
+node (node_a),
+connections (0),
+resolving (false),
+stopped (false)
+{
+}
+
+void germ::http_callback::post (std::shared_ptr<std::string> body_a)
+{
+    std::unique_lock<std::mutex> lock (mutex);
+    if (!stopped)
+    {
+        if (queue.size () >= queue_max)
+        {
+            queue.pop_front ();
+            if (node.config.logging.callback_logging ())
+            {
+                BOOST_LOG (node.log) << boost::str (boost::format ("Callback queue to %1%:%2% is full, dropping the oldest event") % node.config.callback_address % node.config.callback_port);
+            }
+        }
+        queue.push_back (body_a);
+        dispatch (lock);
+    }
+}
+
+void germ::http_callback::stop ()
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    stopped = true;
+    queue.clear ();
+    idle.clear ();
+    for (auto & i : open)
+    {
+        auto connection (i.lock ());
+        if (connection != nullptr)
+        {
+            connection->close ();
+        }
+    }
+    open.clear ();
+}
+
+void germ::http_callback::dispatch (std::unique_lock<std::mutex> & lock_a)
+{
+    while (!queue.empty () && !idle.empty ())
+    {
+        auto connection (idle.back ());
+        idle.pop_back ();
+        auto body (queue.front ());
+        queue.pop_front ();
+        connection->send (body);
+    }
+    if (!queue.empty () && connections < connections_max)
+    {
+        connect (lock_a);
+    }
+}
+
+void germ::http_callback::connect (std::unique_lock<std::mutex> & lock_a)
+{
+    if (!endpoints.empty ())
+    {
+        ++connections;
+        auto connection (std::make_shared<germ::http_callback_connection> (*this));
+        open.erase (std::remove_if (open.begin (), open.end (), [](std::weak_ptr<germ::http_callback_connection> const & i) { return i.expired (); }), open.end ());
+        open.push_back (connection);
+        connection->connect (endpoints[connections % endpoints.size ()]);
+    }
+    else if (!resolving)
+    {
+        resolving = true;
+        auto address (node.config.callback_address);
+        auto port (node.config.callback_port);
+        auto node_l (node.shared ());
+        auto resolver (std::make_shared<boost::asio::ip::tcp::resolver> (node.service));
+        resolver->async_resolve (boost::asio::ip::tcp::resolver::query (address, std::to_string (port)), [node_l, resolver, address, port](boost::system::error_code const & ec, boost::asio::ip::tcp::resolver::iterator i_a) {
+            auto & callback (node_l->callback);
+            std::unique_lock<std::mutex> lock (callback.mutex);
+            callback.resolving = false;
+            if (!ec)
+            {
+                for (auto i (i_a), n (boost::asio::ip::tcp::resolver::iterator{}); i != n; ++i)
+                {
+                    callback.endpoints.push_back (i->endpoint ());
+                }
+                if (!callback.stopped && !callback.endpoints.empty ())
+                {
+                    callback.dispatch (lock);
+                }
+            }
+            else if (node_l->config.logging.callback_logging ())
+            {
+                BOOST_LOG (node_l->log) << boost::str (boost::format ("Error resolving callback: %1%:%2%: %3%") % address % port % ec.message ());
+            }
+        });
+    }
+}
+
+void germ::http_callback::release (std::shared_ptr<germ::http_callback_connection> connection_a)
+{
+    std::unique_lock<std::mutex> lock (mutex);
+    if (!stopped)
+    {
+        idle.push_back (connection_a);
+        dispatch (lock);
+    }
+    else
+    {
+        --connections;
+        boost::system::error_code ignored;
+        connection_a->socket.close (ignored);
+    }
+}
+
+void germ::http_callback::closed (std::shared_ptr<germ::http_callback_connection> connection_a, std::shared_ptr<std::string> retry_a, bool error_a)
+{
+    std::unique_lock<std::mutex> lock (mutex);
+    --connections;
+    boost::system::error_code ignored;
+    connection_a->socket.close (ignored);
+    if (!stopped)
+    {
+        if (retry_a != nullptr)
+        {
+            queue.push_front (retry_a);
+        }
+        if (!error_a)
+        {
+            dispatch (lock);
+        }
+        else
+        {
+            // Resolve again in case the address moved and back off before reconnecting
+            endpoints.clear ();
+            std::weak_ptr<germ::node> node_w (node.shared_from_this ());
+            node.alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (1), [node_w]() {
+                auto node_l (node_w.lock ());
+                if (node_l != nullptr)
+                {
+                    std::unique_lock<std::mutex> lock (node_l->callback.mutex);
+                    if (!node_l->callback.stopped)
+                    {
+                        node_l->callback.dispatch (lock);
+                    }
+                }
+            });
+        }
+    }
+}
+
+germ::http_callback_connection::http_callback_connection (germ::http_callback & callback_a) :
+callback (callback_a),
+strand (callback_a.node.service),
+socket (callback_a.node.service),
+served (0)
+{
+}
+
+void germ::http_callback_connection::close ()
+{
+    auto this_l (shared_from_this ());
+    strand.dispatch ([this_l]() {
+        boost::system::error_code ignored;
+        this_l->socket.close (ignored);
+    });
+}
+
+void germ::http_callback_connection::connect (boost::asio::ip::tcp::endpoint const & endpoint_a)
+{
+    auto this_l (shared_from_this ());
+    auto node_l (callback.node.shared ());
+    socket.async_connect (endpoint_a, strand.wrap ([this_l, node_l, endpoint_a](boost::system::error_code const & ec) {
+        if (!ec)
+        {
+            this_l->callback.release (this_l);
+        }
+        else
+        {
+            if (this_l->callback.node.config.logging.callback_logging ())
+            {
+                BOOST_LOG (this_l->callback.node.log) << boost::str (boost::format ("Unable to connect to callback address: %1%: %2%") % endpoint_a % ec.message ());
+            }
+            this_l->callback.closed (this_l, nullptr, true);
+        }
+    }));
+}
+
+void germ::http_callback_connection::send (std::shared_ptr<std::string> body_a)
+{
+    auto & config (callback.node.config);
+    auto request (std::make_shared<boost::beast::http::request<boost::beast::http::string_body>> ());
+    request->method (boost::beast::http::verb::post);
+    request->target (config.callback_target);
+    request->version (11);
+    request->insert (boost::beast::http::field::host, config.callback_address);
+    request->insert (boost::beast::http::field::content_type, "application/json");
+    request->keep_alive (true);
+    request->body () = *body_a;
+    request->prepare_payload ();
+    auto this_l (shared_from_this ());
+    auto node_l (callback.node.shared ());
+    // Sent from whichever thread released the connection, the strand keeps it apart from a concurrent close
+    strand.dispatch ([this_l, node_l, request, body_a]() {
+        this_l->write (node_l, request, body_a);
+    });
+}
+
+void germ::http_callback_connection::write (std::shared_ptr<germ::node> node_a, std::shared_ptr<boost::beast::http::request<boost::beast::http::string_body>> request_a, std::shared_ptr<std::string> body_a)
+{
+    auto this_l (shared_from_this ());
+    auto node_l (node_a);
+    auto request (request_a);
+    boost::beast::http::async_write (socket, *request, strand.wrap ([this_l, node_l, request, body_a](boost::system::error_code const & ec, size_t bytes_transferred) {
+        if (!ec)
+        {
+            auto response (std::make_shared<boost::beast::http::response<boost::beast::http::string_body>> ());
+            boost::beast::http::async_read (this_l->socket, this_l->buffer, *response, this_l->strand.wrap ([this_l, node_l, response, body_a](boost::system::error_code const & ec, size_t bytes_transferred) {
+                auto & node (*node_l);
+                if (!ec)
+                {
+                    ++this_l->served;
+                    if (response->result () != boost::beast::http::status::ok && node.config.logging.callback_logging ())
+                    {
+                        BOOST_LOG (node.log) << boost::str (boost::format ("Callback to %1%:%2% failed with status: %3%") % node.config.callback_address % node.config.callback_port % response->result ());
+                    }
+                    if (response->keep_alive ())
+                    {
+                        this_l->callback.release (this_l);
+                    }
+                    else
+                    {
+                        this_l->callback.closed (this_l, nullptr, false);
+                    }
+                }
+                else
+                {
+                    if (node.config.logging.callback_logging ())
+                    {
+                        BOOST_LOG (node.log) << boost::str (boost::format ("Unable complete callback: %1%:%2%: %3%") % node.config.callback_address % node.config.callback_port % ec.message ());
+                    }
+                    // A reused connection may have been closed by the server while idle, send the event again on a new one
+                    this_l->callback.closed (this_l, this_l->served > 0 ? body_a : nullptr, this_l->served == 0);
+                }
+            }));
+        }
+        else
+        {
+            auto & node (*node_l);
+            if (node.config.logging.callback_logging ())
+            {
+                BOOST_LOG (node.log) << boost::str (boost::format ("Unable to send callback: %1%:%2%: %3%") % node.config.callback_address % node.config.callback_port % ec.message ());
+            }
+            this_l->callback.closed (this_l, this_l->served > 0 ? body_a : nullptr, this_l->served == 0);
+        }
+    }));
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <src/config.hpp>
+#include <src/lib/numbers.hpp>
+#include <src/node/utility.hpp>
+
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+namespace germ
+{
+class node;
+class tx;
+/**
+ * Options for the confirmation subscription listener, a local WebSocket endpoint streaming confirmed blocks.
+ */
+class subscription_config
+{
+public:
+    subscription_config ();
+    void serialize_json (boost::property_tree::ptree &) const;
+    bool deserialize_json (boost::property_tree::ptree const &);
+    bool enable;
+    boost::asio::ip::address_v6 address;
+    uint16_t port;
+    // Events a subscriber may fall behind by before the oldest are dropped
+    size_t queue_max;
+    // Recent events kept so a subscriber can resume from a sequence number after reconnecting
+    size_t history;
+    // Events sent in one message
+    size_t batch_max;
+};
+/**
+ * A confirmed block, rendered once and shared by every subscriber it's sent to
+ */
+class confirmation_event
+{
+public:
+    uint64_t sequence;
+    germ::account account;
+    // Destination of a send, zero otherwise
+    germ::account destination;
+    std::string json;
+};
+class subscription_session;
+/**
+ * Numbers confirmations and streams them to WebSocket subscribers.
+ * Clients send {"action": "subscribe", "accounts": [...], "sequence": "n", "epoch": "e"}, accounts filters by block account or send destination
+ * and sequence replays the events after it that are still in the history. Sequence numbers restart with the node, so they are only
+ * resumed from when the epoch matches the one reported in the reply.
+ */
+class subscription_server
+{
+public:
+    subscription_server (boost::asio::io_service &, germ::node &, germ::subscription_config const &);
+    void start ();
+    void accept ();
+    void stop ();
+    void publish (std::shared_ptr<germ::tx>, germ::account const &, germ::amount const &, bool);
+    // Events in the history after a sequence number, returns the oldest sequence still held and sets the newest published
+    uint64_t replay (uint64_t, std::vector<std::shared_ptr<germ::confirmation_event const>> &, uint64_t &);
+    size_t size ();
+    boost::asio::ip::tcp::acceptor acceptor;
+    germ::subscription_config const & config;
+    germ::node & node;
+    std::mutex mutex;
+    // Random for each run, tells clients whether their sequence numbers still refer to the same events
+    uint64_t const epoch;
+    // Sequence of the last event published
+    uint64_t sequence;
+    std::deque<std::shared_ptr<germ::confirmation_event const>> history;
+    std::vector<std::weak_ptr<germ::subscription_session>> sessions;
+    static uint16_t const subscription_port = germ::rai_network == germ::germ_networks::germ_live_network ? 7079 : 57000;
+};
+class subscription_session : public std::enable_shared_from_this<germ::subscription_session>
+{
+public:
+    subscription_session (germ::subscription_server &, boost::asio::ip::tcp::socket);
+    void start ();
+    // Queues an event if it is newer than the last one seen and passes the filter, called in sequence order
+    void push (std::shared_ptr<germ::confirmation_event const>);
+    void close ();
+    germ::subscription_server & server;
+    boost::beast::websocket::stream<boost::asio::ip::tcp::socket> stream;
+
+private:
+    void read ();
+    void subscribe (std::string const &);
+    void enqueue (std::shared_ptr<germ::confirmation_event const>);
+    void write_next ();
+    boost::asio::io_service::strand strand;
+    boost::beast::flat_buffer buffer;
+    // Everything below is only touched on the strand
+    bool subscribed;
+    bool writing;
+    std::unordered_set<germ::account> accounts;
+    std::deque<std::string> control;
+    std::deque<std::shared_ptr<germ::confirmation_event const>> queue;
+    uint64_t last_sequence;
+    uint64_t dropped;
+};
+class http_callback_connection;
+/**
+ * Delivers the legacy HTTP callback over a small pool of keep-alive connections.
+ * The address is resolved once and again only after a connection fails, bodies wait in a bounded queue for a free connection.
+ */
+class http_callback
+{
+public:
+    http_callback (germ::node &);
+    void post (std::shared_ptr<std::string>);
+    void stop ();
+    germ::node & node;
+    static size_t constexpr connections_max = 8;
+    static size_t constexpr queue_max = 16 * 1024;
+
+private:
+    friend class germ::http_callback_connection;
+    void dispatch (std::unique_lock<std::mutex> &);
+    void connect (std::unique_lock<std::mutex> &);
+    void release (std::shared_ptr<germ::http_callback_connection>);
+    // Connection is gone, the body is queued again if given and an error backs off before reconnecting
+    void closed (std::shared_ptr<germ::http_callback_connection>, std::shared_ptr<std::string>, bool);
+    std::mutex mutex;
+    std::deque<std::shared_ptr<std::string>> queue;
+    std::vector<std::shared_ptr<germ::http_callback_connection>> idle;
+    // Every connection opened, so stop can close those still connecting or waiting on the server
+    std::vector<std::weak_ptr<germ::http_callback_connection>> open;
+    // Connections open or being opened
+    size_t connections;
+    std::vector<boost::asio::ip::tcp::endpoint> endpoints;
+    bool resolving;
+    bool stopped;
+};
+class http_callback_connection : public std::enable_shared_from_this<germ::http_callback_connection>
+{
+public:
+    http_callback_connection (germ::http_callback &);
+    void connect (boost::asio::ip::tcp::endpoint const &);
+    void send (std::shared_ptr<std::string>);
+    void close ();
+    void write (std::shared_ptr<germ::node>, std::shared_ptr<boost::beast::http::request<boost::beast::http::string_body>>, std::shared_ptr<std::string>);
+    // Handlers hold the node alive, an idle connection holds nothing so the pool doesn't keep the node from being destroyed
+    germ::http_callback & callback;
+    boost::asio::io_service::strand strand;
+    boost::asio::ip::tcp::socket socket;
+    boost::beast::flat_buffer buffer;
+    // Requests completed, a failure on a reused connection is retried since the server may have closed it while idle
+    uint64_t served;
+};
+}
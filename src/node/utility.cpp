@@ -56,7 +56,95 @@ std::vector<boost::filesystem::path> germ::remove_temporary_directories ()
     return all_unique_paths;
 }
 
-germ::mdb_env::mdb_env (bool & error_a, boost::filesystem::path const & path_a, int max_dbs)
+size_t constexpr germ::mdb_env::read_pool_max;
+
+germ::lmdb_config::lmdb_config () :
+sync (germ::lmdb_sync::full),
+sync_commits (1000),
+sync_interval (std::chrono::milliseconds (500)),
+no_readahead (false),
+write_map (false),
+map_size (1ULL * 1024 * 1024 * 1024 * 128), // 128 Gigabyte
+map_growth (1ULL * 1024 * 1024 * 1024 * 16)
+{
+}
+
+void germ::lmdb_config::serialize_json (boost::property_tree::ptree & tree_a) const
+{
+    std::string sync_l;
+    switch (sync)
+    {
+        case germ::lmdb_sync::full:
+            sync_l = "full";
+            break;
+        case germ::lmdb_sync::no_meta_sync:
+            sync_l = "no_meta_sync";
+            break;
+        case germ::lmdb_sync::no_sync:
+            sync_l = "no_sync";
+            break;
+    }
+    tree_a.put ("sync", sync_l);
+    tree_a.put ("sync_commits", std::to_string (sync_commits));
+    tree_a.put ("sync_interval", std::to_string (sync_interval.count ()));
+    tree_a.put ("no_readahead", no_readahead);
+    tree_a.put ("write_map", write_map);
+    tree_a.put ("map_size", std::to_string (map_size));
+    tree_a.put ("map_growth", std::to_string (map_growth));
+}
+
+bool germ::lmdb_config::deserialize_json (boost::property_tree::ptree & tree_a)
+{
+    auto result (false);
+    try
+    {
+        auto sync_l (tree_a.get<std::string> ("sync"));
+        if (sync_l == "full")
+        {
+            sync = germ::lmdb_sync::full;
+        }
+        else if (sync_l == "no_meta_sync")
+        {
+            sync = germ::lmdb_sync::no_meta_sync;
+        }
+        else if (sync_l == "no_sync")
+        {
+            sync = germ::lmdb_sync::no_sync;
+        }
+        else
+        {
+            result = true;
+        }
+        sync_commits = std::stoull (tree_a.get<std::string> ("sync_commits"));
+        sync_interval = std::chrono::milliseconds (std::stoull (tree_a.get<std::string> ("sync_interval")));
+        no_readahead = tree_a.get<bool> ("no_readahead");
+        write_map = tree_a.get<bool> ("write_map");
+        map_size = std::stoull (tree_a.get<std::string> ("map_size"));
+        map_growth = std::stoull (tree_a.get<std::string> ("map_growth"));
+        result |= map_size == 0;
+    }
+    catch (std::logic_error const &)
+    {
+        result = true;
+    }
+    catch (std::runtime_error const &)
+    {
+        result = true;
+    }
+    return result;
+}
+
+germ::mdb_env::mdb_env (bool & error_a, boost::filesystem::path const & path_a, int max_dbs, germ::lmdb_config const & config_a) :
+config (config_a),
+transactions_open (0),
+resizing (false),
+map_full (false),
+sync_stopped (false),
+commits_since_sync (0),
+last_sync (std::chrono::steady_clock::now ()),
+readers_active (0),
+readers_created (0),
+readers_discarded (0)
 {
     boost::system::error_code error;
     if (!path_a.has_parent_path ())
@@ -78,27 +166,264 @@ germ::mdb_env::mdb_env (bool & error_a, boost::filesystem::path const & path_a,
     assert (status1 == 0);
     auto status2 (mdb_env_set_maxdbs (environment, max_dbs));
     assert (status2 == 0);
-    auto status3 (mdb_env_set_mapsize (environment, 1ULL * 1024 * 1024 * 1024 * 128)); // 128 Gigabyte
+    auto status3 (mdb_env_set_mapsize (environment, config.map_size));
     assert (status3 == 0);
     // It seems if there's ever more threads than mdb_env_set_maxreaders has read slots available, we get failures on transaction creation unless MDB_NOTLS is specified
     // This can happen if something like 256 io_threads are specified in the node config
-    auto status4 (mdb_env_open (environment, path_a.string ().c_str (), MDB_NOSUBDIR | MDB_NOTLS, 00600));
+    unsigned flags (MDB_NOSUBDIR | MDB_NOTLS);
+    switch (config.sync)
+    {
+        case germ::lmdb_sync::full:
+            break;
+        case germ::lmdb_sync::no_meta_sync:
+            flags |= MDB_NOMETASYNC;
+            break;
+        case germ::lmdb_sync::no_sync:
+            flags |= MDB_NOSYNC;
+            break;
+    }
+    flags |= config.no_readahead ? MDB_NORDAHEAD : 0;
+    flags |= config.write_map ? MDB_WRITEMAP : 0;
+    auto status4 (mdb_env_open (environment, path_a.string ().c_str (), flags, 00600));
     error_a = status4 != 0;
+    if (!error_a && config.sync == germ::lmdb_sync::no_sync && config.sync_interval.count () != 0)
+    {
+        sync_thread = std::thread ([this]() { sync_run (); });
+    }
 }
 
 germ::mdb_env::~mdb_env ()
 {
+    if (sync_thread.joinable ())
+    {
+        {
+            std::lock_guard<std::mutex> lock (sync_mutex);
+            sync_stopped = true;
+        }
+        sync_condition.notify_all ();
+        sync_thread.join ();
+    }
     if (environment != nullptr)
     {
+        for (auto i : read_pool)
+        {
+            mdb_txn_abort (i);
+        }
+        if (config.sync != germ::lmdb_sync::full)
+        {
+            mdb_env_sync (environment, 1);
+        }
         mdb_env_close (environment);
     }
 }
 
+germ::map_full_error::map_full_error () :
+std::runtime_error ("LMDB map full")
+{
+}
+
+bool germ::mdb_env::grow ()
+{
+    auto result (false);
+    if (config.map_growth != 0)
+    {
+        std::lock_guard<std::mutex> lock (resize_mutex);
+        MDB_envinfo info;
+        auto status1 (mdb_env_info (environment, &info));
+        assert (status1 == 0);
+        MDB_stat stats;
+        auto status2 (mdb_env_stat (environment, &stats));
+        assert (status2 == 0);
+        uint64_t used ((info.me_last_pgno + 1) * stats.ms_psize);
+        if (map_full || used + config.map_growth / 2 > info.me_mapsize)
+        {
+            resizing = true;
+            // LMDB only allows resizing while this process has no open transactions. One beginning from here on sees resizing and backs off, one counted earlier keeps the map as it is until a later grow
+            if (transactions_open == 0)
+            {
+                auto status3 (mdb_env_set_mapsize (environment, info.me_mapsize + config.map_growth));
+                assert (status3 == 0);
+                map_full = false;
+            }
+            else
+            {
+                result = true;
+            }
+            resizing = false;
+        }
+    }
+    return result;
+}
+
+void germ::mdb_env::transaction_begin ()
+{
+    ++transactions_open;
+    while (resizing)
+    {
+        // Uncounted until the resize is applied, which never waits on other transactions
+        --transactions_open;
+        while (resizing)
+        {
+            std::this_thread::yield ();
+        }
+        ++transactions_open;
+    }
+}
+
+void germ::mdb_env::transaction_end ()
+{
+    assert (transactions_open > 0);
+    --transactions_open;
+}
+
+void germ::mdb_env::write_status (int status_a)
+{
+    if (status_a == MDB_MAP_FULL)
+    {
+        map_full = true;
+        throw germ::map_full_error ();
+    }
+}
+
+void germ::mdb_env::committed ()
+{
+    if (config.sync == germ::lmdb_sync::no_sync)
+    {
+        std::lock_guard<std::mutex> lock (sync_mutex);
+        ++commits_since_sync;
+        if (config.sync_commits != 0 && commits_since_sync >= config.sync_commits)
+        {
+            auto status (mdb_env_sync (environment, 1));
+            assert (status == 0);
+            commits_since_sync = 0;
+            last_sync = std::chrono::steady_clock::now ();
+        }
+    }
+}
+
+void germ::mdb_env::sync_run ()
+{
+    std::unique_lock<std::mutex> lock (sync_mutex);
+    while (!sync_stopped)
+    {
+        auto due (last_sync + config.sync_interval);
+        if (std::chrono::steady_clock::now () >= due)
+        {
+            if (commits_since_sync != 0)
+            {
+                auto status (mdb_env_sync (environment, 1));
+                assert (status == 0);
+                commits_since_sync = 0;
+            }
+            last_sync = std::chrono::steady_clock::now ();
+        }
+        else
+        {
+            sync_condition.wait_until (lock, due);
+        }
+    }
+}
+
+void germ::mdb_env::on_commit (MDB_txn * transaction_a, std::function<void ()> const & action_a)
+{
+    on_end (transaction_a, [action_a](bool committed_a) {
+        if (committed_a)
+        {
+            action_a ();
+        }
+    });
+}
+
+void germ::mdb_env::on_end (MDB_txn * transaction_a, std::function<void (bool)> const & action_a)
+{
+    std::lock_guard<std::mutex> lock (commit_mutex);
+    commit_actions[transaction_a].push_back (action_a);
+}
+
+bool germ::mdb_env::uncommitted (MDB_txn * transaction_a)
+{
+    std::lock_guard<std::mutex> lock (commit_mutex);
+    return commit_actions.find (transaction_a) != commit_actions.end ();
+}
+
+void germ::mdb_env::finished (MDB_txn * transaction_a, MDB_txn * parent_a, bool committed_a)
+{
+    std::vector<std::function<void (bool)>> actions;
+    {
+        std::lock_guard<std::mutex> lock (commit_mutex);
+        auto existing (commit_actions.find (transaction_a));
+        if (existing == commit_actions.end ())
+            return;
+
+        actions.swap (existing->second);
+        commit_actions.erase (existing);
+        if (committed_a && parent_a != nullptr)
+        {
+            auto & pending (commit_actions[parent_a]);
+            pending.insert (pending.end (), actions.begin (), actions.end ());
+            return;
+        }
+    }
+    for (auto & i : actions)
+    {
+        i (committed_a);
+    }
+}
+
 germ::mdb_env::operator MDB_env * () const
 {
     return environment;
 }
 
+MDB_txn * germ::mdb_env::read_acquire ()
+{
+    // Only counted while handed out, a reset handle sitting in the pool doesn't hold back a resize
+    transaction_begin ();
+    MDB_txn * result (nullptr);
+    {
+        std::lock_guard<std::mutex> lock (read_pool_mutex);
+        if (!read_pool.empty ())
+        {
+            result = read_pool.back ();
+            read_pool.pop_back ();
+        }
+    }
+    if (result != nullptr)
+    {
+        auto status (mdb_txn_renew (result));
+        assert (status == 0);
+    }
+    else
+    {
+        auto status (mdb_txn_begin (environment, nullptr, MDB_RDONLY, &result));
+        assert (status == 0);
+        ++readers_created;
+    }
+    ++readers_active;
+    return result;
+}
+
+void germ::mdb_env::read_release (MDB_txn * transaction_a)
+{
+    --readers_active;
+    mdb_txn_reset (transaction_a);
+    {
+        std::unique_lock<std::mutex> lock (read_pool_mutex);
+        if (read_pool.size () < read_pool_max)
+        {
+            read_pool.push_back (transaction_a);
+        }
+        else
+        {
+            lock.unlock ();
+            mdb_txn_abort (transaction_a);
+            ++readers_discarded;
+        }
+    }
+    // The handle no longer reads the map so a resize can go ahead
+    transaction_end ();
+}
+
 germ::mdb_val::mdb_val () :
 value ({ 0, nullptr })
 {
@@ -154,16 +479,43 @@ germ::mdb_val::operator MDB_val const & () const
 }
 
 germ::transaction::transaction (germ::mdb_env & environment_a, MDB_txn * parent_a, bool write) :
-environment (environment_a)
+parent (parent_a),
+environment (environment_a),
+write_txn (write && parent_a == nullptr)
 {
+    environment_a.transaction_begin ();
     auto status (mdb_txn_begin (environment_a, parent_a, write ? 0 : MDB_RDONLY, &handle));
     assert (status == 0);
 }
 
 germ::transaction::~transaction ()
 {
+    if (handle != nullptr)
+    {
+        auto status (commit ());
+        assert (status == 0);
+    }
+}
+
+int germ::transaction::commit ()
+{
+    assert (handle != nullptr);
     auto status (mdb_txn_commit (handle));
-    assert (status == 0);
+    environment.finished (handle, parent, status == 0);
+    handle = nullptr;
+    environment.transaction_end ();
+    if (write_txn)
+    {
+        if (status == 0)
+        {
+            environment.committed ();
+        }
+        else if (status == MDB_MAP_FULL)
+        {
+            environment.map_full = true;
+        }
+    }
+    return status;
 }
 
 germ::transaction::operator MDB_txn * () const
@@ -171,6 +523,22 @@ germ::transaction::operator MDB_txn * () const
     return handle;
 }
 
+germ::read_transaction::read_transaction (germ::mdb_env & environment_a) :
+environment (environment_a),
+handle (environment_a.read_acquire ())
+{
+}
+
+germ::read_transaction::~read_transaction ()
+{
+    environment.read_release (handle);
+}
+
+germ::read_transaction::operator MDB_txn * () const
+{
+    return handle;
+}
+
 void germ::open_or_create (std::fstream & stream_a, std::string const & path_a)
 {
     stream_a.open (path_a, std::ios_base::in);
@@ -2,8 +2,14 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 #include <type_traits>
+#include <unordered_map>
 
 #include <boost/filesystem.hpp>
 #include <boost/iostreams/device/back_inserter.hpp>
@@ -102,16 +108,108 @@ bool fetch_object (T & object, boost::filesystem::path const & path_a, std::fstr
     return error;
 }
 
+/**
+ * How write transaction commits reach the disk
+ */
+enum class lmdb_sync : uint8_t
+{
+    full, // Every commit flushes data and meta pages
+    no_meta_sync, // MDB_NOMETASYNC, the meta page is flushed with the next commit
+    no_sync // MDB_NOSYNC, flushed every sync_commits commits or sync_interval, whichever comes first
+};
+
+/**
+ * Options used when opening an mdb_env
+ */
+class lmdb_config
+{
+public:
+    lmdb_config ();
+    void serialize_json (boost::property_tree::ptree &) const;
+    bool deserialize_json (boost::property_tree::ptree &);
+    germ::lmdb_sync sync;
+    /** Commits between flushes in no_sync mode, 0 disables the count */
+    uint64_t sync_commits;
+    /** Time between flushes in no_sync mode, 0 disables the timer */
+    std::chrono::milliseconds sync_interval;
+    /** MDB_NORDAHEAD, helps when the database is much larger than RAM */
+    bool no_readahead;
+    /** MDB_WRITEMAP, writes go straight to the memory map */
+    bool write_map;
+    /** Initial map size in bytes */
+    uint64_t map_size;
+    /** Bytes added to the map once free space falls below half this amount, 0 disables growth */
+    uint64_t map_growth;
+};
+
+/**
+ * Thrown when a write runs out of map space, nothing in the transaction can be committed so the caller aborts it and redoes the work once the map has grown
+ */
+class map_full_error : public std::runtime_error
+{
+public:
+    map_full_error ();
+};
+
 /**
  * RAII wrapper for MDB_env
  */
 class mdb_env
 {
 public:
-    mdb_env (bool &, boost::filesystem::path const &, int max_dbs = 128);
+    mdb_env (bool &, boost::filesystem::path const &, int max_dbs = 128, germ::lmdb_config const & = germ::lmdb_config ());
     ~mdb_env ();
     operator MDB_env * () const;
+    // Extends the map by map_growth if it's close to full or a write ran out of space, skipped while any transaction is open
+    // Called by the store's writer between its write transactions, the block processor for the ledger. Returns true if the map still needs to grow
+    bool grow ();
+    // Counts an open transaction without taking a lock, only yields while a resize is being applied
+    void transaction_begin ();
+    void transaction_end ();
+    // Flushes according to the sync mode, called after a write transaction commits
+    void committed ();
+    // Flushes every sync_interval in no_sync mode so an idle node doesn't keep commits unflushed
+    void sync_run ();
+    // Runs action_a once the transaction commits, it's dropped if the transaction doesn't commit
+    void on_commit (MDB_txn *, std::function<void ()> const &);
+    // Runs action_a with whether the transaction committed once it ends
+    void on_end (MDB_txn *, std::function<void (bool)> const &);
+    // True if the transaction has actions waiting for it to commit
+    bool uncommitted (MDB_txn *);
+    // Runs or drops the actions queued on a transaction that ended, a committed nested transaction hands them to its parent
+    void finished (MDB_txn *, MDB_txn *, bool);
+    // Renews a pooled read transaction or begins a new one if the pool is empty, counted as open until released
+    MDB_txn * read_acquire ();
+    // Resets a read transaction and keeps it for reuse while the pool has room
+    void read_release (MDB_txn *);
+    // Checks the status of a put or del, MDB_MAP_FULL marks the map full and throws germ::map_full_error as the transaction can't be used any more
+    void write_status (int);
     MDB_env * environment;
+    germ::lmdb_config config;
+    // Held by the thread resizing the map
+    std::mutex resize_mutex;
+    std::atomic<uint64_t> transactions_open;
+    // Set while a resize checks for open transactions and applies the new size, a transaction beginning meanwhile backs off until it's cleared
+    std::atomic<bool> resizing;
+    // Set when a write ran out of space, forces the next grow
+    std::atomic<bool> map_full;
+    std::mutex sync_mutex;
+    std::condition_variable sync_condition;
+    bool sync_stopped;
+    uint64_t commits_since_sync;
+    std::chrono::steady_clock::time_point last_sync;
+    std::thread sync_thread;
+    std::mutex commit_mutex;
+    std::unordered_map<MDB_txn *, std::vector<std::function<void (bool)>>> commit_actions;
+    std::mutex read_pool_mutex;
+    std::vector<MDB_txn *> read_pool;
+    /** Read transactions currently handed out */
+    std::atomic<uint64_t> readers_active;
+    /** Read transactions begun, each holds a reader slot until it's aborted */
+    std::atomic<uint64_t> readers_created;
+    /** Read transactions aborted because the pool was full */
+    std::atomic<uint64_t> readers_discarded;
+    static size_t constexpr read_pool_max = 64;
 };
 
 /**
@@ -143,7 +241,27 @@ public:
     transaction (germ::mdb_env &, MDB_txn *, bool);
     ~transaction ();
     operator MDB_txn * () const;
+    // Commits before destruction. MDB_MAP_FULL means nothing was written, the caller redoes the work once the map has grown
+    int commit ();
     MDB_txn * handle;
+    MDB_txn * parent;
     germ::mdb_env & environment;
+    // Top level write transaction, nested ones commit into their parent
+    bool write_txn;
+};
+
+/**
+ * RAII read-only transaction drawn from the environment's pool.
+ * Handles are reset on release and renewed on acquire so each one reads the latest committed snapshot
+ * without paying for mdb_txn_begin or a new reader slot.
+ */
+class read_transaction
+{
+public:
+    read_transaction (germ::mdb_env &);
+    ~read_transaction ();
+    operator MDB_txn * () const;
+    germ::mdb_env & environment;
+    MDB_txn * handle;
 };
 }
@@ -322,6 +322,7 @@ environment (transaction_a.environment)
     password.value_set (key);
     key.data = entry_get_raw (transaction_a, germ::wallet_store::wallet_key_special).key;
     wallet_key_mem.value_set (key);
+    index_load (transaction_a);
 }
 
 germ::wallet_store::wallet_store (bool & init_a, germ::kdf & kdf_a, germ::transaction & transaction_a, germ::account representative_a, unsigned fanout_a, std::string const & wallet_a) :
@@ -376,6 +377,20 @@ environment (transaction_a.environment)
     germ::raw_key key;
     key.data = entry_get_raw (transaction_a, germ::wallet_store::wallet_key_special).key;
     wallet_key_mem.value_set (key);
+    if (!init_a)
+    {
+        index_load (transaction_a);
+    }
+}
+
+void germ::wallet_store::index_load (MDB_txn * transaction_a)
+{
+    std::lock_guard<std::mutex> lock (index_mutex);
+    index.clear ();
+    for (auto i (begin (transaction_a)), n (end ()); i != n; ++i)
+    {
+        index.insert (i->first.uint256 ());
+    }
 }
 
 std::vector<germ::account> germ::wallet_store::accounts (MDB_txn * transaction_a)
@@ -435,6 +450,14 @@ void germ::wallet_store::erase (MDB_txn * transaction_a, germ::public_key const
 {
     auto status (mdb_del (transaction_a, handle, germ::mdb_val (pub), nullptr));
     assert (status == 0);
+    {
+        std::lock_guard<std::mutex> lock (index_mutex);
+        index.erase (pub);
+    }
+    if (index_observer)
+    {
+        index_observer (pub, false);
+    }
 }
 
 germ::wallet_value germ::wallet_store::entry_get_raw (MDB_txn * transaction_a, germ::public_key const & pub_a)
@@ -458,6 +481,18 @@ void germ::wallet_store::entry_put_raw (MDB_txn * transaction_a, germ::public_ke
 {
     auto status (mdb_put (transaction_a, handle, germ::mdb_val (pub_a), entry_a.val (), 0));
     assert (status == 0);
+    if (pub_a.number () >= special_count)
+    {
+        auto inserted (false);
+        {
+            std::lock_guard<std::mutex> lock (index_mutex);
+            inserted = index.insert (pub_a).second;
+        }
+        if (inserted && index_observer)
+        {
+            index_observer (pub_a, true);
+        }
+    }
 }
 
 germ::key_type germ::wallet_store::key_type (germ::wallet_value const & value_a)
@@ -539,7 +574,14 @@ bool germ::wallet_store::fetch (MDB_txn * transaction_a, germ::public_key const
 
 bool germ::wallet_store::exists (MDB_txn * transaction_a, germ::public_key const & pub)
 {
-    return find (transaction_a, pub) != end ();
+    {
+        std::lock_guard<std::mutex> lock (index_mutex);
+        if (index.find (pub) == index.end ())
+            return false;
+    }
+    // The index may hold a key written after the caller's snapshot, a point lookup confirms it
+    germ::mdb_val value;
+    return mdb_get (transaction_a, handle, germ::mdb_val (pub), value) == 0;
 }
 
 void germ::wallet_store::serialize_json (MDB_txn * transaction_a, std::string & string_a)
@@ -715,6 +757,10 @@ lock_observer ([](bool, bool) {}),
 store (init_a, node_a.wallets.kdf, transaction_a, node_a.config.random_representative (), node_a.config.password_fanout, wallet_a),
 node (node_a)
 {
+    if (!init_a)
+    {
+        metadata_load (transaction_a);
+    }
 }
 
 germ::wallet::wallet (bool & init_a, germ::transaction & transaction_a, germ::node & node_a, std::string const & wallet_a, std::string const & json) :
@@ -722,6 +768,10 @@ lock_observer ([](bool, bool) {}),
 store (init_a, node_a.wallets.kdf, transaction_a, node_a.config.random_representative (), node_a.config.password_fanout, wallet_a, json),
 node (node_a)
 {
+    if (!init_a)
+    {
+        metadata_load (transaction_a);
+    }
 }
 
 void germ::wallet::enter_initial_password ()
@@ -763,12 +813,22 @@ bool germ::wallet::enter_password (std::string const & password_a)
     return result;
 }
 
+void germ::wallet::lock ()
+{
+    germ::raw_key empty;
+    empty.data.clear ();
+    std::lock_guard<std::mutex> lock (signers_mutex);
+    store.password.value_set (empty);
+    signers.clear ();
+}
+
 germ::public_key germ::wallet::deterministic_insert (MDB_txn * transaction_a, bool generate_work_a)
 {
     germ::public_key key (0);
     if (store.valid_password (transaction_a))
     {
         key = store.deterministic_insert (transaction_a);
+        metadata_update (transaction_a, key);
         if (generate_work_a)
         {
             work_ensure (key, key);
@@ -790,6 +850,7 @@ germ::public_key germ::wallet::insert_adhoc (MDB_txn * transaction_a, germ::raw_
     if (store.valid_password (transaction_a))
     {
         key = store.insert_adhoc (transaction_a, key_a);
+        metadata_update (transaction_a, key);
         if (generate_work_a)
         {
             work_ensure (key, node.ledger.latest_root (transaction_a, key));
@@ -834,7 +895,13 @@ bool germ::wallet::import (std::string const & json_a, std::string const & passw
     germ::transaction transaction (store.environment, nullptr, true);
     if (!error)
     {
+        // Only the imported accounts change, the rest of the metadata stays as it is
+        auto accounts (temp->accounts (transaction));
         error = store.import (transaction, *temp);
+        for (auto & account : accounts)
+        {
+            metadata_update (transaction, account);
+        }
     }
     temp->destroy (transaction);
     return error;
@@ -850,6 +917,8 @@ void germ::wallet_store::destroy (MDB_txn * transaction_a)
 {
     auto status (mdb_drop (transaction_a, handle, 1));
     assert (status == 0);
+    std::lock_guard<std::mutex> lock (index_mutex);
+    index.clear ();
 }
 
 std::shared_ptr<germ::tx> germ::wallet::receive_action (germ::tx const & send_a, germ::account const & representative_a, germ::uint128_union const & amount_a, bool generate_work_a)
@@ -1058,6 +1127,140 @@ std::shared_ptr<germ::tx> germ::wallet::send_action (germ::account const & sourc
     return block;
 }
 
+std::vector<germ::send_result> germ::wallet::send_batch_action (std::vector<germ::send_item> const & items_a, bool generate_work_a)
+{
+    std::vector<germ::send_result> results (items_a.size (), germ::send_result{ germ::send_status::error, nullptr });
+    class chain
+    {
+    public:
+        germ::block_hash head;
+        germ::uint128_t balance;
+        germ::raw_key prv;
+    };
+    // Head and balance of each source as the batch's sends are appended to it
+    std::unordered_map<germ::account, chain> chains;
+    // New blocks in the order they have to be processed, with the key signing each
+    std::vector<std::pair<std::shared_ptr<germ::tx>, chain const *>> created;
+    auto has_ids (std::any_of (items_a.begin (), items_a.end (), [](germ::send_item const & item_a) { return item_a.id.is_initialized (); }));
+    {
+        germ::transaction transaction (store.environment, nullptr, has_ids);
+        auto valid (store.valid_password (transaction));
+        std::unordered_map<std::string, size_t> batch_ids;
+        for (size_t i (0), n (items_a.size ()); i < n; ++i)
+        {
+            auto & item (items_a[i]);
+            auto & result (results[i]);
+            if (!valid)
+            {
+                result.status = germ::send_status::locked;
+                continue;
+            }
+            boost::optional<germ::mdb_val> id_mdb_val;
+            if (item.id)
+            {
+                auto earlier (batch_ids.find (*item.id));
+                if (earlier != batch_ids.end ())
+                {
+                    result.status = germ::send_status::duplicate;
+                    result.block = results[earlier->second].block;
+                    continue;
+                }
+                id_mdb_val = germ::mdb_val (item.id->size (), const_cast<char *> (item.id->data ()));
+                germ::mdb_val existing;
+                auto status (mdb_get (transaction, node.wallets.send_action_ids, *id_mdb_val, existing));
+                if (status == 0)
+                {
+                    std::shared_ptr<germ::tx> block (node.store.block_get (transaction, existing.uint256 ()));
+                    if (block != nullptr)
+                    {
+                        result.status = germ::send_status::duplicate;
+                        result.block = block;
+                        node.network.republish_block (transaction, block);
+                        continue;
+                    }
+                }
+                else if (status != MDB_NOTFOUND)
+                {
+                    continue;
+                }
+            }
+            auto existing (chains.find (item.source));
+            if (existing == chains.end ())
+            {
+                chain chain_l;
+                chain_l.head = node.ledger.latest (transaction, item.source);
+                if (store.find (transaction, item.source) == store.end () || chain_l.head.is_zero ())
+                {
+                    result.status = germ::send_status::not_found;
+                    continue;
+                }
+                auto error (store.fetch (transaction, item.source, chain_l.prv));
+                assert (!error);
+                chain_l.balance = node.ledger.account_balance (transaction, item.source);
+                existing = chains.insert (std::make_pair (item.source, chain_l)).first;
+            }
+            auto & chain_l (existing->second);
+            if (chain_l.balance.is_zero () || chain_l.balance < item.amount)
+            {
+                result.status = germ::send_status::insufficient_balance;
+                continue;
+            }
+            germ::tx_message tx_info (200, "eeeeeeeee", 40, 10);
+            auto block (std::make_shared<germ::tx> (chain_l.head, item.destination, item.source, item.source, germ::amount (chain_l.balance - item.amount), tx_info, 0));
+            if (id_mdb_val && mdb_put (transaction, node.wallets.send_action_ids, *id_mdb_val, germ::mdb_val (block->hash ()), 0) != 0)
+            {
+                continue;
+            }
+            chain_l.head = block->hash ();
+            chain_l.balance -= item.amount;
+            result.status = germ::send_status::sent;
+            result.block = block;
+            created.push_back (std::make_pair (block, &chain_l));
+            // Only a built send answers later items with the same id, one that failed leaves them to be tried
+            if (item.id)
+            {
+                batch_ids[*item.id] = i;
+            }
+        }
+    }
+    // Hashes don't cover signatures so the chains were built unsigned and signing is shared with the signer pool
+    size_t constexpr sign_chunk (64);
+    auto size (created.size ());
+    node.signer.parallel ((size + sign_chunk - 1) / sign_chunk, [&created, size](size_t chunk_a) {
+        auto end (std::min (size, (chunk_a + 1) * sign_chunk));
+        for (auto i (chunk_a * sign_chunk); i < end; ++i)
+        {
+            auto & block (created[i].first);
+            block->signature_set (germ::sign_message (created[i].second->prv, block->account (), block->hash ()));
+        }
+    });
+    for (auto & i : created)
+    {
+        if (node.block_processor.full ())
+        {
+            node.block_processor.flush ();
+        }
+        node.process_active (i.first);
+    }
+    node.block_processor.flush ();
+    germ::read_transaction transaction (node.store.environment);
+    for (auto & i : results)
+    {
+        if (i.status == germ::send_status::sent && !node.store.block_exists (transaction, i.block->hash ()))
+        {
+            i.status = germ::send_status::rejected;
+        }
+    }
+    if (generate_work_a)
+    {
+        for (auto & i : chains)
+        {
+            work_ensure (i.first, i.second.head);
+        }
+    }
+    return results;
+}
+
 bool germ::wallet::change_sync (germ::account const & source_a, germ::account const & representative_a)
 {
     std::promise<bool> result;
@@ -1113,6 +1316,14 @@ void germ::wallet::send_async (germ::account const & source_a, germ::account con
     });
 }
 
+void germ::wallet::send_batch_async (std::vector<germ::send_item> const & items_a, std::function<void(std::vector<germ::send_result> const &)> const & action_a, bool generate_work_a)
+{
+    this->node.wallets.queue_wallet_action (germ::wallets::high_priority, [this, items_a, action_a, generate_work_a]() {
+        auto results (send_batch_action (items_a, generate_work_a));
+        action_a (results);
+    });
+}
+
 // Update work for account if latest root is root_a
 void germ::wallet::work_update (MDB_txn * transaction_a, germ::account const & account_a, germ::block_hash const & root_a, uint64_t work_a)
 {
@@ -1148,24 +1359,28 @@ bool germ::wallet::search_pending ()
     }
 
     BOOST_LOG (node.log) << "Beginning pending block search";
+    // Only accounts flagged with receivable blocks are visited, watch-only accounts are never flagged
+    auto accounts (receivable_list ());
     germ::transaction transaction_pend (node.store.environment, nullptr, false);
-    for (auto i (store.begin (transaction_pend)), n (store.end ()); i != n; ++i)
+    for (auto & account : accounts)
     {
-        germ::account account (i->first.uint256 ());
-        // Don't search pending for watch-only accounts
-        if (germ::wallet_value (i->second).key.is_zero ())
+        if (!store.exists (transaction_pend, account))
             continue;
 
-        for (auto j (node.store.pending_begin (transaction_pend, germ::pending_key (account, 0))), m (node.store.pending_begin (transaction_pend, germ::pending_key (account.number () + 1, 0))); j != m; ++j)
+        auto receivable (node.store.receivable_get (transaction_pend, account));
+        if (receivable.count != 0 && receivable.total.number () >= node.config.receive_minimum.number ())
         {
-            germ::pending_key key (j->first);
-            auto hash (key.hash);
-            germ::pending_info pending (j->second);
-            auto amount (pending.amount.number ());
-            if (node.config.receive_minimum.number () <= amount)
+            for (auto j (node.store.pending_begin (transaction_pend, germ::pending_key (account, 0))), m (node.store.pending_begin (transaction_pend, germ::pending_key (account.number () + 1, 0))); j != m; ++j)
             {
-                BOOST_LOG (node.log) << boost::str (boost::format ("Found a pending block %1% for account %2%") % hash.to_string () % pending.source.to_account ());
-                node.block_confirm (node.store.block_get (transaction_pend, hash));
+                germ::pending_key key (j->first);
+                auto hash (key.hash);
+                germ::pending_info pending (j->second);
+                auto amount (pending.amount.number ());
+                if (node.config.receive_minimum.number () <= amount)
+                {
+                    BOOST_LOG (node.log) << boost::str (boost::format ("Found a pending block %1% for account %2%") % hash.to_string () % pending.source.to_account ());
+                    node.block_confirm (node.store.block_get (transaction_pend, hash));
+                }
             }
         }
     }
@@ -1173,6 +1388,68 @@ bool germ::wallet::search_pending ()
     return result;
 }
 
+void germ::wallet::metadata_load (MDB_txn * transaction_a)
+{
+    {
+        std::lock_guard<std::mutex> lock (metadata_mutex);
+        representatives.clear ();
+        receivable.clear ();
+    }
+    // Only accounts with flags are visited, most keys have neither weight nor receivable blocks
+    for (germ::store_iterator i (transaction_a, node.wallets.metadata), n (nullptr); i != n; ++i)
+    {
+        germ::account account (i->first.uint256 ());
+        {
+            std::lock_guard<std::mutex> lock (store.index_mutex);
+            if (store.index.find (account) == store.index.end ())
+                continue;
+        }
+        metadata_apply (transaction_a, account, *reinterpret_cast<uint8_t const *> (i->second.data ()));
+    }
+}
+
+void germ::wallet::metadata_update (MDB_txn * transaction_a, germ::account const & account_a)
+{
+    metadata_apply (transaction_a, account_a, node.wallets.metadata_put (transaction_a, account_a));
+}
+
+void germ::wallet::metadata_apply (MDB_txn * transaction_a, germ::account const & account_a, uint8_t flags_a)
+{
+    // Zero for watch-only accounts and accounts no longer held
+    auto held (!store.entry_get_raw (transaction_a, account_a).key.is_zero ());
+    auto weighted (held && (flags_a & germ::wallets::metadata_weighted) != 0);
+    auto pending (held && (flags_a & germ::wallets::metadata_receivable) != 0);
+    std::lock_guard<std::mutex> lock (metadata_mutex);
+    if (weighted)
+    {
+        representatives.insert (account_a);
+    }
+    else
+    {
+        representatives.erase (account_a);
+    }
+    if (pending)
+    {
+        receivable.insert (account_a);
+    }
+    else
+    {
+        receivable.erase (account_a);
+    }
+}
+
+std::vector<germ::account> germ::wallet::representatives_list ()
+{
+    std::lock_guard<std::mutex> lock (metadata_mutex);
+    return std::vector<germ::account> (representatives.begin (), representatives.end ());
+}
+
+std::vector<germ::account> germ::wallet::receivable_list ()
+{
+    std::lock_guard<std::mutex> lock (metadata_mutex);
+    return std::vector<germ::account> (receivable.begin (), receivable.end ());
+}
+
 void germ::wallet::init_free_accounts (MDB_txn * transaction_a)
 {
     free_accounts.clear ();
@@ -1204,12 +1481,10 @@ germ::public_key germ::wallet::change_seed (MDB_txn * transaction_a, germ::raw_k
         else
         {
             // Check if there are pending blocks for account
-            germ::account end (pair.pub.number () + 1);
-            for (auto ii (node.store.pending_begin (transaction_a, germ::pending_key (pair.pub, 0))), nn (node.store.pending_begin (transaction_a, germ::pending_key (end, 0))); ii != nn; ++ii)
+            if (node.store.receivable_get (transaction_a, pair.pub).count != 0)
             {
                 count = i;
                 n = i + 64 + (i / 64);
-                break;
             }
         }
     }
@@ -1249,6 +1524,9 @@ thread ([this]() { do_wallet_actions (); })
     germ::transaction transaction (node.store.environment, nullptr, true);
     auto status (mdb_dbi_open (transaction, nullptr, MDB_CREATE, &handle));
     status |= mdb_dbi_open (transaction, "send_action_ids", MDB_CREATE, &send_action_ids);
+    // Wallets from before the flags were kept have them rebuilt once from the ledger
+    auto metadata_missing (mdb_dbi_open (transaction, "wallet_metadata", 0, &metadata) == MDB_NOTFOUND);
+    status |= mdb_dbi_open (transaction, "wallet_metadata", MDB_CREATE, &metadata);
     assert (status == 0);
     std::string beginning (germ::uint256_union (0).to_string ());
     std::string end ((germ::uint256_union (germ::uint256_t (0) - germ::uint256_t (1))).to_string ());
@@ -1262,6 +1540,14 @@ thread ([this]() { do_wallet_actions (); })
         auto wallet (std::make_shared<germ::wallet> (error, transaction, node_a, text));
         if (!error)
         {
+            if (metadata_missing)
+            {
+                for (auto & account : wallet->store.accounts (transaction))
+                {
+                    wallet->metadata_update (transaction, account);
+                }
+            }
+            holders_add (id, *wallet);
             node_a.background ([wallet]() {
                 wallet->enter_initial_password ();
             });
@@ -1301,6 +1587,7 @@ std::shared_ptr<germ::wallet> germ::wallets::create (germ::uint256_union const &
     }
     if (!error)
     {
+        holders_add (id_a, *result);
         items[id_a] = result;
         node.background ([result]() {
             result->enter_initial_password ();
@@ -1338,6 +1625,18 @@ void germ::wallets::destroy (germ::uint256_union const & id_a)
     auto wallet (existing->second);
     items.erase (existing);
     wallet->store.destroy (transaction);
+    std::lock_guard<std::mutex> lock (holders_mutex);
+    for (auto i (holders.begin ()), n (holders.end ()); i != n;)
+    {
+        if (i->second == id_a)
+        {
+            i = holders.erase (i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
 }
 
 void germ::wallets::do_wallet_actions ()
@@ -1375,27 +1674,68 @@ void germ::wallets::foreach_representative (MDB_txn * transaction_a, std::functi
     for (auto i (items.begin ()), n (items.end ()); i != n; ++i)
     {
         auto & wallet (*i->second);
-        for (auto j (wallet.store.begin (transaction_a)), m (wallet.store.end ()); j != m; ++j)
+        // Keys are only decrypted for accounts with weight, not for every account in the wallet
+        auto representatives (wallet.representatives_list ());
+        if (representatives.empty ())
+            continue;
+
+        std::lock_guard<std::mutex> lock (wallet.signers_mutex);
+        if (!wallet.store.valid_password (transaction_a))
         {
-            germ::account account (j->first.uint256 ());
-            if (node.ledger.weight (transaction_a, account).is_zero ())
+            // Locked some way other than wallet::lock, keys from before can't be used any more
+            wallet.signers.clear ();
+            static auto last_log = std::chrono::steady_clock::time_point ();
+            if (last_log < std::chrono::steady_clock::now () - std::chrono::seconds (60))
+            {
+                last_log = std::chrono::steady_clock::now ();
+                BOOST_LOG (node.log) << boost::str (boost::format ("Representative locked inside wallet %1%") % i->first.to_string ());
+            }
+            continue;
+        }
+        for (auto & account : representatives)
+        {
+            if (!wallet.store.exists (transaction_a, account) || node.ledger.weight (transaction_a, account).is_zero ())
                 continue;
 
-            if (wallet.store.valid_password (transaction_a))
+            germ::raw_key prv;
+            if (!wallet.signers.find (account, prv))
             {
-                germ::raw_key prv;
-                auto error (wallet.store.fetch (transaction_a, j->first.uint256 (), prv));
+                auto error (wallet.store.fetch (transaction_a, account, prv));
                 assert (!error);
-                action_a (j->first.uint256 (), prv);
+                wallet.signers.insert (account, prv);
+                node.stats.inc (germ::stat::type::vote, germ::stat::detail::vote_key_decrypt, germ::stat::dir::out);
             }
-            else
+            action_a (account, prv);
+        }
+    }
+}
+
+void germ::wallets::sign (MDB_txn * transaction_a, std::vector<std::shared_ptr<germ::vote>> const & votes_a)
+{
+    std::vector<uint8_t> signed_l (votes_a.size (), 0);
+    for (auto i (items.begin ()), n (items.end ()); i != n; ++i)
+    {
+        auto & wallet (*i->second);
+        std::lock_guard<std::mutex> lock (wallet.signers_mutex);
+        if (wallet.store.valid_password (transaction_a))
+        {
+            wallet.signers.sign (node.signer, votes_a, signed_l);
+        }
+    }
+    for (size_t j (0), m (votes_a.size ()); j < m; ++j)
+    {
+        auto & vote (*votes_a[j]);
+        for (auto i (items.begin ()), n (items.end ()); !signed_l[j] && i != n; ++i)
+        {
+            auto & wallet (*i->second);
+            std::lock_guard<std::mutex> lock (wallet.signers_mutex);
+            germ::raw_key prv;
+            if (wallet.store.exists (transaction_a, vote.account) && !wallet.store.fetch (transaction_a, vote.account, prv))
             {
-                static auto last_log = std::chrono::steady_clock::time_point ();
-                if (last_log < std::chrono::steady_clock::now () - std::chrono::seconds (60))
-                {
-                    last_log = std::chrono::steady_clock::now ();
-                    BOOST_LOG (node.log) << boost::str (boost::format ("Representative locked inside wallet %1%") % i->first.to_string ());
-                }
+                vote.signature = germ::sign_message (prv, vote.account, vote.hash ());
+                signed_l[j] = 1;
+                node.stats.inc (germ::stat::type::vote, germ::stat::detail::vote_key_decrypt, germ::stat::dir::out);
+                node.stats.inc (germ::stat::type::vote, germ::stat::detail::vote_signed, germ::stat::dir::out);
             }
         }
     }
@@ -1404,9 +1744,113 @@ void germ::wallets::foreach_representative (MDB_txn * transaction_a, std::functi
 bool germ::wallets::exists (MDB_txn * transaction_a, germ::public_key const & account_a)
 {
     auto result (false);
-    for (auto i (items.begin ()), n (items.end ()); !result && i != n; ++i)
+    auto wallets_l (holding (account_a));
+    for (auto i (wallets_l.begin ()), n (wallets_l.end ()); !result && i != n; ++i)
     {
-        result = i->second->store.exists (transaction_a, account_a);
+        result = (*i)->store.exists (transaction_a, account_a);
+    }
+    return result;
+}
+
+void germ::wallets::ledger_update (MDB_txn * transaction_a, germ::account const & account_a)
+{
+    {
+        std::lock_guard<std::mutex> lock (holders_mutex);
+        if (holders.find (account_a) == holders.end ())
+            return;
+    }
+    metadata_put (transaction_a, account_a);
+}
+
+void germ::wallets::ledger_updated (MDB_txn * transaction_a, germ::account const & account_a)
+{
+    auto wallets_l (holding (account_a));
+    if (wallets_l.empty ())
+        return;
+
+    auto flags (metadata_get (transaction_a, account_a));
+    for (auto & wallet : wallets_l)
+    {
+        wallet->metadata_apply (transaction_a, account_a, flags);
+    }
+}
+
+uint8_t germ::wallets::metadata_get (MDB_txn * transaction_a, germ::account const & account_a)
+{
+    uint8_t result (0);
+    germ::mdb_val value;
+    auto status (mdb_get (transaction_a, metadata, germ::mdb_val (account_a), value));
+    if (status == 0)
+    {
+        result = *reinterpret_cast<uint8_t const *> (value.data ());
+    }
+    return result;
+}
+
+uint8_t germ::wallets::metadata_put (MDB_txn * transaction_a, germ::account const & account_a)
+{
+    uint8_t result (0);
+    if (!node.ledger.weight (transaction_a, account_a).is_zero ())
+    {
+        result |= metadata_weighted;
+    }
+    if (node.store.receivable_get (transaction_a, account_a).count != 0)
+    {
+        result |= metadata_receivable;
+    }
+    if (result != metadata_get (transaction_a, account_a))
+    {
+        // Accounts without flags aren't kept, loading only visits flagged accounts
+        auto status (result != 0 ? mdb_put (transaction_a, metadata, germ::mdb_val (account_a), germ::mdb_val (sizeof (result), &result), 0) : mdb_del (transaction_a, metadata, germ::mdb_val (account_a), nullptr));
+        node.store.environment.write_status (status);
+        assert (status == 0);
+    }
+    return result;
+}
+
+void germ::wallets::holders_add (germ::uint256_union const & id_a, germ::wallet & wallet_a)
+{
+    std::lock_guard<std::mutex> lock (holders_mutex);
+    {
+        std::lock_guard<std::mutex> index_lock (wallet_a.store.index_mutex);
+        for (auto & account : wallet_a.store.index)
+        {
+            holders.insert (std::make_pair (account, id_a));
+        }
+    }
+    wallet_a.store.index_observer = [this, id_a](germ::account const & account_a, bool added_a) {
+        std::lock_guard<std::mutex> lock (holders_mutex);
+        if (added_a)
+        {
+            holders.insert (std::make_pair (account_a, id_a));
+        }
+        else
+        {
+            auto range (holders.equal_range (account_a));
+            for (auto i (range.first); i != range.second; ++i)
+            {
+                if (i->second == id_a)
+                {
+                    holders.erase (i);
+                    break;
+                }
+            }
+        }
+    };
+}
+
+std::vector<std::shared_ptr<germ::wallet>> germ::wallets::holding (germ::account const & account_a)
+{
+    std::vector<std::shared_ptr<germ::wallet>> result;
+    std::lock_guard<std::mutex> lock (holders_mutex);
+    auto range (holders.equal_range (account_a));
+    for (auto i (range.first); i != range.second; ++i)
+    {
+        auto existing (items.find (i->second));
+        if (existing != items.end ())
+        {
+            result.push_back (existing->second);
+        }
     }
     return result;
 }
@@ -1426,6 +1870,8 @@ void germ::wallets::stop ()
 
 germ::uint128_t const germ::wallets::generate_priority = std::numeric_limits<germ::uint128_t>::max ();
 germ::uint128_t const germ::wallets::high_priority = std::numeric_limits<germ::uint128_t>::max () - 1;
+uint8_t const germ::wallets::metadata_weighted = 1;
+uint8_t const germ::wallets::metadata_receivable = 2;
 
 germ::store_iterator germ::wallet_store::begin (MDB_txn * transaction_a)
 {
@@ -4,6 +4,7 @@
 #include <src/common.hpp>
 #include <src/node/common.hpp>
 #include <src/node/openclwork.hpp>
+#include <src/node/signer.hpp>
 
 #include <mutex>
 #include <queue>
@@ -117,8 +118,43 @@ public:
     germ::mdb_env & environment;
     MDB_dbi handle;
     std::recursive_mutex mutex;
+    void index_load (MDB_txn *);
+    // Accounts held, mirrored in memory so an account the wallet doesn't hold is rejected without reading the database.
+    // Updated as keys are written, so it can be ahead of a reader's snapshot and a hit is checked in the caller's transaction.
+    std::unordered_set<germ::account> index;
+    std::mutex index_mutex;
+    // Called with an account and whether it was added to or removed from the index
+    std::function<void(germ::account const &, bool)> index_observer;
 };
 class node;
+enum class send_status : uint8_t
+{
+    sent,
+    // The id was used before, the result holds the earlier send
+    duplicate,
+    // Built but not accepted into the ledger
+    rejected,
+    locked,
+    // Source isn't in the wallet or has no blocks
+    not_found,
+    insufficient_balance,
+    error
+};
+// One payment of a send batch, an id makes it idempotent across batches and send_action
+class send_item
+{
+public:
+    germ::account source;
+    germ::account destination;
+    germ::uint128_t amount;
+    boost::optional<std::string> id;
+};
+class send_result
+{
+public:
+    germ::send_status status;
+    std::shared_ptr<germ::tx> block;
+};
 // A wallet is a set of account keys encrypted by a common encryption key
 class wallet : public std::enable_shared_from_this<germ::wallet>
 {
@@ -126,11 +162,15 @@ public:
     std::shared_ptr<germ::tx> change_action (germ::account const &, germ::account const &, bool = true);
     std::shared_ptr<germ::tx> receive_action (germ::tx const &, germ::account const &, germ::uint128_union const &, bool = true);
     std::shared_ptr<germ::tx> send_action (germ::account const &, germ::account const &, germ::uint128_t const &, bool = true, boost::optional<std::string> = {});
+    // Sends are chained per source account in the order given, results are in the same order
+    std::vector<germ::send_result> send_batch_action (std::vector<germ::send_item> const &, bool = true);
     wallet (bool &, germ::transaction &, germ::node &, std::string const &);
     wallet (bool &, germ::transaction &, germ::node &, std::string const &, std::string const &);
     void enter_initial_password ();
     bool valid_password ();
     bool enter_password (std::string const &);
+    // Forgets the password and wipes the cached representative keys
+    void lock ();
     germ::public_key insert_adhoc (germ::raw_key const &, bool = true);
     germ::public_key insert_adhoc (MDB_txn *, germ::raw_key const &, bool = true);
     void insert_watch (MDB_txn *, germ::public_key const &);
@@ -145,15 +185,33 @@ public:
     void receive_async (std::shared_ptr<germ::tx>, germ::account const &, germ::uint128_t const &, std::function<void(std::shared_ptr<germ::tx>)> const &, bool = true);
     germ::block_hash send_sync (germ::account const &, germ::account const &, germ::uint128_t const &);
     void send_async (germ::account const &, germ::account const &, germ::uint128_t const &, std::function<void(std::shared_ptr<germ::tx>)> const &, bool = true, boost::optional<std::string> = {});
+    void send_batch_async (std::vector<germ::send_item> const &, std::function<void(std::vector<germ::send_result> const &)> const &, bool = true);
     void work_apply (germ::account const &, std::function<void(uint64_t)>);
     void work_cache_blocking (germ::account const &, germ::block_hash const &);
     void work_update (MDB_txn *, germ::account const &, germ::block_hash const &, uint64_t);
     void work_ensure (germ::account const &, germ::block_hash const &);
     bool search_pending ();
     void init_free_accounts (MDB_txn *);
+    // Fills the account metadata from the flags the wallets keep, without reading the ledger for every key
+    void metadata_load (MDB_txn *);
+    // Refreshes and stores the metadata of one account after its keys or ledger entries changed, called in a write transaction
+    void metadata_update (MDB_txn *, germ::account const &);
+    // Sets the metadata of one account from flags already read
+    void metadata_apply (MDB_txn *, germ::account const &, uint8_t);
+    std::vector<germ::account> representatives_list ();
+    std::vector<germ::account> receivable_list ();
     /** Changes the wallet seed and returns the first account */
     germ::public_key change_seed (MDB_txn * transaction_a, germ::raw_key const & prv_a);
     std::unordered_set<germ::account> free_accounts;
+    // Accounts with voting weight and accounts with receivable blocks, watch-only accounts are left out of both.
+    // Entries may be stale after a key is removed so users check the account again before acting on it.
+    std::unordered_set<germ::account> representatives;
+    std::unordered_set<germ::account> receivable;
+    std::mutex metadata_mutex;
+    // Representative keys decrypted for voting while the wallet is unlocked
+    germ::signer_cache signers;
+    // Held while the password is checked and signers is filled or used, so a key can't be cached after lock wiped them
+    std::mutex signers_mutex;
     std::function<void(bool, bool)> lock_observer;
     germ::wallet_store store;
     germ::node & node;
@@ -172,7 +230,19 @@ public:
     void do_wallet_actions ();
     void queue_wallet_action (germ::uint128_t const &, std::function<void()> const &);
     void foreach_representative (MDB_txn *, std::function<void(germ::public_key const &, germ::raw_key const &)> const &);
+    // Signs votes for representatives from the cached keys, keys that couldn't be cached are decrypted for the call
+    void sign (MDB_txn *, std::vector<std::shared_ptr<germ::vote>> const &);
     bool exists (MDB_txn *, germ::public_key const &);
+    // Called in the write transaction for the accounts touched by a block added to the ledger, stores their new flags
+    void ledger_update (MDB_txn *, germ::account const &);
+    // Called once that transaction committed, refreshes the metadata of the wallets holding the account
+    void ledger_updated (MDB_txn *, germ::account const &);
+    uint8_t metadata_get (MDB_txn *, germ::account const &);
+    // Reads the flags of an account from the ledger and stores them, called in a write transaction
+    uint8_t metadata_put (MDB_txn *, germ::account const &);
+    // Adds a loaded wallet's accounts to holders and keeps them in step with its index
+    void holders_add (germ::uint256_union const &, germ::wallet &);
+    std::vector<std::shared_ptr<germ::wallet>> holding (germ::account const &);
     void stop ();
     std::function<void(bool)> observer;
     std::unordered_map<germ::uint256_union, std::shared_ptr<germ::wallet>> items;
@@ -182,6 +252,13 @@ public:
     germ::kdf kdf;
     MDB_dbi handle;
     MDB_dbi send_action_ids;
+    // Flags of the accounts held by any wallet, kept so opening a wallet doesn't read the ledger for every key
+    MDB_dbi metadata;
+    static uint8_t const metadata_weighted;
+    static uint8_t const metadata_receivable;
+    // Wallets holding each account, so a ledger update looks the account up once rather than in every wallet
+    std::unordered_multimap<germ::account, germ::uint256_union> holders;
+    std::mutex holders_mutex;
     germ::node & node;
     bool stopped;
     std::thread thread;
@@ -5,4 +5,8 @@
 namespace germ
 {
 boost::filesystem::path app_path ();
+// Allocates zeroed whole pages kept out of swap where the process limit allows, for holding private keys. Returns nullptr
+// if the pages can't be mapped
+void * locked_alloc (size_t);
+void locked_free (void *, size_t);
 }
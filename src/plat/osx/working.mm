@@ -2,6 +2,8 @@
 
 #include <Foundation/Foundation.h>
 
+#include <sys/mman.h>
+
 namespace germ
 {
 boost::filesystem::path app_path ()
@@ -12,4 +14,25 @@ boost::filesystem::path app_path ()
     [dir_string release];
     return result;
 }
+
+void * locked_alloc (size_t size_a)
+{
+    auto result (mmap (nullptr, size_a, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0));
+    if (result != MAP_FAILED)
+    {
+        // Past RLIMIT_MEMLOCK the pages stay usable, they just aren't pinned
+        mlock (result, size_a);
+    }
+    else
+    {
+        result = nullptr;
+    }
+    return result;
+}
+
+void locked_free (void * data_a, size_t size_a)
+{
+    munlock (data_a, size_a);
+    munmap (data_a, size_a);
+}
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <src/node/working.hpp>
 
 #include <pwd.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 
 namespace germ
@@ -12,4 +13,25 @@ boost::filesystem::path app_path ()
     boost::filesystem::path result (entry->pw_dir);
     return result;
 }
+
+void * locked_alloc (size_t size_a)
+{
+    auto result (mmap (nullptr, size_a, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (result != MAP_FAILED)
+    {
+        // Past RLIMIT_MEMLOCK the pages stay usable, they just aren't pinned
+        mlock (result, size_a);
+    }
+    else
+    {
+        result = nullptr;
+    }
+    return result;
+}
+
+void locked_free (void * data_a, size_t size_a)
+{
+    munlock (data_a, size_a);
+    munmap (data_a, size_a);
+}
 }
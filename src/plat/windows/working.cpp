@@ -18,4 +18,21 @@ boost::filesystem::path app_path ()
     }
     return result;
 }
+
+void * locked_alloc (size_t size_a)
+{
+    auto result (VirtualAlloc (nullptr, size_a, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+    if (result != nullptr)
+    {
+        // Past the working set limit the pages stay usable, they just aren't pinned
+        VirtualLock (result, size_a);
+    }
+    return result;
+}
+
+void locked_free (void * data_a, size_t size_a)
+{
+    VirtualUnlock (data_a, size_a);
+    VirtualFree (data_a, 0, MEM_RELEASE);
+}
 }
\ No newline at end of file
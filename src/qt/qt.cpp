@@ -1548,9 +1548,7 @@ wallet (wallet_a)
         if (this->wallet.wallet_m->store.valid_password (transaction))
         {
             // lock wallet
-            germ::raw_key empty;
-            empty.data.clear ();
-            this->wallet.wallet_m->store.password.value_set (empty);
+            this->wallet.wallet_m->lock ();
             update_locked (true, true);
             lock_toggle->setText ("Unlock");
             password->setEnabled (1);
@@ -162,6 +162,187 @@ TEST (store, load)
 	}
 }
 
+TEST (store, ingest_durability)
+{
+	auto ingest ([](germ::lmdb_config const & config_a) {
+		bool init (false);
+		germ::block_store store (init, germ::unique_path (), 128, config_a);
+		EXPECT_FALSE (init);
+		auto begin (std::chrono::steady_clock::now ());
+		for (auto i (0); i != 10000; ++i)
+		{
+			germ::transaction transaction (store.environment, nullptr, true);
+			for (auto j (0); j != 10; ++j)
+			{
+				germ::block_hash hash;
+				germ::random_pool.GenerateBlock (hash.bytes.data (), hash.bytes.size ());
+				store.account_put (transaction, hash, germ::account_info ());
+			}
+		}
+		return std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - begin);
+	});
+	germ::lmdb_config full;
+	germ::lmdb_config no_meta_sync;
+	no_meta_sync.sync = germ::lmdb_sync::no_meta_sync;
+	germ::lmdb_config no_sync;
+	no_sync.sync = germ::lmdb_sync::no_sync;
+	germ::lmdb_config write_map (no_sync);
+	write_map.write_map = true;
+	// Start small so growth is exercised along the way
+	germ::lmdb_config growth (no_sync);
+	growth.map_size = 1024 * 1024;
+	growth.map_growth = 1024 * 1024;
+	std::cerr << "full: " << ingest (full).count () << "ms" << std::endl;
+	std::cerr << "no_meta_sync: " << ingest (no_meta_sync).count () << "ms" << std::endl;
+	std::cerr << "no_sync: " << ingest (no_sync).count () << "ms" << std::endl;
+	std::cerr << "no_sync write_map: " << ingest (write_map).count () << "ms" << std::endl;
+	std::cerr << "no_sync growth: " << ingest (growth).count () << "ms" << std::endl;
+}
+
+TEST (vote_tally, representatives)
+{
+	auto block1 (std::make_shared<germ::tx> (0, 1, 0, germ::test_genesis_key.pub, 100, germ::tx_message (), 0, germ::test_genesis_key.prv, germ::test_genesis_key.pub));
+	auto block2 (std::make_shared<germ::tx> (0, 2, 0, germ::test_genesis_key.pub, 100, germ::tx_message (), 0, germ::test_genesis_key.prv, germ::test_genesis_key.pub));
+	for (auto count : { 1000, 10000 })
+	{
+		germ::system system (24000, 1);
+		auto & node (*system.nodes[0]);
+		std::vector<germ::account> reps;
+		{
+			germ::transaction transaction (node.store.environment, nullptr, true);
+			for (auto i (0); i != count; ++i)
+			{
+				germ::account rep;
+				germ::random_pool.GenerateBlock (rep.bytes.data (), rep.bytes.size ());
+				node.store.representation_put (transaction, rep, 1000);
+				reps.push_back (rep);
+			}
+		}
+		germ::read_transaction transaction (node.store.environment);
+		// Every representative votes once, then switches to the other block
+		germ::votes votes (block1);
+		auto begin (std::chrono::steady_clock::now ());
+		for (auto & block : { block1, block2 })
+		{
+			for (auto & rep : reps)
+			{
+				votes.rep_votes[rep] = block;
+				node.ledger.tally (transaction, votes);
+			}
+		}
+		auto recompute (std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now () - begin));
+		germ::vote_tally tally (block1);
+		begin = std::chrono::steady_clock::now ();
+		for (auto & block : { block1, block2 })
+		{
+			for (auto & rep : reps)
+			{
+				tally.vote (rep, node.ledger.weight (transaction, rep), block);
+				tally.winner ();
+				tally.runner_up ();
+			}
+		}
+		auto incremental (std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now () - begin));
+		ASSERT_EQ (*block2, *tally.winner ().second);
+		ASSERT_EQ (germ::uint128_t (1000) * count, tally.sum ());
+		std::cerr << count << " representatives, recompute: " << recompute.count () / (2 * count) << "ns/vote incremental: " << incremental.count () / (2 * count) << "ns/vote" << std::endl;
+	}
+}
+
+TEST (wallet, million_accounts)
+{
+	germ::system system (24000, 1);
+	auto wallet (system.wallet (0));
+	wallet->insert_adhoc (germ::test_genesis_key.prv);
+	auto count (1000000);
+	std::vector<germ::account> accounts;
+	{
+		// Deterministic entries with random accounts, deriving a million real keys would dominate the run
+		germ::transaction transaction (system.nodes[0]->store.environment, nullptr, true);
+		for (auto i (0); i != count; ++i)
+		{
+			germ::account account;
+			germ::random_pool.GenerateBlock (account.bytes.data (), account.bytes.size ());
+			uint64_t marker (1);
+			marker <<= 32;
+			marker |= i;
+			wallet->store.entry_put_raw (transaction, account, germ::wallet_value (germ::uint256_union (marker), 0));
+			accounts.push_back (account);
+		}
+	}
+	auto begin (std::chrono::steady_clock::now ());
+	{
+		germ::transaction transaction (system.nodes[0]->store.environment, nullptr, false);
+		wallet->metadata_load (transaction);
+	}
+	auto load (std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - begin));
+	size_t visited (0);
+	begin = std::chrono::steady_clock::now ();
+	{
+		germ::transaction transaction (system.nodes[0]->store.environment, nullptr, false);
+		system.nodes[0]->wallets.foreach_representative (transaction, [&visited](germ::public_key const &, germ::raw_key const &) {
+			++visited;
+		});
+	}
+	auto representatives (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - begin));
+	ASSERT_EQ (1, visited);
+	begin = std::chrono::steady_clock::now ();
+	{
+		germ::transaction transaction (system.nodes[0]->store.environment, nullptr, false);
+		for (auto & account : accounts)
+		{
+			ASSERT_TRUE (system.nodes[0]->wallets.exists (transaction, account));
+		}
+	}
+	auto exists (std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now () - begin));
+	begin = std::chrono::steady_clock::now ();
+	wallet->search_pending ();
+	auto search (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - begin));
+	std::cerr << count << " accounts, metadata load: " << load.count () << "ms representatives: " << representatives.count () << "us exists: " << exists.count () / count << "ns/lookup search pending: " << search.count () << "us" << std::endl;
+}
+
+TEST (tx, hash_per_block)
+{
+	germ::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	germ::genesis genesis;
+	germ::keypair key;
+	size_t count (1000);
+	std::vector<std::shared_ptr<germ::tx>> blocks;
+	auto previous (genesis.hash ());
+	for (size_t i (0); i < count; ++i)
+	{
+		// Large payloads are what made recomputing the hash on every call expensive
+		auto block (std::make_shared<germ::tx> (previous, key.pub, 0, germ::test_genesis_key.pub, germ::genesis_amount - i - 1, germ::tx_message (0, std::string (16 * 1024, 'a'), 0, 0), 0, germ::test_genesis_key.prv, germ::test_genesis_key.pub));
+		previous = block->hash ();
+		blocks.push_back (block);
+	}
+	auto computed (germ::tx::hashes_computed.load ());
+	auto begin (std::chrono::steady_clock::now ());
+	for (auto & block : blocks)
+	{
+		node.block_processor.add (block, std::chrono::steady_clock::now ());
+	}
+	node.block_processor.flush ();
+	auto elapsed (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - begin));
+	auto per_block (double (germ::tx::hashes_computed.load () - computed) / count);
+	// Every hash () call used to rehash, time the two side by side
+	size_t calls (1000);
+	begin = std::chrono::steady_clock::now ();
+	for (size_t i (0); i < calls; ++i)
+	{
+		blocks[i % count]->compute_hash ();
+	}
+	auto uncached (std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now () - begin));
+	begin = std::chrono::steady_clock::now ();
+	for (size_t i (0); i < calls; ++i)
+	{
+		blocks[i % count]->hash ();
+	}
+	auto cached (std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now () - begin));
+	std::cerr << "Hashes computed per processed block: " << per_block << " processing: " << elapsed.count () / count << "us/block hash (): " << cached.count () / calls << "ns cached " << uncached.count () / calls << "ns computed" << std::endl;
+}
+
 TEST (node, fork_storm)
 {
 	germ::system system (24000, 64);
@@ -396,3 +577,120 @@ TEST (store, vote_load)
 		node.vote_processor.vote (vote, system.nodes[0]->network.endpoint ());
 	}
 }
+
+TEST (rpc, json_speed)
+{
+	// accounts_balances shaped request and response, done once through property_tree and once through json_document and json_writer
+	size_t accounts (100);
+	std::vector<std::string> names;
+	boost::property_tree::ptree request;
+	request.put ("action", "accounts_balances");
+	boost::property_tree::ptree accounts_l;
+	for (size_t i (0); i < accounts; ++i)
+	{
+		germ::keypair key;
+		names.push_back (key.pub.to_account ());
+		boost::property_tree::ptree entry;
+		entry.put ("", names.back ());
+		accounts_l.push_back (std::make_pair ("", entry));
+	}
+	request.add_child ("accounts", accounts_l);
+	std::stringstream request_stream;
+	boost::property_tree::write_json (request_stream, request);
+	auto body (request_stream.str ());
+	germ::keypair key;
+	germ::tx block (1, key.pub, 0, key.pub, germ::genesis_amount, germ::tx_message (0, "data", 0, 0), 0, key.prv, key.pub);
+	auto tree_call ([&]() {
+		boost::property_tree::ptree request_l;
+		std::stringstream istream (body);
+		boost::property_tree::read_json (istream, request_l);
+		boost::property_tree::ptree response_l;
+		boost::property_tree::ptree balances;
+		for (auto & i : request_l.get_child ("accounts"))
+		{
+			boost::property_tree::ptree entry;
+			entry.put ("balance", germ::genesis_amount.convert_to<std::string> ());
+			entry.put ("pending", "0");
+			// What tx::serialize_json used to build for every block
+			boost::property_tree::ptree contents;
+			contents.put ("type", "send");
+			contents.put ("previous", block.previous ().to_string ());
+			contents.put ("destination", block.destination ().to_account ());
+			contents.put ("source", block.source ().to_string ());
+			contents.put ("balance", block.balance ().to_string_dec ());
+			contents.put ("account", block.account ().to_account ());
+			boost::property_tree::ptree tx;
+			tx.put ("value", germ::to_string_hex (block.tx_info ().value));
+			tx.put ("data", block.tx_info ().data);
+			tx.put ("gas", germ::to_string_hex (block.tx_info ().gas));
+			tx.put ("gasprice", germ::to_string_hex (block.tx_info ().gas_price));
+			contents.put_child ("tx_info", tx);
+			contents.put ("signature", block.signature.to_string ());
+			std::stringstream contents_stream;
+			boost::property_tree::write_json (contents_stream, contents);
+			entry.put ("contents", contents_stream.str ());
+			balances.push_back (std::make_pair (i.second.data (), entry));
+		}
+		response_l.add_child ("balances", balances);
+		std::stringstream ostream;
+		boost::property_tree::write_json (ostream, response_l);
+		return ostream.str ();
+	});
+	auto writer_call ([&]() {
+		auto error (false);
+		germ::json_document document (error, body);
+		germ::json_writer writer;
+		writer.begin_object ();
+		writer.begin_object ("balances");
+		for (auto i (document.root ().find ("accounts")->child); i != nullptr; i = i->next)
+		{
+			writer.begin_object (i->string ());
+			writer.value ("balance", germ::genesis_amount.convert_to<std::string> ());
+			writer.value ("pending", "0");
+			std::string contents;
+			block.serialize_json (contents);
+			writer.value ("contents", contents);
+			writer.end_object ();
+		}
+		writer.end_object ();
+		writer.end_object ();
+		return writer.output;
+	});
+	// Both responses have to read back as the same tree
+	boost::property_tree::ptree tree1;
+	std::stringstream stream1 (tree_call ());
+	boost::property_tree::read_json (stream1, tree1);
+	boost::property_tree::ptree tree2;
+	std::stringstream stream2 (writer_call ());
+	boost::property_tree::read_json (stream2, tree2);
+	ASSERT_EQ (accounts, tree2.get_child ("balances").size ());
+	for (auto & name : names)
+	{
+		auto & entry1 (tree1.get_child ("balances").get_child (name));
+		auto & entry2 (tree2.get_child ("balances").get_child (name));
+		ASSERT_EQ (entry1.get<std::string> ("balance"), entry2.get<std::string> ("balance"));
+		boost::property_tree::ptree contents1;
+		std::stringstream contents_stream1 (entry1.get<std::string> ("contents"));
+		boost::property_tree::read_json (contents_stream1, contents1);
+		boost::property_tree::ptree contents2;
+		std::stringstream contents_stream2 (entry2.get<std::string> ("contents"));
+		boost::property_tree::read_json (contents_stream2, contents2);
+		ASSERT_EQ (contents1, contents2);
+	}
+	size_t calls (1000);
+	size_t total (0);
+	auto begin (std::chrono::steady_clock::now ());
+	for (size_t i (0); i < calls; ++i)
+	{
+		total += tree_call ().size ();
+	}
+	auto tree (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - begin));
+	begin = std::chrono::steady_clock::now ();
+	for (size_t i (0); i < calls; ++i)
+	{
+		total += writer_call ().size ();
+	}
+	auto writer (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - begin));
+	ASSERT_NE (0, total);
+	std::cerr << accounts << " accounts per call, property_tree: " << tree.count () / calls << "us/call json_writer: " << writer.count () / calls << "us/call speedup: " << double (tree.count ()) / std::max<int64_t> (1, writer.count ()) << "x" << std::endl;
+}